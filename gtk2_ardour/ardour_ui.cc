@@ -791,7 +791,7 @@ void
 ARDOUR_UI::save_session_at_its_request (std::string snapshot_name)
 {
 	if (_session) {
-		_session->save_state (snapshot_name);
+		_session->save_state_in_background (snapshot_name);
 	}
 }
 
@@ -2744,16 +2744,28 @@ ARDOUR_UI::save_state (const string & name, bool switch_to_it)
 		_session->add_extra_xml (export_video_dialog->get_state());
 	}
 
-	save_state_canfail (name, switch_to_it);
+	save_state_canfail (name, switch_to_it, true);
 }
 
+/** Save the session and the UI state.
+ *  @param background true to hand the session file write to the session's
+ *  save thread; the return value then only reflects capturing the state.
+ *  Callers that go on to quit, or need to know that the file was written,
+ *  must pass false.
+ */
 int
-ARDOUR_UI::save_state_canfail (string name, bool switch_to_it)
+ARDOUR_UI::save_state_canfail (string name, bool switch_to_it, bool background)
 {
 	if (_session) {
 		int ret;
 
-		if ((ret = _session->save_state (name, false, switch_to_it)) != 0) {
+		if (background) {
+			ret = _session->save_state_in_background (name, false, switch_to_it);
+		} else {
+			ret = _session->save_state (name, false, switch_to_it);
+		}
+
+		if (ret != 0) {
 			return ret;
 		}
 	}
@@ -5238,7 +5250,14 @@ ARDOUR_UI::audioengine_became_silent ()
 
 	case Gtk::RESPONSE_NO:
 		/* save and quit */
-		save_state_canfail ("");
+		if (save_state_canfail ("")) {
+			/* failed - keep running so the session can still be saved */
+			MessageDialog msg (_main_window,
+					   string_compose (_("%1 was unable to save your session."), PROGRAM_NAME));
+			pop_back_splash (msg);
+			msg.run ();
+			break;
+		}
 		exit (0);
 		break;
 
@@ -196,7 +196,7 @@ class ARDOUR_UI : public Gtkmm2ext::UI, public ARDOUR::SessionHandlePtr
 	int unload_session (bool hide_stuff = false);
 	void close_session();
 
-	int  save_state_canfail (std::string state_name = "", bool switch_to_it = false);
+	int  save_state_canfail (std::string state_name = "", bool switch_to_it = false, bool background = false);
 	void save_state (const std::string & state_name = "", bool switch_to_it = false);
 
 	static ARDOUR_UI *instance () { return theArdourUI; }
@@ -1185,6 +1185,19 @@ AudioRegionView::create_waves ()
 	}
 }
 
+/** Add the sources of any of our channels that are still waiting for
+ *  their peaks to be built to @param sources.
+ */
+void
+AudioRegionView::get_sources_awaiting_peaks (SourceList& sources) const
+{
+	for (uint32_t n = 0; n < _data_ready_connections.size() && n < audio_region()->n_channels(); ++n) {
+		if (_data_ready_connections[n]) {
+			sources.push_back (audio_region()->audio_source (n));
+		}
+	}
+}
+
 void
 AudioRegionView::create_one_wave (uint32_t which, bool /*direct*/)
 {
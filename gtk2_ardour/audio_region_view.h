@@ -75,6 +75,7 @@ class AudioRegionView : public RegionView
 
 	void create_waves ();
 	void delete_waves ();
+	void get_sources_awaiting_peaks (ARDOUR::SourceList&) const;
 
 	void set_height (double);
 	void set_samples_per_pixel (double);
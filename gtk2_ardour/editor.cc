@@ -74,6 +74,7 @@
 #include "ardour/profile.h"
 #include "ardour/route_group.h"
 #include "ardour/session_playlists.h"
+#include "ardour/source_factory.h"
 #include "ardour/tempo.h"
 #include "ardour/utils.h"
 
@@ -4604,6 +4605,56 @@ Editor::visual_changer (const VisualChange& vc)
 	}
 
 	_summary->set_overlays_dirty ();
+
+	prioritize_visible_peaks ();
+}
+
+static void
+get_sources_awaiting_peaks_in_range (RegionView* rv, framepos_t start, framepos_t end, SourceList* sources)
+{
+	AudioRegionView* arv = dynamic_cast<AudioRegionView*> (rv);
+
+	if (arv && arv->region()->coverage (start, end) != Evoral::OverlapNone) {
+		arv->get_sources_awaiting_peaks (*sources);
+	}
+}
+
+/** Have the peak files for regions that can currently be seen built before
+ *  any others that are still waiting.
+ */
+void
+Editor::prioritize_visible_peaks ()
+{
+	if (!_session) {
+		return;
+	}
+
+	framepos_t const start = leftmost_frame;
+	framepos_t const end = start + current_page_samples ();
+	double const top = vertical_adjustment.get_value ();
+	double const bottom = top + vertical_adjustment.get_page_size ();
+
+	/* gather them top to bottom, so that they are built in that order */
+	TrackViewList tracks (track_views);
+	sort_track_selection (tracks);
+	SourceList sources;
+
+	for (TrackViewList::iterator i = tracks.begin(); i != tracks.end(); ++i) {
+
+		if ((*i)->hidden() || !(*i)->touched (top, bottom)) {
+			continue;
+		}
+
+		AudioTimeAxisView* atv = dynamic_cast<AudioTimeAxisView*> (*i);
+
+		if (atv && atv->audio_view()) {
+			atv->audio_view()->foreach_regionview (sigc::bind (sigc::ptr_fun (&get_sources_awaiting_peaks_in_range), start, end, &sources));
+		}
+	}
+
+	if (!sources.empty ()) {
+		SourceFactory::prioritize_peakfiles (sources);
+	}
 }
 
 struct EditorOrderTimeAxisSorter {
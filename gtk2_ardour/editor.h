@@ -1127,6 +1127,7 @@ class Editor : public PublicEditor, public PBD::ScopedConnectionList, public ARD
 	int idle_visual_changer ();
 	void visual_changer (const VisualChange&);
 	void ensure_visual_change_idle_handler ();
+	void prioritize_visible_peaks ();
 
 	/* track views */
 	TrackViewList track_views;
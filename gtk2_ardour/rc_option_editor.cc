@@ -235,9 +235,10 @@ public:
 	UndoOptions (RCConfiguration* c) :
 		_rc_config (c),
 		_limit_undo_button (_("Limit undo history to")),
-		_save_undo_button (_("Save undo history of"))
+		_save_undo_button (_("Save undo history of")),
+		_limit_undo_memory_button (_("Limit undo history memory to"))
 	{
-		Table* t = new Table (2, 3);
+		Table* t = new Table (3, 3);
 		t->set_spacings (4);
 
 		t->attach (_limit_undo_button, 0, 1, 0, 1, FILL);
@@ -254,12 +255,22 @@ public:
 		l = manage (left_aligned_label (_("commands")));
 		t->attach (*l, 2, 3, 1, 2);
 
+		t->attach (_limit_undo_memory_button, 0, 1, 2, 3, FILL);
+		_limit_undo_memory_spin.set_range (1, 16384);
+		_limit_undo_memory_spin.set_increments (16, 256);
+		_limit_undo_memory_spin.set_value (256);
+		t->attach (_limit_undo_memory_spin, 1, 2, 2, 3, FILL | EXPAND);
+		l = manage (left_aligned_label (_("MB")));
+		t->attach (*l, 2, 3, 2, 3);
+
 		_box->pack_start (*t);
 
 		_limit_undo_button.signal_toggled().connect (sigc::mem_fun (*this, &UndoOptions::limit_undo_toggled));
 		_limit_undo_spin.signal_value_changed().connect (sigc::mem_fun (*this, &UndoOptions::limit_undo_changed));
 		_save_undo_button.signal_toggled().connect (sigc::mem_fun (*this, &UndoOptions::save_undo_toggled));
 		_save_undo_spin.signal_value_changed().connect (sigc::mem_fun (*this, &UndoOptions::save_undo_changed));
+		_limit_undo_memory_button.signal_toggled().connect (sigc::mem_fun (*this, &UndoOptions::limit_undo_memory_toggled));
+		_limit_undo_memory_spin.signal_value_changed().connect (sigc::mem_fun (*this, &UndoOptions::limit_undo_memory_changed));
 	}
 
 	void parameter_changed (string const & p)
@@ -275,6 +286,13 @@ public:
 			_save_undo_spin.set_sensitive (x);
 		} else if (p == "save-history-depth") {
 			_save_undo_spin.set_value (_rc_config->get_saved_history_depth());
+		} else if (p == "history-memory-limit") {
+			uint32_t const m = _rc_config->get_history_memory_limit();
+			_limit_undo_memory_button.set_active (m != 0);
+			_limit_undo_memory_spin.set_sensitive (m != 0);
+			if (m != 0) {
+				_limit_undo_memory_spin.set_value (m);
+			}
 		}
 	}
 
@@ -283,6 +301,7 @@ public:
 		parameter_changed ("save-history");
 		parameter_changed ("history-depth");
 		parameter_changed ("save-history-depth");
+		parameter_changed ("history-memory-limit");
 	}
 
 	void limit_undo_toggled ()
@@ -310,12 +329,26 @@ public:
 		_rc_config->set_saved_history_depth (_save_undo_spin.get_value_as_int ());
 	}
 
+	void limit_undo_memory_toggled ()
+	{
+		bool const x = _limit_undo_memory_button.get_active ();
+		_limit_undo_memory_spin.set_sensitive (x);
+		_rc_config->set_history_memory_limit (x ? _limit_undo_memory_spin.get_value_as_int () : 0);
+	}
+
+	void limit_undo_memory_changed ()
+	{
+		_rc_config->set_history_memory_limit (_limit_undo_memory_spin.get_value_as_int ());
+	}
+
 private:
 	RCConfiguration* _rc_config;
 	CheckButton _limit_undo_button;
 	SpinButton _limit_undo_spin;
 	CheckButton _save_undo_button;
 	SpinButton _save_undo_spin;
+	CheckButton _limit_undo_memory_button;
+	SpinButton _limit_undo_memory_spin;
 };
 
 
@@ -1816,6 +1849,16 @@ RCOptionEditor::RCOptionEditor ()
 		procs->set_note (string_compose (_("This setting will only take effect when %1 is restarted."), PROGRAM_NAME));
 
                 add_option (_("Misc"), procs);
+
+		bo = new BoolOption (
+			"graph-work-stealing",
+			_("Distribute signal processing using per-thread work queues"),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::get_graph_work_stealing),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::set_graph_work_stealing)
+			);
+		Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+			_("When enabled, each processing thread keeps its own queue of routes that are ready to run, and idle threads take work from the others. This scales better on machines with many cores and sessions with many small routes."));
+		add_option (_("Misc"), bo);
         }
 
 	add_option (_("Misc"), new OptionEditorHeading (S_("Options|Undo")));
@@ -1840,6 +1883,14 @@ RCOptionEditor::RCOptionEditor ()
 		     sigc::mem_fun (*_rc_config, &RCConfiguration::set_periodic_safety_backups)
 		     ));
 
+	add_option (_("Misc"),
+	     new BoolOption (
+		     "background-session-save",
+		     _("Write the session file in the background"),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::get_background_session_save),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::set_background_session_save)
+		     ));
+
 	add_option (_("Misc"),
 	     new BoolOption (
 		     "only-copy-imported-files",
@@ -2332,6 +2383,24 @@ if (!Profile->get_mixbus()) {
 
 	add_option (_("Audio"), new BufferingOptions (_rc_config));
 
+	add_option (_("Audio"),
+	     new SpinOption<uint32_t> (
+		     "butler-io-threads",
+		     _("Disk I/O threads (0: one per CPU core)"),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::get_butler_io_threads),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::set_butler_io_threads),
+		     0, 64, 1, 4
+		     ));
+
+	add_option (_("Audio"),
+	     new SpinOption<uint32_t> (
+		     "session-load-threads",
+		     _("Session loading threads (0: one per CPU core)"),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::get_session_load_threads),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::set_session_load_threads),
+		     0, 64, 1, 4
+		     ));
+
 	add_option (_("Audio"), new OptionEditorHeading (_("Monitoring")));
 
 	ComboOption<MonitorModel>* mm = new ComboOption<MonitorModel> (
@@ -2943,6 +3012,28 @@ if (!Profile->get_mixbus()) {
 #endif
 #endif
 
+	add_option (_("Plugins"), new OptionEditorHeading (_("Automation")));
+
+	ComboOption<uint32_t>* pag = new ComboOption<uint32_t> (
+		"plugin-automation-grid",
+		_("Split plugin processing at automation events"),
+		sigc::mem_fun (*_rc_config, &RCConfiguration::get_plugin_automation_grid),
+		sigc::mem_fun (*_rc_config, &RCConfiguration::set_plugin_automation_grid)
+		);
+
+	pag->add (1, _("at every event (sample accurate)"));
+	pag->add (16, _("at most every 16 samples"));
+	pag->add (32, _("at most every 32 samples"));
+	pag->add (64, _("at most every 64 samples"));
+	pag->add (128, _("at most every 128 samples"));
+
+	Gtkmm2ext::UI::instance()->set_tip (pag->tip_widget(),
+			_("Plugins that cannot apply automation within a process cycle are run in several pieces, one per automation event. "
+			  "Dense automation can split a cycle into many tiny pieces, which is expensive. "
+			  "This sets the shortest piece: events in between take effect at the start of the next one. "
+			  "LV2 plugins that read automation events themselves get them at the same resolution."));
+	add_option (_("Plugins"), pag);
+
 	/* INTERFACE */
 
 #ifdef OPTIONAL_CAIRO_IMAGE_SURFACE
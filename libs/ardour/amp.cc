@@ -204,13 +204,7 @@ Amp::apply_gain (BufferSet& bufs, framecnt_t sample_rate, framecnt_t nframes, ga
 	const double a = 156.825 / sample_rate; // 25 Hz LPF
 
 	for (BufferSet::audio_iterator i = bufs.audio_begin(); i != bufs.audio_end(); ++i) {
-		Sample* const buffer = i->data();
-		double lpf = initial;
-
-		for (pframes_t nx = 0; nx < nframes; ++nx) {
-			buffer[nx] *= lpf;
-			lpf += a * (target - lpf);
-		}
+		const gain_t lpf = apply_gain_ramp (i->data(), nframes, initial, target, a);
 		if (i == bufs.audio_begin()) {
 			rv = lpf;
 		}
@@ -279,14 +273,9 @@ Amp::apply_gain (AudioBuffer& buf, framecnt_t sample_rate, framecnt_t nframes, g
 		return target;
 	}
 
-        Sample* const buffer = buf.data();
 	const double a = 156.825 / sample_rate; // 25 Hz LPF, see [other] Amp::apply_gain() above for details
 
-	double lpf = initial;
-        for (pframes_t nx = 0; nx < nframes; ++nx) {
-                buffer[nx] *= lpf;
-		lpf += a * (target - lpf);
-        }
+	const gain_t lpf = apply_gain_ramp (buf.data(), nframes, initial, target, a);
 
 	if (fabs (lpf - target) < GAIN_COEFF_TINY) return target;
 	if (fabs (lpf) < GAIN_COEFF_TINY) return GAIN_COEFF_ZERO;
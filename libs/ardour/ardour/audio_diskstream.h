@@ -126,6 +126,11 @@ class LIBARDOUR_API AudioDiskstream : public Diskstream
 		}
 	}
 
+	/* Give the calling thread its own refill working buffers, so that
+	 * several butler I/O threads can refill different diskstreams at the
+	 * same time. Threads that never call this share the static buffers.
+	 */
+	static void allocate_thread_working_buffers ();
 
   protected:
 	friend class Session;
@@ -209,7 +214,7 @@ class LIBARDOUR_API AudioDiskstream : public Diskstream
 
 	/* The two central butler operations */
 	int do_flush (RunContext context, bool force = false);
-	int do_refill () { return _do_refill(_mixdown_buffer, _gain_buffer, 0); }
+	int do_refill ();
 
 
 	int read (Sample* buf, Sample* mixdown_buffer, float* gain_buffer,
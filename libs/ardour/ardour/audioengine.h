@@ -131,6 +131,19 @@ class LIBARDOUR_API AudioEngine : public SessionHandlePtr, public PortManager
 	bool freewheeling() const { return _freewheeling; }
 	bool running() const { return _running; }
 
+	/* Offline processing: the caller runs process cycles itself, from its
+	 * own thread and as fast as it can, instead of the backend. The
+	 * process lock is held from start_offline_processing() to
+	 * stop_offline_processing() (which must be called from the same
+	 * thread), so the backend's own process callback just outputs
+	 * silence meanwhile. freewheeling() is true, and each cycle emits
+	 * Freewheel, as for a freewheel export.
+	 */
+	int  start_offline_processing ();
+	int  process_offline (pframes_t nframes);
+	void stop_offline_processing ();
+	bool processing_offline () const { return g_atomic_int_get (const_cast<gint*> (&_processing_offline)); }
+
 	Glib::Threads::Mutex& process_lock() { return _process_lock; }
 	Glib::Threads::RecMutex& state_lock() { return _state_lock; }
 
@@ -261,6 +274,7 @@ class LIBARDOUR_API AudioEngine : public SessionHandlePtr, public PortManager
 	gain_t                     session_removal_gain_step;
 	bool                      _running;
 	bool                      _freewheeling;
+	gint                      _processing_offline;
 	/// number of frames between each check for changes in monitor input
 	framecnt_t                 monitor_check_interval;
 	/// time of the last monitor check in frames
@@ -23,6 +23,8 @@
 #include <vector>
 #include <list>
 
+#include <glibmm/threads.h>
+
 #include "ardour/ardour.h"
 #include "ardour/playlist.h"
 
@@ -57,6 +59,48 @@ private:
 	bool region_changed (const PBD::PropertyChange&, boost::shared_ptr<Region>);
 	void source_offset_changed (boost::shared_ptr<AudioRegion>);
         void load_legacy_crossfades (const XMLNode&, int version);
+
+	/** The order in which to read our regions, and which parts of them to
+	 *  read, worked out once for the whole playlist and then reused by each
+	 *  read() until the playlist's contents_generation() changes.
+	 */
+	struct ReadPlan {
+		struct Segment {
+			AudioRegion* region;   ///< only valid while the playlist's region lock is held
+			framepos_t   from;     ///< first frame to read, in session frames
+			framepos_t   to;       ///< last frame to read (inclusive)
+			framepos_t   copy_from; ///< part of [from, to] that the region's body copies over
+			framepos_t   copy_to;   ///< rather than mixes into the buffer; empty if copy_to < copy_from
+		};
+
+		/** orders indices into segments by Segment::from */
+		struct FromBefore {
+			FromBefore (std::vector<Segment> const & s) : segments (s) {}
+			bool operator() (uint32_t a, uint32_t b) const { return segments[a].from < segments[b].from; }
+			bool operator() (framepos_t pos, uint32_t b) const { return pos < segments[b].from; }
+			std::vector<Segment> const & segments;
+		};
+
+		ReadPlan () : generation (0) {}
+
+		/** in the order in which they must be read, lowest layer first */
+		std::vector<Segment>    segments;
+		/** indices into segments, ordered by Segment::from */
+		std::vector<uint32_t>   by_from;
+		/** max_to[n] is the largest Segment::to of by_from[0] ... by_from[n] */
+		std::vector<framepos_t> max_to;
+		/** ordered, disjoint ranges that some segment's body copies over;
+		 *  everywhere else has to be silenced before reading.
+		 */
+		std::vector<Evoral::Range<framepos_t> > copied;
+		gint generation;
+	};
+
+	boost::shared_ptr<ReadPlan> _read_plan;
+	Glib::Threads::Mutex        _read_plan_lock;
+
+	boost::shared_ptr<ReadPlan> read_plan ();
+	void build_read_plan (ReadPlan&);
 };
 
 } /* namespace ARDOUR */
@@ -106,6 +106,12 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 
 	static void allocate_working_buffers (framecnt_t framerate);
 
+	/** Number of peak resolutions kept for each source, including the main
+	 *  peakfile.  Level n holds one peak per peak_level_fpp (n) samples.
+	 */
+	static const uint32_t n_peak_levels = 4;
+	static framecnt_t peak_level_fpp (uint32_t level);
+
   protected:
 	static bool _build_missing_peakfiles;
 	static bool _build_peakfiles;
@@ -129,6 +135,9 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 
 	int initialize_peakfile (const std::string& path, const bool in_session = false);
 	int build_peaks_from_scratch ();
+	std::string peak_level_path (uint32_t level) const;
+	void unlink_peak_levels ();
+	void invalidate_peak_cache ();
 	int compute_and_write_peaks (Sample* buf, framecnt_t first_frame, framecnt_t cnt,
 	bool force, bool intermediate_peaks_ready_signal);
 	void truncate_peakfile();
@@ -169,6 +178,33 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 	mutable off_t _last_map_off;
 	mutable size_t  _last_raw_map_length;
 	mutable boost::scoped_array<PeakData> peak_cache;
+
+	/* The coarser peak levels (1 .. n_peak_levels-1) live in files next
+	 * to the main peakfile. Each is built from the level below it as
+	 * peaks are written, so that zoomed-out views can read a few peaks
+	 * rather than decimating the whole main peakfile.
+	 */
+	struct PeakLevel {
+		PeakLevel () : fd (-1), peak (-1), merged (0), byte_max (0) {}
+
+		int        fd;
+		framepos_t peak;     ///< index of the peak being accumulated, or -1
+		uint32_t   merged;   ///< number of finer peaks merged into it so far
+		PeakData   data;
+		off_t      byte_max;
+	};
+
+	PeakLevel _peak_levels[n_peak_levels]; ///< [0] is unused
+	mutable gint _peak_levels_ready; ///< read by GUI and waveview threads, so atomic
+
+	int  open_peak_levels ();
+	void close_peak_levels ();
+	int  flush_peak_levels ();
+	void write_peak_levels (PeakData const *, framepos_t first_peak, framecnt_t npeaks);
+	int  add_to_peak_level (uint32_t level, PeakData const *, framepos_t first_peak, framecnt_t npeaks);
+	int  flush_peak_level (uint32_t level);
+	int  build_peak_levels_from_peakfile ();
+	bool peak_levels_valid (time_t peakfile_mtime) const;
 };
 
 }
@@ -17,11 +17,13 @@
 
 */
 
-#include <set>
+#include <list>
 #include <boost/shared_ptr.hpp>
 #include <glibmm/threads.h>
 #include <sigc++/signal.h>
 
+#include "pbd/rcu.h"
+#include "pbd/ringbuffer.h"
 #include "pbd/signals.h"
 
 #include "ardour/session_handle.h"
@@ -38,22 +40,57 @@ class LIBARDOUR_API AutomationWatch : public sigc::trackable, public ARDOUR::Ses
     void remove_automation_watch (boost::shared_ptr<ARDOUR::AutomationControl>);
     void set_session (ARDOUR::Session*);
 
+    /** Called by the process thread at the start of every cycle: note the
+     * value of every control being written, with the position it applies to.
+     * Realtime-safe; does nothing unless a watch exists for @param s.
+     */
+    static void process (ARDOUR::Session& s);
+
+    /** Move everything noted by process() into the automation lists and
+     * end the thinning runs; called before write passes finish.
+     */
+    void flush ();
+
     gint timer ();
 
   private:
-    typedef std::set<boost::shared_ptr<ARDOUR::AutomationControl> > AutomationWatches;
+    /** A value noted by the process thread */
+    struct Event {
+        framepos_t when;
+        double     value;
+        bool       new_pass; ///< transport moved backwards (or looped): restart the write pass here
+    };
+
+    struct Watch {
+        Watch (boost::shared_ptr<ARDOUR::AutomationControl> c);
+
+        boost::shared_ptr<ARDOUR::AutomationControl> ac;
+        RingBuffer<Event> events; ///< written by the process thread only
+
+        /* thinning, done while moving events into the list */
+        bool   have_anchor;
+        Event  anchor;  ///< last point added to the list
+        bool   have_pending;
+        Event  pending; ///< held back until the next point shows whether it is needed
+    };
+
+    typedef std::list<boost::shared_ptr<Watch> > Watches;
 
     AutomationWatch ();
     ~AutomationWatch();
 
     static AutomationWatch* _instance;
     Glib::Threads::Thread*  _thread;
-    framepos_t              _last_time;
+    framepos_t              _last_time; ///< position of the last values noted
     bool                    _run_thread;
-    AutomationWatches        automation_watches;
+    SerializedRCUManager<Watches> automation_watches;
     Glib::Threads::Mutex     automation_watch_lock;
     PBD::ScopedConnection    transport_connection;
 
+    void note_values (framepos_t);
+    void flush_watch (Watch&);
+    void add_point (Watch&, Event const &);
+    void finish_points (Watch&);
     void transport_state_change ();
     void remove_weak_automation_watch (boost::weak_ptr<ARDOUR::AutomationControl>);
     void thread ();
@@ -137,6 +137,7 @@ public:
 	void read_from(const BufferSet& in, framecnt_t nframes);
 	void read_from(const BufferSet& in, framecnt_t nframes, DataType);
 	void merge_from(const BufferSet& in, framecnt_t nframes);
+	void merge_from(const BufferSet* const* ins, uint32_t n_ins, framecnt_t nframes);
 
 	template <typename BS, typename B>
 	class iterator_base {
@@ -27,6 +27,7 @@
 #include "pbd/crossthread.h"
 #include "pbd/ringbuffer.h"
 #include "pbd/pool.h"
+#include "pbd/semutils.h"
 #include "ardour/libardour_visibility.h"
 #include "ardour/types.h"
 #include "ardour/session_handle.h"
@@ -35,6 +36,8 @@
 
 namespace ARDOUR {
 
+class Track;
+
 /**
  *  One of the Butler's functions is to clean up (ie delete) unused CrossThreadPools.
  *  When a thread with a CrossThreadPool terminates, its CTP is added to pool_trash.
@@ -91,8 +94,50 @@ private:
 	void empty_pool_trash ();
 	void config_changed (std::string);
 
+	bool refill_tracks (boost::shared_ptr<RouteList>);
 	bool flush_tracks_to_disk_normal (boost::shared_ptr<RouteList>, uint32_t& errors);
 
+	/* I/O worker pool.
+	 *
+	 * Refill and flush work for one pass is spread over the butler thread
+	 * and config->get_butler_io_threads() - 1 additional I/O threads. The
+	 * butler thread always waits for every worker to finish a pass, so
+	 * a pass completes exactly as it did when all tracks were handled
+	 * serially.
+	 */
+
+	enum IOJob {
+		IORefill,
+		IOFlush,
+		IOForcedFlush,
+		IOQuit
+	};
+
+	struct IOItem {
+		IOItem (boost::shared_ptr<Track> t, float l) : track (t), load (l) {}
+		boost::shared_ptr<Track> track;
+		float load;
+		bool operator< (IOItem const& other) const { return load < other.load; }
+	};
+
+	bool run_io_jobs (IOJob, uint32_t& errors);
+	void process_io_jobs ();
+	void setup_io_threads ();
+	void drop_io_threads ();
+
+	static void* _io_thread_work (void *arg);
+	void*         io_thread_work ();
+
+	std::vector<pthread_t> _io_threads;
+	PBD::Semaphore         _io_run_sem;
+	PBD::Semaphore         _io_done_sem;
+	IOJob                  _io_job;
+	std::vector<IOItem>    _io_items;
+	gint                   _io_next;
+	gint                   _io_outstanding;
+	gint                   _io_errors;
+	gint                   _io_threads_changed;
+
 	/**
 	 * Add request to butler thread request queue
 	 */
@@ -22,7 +22,9 @@
 #include <stdint.h>
 #include <string.h>
 #include <assert.h>
+#include <vector>
 #include <glib.h>
+#include <fftw3.h>
 #include "ardour/libardour_visibility.h"
 
 namespace ARDOUR { namespace DSP {
@@ -142,6 +144,21 @@ namespace ARDOUR { namespace DSP {
 	 */
 	void peaks (float *data, float &min, float &max, uint32_t n_samples);
 
+	/** mix with a gain ramp
+	 * add `src' to `dst', applying a gain that moves from `initial' towards
+	 * `target' by coeff * (target - gain) every sample, like
+	 * ARDOUR::apply_gain_ramp() does in-place.
+	 *
+	 * @param dst destination buffer
+	 * @param src source buffer
+	 * @param n_samples number of samples to mix
+	 * @param initial gain of the first sample
+	 * @param target target gain
+	 * @param coeff low-pass coefficient (0..1), 1 jumps straight to target
+	 * @returns gain for the sample after the last one, to continue the ramp
+	 */
+	LIBARDOUR_API float mix_with_gain_ramp (float *dst, const float *src, const uint32_t n_samples, float initial, float target, float coeff);
+
 	/** non-linear power-scale meter deflection
 	 *
 	 * @param power signal power (dB)
@@ -230,6 +247,11 @@ namespace ARDOUR { namespace DSP {
 			void compute (Type t, double freq, double Q, double gain);
 			/** reset filter state */
 			void reset () { _z1 = _z2 = 0.0; }
+			/** use the coefficients of another filter, keep the state
+			 *
+			 * @param other filter to copy the setup from
+			 */
+			void configure (const BiQuad &other);
 		private:
 			double _rate;
 			float  _z1, _z2;
@@ -237,5 +259,238 @@ namespace ARDOUR { namespace DSP {
 			double _b0, _b1, _b2;
 	};
 
+	/** A bank of cascaded Biquad Filters, for multiple channels
+	 *
+	 * Every channel runs the same chain of `n_stages' filters
+	 * (e.g. the bands of an EQ), each channel with its own state.
+	 */
+	class LIBARDOUR_API BiQuadBank {
+		public:
+			/** Instantiate a Biquad bank
+			 *
+			 * @param samplerate Samplerate
+			 * @param n_channels number of channels
+			 * @param n_stages number of filters per channel
+			 */
+			BiQuadBank (double samplerate, uint32_t n_channels, uint32_t n_stages);
+
+			/** setup a stage for all channels, compute coefficients
+			 *
+			 * @param stage filter stage (0 .. n_stages - 1)
+			 * @param t filter type (LowPass, HighPass, etc)
+			 * @param freq filter frequency
+			 * @param Q filter quality
+			 * @param gain filter gain
+			 */
+			void compute (uint32_t stage, BiQuad::Type t, double freq, double Q, double gain);
+			/** process audio data of one channel, in-place, through all stages
+			 *
+			 * @param channel channel (0 .. n_channels - 1)
+			 * @param data pointer to audio-data
+			 * @param n_samples number of samples to process
+			 */
+			void run (uint32_t channel, float *data, const uint32_t n_samples);
+			/** reset filter state of all channels */
+			void reset ();
+		private:
+			uint32_t _n_channels;
+			uint32_t _n_stages;
+			std::vector<BiQuad> _filters;
+	};
+
+	/** FIR Filter
+	 *
+	 * Direct convolution with a (short) impulse response, e.g. for
+	 * linear-phase filters. The inner loop is a plain dot product
+	 * which the compiler vectorizes.
+	 */
+	class LIBARDOUR_API FIRFilter {
+		public:
+			/** instantiate a FIR filter
+			 *
+			 * Since memory allocation is not realtime safe it should be
+			 * instantiated during dsp_init() or dsp_configure().
+			 *
+			 * @param n_taps length of the impulse response
+			 * @param max_block largest number of samples processed in one go,
+			 * larger blocks are split.
+			 */
+			FIRFilter (uint32_t n_taps, uint32_t max_block = 8192);
+			~FIRFilter ();
+
+			/** access the impulse response
+			 *
+			 * @returns float[n_taps], initially a unit impulse
+			 */
+			float* taps () { return _taps; }
+			/** set a single coefficient of the impulse response
+			 *
+			 * @param tap index (0 .. n_taps - 1)
+			 * @param val coefficient
+			 */
+			void set_tap (uint32_t tap, float val) { if (tap < _n_taps) { _taps[tap] = val; } }
+			/** process audio data, in-place
+			 *
+			 * @param data pointer to audio-data
+			 * @param n_samples number of samples to process
+			 */
+			void run (float *data, const uint32_t n_samples);
+			/** reset filter state */
+			void reset ();
+		private:
+			FIRFilter (const FIRFilter&);
+			FIRFilter& operator= (const FIRFilter&);
+
+			uint32_t _n_taps;
+			uint32_t _max_block;
+			float*   _taps;
+			float*   _history;
+	};
+
+	/** Envelope Follower
+	 *
+	 * Peak envelope with separate attack and release times, e.g. for
+	 * compressors, gates or meters.
+	 */
+	class LIBARDOUR_API EnvelopeFollower {
+		public:
+			/** instantiate an envelope follower
+			 *
+			 * @param samplerate samplerate
+			 * @param attack attack time in milliseconds
+			 * @param release release time in milliseconds
+			 */
+			EnvelopeFollower (double samplerate, float attack, float release);
+			/** set attack time
+			 *
+			 * @param ms attack time in milliseconds
+			 */
+			void set_attack (float ms);
+			/** set release time
+			 *
+			 * @param ms release time in milliseconds
+			 */
+			void set_release (float ms);
+			/** follow audio data
+			 *
+			 * @param data audio-data to analyze
+			 * @param n_samples number of samples to analyze
+			 * @returns envelope level after the last sample
+			 */
+			float proc (const float *data, const uint32_t n_samples);
+			/** follow audio data, keep the envelope
+			 *
+			 * @param data audio-data to analyze
+			 * @param env array to store the envelope in, n_samples long
+			 * @param n_samples number of samples to analyze
+			 */
+			void run (const float *data, float *env, const uint32_t n_samples);
+			/** current envelope level */
+			float level () const { return _env; }
+			/** reset envelope */
+			void reset () { _env = 0.f; }
+		private:
+			float _rate;
+			float _env;
+			float _attack;
+			float _release;
+	};
+
+	/** Delay Line */
+	class LIBARDOUR_API DelayLine {
+		public:
+			/** instantiate a delay line
+			 *
+			 * Since memory allocation is not realtime safe it should be
+			 * instantiated during dsp_init() or dsp_configure().
+			 *
+			 * @param max_delay maximum delay in samples
+			 */
+			DelayLine (uint32_t max_delay);
+			~DelayLine ();
+
+			/** set the delay
+			 *
+			 * @param delay delay in samples, at most max_delay
+			 */
+			void set_delay (uint32_t delay);
+			/** process audio data, in-place
+			 *
+			 * @param data pointer to audio-data
+			 * @param n_samples number of samples to process
+			 */
+			void run (float *data, const uint32_t n_samples);
+			/** clear the delay line */
+			void reset ();
+		private:
+			DelayLine (const DelayLine&);
+			DelayLine& operator= (const DelayLine&);
+
+			float*   _buf;
+			uint32_t _size;
+			uint32_t _mask;
+			uint32_t _max_delay;
+			uint32_t _delay;
+			uint32_t _w;
+	};
+
+	/** Spectrum Analysis
+	 *
+	 * Real FFT of a Hann-windowed block of audio-data.
+	 */
+	class LIBARDOUR_API FFTSpectrum {
+		public:
+			/** instantiate a spectrum analyzer
+			 *
+			 * Since memory allocation and FFT planning is not realtime
+			 * safe it should be instantiated during dsp_init() or
+			 * dsp_configure().
+			 *
+			 * @param window_size FFT size (in samples)
+			 * @param rate samplerate
+			 */
+			FFTSpectrum (uint32_t window_size, double rate);
+			~FFTSpectrum ();
+
+			/** set data to be analyzed, applying a Hann window
+			 *
+			 * @param data audio-data
+			 * @param n_samples number of samples to copy
+			 * @param offset position in the FFT window to copy the data to
+			 */
+			void set_data_hann (float const * const data, const uint32_t n_samples, const uint32_t offset = 0);
+			/** process the data in the FFT window */
+			void execute ();
+			/** magnitude of a bin, after execute()
+			 *
+			 * @param b bin (0 .. window_size / 2 - 1)
+			 * @param norm gain factor (e.g. to normalize to the window size)
+			 */
+			float magnitude_at_bin (const uint32_t b, const float norm = 1.f) const;
+			/** power (dB) of a bin, after execute()
+			 *
+			 * @param b bin (0 .. window_size / 2 - 1)
+			 * @param norm gain factor (e.g. to normalize to the window size)
+			 */
+			float power_at_bin (const uint32_t b, const float norm = 1.f) const;
+			/** center frequency of a bin
+			 *
+			 * @param b bin
+			 */
+			float freq_at_bin (const uint32_t b) const { return b * _rate / _window_size; }
+			/** number of bins */
+			uint32_t bins () const { return _window_size / 2; }
+		private:
+			FFTSpectrum (const FFTSpectrum&);
+			FFTSpectrum& operator= (const FFTSpectrum&);
+
+			uint32_t   _window_size;
+			double     _rate;
+			float*     _hann_window;
+			float*     _fft_data_in;
+			float*     _fft_data_out;
+			fftwf_plan _fftplan;
+	};
+
 } } /* namespace */
 #endif
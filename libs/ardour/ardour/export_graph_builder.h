@@ -24,10 +24,11 @@
 #include "ardour/export_handler.h"
 #include "ardour/export_analysis.h"
 
-#include "audiographer/utils/identity_vertex.h"
+#include "audiographer/sink.h"
 
 #include <boost/ptr_container/ptr_list.hpp>
 #include <glibmm/threadpool.h>
+#include <glibmm/threads.h>
 
 namespace AudioGrapher {
 	class SampleRateConverter;
@@ -56,9 +57,9 @@ class LIBARDOUR_API ExportGraphBuilder
 	typedef ExportHandler::FileSpec FileSpec;
 
 	typedef boost::shared_ptr<AudioGrapher::Sink<Sample> > FloatSinkPtr;
-	typedef boost::shared_ptr<AudioGrapher::IdentityVertex<Sample> > IdentityVertexPtr;
+	typedef boost::shared_ptr<AudioGrapher::Threader<Sample> > ThreaderPtr;
 	typedef boost::shared_ptr<AudioGrapher::Analyser> AnalysisPtr;
-	typedef std::map<ExportChannelPtr,  IdentityVertexPtr> ChannelMap;
+	typedef std::map<ExportChannelPtr, Sample const *> ChannelMap;
 	typedef std::map<std::string, AnalysisPtr> AnalysisMap;
 
   public:
@@ -66,7 +67,10 @@ class LIBARDOUR_API ExportGraphBuilder
 	ExportGraphBuilder (Session const & session);
 	~ExportGraphBuilder ();
 
-	int process (framecnt_t frames, bool last_cycle);
+	/** Process @param frames frames, starting @param offset frames into
+	 * the current process cycle.
+	 */
+	int process (framecnt_t offset, framecnt_t frames, bool last_cycle);
 	bool process_normalize (); // returns true when finished
 	bool will_normalize() { return !normalizers.empty(); }
 	unsigned get_normalize_cycle_count() const;
@@ -162,7 +166,6 @@ class LIBARDOUR_API ExportGraphBuilder
 		typedef boost::shared_ptr<AudioGrapher::PeakReader> PeakReaderPtr;
 		typedef boost::shared_ptr<AudioGrapher::Normalizer> NormalizerPtr;
 		typedef boost::shared_ptr<AudioGrapher::TmpFile<Sample> > TmpFilePtr;
-		typedef boost::shared_ptr<AudioGrapher::Threader<Sample> > ThreaderPtr;
 		typedef boost::shared_ptr<AudioGrapher::AllocatingProcessContext<Sample> > BufferPtr;
 
 		void start_post_processing();
@@ -229,6 +232,7 @@ class LIBARDOUR_API ExportGraphBuilder
 	class ChannelConfig {
 	    public:
 		ChannelConfig (ExportGraphBuilder & parent, FileSpec const & new_config, ChannelMap & channel_map);
+		FloatSinkPtr sink ();
 		void add_child (FileSpec const & new_config);
 		void remove_children (bool remove_out_files);
 		bool operator== (FileSpec const & other_config) const;
@@ -237,9 +241,24 @@ class LIBARDOUR_API ExportGraphBuilder
 		typedef boost::shared_ptr<AudioGrapher::Interleaver<Sample> > InterleaverPtr;
 		typedef boost::shared_ptr<AudioGrapher::Chunker<Sample> > ChunkerPtr;
 
+		/* Feeds the interleaver with the channel data read by
+		 * ExportGraphBuilder::process(). The context it is given only
+		 * carries the frame count and flags.
+		 */
+		class Input : public AudioGrapher::Sink<Sample> {
+		    public:
+			Input (ChannelConfig & config) : config (config) {}
+			void process (AudioGrapher::ProcessContext<Sample> const & c);
+			using AudioGrapher::Sink<Sample>::process;
+		    private:
+			ChannelConfig & config;
+		};
+
 		ExportGraphBuilder &      parent;
 		FileSpec                  config;
 		boost::ptr_list<SilenceHandler> children;
+		std::vector<ChannelMap::const_iterator> channels;
+		FloatSinkPtr              input;
 		InterleaverPtr            interleaver;
 		ChunkerPtr                chunker;
 		framecnt_t                max_frames_out;
@@ -252,12 +271,16 @@ class LIBARDOUR_API ExportGraphBuilder
 	typedef boost::ptr_list<ChannelConfig> ChannelConfigList;
 	ChannelConfigList channel_configs;
 
-	// The sources of all data, each channel is read only once
+	// The sources of all data, each channel is read only once per cycle
 	ChannelMap channels;
 
+	// Runs the channel configurations in parallel
+	ThreaderPtr threader;
+
 	framecnt_t process_buffer_frames;
 
 	std::list<Normalizer *> normalizers;
+	Glib::Threads::Mutex    normalizers_lock;
 
 	AnalysisMap analysis_map;
 
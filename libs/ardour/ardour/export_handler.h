@@ -21,6 +21,7 @@
 #ifndef __ardour_export_handler_h__
 #define __ardour_export_handler_h__
 
+#include <list>
 #include <map>
 
 #include <boost/operators.hpp>
@@ -110,6 +111,12 @@ class LIBARDOUR_API ExportHandler : public ExportElementFactory, public sigc::tr
 	                        BroadcastInfoPtr broadcast_info);
 	void do_export ();
 
+	/** Run the export from the calling thread, one engine buffer at a time
+	 * and as fast as possible, without freewheeling the backend.
+	 * @return 0 once the export has finished, -1 if it failed or was aborted.
+	 */
+	int do_offline_export ();
+
 	std::string get_cd_marker_filename(std::string filename, CDMarkerFormat format);
 
 	/** signal emitted when soundcloud export reports progress updates during upload.
@@ -126,31 +133,48 @@ class LIBARDOUR_API ExportHandler : public ExportElementFactory, public sigc::tr
 
   private:
 
-	void handle_duplicate_format_extensions();
+	/* The timespan and corresponding file specifications that we are exporting;
+	   there can be multiple FileSpecs for each ExportTimespan.
+	*/
+	typedef std::multimap<ExportTimespanPtr, FileSpec> ConfigMap;
+	typedef std::pair<ConfigMap::iterator, ConfigMap::iterator> TimespanBounds;
+
+	void handle_duplicate_format_extensions (TimespanBounds const & timespan_bounds);
 	int process (framecnt_t frames);
 
 	Session &          session;
-	boost::shared_ptr<ExportGraphBuilder> graph_builder;
 	ExportStatusPtr    export_status;
 
-	/* The timespan and corresponding file specifications that we are exporting;
-	   there can be multiple FileSpecs for each ExportTimespan.
-	*/
-	typedef std::multimap<ExportTimespanPtr, FileSpec> ConfigMap;
 	ConfigMap          config_map;
 
 	bool               normalizing;
 
-	/* Timespan management */
+	/* Timespan management
+
+	   Timespans that overlap, or that are closer together than the
+	   export pre-roll, are rendered in a single pass of the transport.
+	   Each timespan has its own graph, which is fed the part of every
+	   cycle that falls within the timespan.
+	*/
+
+	struct TimespanGraph {
+		TimespanGraph (ExportTimespanPtr timespan, boost::shared_ptr<ExportGraphBuilder> graph_builder)
+		  : timespan (timespan), graph_builder (graph_builder) {}
+
+		ExportTimespanPtr                     timespan;
+		boost::shared_ptr<ExportGraphBuilder> graph_builder;
+	};
+
+	typedef std::list<TimespanGraph> TimespanGraphs;
 
 	void start_timespan ();
 	int  process_timespan (framecnt_t frames);
 	int  process_normalize ();
-	void finish_timespan ();
+	void finish_timespan (TimespanGraph const & tg);
 
-	typedef std::pair<ConfigMap::iterator, ConfigMap::iterator> TimespanBounds;
-	ExportTimespanPtr     current_timespan;
-	TimespanBounds        timespan_bounds;
+	TimespanGraphs        rolling;      ///< timespans of this pass that have not ended yet
+	TimespanGraphs        to_normalize; ///< timespans of this pass waiting to be normalized
+	framepos_t            pass_end;
 
 	PBD::ScopedConnection process_connection;
 	framepos_t             process_position;
@@ -82,6 +82,11 @@ public:
 
 	static PBD::Signal2<int,std::string,std::vector<std::string> > AmbiguousFileName;
 
+	/** Make find() fail, rather than emit AmbiguousFileName, when called
+	 *  from the calling thread.
+	 */
+	static void dont_ask_in_this_thread ();
+
 	void existence_check ();
 	virtual void prevent_deletion ();
 
@@ -29,6 +29,7 @@
 #include <boost/shared_ptr.hpp>
 
 #include <glib.h>
+#include <glibmm/threads.h>
 
 #include "pbd/semutils.h"
 
@@ -85,6 +86,33 @@ public:
 
 	bool in_process_thread () const;
 
+	/** Statistics for the work-stealing scheduler (see the
+	 *  graph-work-stealing configuration variable). These are
+	 *  updated by the process threads at the end of each cycle, so
+	 *  a copy taken from another thread is only approximate.
+	 */
+	struct Stats {
+		Stats ()
+			: cycles (0), steals (0), last_steals (0)
+			, idle_usecs (0), last_idle_usecs (0), max_idle_usecs (0) {}
+
+		/** number of cycles run using work stealing */
+		uint64_t cycles;
+		/** nodes run by a thread other than the one that made them ready */
+		uint64_t steals;
+		uint32_t last_steals;
+		/** process thread time during a cycle not spent running nodes,
+		 *  summed over all threads.
+		 */
+		uint64_t idle_usecs;
+		uint32_t last_idle_usecs;
+		uint32_t max_idle_usecs;
+	};
+
+	Stats stats () const { return _stats; }
+	/** reset the statistics at the end of the next cycle */
+	void reset_stats () { g_atomic_int_set (&_reset_stats, 1); }
+
 protected:
 	virtual void session_going_away ();
 
@@ -98,11 +126,45 @@ private:
 
 	node_list_t _init_trigger_list[2];
 
+	/** The nodes of each chain, ordered such that every node comes after
+	 *  all of the nodes that it feeds.
+	 */
+	std::vector<GraphNode*> _sinks_first[2];
+	void update_priorities (int chain);
+	void queue_ready (GraphNode*);
+	static bool lower_priority (node_ptr_t const &, node_ptr_t const &);
+
 	std::vector<GraphNode *> _trigger_queue;
 	pthread_mutex_t          _trigger_mutex;
 
 	PBD::Semaphore _execution_sem;
 
+	/* work-stealing mode: each process thread has its own queue of ready
+	 * nodes; it runs the most recently readied node itself, and idle
+	 * threads take the oldest nodes from the other threads' queues.
+	 * _trigger_queue is then only used if a thread's queue is full.
+	 */
+	struct Worker;
+	std::vector<Worker*> _workers;
+	volatile gint        _n_workers;
+	bool                 _work_stealing;
+	/** number of nodes in _trigger_queue while in work-stealing mode */
+	volatile gint        _overflow_count;
+
+	static Glib::Threads::Private<Worker> _current_worker;
+
+	void setup_worker ();
+	bool run_one_stealing (Worker*);
+	GraphNode* steal (Worker*);
+	void wake_one ();
+
+	Stats         _stats;
+	volatile gint _reset_stats;
+	gint64        _cycle_start;
+	uint64_t      _stats_busy_usecs;
+	uint64_t      _stats_steals;
+	void update_stats ();
+
 	/** Signalled to start a run of the graph for a process callback */
 	PBD::Semaphore _callback_start_sem;
 	PBD::Semaphore _callback_done_sem;
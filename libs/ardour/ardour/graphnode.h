@@ -45,14 +45,20 @@ class LIBARDOUR_API GraphNode
 	virtual ~GraphNode();
 
 	void prep( int chain );
-	void dec_ref();
 	void finish( int chain );
 
 	virtual void process();
 
+	/** @return recent average time taken by process(), in microseconds,
+	 *  when run by the Graph.
+	 */
+	float dsp_cost () const { return _dsp_cost; }
+
     private:
 	friend class Graph;
 
+	void update_dsp_cost (gint64 usecs);
+
 	/** Nodes that we directly feed */
 	node_set_t  _activation_set[2];
 
@@ -61,6 +67,12 @@ class LIBARDOUR_API GraphNode
 	gint _refcount;
 	/** The number of nodes that we directly feed us (one count for each chain) */
 	gint _init_refcount[2];
+
+	float _dsp_cost;
+	/** _dsp_cost plus the largest total cost of any path from us to the
+	 *  end of the graph; nodes with a higher priority are run first.
+	 */
+	float _priority;
 };
 
 }
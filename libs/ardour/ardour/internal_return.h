@@ -49,6 +49,8 @@ class LIBARDOUR_API InternalReturn : public Return
 	std::list<InternalSend*> _sends;
 	/** mutex to protect _sends */
 	Glib::Threads::Mutex _sends_mutex;
+	/** buffers of the active sends, gathered in run(); sized in add_send() */
+	std::vector<BufferSet const *> _merge_sources;
 };
 
 } // namespace ARDOUR
@@ -70,6 +70,7 @@ public:
 	void cleanup () { }
 
 	int set_block_size (pframes_t /*nframes*/) { return 0; }
+	bool sample_accurate_automation () const { return _lua_automation_vectors; }
 	framecnt_t  signal_latency() const { return 0; }
 
 	int connect_and_run (BufferSet& bufs,
@@ -120,6 +121,10 @@ private:
 	std::string _docs;
 	bool _lua_does_channelmapping;
 	bool _lua_has_inline_display;
+	bool _lua_automation_vectors;
+	luabridge::LuaRef * _lua_ctrl_vectors; ///< the CtrlVectors table, if the script uses it
+	std::vector<float const*> _ctrl_vectors;      ///< what _lua_ctrl_vectors holds, by parameter
+	std::vector<float const*> _ctrl_vectors_next; ///< scratch for connect_and_run()
 
 	void queue_draw () { QueueDraw(); /* EMIT SIGNAL */ }
 	DSP::DspShm* instance_shm () { return &lshm; }
@@ -90,6 +90,22 @@ typedef struct {
 #define LV2_AUTOMATE_URI_PREFIX LV2_AUTOMATE_URI "#"
 /** an lv2:optionalFeature */
 #define LV2_AUTOMATE_URI__can_write LV2_AUTOMATE_URI_PREFIX "canWriteAutomatation"
+/** an lv2:optionalFeature, for sample-accurate automation of control
+ * ports without splitting the process cycle.
+ *
+ * A plugin declaring it needs an atom:Sequence input port that
+ * atom:supports auto:automationControl, and marks the control inputs
+ * that it can automate this way with the auto:automationControlled
+ * lv2:portProperty. While any of those is automated, the host runs the
+ * plugin for the whole cycle: the control port holds the value at the
+ * start of the cycle, and each change after that arrives on the atom
+ * input as an auto:event object, time-stamped with the frame from which
+ * it applies, with the port index as auto:parameter (atom:Int) and the
+ * new value as auto:value (atom:Float).
+ *
+ * This is an Ardour extension; libs/plugins/autogain.lv2 is an example.
+ */
+#define LV2_AUTOMATE_URI__can_read LV2_AUTOMATE_URI_PREFIX "canReadAutomation"
 /** atom:supports */
 #define LV2_AUTOMATE_URI__control LV2_AUTOMATE_URI_PREFIX "automationControl"
 /** lv2:portProperty */
@@ -106,6 +106,8 @@ class LIBARDOUR_API LV2Plugin : public ARDOUR::Plugin, public ARDOUR::Workee
 
 	int set_block_size (pframes_t);
 	bool requires_fixed_sized_buffers () const;
+	bool sample_accurate_automation () const;
+	bool prepare_automation_vectors (AutomationVectors const&, pframes_t);
 
 	int connect_and_run (BufferSet& bufs,
 	                     ChanMapping in, ChanMapping out,
@@ -188,9 +190,13 @@ class LIBARDOUR_API LV2Plugin : public ARDOUR::Plugin, public ARDOUR::Workee
 	std::string   _plugin_state_dir;
 	uint32_t      _patch_port_in_index;
 	uint32_t      _patch_port_out_index;
+	uint32_t      _auto_ctrl_port_in_index; ///< atom input that takes auto:event messages
+	uint32_t      _auto_ctrl_atom_buf_index; ///< its buffer in _atom_ev_buffers
+	framecnt_t    _auto_event_grid;         ///< frames between auto:event messages
 	URIMap&       _uri_map;
 	bool          _no_sample_accurate_ctrl;
 	bool          _can_write_automation;
+	bool          _can_read_automation;
 	framecnt_t    _max_latency;
 	framecnt_t    _current_latency;
 
@@ -302,6 +308,10 @@ class LIBARDOUR_API LV2Plugin : public ARDOUR::Plugin, public ARDOUR::Workee
 	void allocate_atom_event_buffers ();
 	void run (pframes_t nsamples);
 
+#ifdef LV2_EXTENDED
+	uint32_t write_automation_events (AutomationVectors const&, pframes_t, LV2_Evbuf*);
+#endif
+
 	void load_supported_properties(PropertyDescriptors& descs);
 
 #ifdef LV2_EXTENDED
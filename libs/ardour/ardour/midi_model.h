@@ -74,6 +74,10 @@ public:
 		virtual int set_state (const XMLNode&, int version) = 0;
 		virtual XMLNode & get_state () = 0;
 
+		size_t memory_size () const {
+			return Command::memory_size () + sizeof (DiffCommand) - sizeof (Command) + _name.capacity ();
+		}
+
 		boost::shared_ptr<MidiModel> model() const { return _model; }
 
 	protected:
@@ -122,6 +126,9 @@ public:
 
 		NoteDiffCommand& operator+= (const NoteDiffCommand& other);
 
+		size_t memory_size () const;
+		void compact ();
+
 		static Variant get_value (const NotePtr note, Property prop);
 
 		static Variant::Type value_type (Property prop);
@@ -173,6 +180,8 @@ public:
 
 		void change (boost::shared_ptr<Evoral::Event<TimeType> >, TimeType);
 
+		size_t memory_size () const;
+
 	private:
 		struct Change {
 			boost::shared_ptr<Evoral::Event<TimeType> > sysex;
@@ -209,6 +218,8 @@ public:
 		void change_program (PatchChangePtr, uint8_t);
 		void change_bank (PatchChangePtr, int);
 
+		size_t memory_size () const;
+
 		enum Property {
 			Time,
 			Channel,
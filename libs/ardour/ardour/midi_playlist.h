@@ -30,6 +30,7 @@
 #include "ardour/midi_state_tracker.h"
 #include "ardour/note_fixer.h"
 #include "ardour/playlist.h"
+#include "evoral/EventSink.hpp"
 #include "evoral/Note.hpp"
 #include "evoral/Parameter.hpp"
 
@@ -109,6 +110,7 @@ public:
 	void resolve_note_trackers (Evoral::EventSink<framepos_t>& dst, framepos_t time);
 
 protected:
+	void region_added (boost::shared_ptr<Region> region);
 	void remove_dependents (boost::shared_ptr<Region> region);
 
 private:
@@ -116,17 +118,71 @@ private:
 	typedef Evoral::Event<framepos_t>   Event;
 
 	struct RegionTracker : public boost::noncopyable {
+		RegionTracker () : active (false) {}
+
+		void reset () {
+			tracker.reset ();
+			fixer.clear ();
+			active = false;
+		}
+
 		MidiStateTracker tracker;  ///< Active note tracker
 		NoteFixer        fixer;    ///< Edit compensation
+		bool             active;   ///< true if the region was read into by the last read
 	};
 
+	/** One tracker per region in the playlist, created when the region is
+	 *  added so that read() never has to.
+	 */
 	typedef std::map< Region*, boost::shared_ptr<RegionTracker> > NoteTrackers;
 
+	/** The events read from one region during read(), in the order the
+	 *  region produced them.  The storage is kept between reads, so once it
+	 *  has grown to fit the busiest block nothing in here allocates.
+	 */
+	class ReadStream : public Evoral::EventSink<framepos_t> {
+	public:
+		ReadStream () : next (0), sorted (true) {}
+
+		uint32_t write (framepos_t time, Evoral::EventType type, uint32_t size, const uint8_t* buf);
+
+		void clear ();
+		void sort ();
+
+		bool done () const { return next == events.size(); }
+
+		struct Entry {
+			framepos_t        time;
+			Evoral::EventType type;
+			uint32_t          offset; ///< into data
+			uint32_t          size;
+		};
+
+		/** @return true if event a (of stream sa) must be played before b (of sb) */
+		static bool before (ReadStream const & sa, Entry const & a, ReadStream const & sb, Entry const & b);
+
+		std::vector<Entry>   events;
+		std::vector<uint8_t> data;
+		size_t               next;   ///< the first event not yet merged
+		bool                 sorted; ///< false if an event was written out of order
+	};
+
 	void dump () const;
 
-	NoteTrackers _note_trackers;
-	NoteMode     _note_mode;
-	framepos_t   _read_end;
+	void add_tracker (Region*);
+
+	NoteTrackers                             _note_trackers;
+	NoteMode                                 _note_mode;
+	framepos_t                               _read_end;
+	std::vector<boost::shared_ptr<Region> >  _read_regions; ///< scratch for read()
+	std::vector<ReadStream>                  _read_streams; ///< scratch for read()
+
+	/** Held by read().  Tracks sharing this playlist may be refilled by
+	 *  different butler threads at once, and the region read lock they
+	 *  take is shared, so this serializes their use of the trackers and
+	 *  the scratch above.
+	 */
+	Glib::Threads::Mutex                     _read_mutex;
 };
 
 } /* namespace ARDOUR */
@@ -24,6 +24,7 @@
 #include <set>
 #include <map>
 #include <list>
+#include <vector>
 #include <boost/shared_ptr.hpp>
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/utility.hpp>
@@ -42,6 +43,7 @@
 
 #include "ardour/ardour.h"
 #include "ardour/region.h"
+#include "ardour/region_index.h"
 #include "ardour/session_object.h"
 #include "ardour/data_type.h"
 
@@ -171,6 +173,15 @@ public:
 	boost::shared_ptr<RegionList> regions_touched (framepos_t start, framepos_t end);
 	boost::shared_ptr<RegionList> regions_with_start_within (Evoral::Range<framepos_t>);
 	boost::shared_ptr<RegionList> regions_with_end_within (Evoral::Range<framepos_t>);
+
+	/* as above, but appending (in position order) to a caller-owned
+	 * vector, which can be reused to avoid allocating on every query.
+	 */
+	void regions_at (framepos_t frame, std::vector<boost::shared_ptr<Region> >&);
+	void regions_touched (framepos_t start, framepos_t end, std::vector<boost::shared_ptr<Region> >&);
+	void regions_with_start_within (Evoral::Range<framepos_t>, std::vector<boost::shared_ptr<Region> >&);
+	void regions_with_end_within (Evoral::Range<framepos_t>, std::vector<boost::shared_ptr<Region> >&);
+
 	uint32_t                   region_use_count (boost::shared_ptr<Region>) const;
 	boost::shared_ptr<Region>  find_region (const PBD::ID&) const;
 	boost::shared_ptr<Region>  top_region_at (framepos_t frame);
@@ -186,6 +197,12 @@ public:
 
 	void foreach_region (boost::function<void (boost::shared_ptr<Region>)>);
 
+	/** @return a counter that is incremented whenever a change is made that
+	 *  might alter what this playlist reads back: regions being added, removed,
+	 *  moved or relayered, or any property of one of them changing.
+	 */
+	gint contents_generation () const { return g_atomic_int_get (&_contents_generation); }
+
 	XMLNode& get_state ();
 	virtual int set_state (const XMLNode&, int version);
 	XMLNode& get_template ();
@@ -257,12 +274,14 @@ public:
                     : Glib::Threads::RWLock::WriterLock (pl->region_lock)
                     , playlist (pl)
                     , block_notify (do_block_notify) {
+                    g_atomic_pointer_set (&playlist->_region_lock_writer, Glib::Threads::Thread::self ());
                     if (block_notify) {
                             playlist->delay_notifications();
                     }
             }
 
         ~RegionWriteLock() {
+                g_atomic_pointer_set (&playlist->_region_lock_writer, 0);
                 Glib::Threads::RWLock::WriterLock::release ();
                 if (block_notify) {
                         playlist->release_notifications ();
@@ -274,11 +293,13 @@ public:
 
 	RegionListProperty   regions;  /* the current list of regions in the playlist */
 	std::set<boost::shared_ptr<Region> > all_regions; /* all regions ever added to this playlist */
+	RegionIndex      region_index; /* interval index over `regions', protected by region_lock */
 	PBD::ScopedConnectionList region_state_changed_connections;
 	DataType        _type;
 	int             _sort_id;
 	mutable gint    block_notifications;
 	mutable gint    ignore_state_changes;
+	mutable gint   _contents_generation;
 	std::set<boost::shared_ptr<Region> > pending_adds;
 	std::set<boost::shared_ptr<Region> > pending_removes;
 	RegionList       pending_bounds;
@@ -324,7 +345,9 @@ public:
 
 	void _set_sort_id ();
 
-	boost::shared_ptr<RegionList> regions_touched_locked (framepos_t start, framepos_t end);
+	void regions_touched_locked (framepos_t start, framepos_t end, std::vector<boost::shared_ptr<Region> >&) const;
+
+	void bump_contents_generation () { g_atomic_int_inc (&_contents_generation); }
 
 	void notify_region_removed (boost::shared_ptr<Region>);
 	void notify_region_added (boost::shared_ptr<Region>);
@@ -357,6 +380,8 @@ public:
 	void ripple_unlocked (framepos_t at, framecnt_t distance, RegionList *exclude);
 
 
+	/** Called (with the region lock held) when a region has been added to this playlist */
+	virtual void region_added (boost::shared_ptr<Region> /*region*/) {}
 	virtual void remove_dependents (boost::shared_ptr<Region> /*region*/) {}
 
 	virtual XMLNode& state (bool);
@@ -396,6 +421,15 @@ public:
 	friend class RegionReadLock;
 	friend class RegionWriteLock;
 	mutable Glib::Threads::RWLock region_lock;
+	/** the thread holding region_lock for writing, if any; regions change
+	 *  (and so call region_bounds_changed()) both from inside locked
+	 *  playlist operations and from outside them.
+	 */
+	Glib::Threads::Thread* _region_lock_writer;
+
+	bool region_lock_held_for_writing () const {
+		return g_atomic_pointer_get (&_region_lock_writer) == Glib::Threads::Thread::self ();
+	}
 
   private:
 	void setup_layering_indices (RegionList const &);
@@ -96,6 +96,28 @@ class LIBARDOUR_API Plugin : public PBD::StatefulDestructible, public Latent
 	virtual bool requires_fixed_sized_buffers() const { return false; }
 	virtual bool inplace_broken() const { return false; }
 
+	/** The values of an automated control port for every frame of a
+	 *  process cycle.
+	 */
+	struct LIBARDOUR_API AutomationVector {
+		uint32_t     port;
+		float const* values;
+	};
+	typedef std::vector<AutomationVector> AutomationVectors;
+
+	/** @return true if the plugin applies automation vectors (see
+	 *  _automation_vectors) itself. The PluginInsert will then run it for
+	 *  the whole process cycle rather than splitting the cycle at
+	 *  automation events.
+	 */
+	virtual bool sample_accurate_automation () const { return false; }
+
+	/** Called with the automation vectors for the next connect_and_run().
+	 *  @return false if the plugin cannot apply them after all; the cycle
+	 *  is then split at automation events instead.
+	 */
+	virtual bool prepare_automation_vectors (AutomationVectors const&, pframes_t) { return true; }
+
 	virtual int connect_and_run (BufferSet& bufs,
 				     ChanMapping in, ChanMapping out,
 				     pframes_t nframes, framecnt_t offset);
@@ -332,6 +354,12 @@ protected:
 	ARDOUR::Session&         _session;
 	PluginInfoPtr            _info;
 	uint32_t                 _cycles;
+
+	/** Automation for the current connect_and_run(), if any; only set for
+	 *  plugins that return true from sample_accurate_automation().
+	 *  Control ports hold the values at the start of the cycle.
+	 */
+	AutomationVectors const* _automation_vectors;
 	std::map<std::string, PresetRecord> _presets;
 
 private:
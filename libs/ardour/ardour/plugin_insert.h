@@ -30,6 +30,7 @@
 #include "ardour/chan_mapping.h"
 #include "ardour/fixed_delay.h"
 #include "ardour/io.h"
+#include "ardour/plugin.h"
 #include "ardour/types.h"
 #include "ardour/parameter_descriptor.h"
 #include "ardour/processor.h"
@@ -162,6 +163,16 @@ class LIBARDOUR_API PluginInsert : public Processor
 	void realtime_locate ();
 	void monitoring_changed ();
 
+	/** Statistics on how automation playback has split process cycles
+	 *  into several plugin runs, since the last clear_automation_stats().
+	 *  @param cycles number of cycles run with automation playback
+	 *  @param runs total number of plugin runs in those cycles
+	 *  @param max_runs largest number of runs in a single cycle
+	 *  @return false if there have been no such cycles
+	 */
+	bool get_automation_stats (uint64_t& cycles, uint64_t& runs, uint32_t& max_runs) const;
+	void clear_automation_stats ();
+
 	/** A control that manipulates a plugin parameter (control port). */
 	struct PluginControl : public AutomationControl
 	{
@@ -327,6 +338,22 @@ class LIBARDOUR_API PluginInsert : public Processor
 	void automation_run (BufferSet& bufs, framepos_t start, pframes_t nframes);
 	void connect_and_run (BufferSet& bufs, pframes_t nframes, framecnt_t offset, bool with_auto, framepos_t now = 0);
 
+	void allocate_automation_vectors (pframes_t nframes);
+	bool fill_automation_vectors (framepos_t start, pframes_t nframes);
+	void update_automation_stats (uint32_t runs);
+
+	/** storage for one cycle of every automated plugin parameter, for
+	 *  plugins that take sample-accurate automation.
+	 */
+	std::vector<float>        _automation_data;
+	pframes_t                 _automation_data_nframes;
+	Plugin::AutomationVectors _automation_vectors;
+
+	uint64_t _automation_stat_cycles;
+	uint64_t _automation_stat_runs;
+	uint32_t _automation_stat_max_runs;
+	gint     _automation_stat_reset;
+
 	void create_automatable_parameters ();
 	void control_list_automation_state_changed (Evoral::Parameter, AutoState);
 	void set_parameter_state_2X (const XMLNode& node, int version);
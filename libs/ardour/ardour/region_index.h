@@ -0,0 +1,159 @@
+/*
+    Copyright (C) 2016 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#ifndef __ardour_region_index_h__
+#define __ardour_region_index_h__
+
+#include <map>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/types.h"
+
+namespace ARDOUR {
+
+class Region;
+
+/** An interval tree over a set of regions, keyed on each region's first and
+ *  last frame.  Playlists keep one of these alongside their region list so
+ *  that "which regions touch this range" style queries cost O(log n + k)
+ *  rather than a walk over every region.
+ *
+ *  The bounds of each region are copied into the index when it is added or
+ *  updated, so whoever owns the index must call update() whenever a region
+ *  changes position or length.
+ *
+ *  Regions at equal positions are kept in the order in which they were
+ *  (last) added or updated, which matches the upper_bound() insertion used
+ *  for the playlist's region list.
+ *
+ *  None of the query methods allocate, apart from whatever the caller's
+ *  result vector needs to grow to.  Results are appended, in ascending
+ *  position order.
+ */
+class LIBARDOUR_API RegionIndex : public boost::noncopyable
+{
+  public:
+	RegionIndex ();
+	~RegionIndex ();
+
+	void add (boost::shared_ptr<Region>);
+	void remove (boost::shared_ptr<Region>);
+	/** re-read the bounds of a region; does nothing if it is not in the index */
+	void update (boost::shared_ptr<Region>);
+	void clear ();
+
+	size_t size () const { return _nodes.size(); }
+	bool empty () const { return _nodes.empty(); }
+
+	/** regions with some part within [start, end] */
+	void regions_touched (framepos_t start, framepos_t end, std::vector<boost::shared_ptr<Region> >&) const;
+	/** regions that cover frame */
+	void regions_at (framepos_t frame, std::vector<boost::shared_ptr<Region> >&) const;
+	uint32_t count_regions_at (framepos_t frame) const;
+	/** regions whose first frame lies within [start, end] */
+	void regions_with_start_within (framepos_t start, framepos_t end, std::vector<boost::shared_ptr<Region> >&) const;
+	/** regions whose last frame lies within [start, end] */
+	void regions_with_end_within (framepos_t start, framepos_t end, std::vector<boost::shared_ptr<Region> >&) const;
+
+	/** @return the first region (in position order) that starts after frame */
+	boost::shared_ptr<Region> first_starting_after (framepos_t frame) const;
+	/** @return the first region (in position order) of those that start
+	 *  closest to, but before, frame.
+	 */
+	boost::shared_ptr<Region> last_starting_before (framepos_t frame) const;
+	/** @return the region whose last frame is closest to, but after, frame;
+	 *  of several such regions, the first in position order.
+	 */
+	boost::shared_ptr<Region> first_ending_after (framepos_t frame) const;
+
+	/** Call f (boost::shared_ptr<Region> const &) for every region with some
+	 *  part within [start, end], in ascending position order.
+	 */
+	template<typename F> void foreach_touched (framepos_t start, framepos_t end, F& f) const {
+		if (start <= end) {
+			foreach_touched (_root, start, end, f);
+		}
+	}
+
+  private:
+	struct Node;
+
+	/** every node keyed by its end, since the tree (ordered by start) cannot
+	 *  find the nearest end after a position without visiting every region
+	 *  that spans it.
+	 */
+	typedef std::multimap<framepos_t, Node*> EndMap;
+
+	struct Node {
+		Node (boost::shared_ptr<Region> const &, uint64_t);
+
+		boost::shared_ptr<Region> region;
+		framepos_t start;   ///< region's first frame when last indexed
+		framepos_t end;     ///< region's last frame when last indexed
+		framepos_t max_end; ///< largest end in this subtree
+		uint64_t   seq;     ///< tie-break for equal starts
+		int        height;
+		Node*      left;
+		Node*      right;
+		EndMap::iterator end_pos; ///< this node's entry in _ends
+
+		void set_bounds ();
+	};
+
+	typedef std::map<Region const *, Node*> NodeMap;
+
+	Node*    _root;
+	NodeMap  _nodes;
+	EndMap   _ends;
+	uint64_t _next_seq;
+
+	template<typename F> static void foreach_touched (Node const * n, framepos_t start, framepos_t end, F& f) {
+		if (!n || n->max_end < start) {
+			return;
+		}
+		foreach_touched (n->left, start, end, f);
+		if (n->start > end) {
+			return;
+		}
+		/* zero-length regions (end < start) never touch anything */
+		if (n->end >= start && n->end >= n->start) {
+			f (n->region);
+		}
+		foreach_touched (n->right, start, end, f);
+	}
+
+	static Node* insert (Node*, Node*);
+	static Node* remove (Node*, Node*);
+	static Node* remove_min (Node*, Node*&);
+	static Node* balance (Node*);
+	static Node* rotate_left (Node*);
+	static Node* rotate_right (Node*);
+	static void  recompute (Node*);
+	static bool  before (Node const *, Node const *);
+	static void  destroy (Node*);
+
+	static void  start_within (Node const *, framepos_t, framepos_t, std::vector<boost::shared_ptr<Region> >&);
+};
+
+} /* namespace ARDOUR */
+
+#endif /* __ardour_region_index_h__ */
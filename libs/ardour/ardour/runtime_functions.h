@@ -31,6 +31,15 @@ namespace ARDOUR {
 	typedef void  (*mix_buffers_with_gain_t)	(ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t, float);
 	typedef void  (*mix_buffers_no_gain_t)		(ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t);
 	typedef void  (*copy_vector_t)			    (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t);
+	/** apply a gain that moves from initial towards target by coeff * (target - gain)
+	 *  every sample; returns the gain that would apply to the sample after the last one
+	 */
+	typedef float (*apply_gain_ramp_t)          (ARDOUR::Sample *, pframes_t, float initial, float target, float coeff);
+	/** copy nframes of one channel out of (deinterleave) or into (interleave)
+	 *  a buffer of n_channels interleaved channels
+	 */
+	typedef void  (*deinterleave_t)             (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pframes_t, uint32_t channel, uint32_t n_channels);
+	typedef void  (*interleave_t)               (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pframes_t, uint32_t channel, uint32_t n_channels);
 
 	LIBARDOUR_API extern compute_peak_t		compute_peak;
 	LIBARDOUR_API extern find_peaks_t               find_peaks;
@@ -38,6 +47,9 @@ namespace ARDOUR {
 	LIBARDOUR_API extern mix_buffers_with_gain_t	mix_buffers_with_gain;
 	LIBARDOUR_API extern mix_buffers_no_gain_t	mix_buffers_no_gain;
 	LIBARDOUR_API extern copy_vector_t			copy_vector;
+	LIBARDOUR_API extern apply_gain_ramp_t          apply_gain_ramp;
+	LIBARDOUR_API extern deinterleave_t             deinterleave;
+	LIBARDOUR_API extern interleave_t               interleave;
 }
 
 #endif /* __ardour_runtime_functions_h__ */
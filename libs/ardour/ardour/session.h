@@ -493,6 +493,15 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 	 * @return zero on success
 	 */
 	int save_state (std::string snapshot_name, bool pending = false, bool switch_to_snapshot = false, bool template_only = false);
+	/** Capture the session state like save_state() does, but format and write it
+	 * on a background thread. A save that is still queued when another one is
+	 * requested for the same file is replaced by it. Write errors are reported
+	 * once the write has happened, and leave the session dirty.
+	 * @return zero if the state was captured
+	 */
+	int save_state_in_background (std::string snapshot_name, bool pending = false, bool switch_to_snapshot = false);
+	/** Wait until all background saves have been written */
+	void wait_for_background_save ();
 	int restore_state (std::string snapshot_name);
 	int save_template (std::string template_name, bool replace_existing = false);
 	int save_history (std::string snapshot_name = "");
@@ -508,6 +517,12 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 	PBD::Signal1<void,std::string> StateSaved;
 	PBD::Signal0<void> StateReady;
 
+	/* emitted after each save with the snapshot name, the time in microseconds
+	 * spent capturing state in the calling thread, and the total time until
+	 * the state was written. May be emitted from the background save thread.
+	 */
+	PBD::Signal3<void,std::string,int64_t,int64_t> StateSaveTimed;
+
 	/* emitted when session needs to be saved due to some internal
 	 * event or condition (i.e. not in response to a user request).
 	 *
@@ -871,6 +886,7 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 	UndoHistory& history() { return _history; }
 
 	uint32_t undo_depth() const { return _history.undo_depth(); }
+	size_t history_memory_size() const { return _history.memory_size(); }
 	uint32_t redo_depth() const { return _history.redo_depth(); }
 	std::string next_undo() const { return _history.next_undo(); }
 	std::string next_redo() const { return _history.next_redo(); }
@@ -1061,6 +1077,11 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 	*/
 	static PBD::Signal0<void> SuccessfulGraphSort;
 
+	/** @return the graph used to run routes in parallel, or 0 if
+	    routes are run by the main process thread only.
+	*/
+	boost::shared_ptr<Graph> process_graph () const { return _process_graph; }
+
 	/* handlers can return an integer value:
 	   0: config.set_audio_search_path() or config.set_midi_search_path() was used
 	   to modify the search path and we should try to find it again.
@@ -1326,6 +1347,21 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 	gint            _suspend_save; /* atomic */
 	volatile bool   _save_queued;
 	Glib::Threads::Mutex save_state_lock;
+
+	struct SaveJob;
+	Glib::Threads::Thread* _save_thread;
+	Glib::Threads::Mutex   _save_queue_lock;
+	Glib::Threads::Cond    _save_queue_cond;
+	std::list<SaveJob*>    _save_queue;
+	bool                   _save_in_flight;
+	bool                   _save_thread_quit;
+
+	int  save_state_internal (std::string snapshot_name, bool pending, bool switch_to_snapshot, bool template_only, bool background);
+	int  write_state (SaveJob&);
+	int  write_history (std::string const & snapshot_name, XMLNode* history);
+	void finish_save (SaveJob&, int result);
+	void save_thread ();
+	void stop_save_thread ();
 	Glib::Threads::Mutex peak_cleanup_lock;
 
 	int      load_options (const XMLNode&);
@@ -1844,6 +1880,7 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 	XMLNode& get_control_protocol_state ();
 
 	void set_history_depth (uint32_t depth);
+	void set_history_memory_limit (uint32_t megabytes);
 
 	static bool _disable_all_loaded_plugins;
 	static bool _bypass_all_loaded_plugins;
@@ -22,6 +22,8 @@
 
 #include <sndfile.h>
 
+#include <boost/shared_ptr.hpp>
+
 #include "ardour/audiofilesource.h"
 #include "ardour/broadcast_info.h"
 
@@ -90,6 +92,12 @@ class LIBARDOUR_API SndFileSource : public AudioFileSource {
 	SF_INFO _info;
 	BroadcastInfo *_broadcast_info;
 
+	/* decodes and caches blocks of an interleaved multichannel file on
+	 * behalf of every (read-only) SndFileSource that uses the same file.
+	 */
+	class SharedReader;
+	boost::shared_ptr<SharedReader> _shared_reader;
+
 	void init_sndfile ();
 	int open();
 	int setup_broadcast_info (framepos_t when, struct tm&, time_t);
@@ -42,7 +42,7 @@ class LIBARDOUR_API SourceFactory {
 
 	static PBD::Signal1<void,boost::shared_ptr<Source> > SourceCreated;
 
-	static boost::shared_ptr<Source> create (Session&, const XMLNode& node, bool async = false);
+	static boost::shared_ptr<Source> create (Session&, const XMLNode& node, bool async = false, bool announce = true);
 	static boost::shared_ptr<Source> createSilent (Session&, const XMLNode& node,
 	                                               framecnt_t nframes, float sample_rate);
 
@@ -64,12 +64,15 @@ class LIBARDOUR_API SourceFactory {
 		(DataType type, Session& s, boost::shared_ptr<Playlist> p, const PBD::ID& orig, const std::string& name,
 		 uint32_t chn, frameoffset_t start, framecnt_t len, bool copy, bool defer_peaks);
 
-        static Glib::Threads::Cond                       PeaksToBuild;
-        static Glib::Threads::Mutex                      peak_building_lock;
-	static std::list< boost::weak_ptr<AudioSource> > files_with_peaks;
-
+	/** @return the number of sources waiting for or having their peaks built */
 	static int peak_work_queue_length ();
 	static int setup_peakfile (boost::shared_ptr<Source>, bool async);
+
+	/** Have the peaks for @param sources built, in that order, before those
+	 *  of any other sources that are waiting for them (e.g. because they have
+	 *  just come into view). Sources that are not waiting are ignored.
+	 */
+	static void prioritize_peakfiles (SourceList const & sources);
 };
 
 }
@@ -66,6 +66,28 @@ using namespace PBD;
 Sample* AudioDiskstream::_mixdown_buffer       = 0;
 gain_t* AudioDiskstream::_gain_buffer          = 0;
 
+namespace {
+
+struct RefillWorkingBuffers {
+	Sample* mixdown_buffer;
+	gain_t* gain_buffer;
+
+	RefillWorkingBuffers () {
+		/* see AudioDiskstream::allocate_working_buffers() for the size */
+		mixdown_buffer = new Sample[2*1048576];
+		gain_buffer    = new gain_t[2*1048576];
+	}
+
+	~RefillWorkingBuffers () {
+		delete [] mixdown_buffer;
+		delete [] gain_buffer;
+	}
+};
+
+Glib::Threads::Private<RefillWorkingBuffers> thread_refill_buffers;
+
+}
+
 AudioDiskstream::AudioDiskstream (Session &sess, const string &name, Diskstream::Flag flag)
 	: Diskstream(sess, name, flag)
 	, channels (new ChannelList)
@@ -142,6 +164,14 @@ AudioDiskstream::allocate_working_buffers()
 	_gain_buffer          = new gain_t[2*1048576];
 }
 
+void
+AudioDiskstream::allocate_thread_working_buffers ()
+{
+	if (thread_refill_buffers.get() == 0) {
+		thread_refill_buffers.set (new RefillWorkingBuffers);
+	}
+}
+
 void
 AudioDiskstream::free_working_buffers()
 {
@@ -1077,6 +1107,18 @@ AudioDiskstream::read (Sample* buf, Sample* mixdown_buffer, float* gain_buffer,
 	return 0;
 }
 
+int
+AudioDiskstream::do_refill ()
+{
+	RefillWorkingBuffers* wb = thread_refill_buffers.get ();
+
+	if (wb) {
+		return _do_refill (wb->mixdown_buffer, wb->gain_buffer, 0);
+	}
+
+	return _do_refill (_mixdown_buffer, _gain_buffer, 0);
+}
+
 int
 AudioDiskstream::_do_refill_with_alloc (bool partial_fill)
 {
@@ -20,6 +20,10 @@
 #include <algorithm>
 
 #include <cstdlib>
+#include <cstring>
+#include <map>
+
+#include <glibmm/threads.h>
 
 #include "ardour/types.h"
 #include "ardour/debug.h"
@@ -140,7 +144,7 @@ AudioPlaylist::AudioPlaylist (boost::shared_ptr<const AudioPlaylist> other, fram
 
 /** Sort by descending layer and then by ascending position */
 struct ReadSorter {
-    bool operator() (boost::shared_ptr<Region> a, boost::shared_ptr<Region> b) {
+    bool operator() (boost::shared_ptr<Region> const & a, boost::shared_ptr<Region> const & b) {
 	    if (a->layer() != b->layer()) {
 		    return a->layer() > b->layer();
 	    }
@@ -149,13 +153,175 @@ struct ReadSorter {
     }
 };
 
-/** A segment of region that needs to be read */
-struct Segment {
-	Segment (boost::shared_ptr<AudioRegion> r, Evoral::Range<framepos_t> a) : region (r), range (a) {}
+/** Segment indices for the current read; one per reading thread, reused so
+ *  that reads do not allocate.
+ */
+static Glib::Threads::Private<vector<uint32_t> > thread_read_segments;
+
+namespace {
 
-	boost::shared_ptr<AudioRegion> region; ///< the region
-	Evoral::Range<framepos_t> range;       ///< range of the region to read, in session frames
-};
+typedef map<framepos_t, framepos_t> RangeMap;
+
+/** Add [from, to] to a set of disjoint, non-adjacent ranges keyed by their start */
+void
+add_range (RangeMap& ranges, framepos_t from, framepos_t to)
+{
+	RangeMap::iterator i = ranges.upper_bound (from);
+
+	if (i != ranges.begin ()) {
+		RangeMap::iterator p = i;
+		--p;
+		if (p->second + 1 >= from) {
+			from = p->first;
+			to = max (to, p->second);
+			i = p;
+		}
+	}
+
+	while (i != ranges.end () && i->first <= to + 1) {
+		to = max (to, i->second);
+		ranges.erase (i++);
+	}
+
+	ranges[from] = to;
+}
+
+bool
+range_ends_before (Evoral::Range<framepos_t> const & r, framepos_t pos)
+{
+	return r.to < pos;
+}
+
+}
+
+/** Work out the read plan for the whole playlist; called with the region lock held.
+ *
+ *  Regions are considered by descending layer and then ascending position.
+ *  Each one is read wherever it has not been completely covered by the body
+ *  of an opaque region above it, and the reads are done from the bottom up
+ *  so that fades can mix with whatever lies underneath.
+ */
+void
+AudioPlaylist::build_read_plan (ReadPlan& plan)
+{
+	vector<boost::shared_ptr<Region> > all (regions.begin(), regions.end());
+	stable_sort (all.begin(), all.end(), ReadSorter ());
+
+	/* the parts of the timeline for which no more regions need to be read */
+	RangeMap done;
+	vector<Evoral::Range<framepos_t> > parts;
+
+	for (vector<boost::shared_ptr<Region> >::iterator i = all.begin(); i != all.end(); ++i) {
+		boost::shared_ptr<AudioRegion> ar = boost::dynamic_pointer_cast<AudioRegion> (*i);
+
+		/* muted regions don't figure into it at all */
+		if (!ar || ar->muted ()) {
+			continue;
+		}
+
+		framepos_t const first = ar->first_frame ();
+		framepos_t const last = ar->last_frame ();
+
+		if (last < first) {
+			continue;
+		}
+
+		/* Work out which bits of this region are not done yet */
+
+		parts.clear ();
+
+		RangeMap::iterator d = done.upper_bound (first);
+
+		if (d != done.begin ()) {
+			RangeMap::iterator p = d;
+			--p;
+			if (p->second >= first) {
+				d = p;
+			}
+		}
+
+		framepos_t pos = first;
+
+		for (; pos <= last && d != done.end () && d->first <= last; ++d) {
+			if (d->first > pos) {
+				parts.push_back (Evoral::Range<framepos_t> (pos, d->first - 1));
+			}
+			pos = max (pos, d->second + 1);
+		}
+
+		if (pos <= last) {
+			parts.push_back (Evoral::Range<framepos_t> (pos, last));
+		}
+
+		/* Make a note to read those bits, adding their bodies (the parts
+		   between end-of-fade-in and start-of-fade-out) to the `done' list.
+		*/
+
+		Evoral::Range<framepos_t> const body = ar->body_range ();
+
+		for (vector<Evoral::Range<framepos_t> >::const_iterator j = parts.begin(); j != parts.end(); ++j) {
+			ReadPlan::Segment s;
+
+			s.region = ar.get ();
+			s.from = j->from;
+			s.to = j->to;
+			s.copy_from = 0;
+			s.copy_to = -1;
+
+			if (ar->opaque () && body.from < j->to && body.to > j->from) {
+				s.copy_from = max (j->from, body.from);
+				s.copy_to = min (j->to, body.to);
+				/* overlapping fades leave no body at all */
+				if (s.copy_from <= s.copy_to) {
+					add_range (done, s.copy_from, s.copy_to);
+				}
+			}
+
+			plan.segments.push_back (s);
+		}
+	}
+
+	/* we read from the bottom up */
+	reverse (plan.segments.begin(), plan.segments.end());
+
+	plan.by_from.reserve (plan.segments.size());
+	for (uint32_t n = 0; n < plan.segments.size(); ++n) {
+		plan.by_from.push_back (n);
+	}
+	stable_sort (plan.by_from.begin(), plan.by_from.end(), ReadPlan::FromBefore (plan.segments));
+
+	plan.max_to.reserve (plan.by_from.size());
+	for (vector<uint32_t>::const_iterator n = plan.by_from.begin(); n != plan.by_from.end(); ++n) {
+		framepos_t const to = plan.segments[*n].to;
+		plan.max_to.push_back (plan.max_to.empty() ? to : max (plan.max_to.back(), to));
+	}
+
+	plan.copied.reserve (done.size());
+	for (RangeMap::const_iterator r = done.begin(); r != done.end(); ++r) {
+		plan.copied.push_back (Evoral::Range<framepos_t> (r->first, r->second));
+	}
+}
+
+/** @return the read plan for our current contents; called with the region lock held */
+boost::shared_ptr<AudioPlaylist::ReadPlan>
+AudioPlaylist::read_plan ()
+{
+	Glib::Threads::Mutex::Lock lm (_read_plan_lock);
+
+	gint const generation = contents_generation ();
+
+	if (!_read_plan || _read_plan->generation != generation) {
+		boost::shared_ptr<ReadPlan> plan (new ReadPlan);
+		plan->generation = generation;
+		build_read_plan (*plan);
+		_read_plan = plan;
+
+		DEBUG_TRACE (DEBUG::AudioPlayback, string_compose ("Playlist %1 new read plan with %2 segments over %3 regions\n",
+		                                                   name(), plan->segments.size(), regions.size()));
+	}
+
+	return _read_plan;
+}
 
 /** @param start Start position in session frames.
  *  @param cnt Number of frames to read.
@@ -167,20 +333,9 @@ AudioPlaylist::read (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, fr
 	DEBUG_TRACE (DEBUG::AudioPlayback, string_compose ("Playlist %1 read @ %2 for %3, channel %4, regions %5 mixdown @ %6 gain @ %7\n",
 							   name(), start, cnt, chan_n, regions.size(), mixdown_buffer, gain_buffer));
 
-	/* optimizing this memset() away involves a lot of conditionals
-	   that may well cause more of a hit due to cache misses
-	   and related stuff than just doing this here.
-
-	   it would be great if someone could measure this
-	   at some point.
-
-	   one way or another, parts of the requested area
-	   that are not written to by Region::region_at()
-	   for all Regions that cover the area need to be
-	   zeroed.
-	*/
-
-	memset (buf, 0, sizeof (Sample) * cnt);
+	if (cnt <= 0) {
+		return 0;
+	}
 
 	/* this function is never called from a realtime thread, so
 	   its OK to block (for short intervals).
@@ -188,69 +343,79 @@ AudioPlaylist::read (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, fr
 
 	Playlist::RegionReadLock rl (this);
 
-	/* Find all the regions that are involved in the bit we are reading,
-	   and sort them by descending layer and ascending position.
+	/* The plan is only rebuilt when our contents have changed, so all
+	   that is left to do here is to pick out the segments that touch the
+	   range we are reading.
 	*/
-	boost::shared_ptr<RegionList> all = regions_touched_locked (start, start + cnt - 1);
-	all->sort (ReadSorter ());
 
-	/* This will be a list of the bits of our read range that we have
-	   handled completely (ie for which no more regions need to be read).
-	   It is a list of ranges in session frames.
-	*/
-	Evoral::RangeList<framepos_t> done;
+	boost::shared_ptr<ReadPlan> plan = read_plan ();
+	framepos_t const end = start + cnt - 1;
 
-	/* This will be a list of the bits of regions that we need to read */
-	list<Segment> to_do;
+	/* Silence the parts of the buffer that are not going to be completely
+	   overwritten by the body of some opaque region; everything else is
+	   going to be mixed into what is there.
+	*/
 
-	/* Now go through the `all' list filling in `to_do' and `done' */
-	for (RegionList::iterator i = all->begin(); i != all->end(); ++i) {
-		boost::shared_ptr<AudioRegion> ar = boost::dynamic_pointer_cast<AudioRegion> (*i);
+	framepos_t pos = start;
 
-		/* muted regions don't figure into it at all */
-		if ( ar->muted() )
-			continue;
+	for (vector<Evoral::Range<framepos_t> >::const_iterator c = lower_bound (plan->copied.begin(), plan->copied.end(), start, range_ends_before);
+	     c != plan->copied.end() && c->from <= end; ++c) {
+		if (c->from > pos) {
+			memset (buf + (pos - start), 0, sizeof (Sample) * (c->from - pos));
+		}
+		pos = c->to + 1;
+	}
 
-		/* Work out which bits of this region need to be read;
-		   first, trim to the range we are reading...
-		*/
-		Evoral::Range<framepos_t> region_range = ar->range ();
-		region_range.from = max (region_range.from, start);
-		region_range.to = min (region_range.to, start + cnt - 1);
+	if (pos <= end) {
+		memset (buf + (pos - start), 0, sizeof (Sample) * (end - pos + 1));
+	}
 
-		/* ... and then remove the bits that are already done */
+	/* Find the segments that touch [start, end] ... */
 
-		Evoral::RangeList<framepos_t> region_to_do = Evoral::subtract (region_range, done);
+	vector<uint32_t>* todo = thread_read_segments.get ();
 
-		/* Make a note to read those bits, adding their bodies (the parts between end-of-fade-in
-		   and start-of-fade-out) to the `done' list.
-		*/
+	if (!todo) {
+		todo = new vector<uint32_t>;
+		thread_read_segments.set (todo);
+	}
 
-		Evoral::RangeList<framepos_t>::List t = region_to_do.get ();
+	todo->clear ();
 
-		for (Evoral::RangeList<framepos_t>::List::iterator j = t.begin(); j != t.end(); ++j) {
-			Evoral::Range<framepos_t> d = *j;
-			to_do.push_back (Segment (ar, d));
+	vector<uint32_t>::const_iterator const first = plan->by_from.begin();
+	vector<uint32_t>::const_iterator const last = upper_bound (first, plan->by_from.end(), end, ReadPlan::FromBefore (plan->segments));
+	vector<framepos_t>::const_iterator const m = lower_bound (plan->max_to.begin(), plan->max_to.begin() + (last - first), start);
 
-			if (ar->opaque ()) {
-				/* Cut this range down to just the body and mark it done */
-				Evoral::Range<framepos_t> body = ar->body_range ();
-				if (body.from < d.to && body.to > d.from) {
-					d.from = max (d.from, body.from);
-					d.to = min (d.to, body.to);
-					done.add (d);
-				}
-			}
+	for (vector<uint32_t>::const_iterator i = first + (m - plan->max_to.begin()); i != last; ++i) {
+		if (plan->segments[*i].to >= start) {
+			todo->push_back (*i);
 		}
 	}
 
-	/* Now go backwards through the to_do list doing the actual reads */
-	for (list<Segment>::reverse_iterator i = to_do.rbegin(); i != to_do.rend(); ++i) {
+	/* ... and read them, from the bottom up */
+
+	sort (todo->begin(), todo->end());
+
+	for (vector<uint32_t>::const_iterator i = todo->begin(); i != todo->end(); ++i) {
+		ReadPlan::Segment const & s (plan->segments[*i]);
+		framepos_t const from = max (s.from, start);
+		framepos_t const to = min (s.to, end);
+		framecnt_t const len = to - from + 1;
+
 		DEBUG_TRACE (DEBUG::AudioPlayback, string_compose ("\tPlaylist %1 read %2 @ %3 for %4, channel %5, buf @ %6 offset %7\n",
-								   name(), i->region->name(), i->range.from,
-								   i->range.to - i->range.from + 1, (int) chan_n,
-								   buf, i->range.from - start));
-		i->region->read_at (buf + i->range.from - start, mixdown_buffer, gain_buffer, i->range.from, i->range.to - i->range.from + 1, chan_n);
+								   name(), s.region->name(), from, len, (int) chan_n, buf, from - start));
+
+		framecnt_t const n = s.region->read_at (buf + (from - start), mixdown_buffer, gain_buffer, from, len, chan_n);
+
+		if (n < len) {
+			/* we did not silence the part that the body should have
+			   copied over, so do that now.
+			*/
+			framepos_t const zfrom = max (from + n, s.copy_from);
+			framepos_t const zto = min (to, s.copy_to);
+			if (zto >= zfrom) {
+				memset (buf + (zfrom - start), 0, sizeof (Sample) * (zto - zfrom + 1));
+			}
+		}
 	}
 
 	return cnt;
@@ -298,6 +463,7 @@ AudioPlaylist::destroy_region (boost::shared_ptr<Region> region)
 
 			if ((*i) == region) {
 				regions.erase (i);
+				region_index.remove (region);
 				changed = true;
 			}
 
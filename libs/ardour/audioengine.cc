@@ -74,6 +74,7 @@ AudioEngine::AudioEngine ()
 	, session_removal_countdown (-1)
 	, _running (false)
 	, _freewheeling (false)
+	, _processing_offline (0)
 	, monitor_check_interval (INT32_MAX)
 	, last_monitor_check (0)
 	, _processed_frames (0)
@@ -205,6 +206,12 @@ AudioEngine::process_callback (pframes_t nframes)
 
 	if (!tm.locked()) {
 		/* return having done nothing */
+		if (processing_offline ()) {
+			/* the lock is held by an offline render which owns
+			 * (and reads back) the port buffers; leave them alone.
+			 */
+			return 0;
+		}
 		if (_session) {
 			Xrun();
 		}
@@ -1254,6 +1261,60 @@ AudioEngine::freewheel_callback (bool onoff)
 	_freewheeling = onoff;
 }
 
+int
+AudioEngine::start_offline_processing ()
+{
+	if (!_running || !_session || _freewheeling) {
+		return -1;
+	}
+
+	_process_lock.lock ();
+
+	g_atomic_int_set (&_processing_offline, 1);
+	_freewheeling = true;
+
+	if (!SessionEvent::has_per_thread_pool ()) {
+		SessionEvent::create_per_thread_pool (X_("offline process"), 512);
+	}
+
+	return 0;
+}
+
+/** Run one process cycle of @param nframes frames, which must not exceed
+ *  samples_per_cycle(), from the calling thread.
+ */
+int
+AudioEngine::process_offline (pframes_t nframes)
+{
+	assert (processing_offline ());
+	assert (nframes <= samples_per_cycle ());
+
+	InternalSend::CycleStart (nframes);
+	PortManager::cycle_start (nframes);
+
+	/* no handler means that the export did not get going (or has
+	 * already been finalized); there is nothing left to run.
+	 */
+	int ret = Freewheel (nframes).get_value_or (-1);
+
+	PortManager::cycle_end (nframes);
+
+	return ret;
+}
+
+void
+AudioEngine::stop_offline_processing ()
+{
+	if (!processing_offline ()) {
+		return;
+	}
+
+	_freewheeling = false;
+	g_atomic_int_set (&_processing_offline, 0);
+
+	_process_lock.unlock ();
+}
+
 void
 AudioEngine::latency_callback (bool for_playback)
 {
@@ -152,6 +152,7 @@ AudioFileSource::~AudioFileSource ()
 	if (removable()) {
 		::g_unlink (_path.c_str());
 		::g_unlink (_peakpath.c_str());
+		unlink_peak_levels ();
 	}
 }
 
@@ -237,6 +238,7 @@ AudioFileSource::mark_streaming_write_completed (const Lock& lock)
 int
 AudioFileSource::move_dependents_to_trash()
 {
+	unlink_peak_levels ();
 	return ::g_unlink (_peakpath.c_str());
 }
 
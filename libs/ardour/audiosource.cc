@@ -49,6 +49,7 @@
 #include <glibmm/fileutils.h>
 #include <glibmm/miscutils.h>
 
+#include "pbd/compose.h"
 #include "pbd/file_utils.h"
 #include "pbd/scoped_file_descriptor.h"
 #include "pbd/xml++.h"
@@ -75,6 +76,7 @@ bool AudioSource::_build_missing_peakfiles = false;
 bool AudioSource::_build_peakfiles = false;
 
 #define _FPP 256
+#define _PEAK_LEVEL_RATIO 16
 
 AudioSource::AudioSource (Session& s, const string& name)
 	: Source (s, DataType::AUDIO, name)
@@ -89,6 +91,7 @@ AudioSource::AudioSource (Session& s, const string& name)
 	, _last_scale (0.0)
 	, _last_map_off (0)
 	, _last_raw_map_length (0)
+	, _peak_levels_ready (0)
 {
 }
 
@@ -105,6 +108,7 @@ AudioSource::AudioSource (Session& s, const XMLNode& node)
 	, _last_scale (0.0)
 	, _last_map_off (0)
 	, _last_raw_map_length (0)
+	, _peak_levels_ready (0)
 {
 	if (set_state (node, Stateful::loading_state_version)) {
 		throw failed_constructor();
@@ -124,6 +128,8 @@ AudioSource::~AudioSource ()
 		_peakfile_fd = -1;
 	}
 
+	close_peak_levels ();
+
 	delete [] peak_leftovers;
 }
 
@@ -230,6 +236,17 @@ AudioSource::rename_peakfile (string newpath)
 		}
 	}
 
+	for (uint32_t n = 1; n < n_peak_levels; ++n) {
+		const string oldlevel = peak_level_path (n);
+		if (Glib::file_test (oldlevel, Glib::FILE_TEST_EXISTS)) {
+			const string newlevel = string_compose ("%1.%2", newpath, peak_level_fpp (n));
+			if (g_rename (oldlevel.c_str(), newlevel.c_str()) != 0) {
+				/* not fatal, they will be rebuilt from the main peakfile */
+				::g_unlink (oldlevel.c_str());
+			}
+		}
+	}
+
 	_peakpath = newpath;
 
 	return 0;
@@ -308,6 +325,25 @@ AudioSource::initialize_peakfile (const string& audio_path, const bool in_sessio
 
 	if (!empty() && !_peaks_built && _build_missing_peakfiles && _build_peakfiles) {
 		build_peaks_from_scratch ();
+	} else if (_peaks_built) {
+		/* older versions wrote only the main peakfile; add the coarser
+		 * levels (cheaply, from the main peakfile) if they are missing
+		 * or stale.
+		 */
+		if (peak_levels_valid (statbuf.st_mtime)) {
+			g_atomic_int_set (&_peak_levels_ready, 1);
+		} else {
+			Glib::Threads::Mutex::Lock lm (_lock);
+			if (build_peak_levels_from_peakfile ()) {
+				unlink_peak_levels ();
+			}
+		}
+
+		/* if this was queued for a peak-building thread, the GUI may be
+		 * waiting to hear that it needn't wait any longer.
+		 */
+		Glib::Threads::Mutex::Lock lp (_peaks_ready_lock);
+		PeaksReady (); /* EMIT SIGNAL */
 	}
 
 	return 0;
@@ -331,10 +367,48 @@ AudioSource::write (Sample *dst, framecnt_t cnt)
 	return write_unlocked (dst, cnt);
 }
 
+framecnt_t
+AudioSource::peak_level_fpp (uint32_t level)
+{
+	framecnt_t fpp = _FPP;
+
+	while (level--) {
+		fpp *= _PEAK_LEVEL_RATIO;
+	}
+
+	return fpp;
+}
+
+string
+AudioSource::peak_level_path (uint32_t level) const
+{
+	if (level == 0) {
+		return _peakpath;
+	}
+
+	return string_compose ("%1.%2", _peakpath, peak_level_fpp (level));
+}
+
 int
 AudioSource::read_peaks (PeakData *peaks, framecnt_t npeaks, framepos_t start, framecnt_t cnt, double samples_per_visual_peak) const
 {
-	return read_peaks_with_fpp (peaks, npeaks, start, cnt, samples_per_visual_peak, _FPP);
+	framecnt_t fpp = _FPP;
+
+	/* use the coarsest level that still has at least as many peaks as we
+	 * have been asked for, so that the amount of peak data read depends on
+	 * the number of pixels drawn rather than on the length of the range.
+	 */
+
+	if (g_atomic_int_get (&_peak_levels_ready)) {
+		for (uint32_t n = n_peak_levels - 1; n > 0; --n) {
+			if (peak_level_fpp (n) <= samples_per_visual_peak) {
+				fpp = peak_level_fpp (n);
+				break;
+			}
+		}
+	}
+
+	return read_peaks_with_fpp (peaks, npeaks, start, cnt, samples_per_visual_peak, fpp);
 }
 
 /** @param peaks Buffer to write peak data.
@@ -363,9 +437,24 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, framecnt_t npeaks, framepos_t
 
 	GStatBuf statbuf;
 
+	string peakpath = _peakpath;
+
+	for (uint32_t n = 1; n < n_peak_levels; ++n) {
+		if (samples_per_file_peak == peak_level_fpp (n)) {
+			peakpath = peak_level_path (n);
+			break;
+		}
+	}
+
+	if (peakpath != _peakpath && g_stat (peakpath.c_str(), &statbuf) != 0) {
+		/* the coarser levels are not required; use the main peakfile */
+		peakpath = _peakpath;
+		samples_per_file_peak = _FPP;
+	}
+
 	expected_peaks = (cnt / (double) samples_per_file_peak);
-	if (g_stat (_peakpath.c_str(), &statbuf) != 0) {
-		error << string_compose (_("Cannot open peakfile @ %1 for size check (%2)"), _peakpath, strerror (errno)) << endmsg;
+	if (g_stat (peakpath.c_str(), &statbuf) != 0) {
+		error << string_compose (_("Cannot open peakfile @ %1 for size check (%2)"), peakpath, strerror (errno)) << endmsg;
 		return -1;
 	}
 
@@ -386,22 +475,35 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, framecnt_t npeaks, framepos_t
 		const off_t expected_file_size = (_length / (double) samples_per_file_peak) * sizeof (PeakData);
 
 		if (statbuf.st_size < expected_file_size) {
-			warning << string_compose (_("peak file %1 is truncated from %2 to %3"), _peakpath, expected_file_size, statbuf.st_size) << endmsg;
+			warning << string_compose (_("peak file %1 is truncated from %2 to %3"), peakpath, expected_file_size, statbuf.st_size) << endmsg;
 			const_cast<AudioSource*>(this)->build_peaks_from_scratch ();
-			if (g_stat (_peakpath.c_str(), &statbuf) != 0) {
-				error << string_compose (_("Cannot open peakfile @ %1 for size check (%2) after rebuild"), _peakpath, strerror (errno)) << endmsg;
+			if (g_stat (peakpath.c_str(), &statbuf) != 0) {
+				error << string_compose (_("Cannot open peakfile @ %1 for size check (%2) after rebuild"), peakpath, strerror (errno)) << endmsg;
 			}
-			if (statbuf.st_size < expected_file_size) {
+			if (statbuf.st_size < expected_file_size && peakpath != _peakpath) {
+				/* a coarser level is still short; use the main peakfile */
+				peakpath = _peakpath;
+				samples_per_file_peak = _FPP;
+				expected_peaks = (cnt / (double) samples_per_file_peak);
+				if (g_stat (peakpath.c_str(), &statbuf) != 0) {
+					error << string_compose (_("Cannot open peakfile @ %1 for size check (%2) after rebuild"), peakpath, strerror (errno)) << endmsg;
+					return -1;
+				}
+				if (statbuf.st_size < (off_t) ((_length / (double) samples_per_file_peak) * sizeof (PeakData))) {
+					fatal << "peak file is still truncated after rebuild" << endmsg;
+					/*NOTREACHED*/
+				}
+			} else if (statbuf.st_size < expected_file_size) {
 				fatal << "peak file is still truncated after rebuild" << endmsg;
 				/*NOTREACHED*/
 			}
 		}
 	}
 
-	ScopedFileDescriptor sfd (g_open (_peakpath.c_str(), O_RDONLY, 0444));
+	ScopedFileDescriptor sfd (g_open (peakpath.c_str(), O_RDONLY, 0444));
 
 	if (sfd < 0) {
-		error << string_compose (_("Cannot open peakfile @ %1 for reading (%2)"), _peakpath, strerror (errno)) << endmsg;
+		error << string_compose (_("Cannot open peakfile @ %1 for reading (%2)"), peakpath, strerror (errno)) << endmsg;
 		return -1;
 	}
 
@@ -470,13 +572,13 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, framecnt_t npeaks, framepos_t
 
 			map_handle = CreateFileMapping(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
 			if (map_handle == NULL) {
-				error << string_compose (_("map failed - could not create file mapping for peakfile %1."), _peakpath) << endmsg;
+				error << string_compose (_("map failed - could not create file mapping for peakfile %1."), peakpath) << endmsg;
 				return -1;
 			}
 
 			view_handle = MapViewOfFile(map_handle, FILE_MAP_READ, 0, read_map_off, map_length);
 			if (view_handle == NULL) {
-				error << string_compose (_("map failed - could not map peakfile %1."), _peakpath) << endmsg;
+				error << string_compose (_("map failed - could not map peakfile %1."), peakpath) << endmsg;
 				return -1;
 			}
 
@@ -487,13 +589,13 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, framecnt_t npeaks, framepos_t
 			err_flag = UnmapViewOfFile (view_handle);
 			err_flag = CloseHandle(map_handle);
 			if(!err_flag) {
-				error << string_compose (_("unmap failed - could not unmap peakfile %1."), _peakpath) << endmsg;
+				error << string_compose (_("unmap failed - could not unmap peakfile %1."), peakpath) << endmsg;
 				return -1;
 			}
 #else
 			addr = (char*) mmap (0, map_length, PROT_READ, MAP_PRIVATE, sfd, read_map_off);
 			if (addr ==  MAP_FAILED) {
-				error << string_compose (_("map failed - could not mmap peakfile %1."), _peakpath) << endmsg;
+				error << string_compose (_("map failed - could not mmap peakfile %1."), peakpath) << endmsg;
 				return -1;
 			}
 
@@ -565,13 +667,13 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, framecnt_t npeaks, framepos_t
 
 			map_handle = CreateFileMapping(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
 			if (map_handle == NULL) {
-				error << string_compose (_("map failed - could not create file mapping for peakfile %1."), _peakpath) << endmsg;
+				error << string_compose (_("map failed - could not create file mapping for peakfile %1."), peakpath) << endmsg;
 				return -1;
 			}
 
 			view_handle = MapViewOfFile(map_handle, FILE_MAP_READ, 0, read_map_off, map_length);
 			if (view_handle == NULL) {
-				error << string_compose (_("map failed - could not map peakfile %1."), _peakpath) << endmsg;
+				error << string_compose (_("map failed - could not map peakfile %1."), peakpath) << endmsg;
 				return -1;
 			}
 
@@ -582,13 +684,13 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, framecnt_t npeaks, framepos_t
 			err_flag = UnmapViewOfFile (view_handle);
 			err_flag = CloseHandle(map_handle);
 			if(!err_flag) {
-				error << string_compose (_("unmap failed - could not unmap peakfile %1."), _peakpath) << endmsg;
+				error << string_compose (_("unmap failed - could not unmap peakfile %1."), peakpath) << endmsg;
 				return -1;
 			}
 #else
 			addr = (char*) mmap (0, map_length, PROT_READ, MAP_PRIVATE, sfd, read_map_off);
 			if (addr ==  MAP_FAILED) {
-				error << string_compose (_("map failed - could not mmap peakfile %1."), _peakpath) << endmsg;
+				error << string_compose (_("map failed - could not mmap peakfile %1."), peakpath) << endmsg;
 				return -1;
 			}
 
@@ -729,6 +831,9 @@ AudioSource::build_peaks_from_scratch ()
 
 		Glib::Threads::Mutex::Lock lp (_lock);
 
+		/* all levels are rebuilt along with the main peakfile */
+		unlink_peak_levels ();
+
 		if (prepare_for_peakfile_writes ()) {
 			goto out;
 		}
@@ -784,6 +889,7 @@ AudioSource::build_peaks_from_scratch ()
 	if (ret) {
 		DEBUG_TRACE (DEBUG::Peaks, string_compose("Could not write peak data, attempting to remove peakfile %1\n", _peakpath));
 		::g_unlink (_peakpath.c_str());
+		unlink_peak_levels ();
 	}
 
 	return ret;
@@ -799,6 +905,7 @@ AudioSource::close_peakfile ()
 	}
 	if (!_peakpath.empty()) {
 		::g_unlink (_peakpath.c_str());
+		unlink_peak_levels ();
 	}
 	_peaks_built = false;
 	return 0;
@@ -815,6 +922,15 @@ AudioSource::prepare_for_peakfile_writes ()
 		error << string_compose(_("AudioSource: cannot open _peakpath (c) \"%1\" (%2)"), _peakpath, strerror (errno)) << endmsg;
 		return -1;
 	}
+
+	/* the coarser levels are not required, so failing to open them is
+	 * not an error; read_peaks() will use the main peakfile instead.
+	 */
+	if (open_peak_levels ()) {
+		close_peak_levels ();
+		unlink_peak_levels ();
+	}
+
 	return 0;
 }
 
@@ -826,6 +942,7 @@ AudioSource::done_with_peakfile_writes (bool done)
 			close (_peakfile_fd);
 			_peakfile_fd = -1;
 		}
+		close_peak_levels ();
 		return;
 	}
 
@@ -833,6 +950,24 @@ AudioSource::done_with_peakfile_writes (bool done)
 		compute_and_write_peaks (0, 0, 0, true, false, _FPP);
 	}
 
+	bool levels_ok = (flush_peak_levels () == 0);
+
+	if (done && levels_ok) {
+		/* every level must cover the whole source; if some writes
+		 * were skipped (e.g. a destructive source reopened), derive
+		 * the levels from the main peakfile instead.
+		 */
+		for (uint32_t n = 1; n < n_peak_levels; ++n) {
+			const off_t expected = (_length / peak_level_fpp (n)) * sizeof (PeakData);
+			if (_peak_levels[n].byte_max < expected) {
+				levels_ok = false;
+				break;
+			}
+		}
+	}
+
+	close_peak_levels ();
+
 	if (done) {
 		Glib::Threads::Mutex::Lock lm (_peaks_ready_lock);
 		_peaks_built = true;
@@ -841,6 +976,15 @@ AudioSource::done_with_peakfile_writes (bool done)
 
 	close (_peakfile_fd);
 	_peakfile_fd = -1;
+
+	if (done) {
+		if (!levels_ok && build_peak_levels_from_peakfile ()) {
+			unlink_peak_levels ();
+			levels_ok = false;
+		}
+		g_atomic_int_set (&_peak_levels_ready, levels_ok ? 1 : 0);
+		invalidate_peak_cache ();
+	}
 }
 
 /** @param first_frame Offset from the source start of the first frame to
@@ -902,6 +1046,10 @@ AudioSource::compute_and_write_peaks (Sample* buf, framecnt_t first_frame, frame
 
 			_peak_byte_max = max (_peak_byte_max, (off_t) (byte + sizeof(PeakData)));
 
+			if (fpp == _FPP) {
+				write_peak_levels (&x, peak_leftover_frame / fpp, 1);
+			}
+
 			{
 				Glib::Threads::Mutex::Lock lm (_peaks_ready_lock);
 				PeakRangeReady (peak_leftover_frame, peak_leftover_cnt); /* EMIT SIGNAL */
@@ -1028,6 +1176,10 @@ AudioSource::compute_and_write_peaks (Sample* buf, framecnt_t first_frame, frame
 
 	_peak_byte_max = max (_peak_byte_max, (off_t) (first_peak_byte + bytes_to_write));
 
+	if (fpp == _FPP) {
+		write_peak_levels (peakbuf.get(), first_frame / fpp, peaks_computed);
+	}
+
 	if (frames_done) {
 		Glib::Threads::Mutex::Lock lm (_peaks_ready_lock);
 		PeakRangeReady (first_frame, frames_done); /* EMIT SIGNAL */
@@ -1061,6 +1213,283 @@ AudioSource::truncate_peakfile ()
 	}
 }
 
+/** Make the next read_peaks() read the peak files again instead of
+ *  answering from peak_cache, which may hold peaks of a level that has
+ *  since been removed or rebuilt.  peak_cache itself is replaced by that
+ *  read; it is not freed here, since a reader may be using it.
+ */
+void
+AudioSource::invalidate_peak_cache ()
+{
+	_first_run = true;
+	_last_scale = 0.0;
+	_last_map_off = 0;
+	_last_raw_map_length = 0;
+}
+
+void
+AudioSource::unlink_peak_levels ()
+{
+	g_atomic_int_set (&_peak_levels_ready, 0);
+	invalidate_peak_cache ();
+
+	if (_peakpath.empty()) {
+		return;
+	}
+
+	for (uint32_t n = 1; n < n_peak_levels; ++n) {
+		::g_unlink (peak_level_path (n).c_str());
+	}
+}
+
+int
+AudioSource::open_peak_levels ()
+{
+	for (uint32_t n = 1; n < n_peak_levels; ++n) {
+
+		PeakLevel& pl (_peak_levels[n]);
+
+		if (pl.fd >= 0) {
+			continue;
+		}
+
+		const string path = peak_level_path (n);
+
+		if ((pl.fd = g_open (path.c_str(), O_CREAT|O_RDWR, 0664)) < 0) {
+			error << string_compose(_("AudioSource: cannot open peak level file \"%1\" (%2)"), path, strerror (errno)) << endmsg;
+			return -1;
+		}
+
+		pl.byte_max = lseek (pl.fd, 0, SEEK_END);
+		pl.peak = -1;
+		pl.merged = 0;
+	}
+
+	return 0;
+}
+
+void
+AudioSource::close_peak_levels ()
+{
+	for (uint32_t n = 1; n < n_peak_levels; ++n) {
+		if (_peak_levels[n].fd >= 0) {
+			close (_peak_levels[n].fd);
+			_peak_levels[n].fd = -1;
+		}
+		_peak_levels[n].peak = -1;
+		_peak_levels[n].merged = 0;
+	}
+}
+
+/** Feed newly written main peakfile data to the coarser levels. Failure is
+ *  not fatal: the levels are dropped and read_peaks() uses the main
+ *  peakfile.
+ */
+void
+AudioSource::write_peak_levels (PeakData const * peaks, framepos_t first_peak, framecnt_t npeaks)
+{
+	if (_peak_levels[1].fd < 0 || npeaks == 0) {
+		return;
+	}
+
+	if (add_to_peak_level (1, peaks, first_peak, npeaks)) {
+		close_peak_levels ();
+		unlink_peak_levels ();
+	}
+}
+
+/** Merge npeaks peaks of level - 1, starting at index first_peak, into level.
+ *  Completed peaks are written out and passed on to the next level.
+ */
+int
+AudioSource::add_to_peak_level (uint32_t level, PeakData const * peaks, framepos_t first_peak, framecnt_t npeaks)
+{
+	PeakLevel& pl (_peak_levels[level]);
+
+	for (framecnt_t i = 0; i < npeaks; ++i) {
+
+		const framepos_t finer = first_peak + i;
+		const framepos_t peak = finer / _PEAK_LEVEL_RATIO;
+
+		if (pl.peak != peak) {
+
+			if (flush_peak_level (level)) {
+				return -1;
+			}
+
+			pl.peak = peak;
+			pl.merged = 0;
+
+			/* if we are not starting at the beginning of this peak
+			 * (e.g. after a seek), merge with what is already there.
+			 */
+
+			const off_t byte = peak * sizeof (PeakData);
+
+			if ((finer % _PEAK_LEVEL_RATIO) && (byte + (off_t) sizeof (PeakData) <= pl.byte_max)) {
+				if (lseek (pl.fd, byte, SEEK_SET) == byte && ::read (pl.fd, &pl.data, sizeof (PeakData)) == sizeof (PeakData)) {
+					pl.merged = 1;
+				}
+			}
+		}
+
+		if (pl.merged == 0) {
+			pl.data = peaks[i];
+		} else {
+			pl.data.max = max (pl.data.max, peaks[i].max);
+			pl.data.min = min (pl.data.min, peaks[i].min);
+		}
+
+		++pl.merged;
+
+		if ((finer % _PEAK_LEVEL_RATIO) == _PEAK_LEVEL_RATIO - 1) {
+			if (flush_peak_level (level)) {
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/** Write out the (possibly partial) peak being accumulated for level */
+int
+AudioSource::flush_peak_level (uint32_t level)
+{
+	PeakLevel& pl (_peak_levels[level]);
+
+	if (pl.peak < 0 || pl.merged == 0) {
+		pl.peak = -1;
+		return 0;
+	}
+
+	const off_t byte = pl.peak * sizeof (PeakData);
+
+	if (lseek (pl.fd, byte, SEEK_SET) != byte) {
+		error << string_compose(_("%1: could not seek in peak file data (%2)"), _name, strerror (errno)) << endmsg;
+		return -1;
+	}
+
+	if (::write (pl.fd, &pl.data, sizeof (PeakData)) != sizeof (PeakData)) {
+		error << string_compose(_("%1: could not write peak file data (%2)"), _name, strerror (errno)) << endmsg;
+		return -1;
+	}
+
+	pl.byte_max = max (pl.byte_max, (off_t) (byte + sizeof (PeakData)));
+
+	const framepos_t peak = pl.peak;
+	const PeakData data = pl.data;
+
+	pl.peak = -1;
+	pl.merged = 0;
+
+	if (level + 1 < n_peak_levels) {
+		return add_to_peak_level (level + 1, &data, peak, 1);
+	}
+
+	return 0;
+}
+
+int
+AudioSource::flush_peak_levels ()
+{
+	if (_peak_levels[1].fd < 0) {
+		return -1;
+	}
+
+	/* finest first, since each flush feeds the next level up */
+
+	for (uint32_t n = 1; n < n_peak_levels; ++n) {
+		if (flush_peak_level (n)) {
+			close_peak_levels ();
+			unlink_peak_levels ();
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+bool
+AudioSource::peak_levels_valid (time_t peakfile_mtime) const
+{
+	for (uint32_t n = 1; n < n_peak_levels; ++n) {
+
+		GStatBuf statbuf;
+
+		if (g_stat (peak_level_path (n).c_str(), &statbuf) != 0) {
+			return false;
+		}
+
+		/* same slop as for the main peakfile vs. the audio file */
+
+		if (peakfile_mtime > statbuf.st_mtime && (peakfile_mtime - statbuf.st_mtime > 6)) {
+			return false;
+		}
+
+		if (statbuf.st_size < (off_t) ((_length / peak_level_fpp (n)) * sizeof (PeakData))) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/** (Re)build the coarser peak levels from the main peakfile alone, without
+ *  reading any audio data. Used for peakfiles written before levels existed.
+ *  Does not take _lock, since it is also used from done_with_peakfile_writes().
+ */
+int
+AudioSource::build_peak_levels_from_peakfile ()
+{
+	const framecnt_t bufsize = 8192;
+
+	g_atomic_int_set (&_peak_levels_ready, 0);
+
+	ScopedFileDescriptor sfd (g_open (_peakpath.c_str(), O_RDONLY, 0444));
+
+	if (sfd < 0) {
+		return -1;
+	}
+
+	unlink_peak_levels ();
+
+	if (open_peak_levels ()) {
+		close_peak_levels ();
+		return -1;
+	}
+
+	DEBUG_TRACE (DEBUG::Peaks, string_compose ("Building peak levels from %1\n", _peakpath));
+
+	boost::scoped_array<PeakData> buf (new PeakData[bufsize]);
+	framepos_t peak = 0;
+	ssize_t nread;
+
+	while ((nread = ::read (sfd, buf.get(), bufsize * sizeof (PeakData))) > 0) {
+
+		const framecnt_t npeaks = nread / sizeof (PeakData);
+
+		if (add_to_peak_level (1, buf.get(), peak, npeaks)) {
+			close_peak_levels ();
+			return -1;
+		}
+
+		peak += npeaks;
+	}
+
+	if (nread < 0 || flush_peak_levels ()) {
+		close_peak_levels ();
+		return -1;
+	}
+
+	close_peak_levels ();
+
+	g_atomic_int_set (&_peak_levels_ready, 1);
+	invalidate_peak_cache ();
+
+	return 0;
+}
+
 framecnt_t
 AudioSource::available_peaks (double zoom_factor) const
 {
@@ -17,6 +17,7 @@
 
 */
 
+#include <cmath>
 #include <iostream>
 
 #include <glibmm/timer.h>
@@ -26,6 +27,7 @@
 #include "ardour/automation_control.h"
 #include "ardour/automation_watch.h"
 #include "ardour/debug.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/session.h"
 
 using namespace ARDOUR;
@@ -42,10 +44,19 @@ AutomationWatch::instance ()
 	return *_instance;
 }
 
+AutomationWatch::Watch::Watch (boost::shared_ptr<AutomationControl> c)
+	: ac (c)
+	, events (1024) /* > 0.5 sec of 64 frame cycles at 96kHz; more than enough between two timer() calls */
+	, have_anchor (false)
+	, have_pending (false)
+{
+}
+
 AutomationWatch::AutomationWatch ()
 	: _thread (0)
 	, _last_time (0)
 	, _run_thread (false)
+	, automation_watches (new Watches)
 {
 
 }
@@ -59,7 +70,10 @@ AutomationWatch::~AutomationWatch ()
 	}
 
 	Glib::Threads::Mutex::Lock lm (automation_watch_lock);
-	automation_watches.clear ();
+	{
+		RCUWriter<Watches> writer (automation_watches);
+		writer.get_copy ()->clear ();
+	}
 }
 
 void
@@ -67,7 +81,24 @@ AutomationWatch::add_automation_watch (boost::shared_ptr<AutomationControl> ac)
 {
 	Glib::Threads::Mutex::Lock lm (automation_watch_lock);
 	DEBUG_TRACE (DEBUG::Automation, string_compose ("now watching control %1 for automation, astate = %2\n", ac->name(), enum_2_string (ac->automation_state())));
-	automation_watches.insert (ac);
+
+	{
+		RCUWriter<Watches> writer (automation_watches);
+		boost::shared_ptr<Watches> w = writer.get_copy ();
+		Watches::const_iterator i;
+		for (i = w->begin(); i != w->end(); ++i) {
+			if ((*i)->ac == ac) {
+				break;
+			}
+		}
+		if (i == w->end()) {
+			w->push_back (boost::shared_ptr<Watch> (new Watch (ac)));
+		}
+	}
+
+	/* no flush () here: the process thread may still hold the old list.
+	 * The next write, or timer (), lets go of it once nobody does.
+	 */
 
 	/* if an automation control is added here while the transport is
 	 * rolling, make sure that it knows that there is a write pass going
@@ -107,42 +138,181 @@ AutomationWatch::remove_automation_watch (boost::shared_ptr<AutomationControl> a
 {
 	Glib::Threads::Mutex::Lock lm (automation_watch_lock);
 	DEBUG_TRACE (DEBUG::Automation, string_compose ("remove control %1 from automation watch\n", ac->name()));
-	automation_watches.erase (ac);
+
+	{
+		RCUWriter<Watches> writer (automation_watches);
+		boost::shared_ptr<Watches> w = writer.get_copy ();
+		for (Watches::iterator i = w->begin(); i != w->end(); ++i) {
+			if ((*i)->ac == ac) {
+				/* keep whatever was written up to now */
+				flush_watch (**i);
+				finish_points (**i);
+				w->erase (i);
+				break;
+			}
+		}
+	}
+
 	ac->list()->set_in_write_pass (false);
 }
 
+void
+AutomationWatch::process (Session& s)
+{
+	/* never create the instance here, this is the process thread */
+	AutomationWatch* aw = _instance;
+
+	if (!aw || aw->_session != &s || !s.transport_rolling()) {
+		return;
+	}
+
+	aw->note_values (s.audible_frame ());
+}
+
+void
+AutomationWatch::note_values (framepos_t time)
+{
+	if (time == _last_time) {
+		return;
+	}
+
+	/* we only write automation in the forward direction; this fixes
+	 * automation-recording in a loop. if the transport stopped or
+	 * reversed, the automation pass is restarted when the values are
+	 * added to the list.
+	 */
+	const bool new_pass = time < _last_time;
+
+	boost::shared_ptr<Watches> w = automation_watches.reader ();
+
+	for (Watches::const_iterator i = w->begin(); i != w->end(); ++i) {
+		if (!(*i)->ac->automation_write()) {
+			continue;
+		}
+		const Event ev = { time, (*i)->ac->user_double(), new_pass };
+		/* if the ring is full, drop the value: the list will
+		 * interpolate over the gap.
+		 */
+		(*i)->events.write (&ev, 1);
+	}
+
+	_last_time = time;
+}
+
+/** Move values noted by the process thread into @param w's list.
+ * Must be called with automation_watch_lock held.
+ */
+void
+AutomationWatch::flush_watch (Watch& w)
+{
+	Event batch[64];
+	guint n;
+
+	while ((n = w.events.read (batch, 64)) > 0) {
+		for (guint e = 0; e < n; ++e) {
+			if (batch[e].new_pass) {
+				DEBUG_TRACE (DEBUG::Automation, string_compose ("%1: transport in rewind, restart write pass at %2\n",
+										w.ac->name(), batch[e].when));
+				finish_points (w);
+				w.ac->list()->set_in_write_pass (false);
+				w.ac->list()->set_in_write_pass (true, true, batch[e].when);
+			}
+			add_point (w, batch[e]);
+		}
+	}
+}
+
+/** Add a value to the list, thinning the recorded points as we go (see
+ * Evoral::ControlList::thin()): a point is held back until the next one
+ * arrives, and dropped if it lies (nearly) on the line between the point
+ * before it and the next.  Runs of an unchanged value are reduced to their
+ * first and last points even when thinning is off.
+ */
+void
+AutomationWatch::add_point (Watch& w, Event const & ev)
+{
+	const double thinning_factor = w.ac->toggled() ? 0.0 : Config->get_automation_thinning_factor ();
+
+	if (w.have_anchor && w.have_pending) {
+		Event const & a (w.anchor);
+		Event const & p (w.pending);
+
+		if (ev.value == p.value && p.value == a.value) {
+			w.pending = ev;
+			return;
+		}
+	}
+
+	if (w.have_anchor && w.have_pending && thinning_factor != 0.0) {
+		Event const & a (w.anchor);
+		Event const & p (w.pending);
+
+		/* compute the area of the triangle formed by 3 points */
+		const double area = fabs ((a.when * (p.value - ev.value)) +
+		                          (p.when * (ev.value - a.value)) +
+		                          (ev.when * (a.value - p.value)));
+
+		if (area < thinning_factor) {
+			w.pending = ev;
+			return;
+		}
+	}
+
+	if (w.have_pending) {
+		w.ac->list()->add (w.pending.when, w.pending.value, true);
+		w.anchor = w.pending;
+		w.have_anchor = true;
+	}
+
+	w.pending = ev;
+	w.have_pending = true;
+}
+
+/** Add the point held back by add_point(), at the end of a write pass */
+void
+AutomationWatch::finish_points (Watch& w)
+{
+	if (w.have_pending) {
+		w.ac->list()->add (w.pending.when, w.pending.value, true);
+	}
+	w.have_anchor = false;
+	w.have_pending = false;
+}
+
+void
+AutomationWatch::flush ()
+{
+	Glib::Threads::Mutex::Lock lm (automation_watch_lock);
+	boost::shared_ptr<Watches> w = automation_watches.reader ();
+
+	for (Watches::const_iterator i = w->begin(); i != w->end(); ++i) {
+		flush_watch (**i);
+		finish_points (**i);
+	}
+}
+
 gint
 AutomationWatch::timer ()
 {
-	if (!_session || !_session->transport_rolling()) {
+	if (!_session) {
 		return TRUE;
 	}
 
+	Glib::Threads::Mutex::Lock lm (automation_watch_lock);
+
 	{
-		Glib::Threads::Mutex::Lock lm (automation_watch_lock);
+		boost::shared_ptr<Watches> w = automation_watches.reader ();
 
-		framepos_t time = _session->audible_frame ();
-		if (time > _last_time) {  //we only write automation in the forward direction; this fixes automation-recording in a loop
-			for (AutomationWatches::iterator aw = automation_watches.begin(); aw != automation_watches.end(); ++aw) {
-				if ((*aw)->alist()->automation_write()) {
-					(*aw)->list()->add (time, (*aw)->user_double(), true);
-				}
-			}
-		} else if (time != _last_time) {  //transport stopped or reversed.  stop the automation pass and start a new one (for bonus points, someday store the previous pass in an undo record)
-			for (AutomationWatches::iterator aw = automation_watches.begin(); aw != automation_watches.end(); ++aw) {
-				DEBUG_TRACE (DEBUG::Automation, string_compose ("%1: transport in rewind, speed %2, in write pass ? %3 writing ? %4\n",
-										(*aw)->name(), _session->transport_speed(), _session->transport_rolling(),
-										(*aw)->alist()->automation_write()));
-				(*aw)->list()->set_in_write_pass (false);
-				if ( (*aw)->alist()->automation_write() ) {
-					(*aw)->list()->set_in_write_pass (true, time);
-				}
-			}
+		for (Watches::const_iterator i = w->begin(); i != w->end(); ++i) {
+			flush_watch (**i);
 		}
-
-		_last_time = time;
 	}
 
+	/* destroy watches removed since the last tick here, rather than in
+	 * the process thread when it drops its reference to an old list.
+	 */
+	automation_watches.collect ();
+
 	return TRUE;
 }
 
@@ -189,15 +359,19 @@ AutomationWatch::transport_state_change ()
 
 	{
 		Glib::Threads::Mutex::Lock lm (automation_watch_lock);
+		boost::shared_ptr<Watches> w = automation_watches.reader ();
 
-		for (AutomationWatches::iterator aw = automation_watches.begin(); aw != automation_watches.end(); ++aw) {
+		for (Watches::const_iterator aw = w->begin(); aw != w->end(); ++aw) {
+			boost::shared_ptr<AutomationControl> ac ((*aw)->ac);
 			DEBUG_TRACE (DEBUG::Automation, string_compose ("%1: transport state changed, speed %2, in write pass ? %3 writing ? %4\n",
-									(*aw)->name(), _session->transport_speed(), rolling,
-									(*aw)->alist()->automation_write()));
-			if (rolling && (*aw)->alist()->automation_write()) {
-				(*aw)->list()->set_in_write_pass (true);
+									ac->name(), _session->transport_speed(), rolling,
+									ac->alist()->automation_write()));
+			flush_watch (**aw);
+			finish_points (**aw);
+			if (rolling && ac->alist()->automation_write()) {
+				ac->list()->set_in_write_pass (true);
 			} else {
-				(*aw)->list()->set_in_write_pass (false);
+				ac->list()->set_in_write_pass (false);
 			}
 		}
 	}
@@ -466,6 +466,41 @@ BufferSet::merge_from (const BufferSet& in, framecnt_t nframes)
 	}
 }
 
+/** Merge all of \a ins into our existing buffers, as merge_from() would for
+ * each of them in turn.  MIDI buffers are merged from all sources in a single
+ * pass, rather than by shifting our events for every interleaved source.
+ */
+void
+BufferSet::merge_from (const BufferSet* const* ins, uint32_t n_ins, framecnt_t nframes)
+{
+	for (uint32_t n = 0; n < n_ins; ++n) {
+		BufferSet::iterator o = begin (DataType::AUDIO);
+		for (BufferSet::const_iterator i = ins[n]->begin (DataType::AUDIO); i != ins[n]->end (DataType::AUDIO) && o != end (DataType::AUDIO); ++i, ++o) {
+			o->merge_from (*i, nframes);
+		}
+	}
+
+	static const uint32_t max_sources = 32;
+	const MidiBuffer* srcs[max_sources];
+
+	for (uint32_t b = 0; b < count().n_midi(); ++b) {
+		uint32_t n_srcs = 0;
+		for (uint32_t n = 0; n < n_ins; ++n) {
+			if (b >= ins[n]->count().n_midi()) {
+				continue;
+			}
+			srcs[n_srcs++] = &ins[n]->get_midi (b);
+			if (n_srcs == max_sources) {
+				get_midi (b).merge_in_place (srcs, n_srcs);
+				n_srcs = 0;
+			}
+		}
+		if (n_srcs) {
+			get_midi (b).merge_in_place (srcs, n_srcs);
+		}
+	}
+}
+
 void
 BufferSet::silence (framecnt_t nframes, framecnt_t offset)
 {
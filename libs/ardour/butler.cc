@@ -17,6 +17,7 @@
 
 */
 
+#include <algorithm>
 #include <errno.h>
 #include <fcntl.h>
 #include <unistd.h>
@@ -25,8 +26,10 @@
 #include <poll.h>
 #endif
 
+#include "pbd/cpus.h"
 #include "pbd/error.h"
 #include "pbd/pthread_utils.h"
+#include "ardour/audio_diskstream.h"
 #include "ardour/debug.h"
 #include "ardour/butler.h"
 #include "ardour/io.h"
@@ -50,8 +53,15 @@ Butler::Butler(Session& s)
 	, midi_dstream_buffer_size(0)
 	, pool_trash(16)
 	, _xthread (true)
+	, _io_run_sem ("butler_io_run", 0)
+	, _io_done_sem ("butler_io_done", 0)
+	, _io_job (IORefill)
 {
 	g_atomic_int_set(&should_do_transport_work, 0);
+	g_atomic_int_set(&_io_next, 0);
+	g_atomic_int_set(&_io_outstanding, 0);
+	g_atomic_int_set(&_io_errors, 0);
+	g_atomic_int_set(&_io_threads_changed, 1);
 	SessionEvent::pool->set_trash (&pool_trash);
 
         /* catch future changes to parameters */
@@ -98,6 +108,12 @@ Butler::config_changed (std::string p)
 		_session.adjust_playback_buffering ();
 	} else if (p == "midi-readahead") {
 		MidiDiskstream::set_readahead_frames ((framecnt_t) (Config->get_midi_readahead() * _session.frame_rate()));
+	} else if (p == "butler-io-threads") {
+		/* the pool is rebuilt by the butler thread itself, between passes */
+		g_atomic_int_set (&_io_threads_changed, 1);
+		if (have_thread) {
+			summon ();
+		}
 	}
 }
 
@@ -162,7 +178,6 @@ Butler::thread_work ()
 	uint32_t err = 0;
 
 	bool disk_work_outstanding = false;
-	RouteList::iterator i;
 
 	while (true) {
 		DEBUG_TRACE (DEBUG::Butler, string_compose ("%1 butler main loop, disk work outstanding ? %2 @ %3\n", DEBUG_THREAD_SELF, disk_work_outstanding, g_get_monotonic_time()));
@@ -188,6 +203,7 @@ Butler::thread_work ()
 
 					case Request::Quit:
 						DEBUG_TRACE (DEBUG::Butler, string_compose ("%1: butler asked to quit @ %2\n", DEBUG_THREAD_SELF, g_get_monotonic_time()));
+						drop_io_threads ();
 						return 0;
 						abort(); /*NOTREACHED*/
 						break;
@@ -198,6 +214,10 @@ Butler::thread_work ()
 			}
 		}
 
+		if (g_atomic_int_compare_and_exchange (&_io_threads_changed, 1, 0)) {
+			drop_io_threads ();
+			setup_io_threads ();
+		}
 
 	  restart:
 		DEBUG_TRACE (DEBUG::Butler, "at restart for disk work\n");
@@ -221,47 +241,7 @@ Butler::thread_work ()
 
 		boost::shared_ptr<RouteList> rl = _session.get_routes();
 
-		RouteList rl_with_auditioner = *rl;
-		rl_with_auditioner.push_back (_session.the_auditioner());
-
-		for (i = rl_with_auditioner.begin(); !transport_work_requested() && should_run && i != rl_with_auditioner.end(); ++i) {
-
-			boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
-
-			if (!tr) {
-				continue;
-			}
-
-			boost::shared_ptr<IO> io = tr->input ();
-
-			if (io && !io->active()) {
-				/* don't read inactive tracks */
-				DEBUG_TRACE (DEBUG::Butler, string_compose ("butler skips inactive track %1\n", tr->name()));
-				continue;
-			}
-			DEBUG_TRACE (DEBUG::Butler, string_compose ("butler refills %1, playback load = %2\n", tr->name(), tr->playback_buffer_load()));
-			switch (tr->do_refill ()) {
-			case 0:
-				DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill done %1\n", tr->name()));
-				break;
-
-			case 1:
-				DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill unfinished %1\n", tr->name()));
-				disk_work_outstanding = true;
-				break;
-
-			default:
-				error << string_compose(_("Butler read ahead failure on dstream %1"), (*i)->name()) << endmsg;
-                                std::cerr << string_compose(_("Butler read ahead failure on dstream %1"), (*i)->name()) << std::endl;
-				break;
-			}
-
-		}
-
-		if (i != rl_with_auditioner.begin() && i != rl_with_auditioner.end()) {
-			/* we didn't get to all the streams */
-			disk_work_outstanding = true;
-		}
+		disk_work_outstanding = refill_tracks (rl);
 
 		if (!err && transport_work_requested()) {
 			DEBUG_TRACE (DEBUG::Butler, "transport work requested during refill, back to restart\n");
@@ -308,13 +288,16 @@ Butler::thread_work ()
 }
 
 bool
-Butler::flush_tracks_to_disk_normal (boost::shared_ptr<RouteList> rl, uint32_t& errors)
+Butler::refill_tracks (boost::shared_ptr<RouteList> rl)
 {
-	bool disk_work_outstanding = false;
+	uint32_t errors = 0;
+
+	_io_items.clear ();
 
-	for (RouteList::iterator i = rl->begin(); !transport_work_requested() && should_run && i != rl->end(); ++i) {
+	RouteList rl_with_auditioner = *rl;
+	rl_with_auditioner.push_back (_session.the_auditioner());
 
-		// cerr << "write behind for " << (*i)->name () << endl;
+	for (RouteList::iterator i = rl_with_auditioner.begin(); i != rl_with_auditioner.end(); ++i) {
 
 		boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
 
@@ -322,48 +305,58 @@ Butler::flush_tracks_to_disk_normal (boost::shared_ptr<RouteList> rl, uint32_t&
 			continue;
 		}
 
-		/* note that we still try to flush diskstreams attached to inactive routes
-		 */
+		boost::shared_ptr<IO> io = tr->input ();
 
-		int ret;
+		if (io && !io->active()) {
+			/* don't read inactive tracks */
+			DEBUG_TRACE (DEBUG::Butler, string_compose ("butler skips inactive track %1\n", tr->name()));
+			continue;
+		}
 
-		DEBUG_TRACE (DEBUG::Butler, string_compose ("butler flushes track %1 capture load %2\n", tr->name(), tr->capture_buffer_load()));
-		ret = tr->do_flush (ButlerContext, false);
-		switch (ret) {
-		case 0:
-			DEBUG_TRACE (DEBUG::Butler, string_compose ("\tflush complete for %1\n", tr->name()));
-			break;
+		_io_items.push_back (IOItem (tr, tr->playback_buffer_load()));
+	}
 
-		case 1:
-			DEBUG_TRACE (DEBUG::Butler, string_compose ("\tflush not finished for %1\n", tr->name()));
-			disk_work_outstanding = true;
-			break;
+	/* emptiest playback buffers first: they are closest to an underrun */
+	std::stable_sort (_io_items.begin(), _io_items.end());
 
-		default:
-			errors++;
-			error << string_compose(_("Butler write-behind failure on dstream %1"), (*i)->name()) << endmsg;
-			std::cerr << string_compose(_("Butler write-behind failure on dstream %1"), (*i)->name()) << std::endl;
-			/* don't break - try to flush all streams in case they
-			   are split across disks.
-			*/
+	return run_io_jobs (IORefill, errors);
+}
+
+bool
+Butler::flush_tracks_to_disk_normal (boost::shared_ptr<RouteList> rl, uint32_t& errors)
+{
+	_io_items.clear ();
+
+	for (RouteList::iterator i = rl->begin(); i != rl->end(); ++i) {
+
+		boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
+
+		if (!tr) {
+			continue;
 		}
+
+		/* note that we still try to flush diskstreams attached to inactive routes
+		 */
+
+		/* fullest capture buffers first: they are closest to an overrun */
+		_io_items.push_back (IOItem (tr, -tr->capture_buffer_load()));
 	}
 
-	return disk_work_outstanding;
+	std::stable_sort (_io_items.begin(), _io_items.end());
+
+	return run_io_jobs (IOFlush, errors);
 }
 
 bool
 Butler::flush_tracks_to_disk_after_locate (boost::shared_ptr<RouteList> rl, uint32_t& errors)
 {
-	bool disk_work_outstanding = false;
-
 	/* almost the same as the "normal" version except that we do not test
 	 * for transport_work_requested() and we force flushes.
 	 */
 
-	for (RouteList::iterator i = rl->begin(); i != rl->end(); ++i) {
+	_io_items.clear ();
 
-		// cerr << "write behind for " << (*i)->name () << endl;
+	for (RouteList::iterator i = rl->begin(); i != rl->end(); ++i) {
 
 		boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
 
@@ -371,34 +364,180 @@ Butler::flush_tracks_to_disk_after_locate (boost::shared_ptr<RouteList> rl, uint
 			continue;
 		}
 
-		/* note that we still try to flush diskstreams attached to inactive routes
-		 */
+		_io_items.push_back (IOItem (tr, 0));
+	}
+
+	return run_io_jobs (IOForcedFlush, errors);
+}
+
+/** Hand the tracks in _io_items to the butler thread and all I/O threads,
+ *  and wait until every one of them has finished its share.
+ *
+ *  @return true if some track still has work to do.
+ */
+bool
+Butler::run_io_jobs (IOJob job, uint32_t& errors)
+{
+	_io_job = job;
+	g_atomic_int_set (&_io_next, 0);
+	g_atomic_int_set (&_io_outstanding, 0);
+	g_atomic_int_set (&_io_errors, 0);
+
+	const size_t n_helpers = std::min (_io_threads.size(), _io_items.size() > 0 ? _io_items.size() - 1 : 0);
+
+	for (size_t n = 0; n < n_helpers; ++n) {
+		_io_run_sem.signal ();
+	}
+
+	process_io_jobs ();
+
+	for (size_t n = 0; n < n_helpers; ++n) {
+		_io_done_sem.wait ();
+	}
+
+	errors += g_atomic_int_get (&_io_errors);
+
+	/* drop our references to the tracks now, not at the next pass */
+	_io_items.clear ();
+
+	return g_atomic_int_get (&_io_outstanding);
+}
 
-		int ret;
+void
+Butler::process_io_jobs ()
+{
+	const gint n_items = _io_items.size();
+
+	while (true) {
 
-		DEBUG_TRACE (DEBUG::Butler, string_compose ("butler flushes track %1 capture load %2\n", tr->name(), tr->capture_buffer_load()));
-		ret = tr->do_flush (ButlerContext, true);
-		switch (ret) {
-		case 0:
-			DEBUG_TRACE (DEBUG::Butler, string_compose ("\tflush complete for %1\n", tr->name()));
+		if (_io_job != IOForcedFlush && (transport_work_requested() || !should_run)) {
+			if (g_atomic_int_get (&_io_next) < n_items) {
+				/* we didn't get to all the streams */
+				g_atomic_int_set (&_io_outstanding, 1);
+			}
 			break;
+		}
+
+		const gint n = g_atomic_int_add (&_io_next, 1);
 
-		case 1:
-			DEBUG_TRACE (DEBUG::Butler, string_compose ("\tflush not finished for %1\n", tr->name()));
-			disk_work_outstanding = true;
+		if (n >= n_items) {
 			break;
+		}
 
-		default:
-			errors++;
-			error << string_compose(_("Butler write-behind failure on dstream %1"), (*i)->name()) << endmsg;
-			std::cerr << string_compose(_("Butler write-behind failure on dstream %1"), (*i)->name()) << std::endl;
-			/* don't break - try to flush all streams in case they
-			   are split across disks.
-			*/
+		boost::shared_ptr<Track> tr = _io_items[n].track;
+
+		if (_io_job == IORefill) {
+
+			DEBUG_TRACE (DEBUG::Butler, string_compose ("butler refills %1, playback load = %2\n", tr->name(), tr->playback_buffer_load()));
+			switch (tr->do_refill ()) {
+			case 0:
+				DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill done %1\n", tr->name()));
+				break;
+
+			case 1:
+				DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill unfinished %1\n", tr->name()));
+				g_atomic_int_set (&_io_outstanding, 1);
+				break;
+
+			default:
+				error << string_compose(_("Butler read ahead failure on dstream %1"), tr->name()) << endmsg;
+				std::cerr << string_compose(_("Butler read ahead failure on dstream %1"), tr->name()) << std::endl;
+				break;
+			}
+
+		} else {
+
+			DEBUG_TRACE (DEBUG::Butler, string_compose ("butler flushes track %1 capture load %2\n", tr->name(), tr->capture_buffer_load()));
+			switch (tr->do_flush (ButlerContext, _io_job == IOForcedFlush)) {
+			case 0:
+				DEBUG_TRACE (DEBUG::Butler, string_compose ("\tflush complete for %1\n", tr->name()));
+				break;
+
+			case 1:
+				DEBUG_TRACE (DEBUG::Butler, string_compose ("\tflush not finished for %1\n", tr->name()));
+				g_atomic_int_set (&_io_outstanding, 1);
+				break;
+
+			default:
+				g_atomic_int_inc (&_io_errors);
+				error << string_compose(_("Butler write-behind failure on dstream %1"), tr->name()) << endmsg;
+				std::cerr << string_compose(_("Butler write-behind failure on dstream %1"), tr->name()) << std::endl;
+				/* don't break - try to flush all streams in case they
+				   are split across disks.
+				*/
+			}
 		}
 	}
+}
 
-	return disk_work_outstanding;
+void
+Butler::setup_io_threads ()
+{
+	uint32_t n_threads = Config->get_butler_io_threads ();
+
+	if (n_threads == 0) {
+		n_threads = hardware_concurrency ();
+	}
+
+	/* the butler thread itself is always one of the I/O threads */
+	for (uint32_t n = 1; n < n_threads; ++n) {
+		pthread_t t;
+		if (pthread_create_and_store ("butler io", &t, _io_thread_work, this)) {
+			error << _("Session: could not create butler I/O thread") << endmsg;
+			break;
+		}
+		_io_threads.push_back (t);
+	}
+
+	DEBUG_TRACE (DEBUG::Butler, string_compose ("butler uses %1 additional I/O threads\n", _io_threads.size()));
+}
+
+void
+Butler::drop_io_threads ()
+{
+	if (_io_threads.empty()) {
+		return;
+	}
+
+	_io_job = IOQuit;
+
+	for (size_t n = 0; n < _io_threads.size(); ++n) {
+		_io_run_sem.signal ();
+	}
+
+	for (std::vector<pthread_t>::iterator i = _io_threads.begin(); i != _io_threads.end(); ++i) {
+		void* status;
+		pthread_join (*i, &status);
+	}
+
+	_io_threads.clear ();
+}
+
+void *
+Butler::_io_thread_work (void* arg)
+{
+	SessionEvent::create_per_thread_pool ("butler io events", 64);
+	pthread_set_name (X_("butler io"));
+	AudioDiskstream::allocate_thread_working_buffers ();
+	return ((Butler *) arg)->io_thread_work ();
+}
+
+void *
+Butler::io_thread_work ()
+{
+	while (true) {
+		_io_run_sem.wait ();
+
+		if (_io_job == IOQuit) {
+			break;
+		}
+
+		process_io_jobs ();
+
+		_io_done_sem.signal ();
+	}
+
+	return 0;
 }
 
 void
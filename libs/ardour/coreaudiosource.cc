@@ -23,6 +23,7 @@
 
 #include "pbd/error.h"
 #include "ardour/coreaudiosource.h"
+#include "ardour/runtime_functions.h"
 #include "ardour/utils.h"
 
 #ifdef COREAUDIO105
@@ -209,14 +210,7 @@ CoreAudioSource::read_unlocked (Sample *dst, framepos_t start, framecnt_t cnt) c
 		return 0;
 	}
 
-	Sample *ptr = interleave_buf + _channel;
-
-	/* stride through the interleaved data */
-
-	for (framecnt_t n = 0; n < file_cnt; ++n) {
-		dst[n] = *ptr;
-		ptr += n_channels;
-	}
+	deinterleave (dst, interleave_buf, file_cnt, _channel, n_channels);
 
 	return cnt;
 }
@@ -19,8 +19,13 @@
 
 #include <stdlib.h>
 #include <math.h>
+#include <algorithm>
+#include <glibmm/threads.h>
+#include "pbd/malign.h"
 #include "ardour/dB.h"
 #include "ardour/dsp_filter.h"
+#include "ardour/types.h"
+#include "ardour/runtime_functions.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -65,6 +70,26 @@ ARDOUR::DSP::peaks (float *data, float &min, float &max, uint32_t n_samples) {
 	}
 }
 
+float
+ARDOUR::DSP::mix_with_gain_ramp (float *dst, const float *src, const uint32_t n_samples, float initial, float target, float coeff) {
+	/* let the (vectorized) runtime function compute the ramp on a copy,
+	 * a block at a time
+	 */
+	float buf[256];
+	float gain = initial;
+	uint32_t done = 0;
+	while (done < n_samples) {
+		const uint32_t n = std::min (n_samples - done, (uint32_t) 256);
+		::memcpy (buf, &src[done], n * sizeof (float));
+		gain = ARDOUR::apply_gain_ramp (buf, n, gain, target, coeff);
+		for (uint32_t i = 0; i < n; ++i) {
+			dst[done + i] += buf[i];
+		}
+		done += n;
+	}
+	return gain;
+}
+
 LowPass::LowPass (double samplerate, float freq)
 	: _rate (samplerate)
 	, _z (0)
@@ -250,3 +275,293 @@ BiQuad::compute (Type type, double freq, double Q, double gain)
 	_a1 /= _a0;
 	_a2 /= _a0;
 }
+
+void
+BiQuad::configure (const BiQuad &other)
+{
+	_rate = other._rate;
+	_a1 = other._a1;
+	_a2 = other._a2;
+	_b0 = other._b0;
+	_b1 = other._b1;
+	_b2 = other._b2;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+BiQuadBank::BiQuadBank (double samplerate, uint32_t n_channels, uint32_t n_stages)
+	: _n_channels (n_channels)
+	, _n_stages (n_stages)
+	, _filters (n_channels * n_stages, BiQuad (samplerate))
+{
+}
+
+void
+BiQuadBank::compute (uint32_t stage, BiQuad::Type type, double freq, double Q, double gain)
+{
+	if (stage >= _n_stages || _n_channels == 0) {
+		return;
+	}
+	_filters[stage].compute (type, freq, Q, gain);
+	for (uint32_t c = 1; c < _n_channels; ++c) {
+		_filters[c * _n_stages + stage].configure (_filters[stage]);
+	}
+}
+
+void
+BiQuadBank::run (uint32_t channel, float *data, const uint32_t n_samples)
+{
+	if (channel >= _n_channels) {
+		return;
+	}
+	for (uint32_t s = 0; s < _n_stages; ++s) {
+		_filters[channel * _n_stages + s].run (data, n_samples);
+	}
+}
+
+void
+BiQuadBank::reset ()
+{
+	for (std::vector<BiQuad>::iterator i = _filters.begin (); i != _filters.end (); ++i) {
+		i->reset ();
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+FIRFilter::FIRFilter (uint32_t n_taps, uint32_t max_block)
+	: _n_taps (std::max (n_taps, (uint32_t) 1))
+	, _max_block (std::max (max_block, (uint32_t) 1))
+{
+	_taps = (float*) calloc (_n_taps, sizeof (float));
+	_taps[0] = 1.f;
+	cache_aligned_malloc ((void**) &_history, (_n_taps - 1 + _max_block) * sizeof (float));
+	reset ();
+}
+
+FIRFilter::~FIRFilter ()
+{
+	free (_taps);
+	cache_aligned_free (_history);
+}
+
+void
+FIRFilter::reset ()
+{
+	::memset (_history, 0, (_n_taps - 1) * sizeof (float));
+}
+
+void
+FIRFilter::run (float *data, const uint32_t n_samples)
+{
+	/* _history holds the last n_taps - 1 input samples followed by the
+	 * current block, so that every output sample is a dot product of the
+	 * (reversed) impulse response with a contiguous range of input.
+	 */
+	const uint32_t n_taps = _n_taps;
+	float const * const taps = _taps;
+	uint32_t done = 0;
+
+	while (done < n_samples) {
+		const uint32_t n = std::min (n_samples - done, _max_block);
+		float* in = &_history[n_taps - 1];
+
+		::memcpy (in, &data[done], n * sizeof (float));
+
+		for (uint32_t i = 0; i < n; ++i) {
+			float const * const x = &in[i];
+			float acc = 0.f;
+			for (uint32_t k = 0; k < n_taps; ++k) {
+				acc += taps[k] * x[-(int32_t)k];
+			}
+			data[done + i] = acc;
+		}
+
+		::memmove (_history, &_history[n], (n_taps - 1) * sizeof (float));
+		done += n;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+EnvelopeFollower::EnvelopeFollower (double samplerate, float attack, float release)
+	: _rate (samplerate)
+	, _env (0.f)
+{
+	set_attack (attack);
+	set_release (release);
+}
+
+void
+EnvelopeFollower::set_attack (float ms)
+{
+	_attack = 1.f - expf (-1000.f / (std::max (ms, .01f) * _rate));
+}
+
+void
+EnvelopeFollower::set_release (float ms)
+{
+	_release = 1.f - expf (-1000.f / (std::max (ms, .01f) * _rate));
+}
+
+float
+EnvelopeFollower::proc (const float *data, const uint32_t n_samples)
+{
+	// localize variables
+	const float attack = _attack;
+	const float release = _release;
+	float env = _env;
+	for (uint32_t i = 0; i < n_samples; ++i) {
+		const float x = fabsf (data[i]);
+		env += (x > env ? attack : release) * (x - env);
+	}
+	_env = env + 1e-20f; // denormal protection
+	return _env;
+}
+
+void
+EnvelopeFollower::run (const float *data, float *env_out, const uint32_t n_samples)
+{
+	// localize variables
+	const float attack = _attack;
+	const float release = _release;
+	float env = _env;
+	for (uint32_t i = 0; i < n_samples; ++i) {
+		const float x = fabsf (data[i]);
+		env += (x > env ? attack : release) * (x - env);
+		env_out[i] = env;
+	}
+	_env = env + 1e-20f; // denormal protection
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+DelayLine::DelayLine (uint32_t max_delay)
+	: _max_delay (max_delay)
+	, _delay (0)
+	, _w (0)
+{
+	/* room for the longest delay plus at least 256 samples, so that
+	 * blocks need not be split too often.
+	 */
+	_size = 1;
+	while (_size < max_delay + 256) {
+		_size <<= 1;
+	}
+	_mask = _size - 1;
+	_buf = (float*) calloc (_size, sizeof (float));
+}
+
+DelayLine::~DelayLine ()
+{
+	free (_buf);
+}
+
+void
+DelayLine::set_delay (uint32_t delay)
+{
+	_delay = std::min (delay, _max_delay);
+}
+
+void
+DelayLine::reset ()
+{
+	::memset (_buf, 0, _size * sizeof (float));
+}
+
+void
+DelayLine::run (float *data, const uint32_t n_samples)
+{
+	/* write a chunk, then read it back `delay' samples late. A chunk is
+	 * short enough for the samples to be read to not be overwritten yet.
+	 */
+	uint32_t done = 0;
+	while (done < n_samples) {
+		const uint32_t n = std::min (n_samples - done, _size - _max_delay);
+
+		const uint32_t w0 = std::min (n, _size - _w);
+		::memcpy (&_buf[_w], &data[done], w0 * sizeof (float));
+		::memcpy (_buf, &data[done + w0], (n - w0) * sizeof (float));
+
+		const uint32_t r = (_w + _size - _delay) & _mask;
+		const uint32_t r0 = std::min (n, _size - r);
+		::memcpy (&data[done], &_buf[r], r0 * sizeof (float));
+		::memcpy (&data[done + r0], _buf, (n - r0) * sizeof (float));
+
+		_w = (_w + n) & _mask;
+		done += n;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+/* FFTW planning is not thread-safe */
+static Glib::Threads::Mutex fft_planner_lock;
+
+FFTSpectrum::FFTSpectrum (uint32_t window_size, double rate)
+	: _window_size (window_size)
+	, _rate (rate)
+{
+	Glib::Threads::Mutex::Lock lk (fft_planner_lock);
+
+	_fft_data_in  = (float *) fftwf_malloc (sizeof (float) * _window_size);
+	_fft_data_out = (float *) fftwf_malloc (sizeof (float) * _window_size);
+	_fftplan = fftwf_plan_r2r_1d (_window_size, _fft_data_in, _fft_data_out, FFTW_R2HC, FFTW_ESTIMATE);
+
+	::memset (_fft_data_in, 0, sizeof (float) * _window_size);
+	::memset (_fft_data_out, 0, sizeof (float) * _window_size);
+
+	_hann_window = (float *) malloc (sizeof (float) * _window_size);
+	double sum = 0.0;
+	for (uint32_t i = 0; i < _window_size; ++i) {
+		_hann_window[i] = 0.5f - (0.5f * (float) cos (2.0f * M_PI * (float) i / (float) (_window_size)));
+		sum += _hann_window[i];
+	}
+	const double isum = 2.0 / sum;
+	for (uint32_t i = 0; i < _window_size; ++i) {
+		_hann_window[i] *= isum;
+	}
+}
+
+FFTSpectrum::~FFTSpectrum ()
+{
+	{
+		Glib::Threads::Mutex::Lock lk (fft_planner_lock);
+		fftwf_destroy_plan (_fftplan);
+	}
+	fftwf_free (_fft_data_in);
+	fftwf_free (_fft_data_out);
+	free (_hann_window);
+}
+
+void
+FFTSpectrum::set_data_hann (float const * const data, uint32_t n_samples, uint32_t offset)
+{
+	assert (n_samples + offset <= _window_size);
+	for (uint32_t i = 0; i < n_samples; ++i) {
+		_fft_data_in[i + offset] = data[i] * _hann_window[i + offset];
+	}
+}
+
+void
+FFTSpectrum::execute ()
+{
+	fftwf_execute (_fftplan);
+}
+
+float
+FFTSpectrum::magnitude_at_bin (const uint32_t b, const float norm) const
+{
+	assert (b < _window_size / 2);
+	/* half-complex output: real parts first, imaginary parts in reverse */
+	const float re = _fft_data_out[b];
+	const float im = b > 0 ? _fft_data_out[_window_size - b] : 0.f;
+	return norm * sqrtf (re * re + im * im);
+}
+
+float
+FFTSpectrum::power_at_bin (const uint32_t b, const float norm) const
+{
+	const float m = magnitude_at_bin (b, norm);
+	return m > 1e-20f ? 20.f * log10f (m) : -200.f;
+}
@@ -58,6 +58,7 @@ ExportGraphBuilder::ExportGraphBuilder (Session const & session)
 	, thread_pool (hardware_concurrency())
 {
 	process_buffer_frames = session.engine().samples_per_cycle();
+	threader.reset (new Threader<Sample> (thread_pool));
 }
 
 ExportGraphBuilder::~ExportGraphBuilder ()
@@ -65,16 +66,26 @@ ExportGraphBuilder::~ExportGraphBuilder ()
 }
 
 int
-ExportGraphBuilder::process (framecnt_t frames, bool last_cycle)
+ExportGraphBuilder::process (framecnt_t offset, framecnt_t frames, bool last_cycle)
 {
-	assert(frames <= process_buffer_frames);
+	assert(offset + frames <= process_buffer_frames);
 
+	/* Read every channel once, up front: channels may be shared between
+	 * channel configurations, which then run in parallel.
+	 */
 	for (ChannelMap::iterator it = channels.begin(); it != channels.end(); ++it) {
 		Sample const * process_buffer = 0;
-		it->first->read (process_buffer, frames);
-		ConstProcessContext<Sample> context(process_buffer, frames, 1);
-		if (last_cycle) { context().set_flag (ProcessContext<Sample>::EndOfInput); }
-		it->second->process (context);
+		it->first->read (process_buffer, offset + frames);
+		it->second = process_buffer + offset;
+	}
+
+	ConstProcessContext<Sample> context ((Sample const *) 0, frames, 1);
+	if (last_cycle) { context().set_flag (ProcessContext<Sample>::EndOfInput); }
+
+	if (channel_configs.size() == 1) {
+		channel_configs.front().sink()->process (context);
+	} else {
+		threader->process (context);
 	}
 
 	return 0;
@@ -108,6 +119,7 @@ void
 ExportGraphBuilder::reset ()
 {
 	timespan.reset();
+	threader->clear_outputs ();
 	channel_configs.clear ();
 	channels.clear ();
 	normalizers.clear ();
@@ -119,6 +131,8 @@ ExportGraphBuilder::cleanup (bool remove_out_files/*=false*/)
 {
 	ChannelConfigList::iterator iter = channel_configs.begin();
 
+	threader->clear_outputs ();
+
 	while (iter != channel_configs.end() ) {
 		iter->remove_children(remove_out_files);
 		iter = channel_configs.erase(iter);
@@ -197,6 +211,7 @@ ExportGraphBuilder::add_split_config (FileSpec const & config)
 
 	// No duplicate channel config found, create new one
 	channel_configs.push_back (new ChannelConfig (*this, config, channels));
+	threader->add_output (channel_configs.back().sink ());
 }
 
 /* Encoder */
@@ -231,6 +246,8 @@ ExportGraphBuilder::Encoder::init (FileSpec const & new_config)
 void
 ExportGraphBuilder::Encoder::add_child (FileSpec const & new_config)
 {
+	/* the copy may be of another (equal) channel configuration */
+	new_config.filename->set_channel_config (new_config.channel_config);
 	filenames.push_back (new_config.filename);
 }
 
@@ -497,6 +514,9 @@ ExportGraphBuilder::Normalizer::start_post_processing()
 	}
 	tmp_file->seek (0, SEEK_SET);
 	tmp_file->add_output (normalizer);
+
+	/* channel configurations finish in parallel */
+	Glib::Threads::Mutex::Lock lm (parent.normalizers_lock);
 	parent.normalizers.push_back (this);
 }
 
@@ -569,7 +589,8 @@ ExportGraphBuilder::SRC::add_child_to_list (FileSpec const & new_config, boost::
 bool
 ExportGraphBuilder::SRC::operator== (FileSpec const & other_config) const
 {
-	return config.format->sample_rate() == other_config.format->sample_rate();
+	return config.format->sample_rate() == other_config.format->sample_rate() &&
+		config.format->src_quality() == other_config.format->src_quality();
 }
 
 /* SilenceHandler */
@@ -660,21 +681,32 @@ ExportGraphBuilder::ChannelConfig::ChannelConfig (ExportGraphBuilder & parent, F
 	interleaver->add_output(chunker);
 
 	ChannelList const & channel_list = config.channel_config->get_channels();
-	unsigned chan = 0;
-	for (ChannelList::const_iterator it = channel_list.begin(); it != channel_list.end(); ++it, ++chan) {
-		ChannelMap::iterator map_it = channel_map.find (*it);
-		if (map_it == channel_map.end()) {
-			std::pair<ChannelMap::iterator, bool> result_pair =
-				channel_map.insert (std::make_pair (*it, IdentityVertexPtr (new IdentityVertex<Sample> ())));
-			assert (result_pair.second);
-			map_it = result_pair.first;
-		}
-		map_it->second->add_output (interleaver->input (chan));
+	for (ChannelList::const_iterator it = channel_list.begin(); it != channel_list.end(); ++it) {
+		// insert() leaves channels that are already there alone
+		channels.push_back (channel_map.insert (std::make_pair (*it, (Sample const *) 0)).first);
 	}
 
+	input.reset (new Input (*this));
+
 	add_child (new_config);
 }
 
+ExportGraphBuilder::FloatSinkPtr
+ExportGraphBuilder::ChannelConfig::sink ()
+{
+	return input;
+}
+
+void
+ExportGraphBuilder::ChannelConfig::Input::process (ProcessContext<Sample> const & c)
+{
+	unsigned chan = 0;
+	for (std::vector<ChannelMap::const_iterator>::const_iterator it = config.channels.begin(); it != config.channels.end(); ++it, ++chan) {
+		ConstProcessContext<Sample> context (c, (*it)->second, c.frames(), 1);
+		config.interleaver->input (chan)->process (context);
+	}
+}
+
 void
 ExportGraphBuilder::ChannelConfig::add_child (FileSpec const & new_config)
 {
@@ -707,7 +739,28 @@ ExportGraphBuilder::ChannelConfig::remove_children (bool remove_out_files)
 bool
 ExportGraphBuilder::ChannelConfig::operator== (FileSpec const & other_config) const
 {
-	return config.channel_config == other_config.channel_config;
+	if (config.channel_config == other_config.channel_config) {
+		return true;
+	}
+
+	/* Split configurations are created anew for each format, so compare
+	 * the channels themselves to share the graph between formats.
+	 */
+	typedef ExportChannelConfiguration::ChannelList ChannelList;
+	ChannelList const & ours = config.channel_config->get_channels();
+	ChannelList const & theirs = other_config.channel_config->get_channels();
+
+	if (ours.size() != theirs.size()) {
+		return false;
+	}
+
+	for (ChannelList::const_iterator a = ours.begin(), b = theirs.begin(); a != ours.end(); ++a, ++b) {
+		if (*a < *b || *b < *a) {
+			return false;
+		}
+	}
+
+	return true;
 }
 
 } // namespace ARDOUR
@@ -20,12 +20,15 @@
 
 #include "ardour/export_handler.h"
 
+#include <algorithm>
+
 #include "pbd/gstdio_compat.h"
 #include <glibmm.h>
 #include <glibmm/convert.h>
 
 #include "pbd/convert.h"
 
+#include "ardour/audioengine.h"
 #include "ardour/audiofile_tagger.h"
 #include "ardour/debug.h"
 #include "ardour/export_graph_builder.h"
@@ -34,6 +37,7 @@
 #include "ardour/export_status.h"
 #include "ardour/export_format_specification.h"
 #include "ardour/export_filename.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/soundcloud_upload.h"
 #include "ardour/system_exec.h"
 #include "pbd/openuri.h"
@@ -108,9 +112,9 @@ ExportElementFactory::add_filename_copy (ExportFilenamePtr other)
 ExportHandler::ExportHandler (Session & session)
   : ExportElementFactory (session)
   , session (session)
-  , graph_builder (new ExportGraphBuilder (session))
   , export_status (session.get_export_status ())
   , normalizing (false)
+  , pass_end (0)
   , cue_tracknum (0)
   , cue_indexnum (0)
 {
@@ -118,7 +122,12 @@ ExportHandler::ExportHandler (Session & session)
 
 ExportHandler::~ExportHandler ()
 {
-	graph_builder->cleanup (export_status->aborted () );
+	for (TimespanGraphs::iterator i = rolling.begin(); i != rolling.end(); ++i) {
+		i->graph_builder->cleanup (export_status->aborted () );
+	}
+	for (TimespanGraphs::iterator i = to_normalize.begin(); i != to_normalize.end(); ++i) {
+		i->graph_builder->cleanup (export_status->aborted () );
+	}
 }
 
 /** Add an export to the `to-do' list */
@@ -162,50 +171,107 @@ ExportHandler::do_export ()
 	start_timespan ();
 }
 
+int
+ExportHandler::do_offline_export ()
+{
+	AudioEngine& engine (session.engine ());
+
+	if (engine.start_offline_processing ()) {
+		return -1;
+	}
+
+	do_export ();
+
+	const pframes_t nframes = engine.samples_per_cycle ();
+
+	while (export_status->running ()) {
+		if (engine.process_offline (nframes)) {
+			export_status->abort (true);
+			break;
+		}
+	}
+
+	engine.stop_offline_processing ();
+
+	return export_status->aborted () ? -1 : 0;
+}
+
+struct TimespanSortByStart {
+    bool operator() (ExportTimespanPtr const & a, ExportTimespanPtr const & b) {
+	    return *a < *b;
+    }
+};
+
 void
 ExportHandler::start_timespan ()
 {
-	export_status->timespan++;
-
 	if (config_map.empty()) {
+		export_status->timespan++;
 		// freewheeling has to be stopped from outside the process cycle
 		export_status->set_running (false);
 		return;
 	}
 
-	/* finish_timespan pops the config_map entry that has been done, so
-	   this is the timespan to do this time
+	/* finish_timespan pops the config_map entries that have been done,
+	   so the remaining timespans are all still to do. Collect them in
+	   order of their start.
+	*/
+	std::vector<ExportTimespanPtr> timespans;
+	for (ConfigMap::iterator it = config_map.begin(); it != config_map.end(); it = config_map.upper_bound (it->first)) {
+		timespans.push_back (it->first);
+	}
+	std::sort (timespans.begin(), timespans.end(), TimespanSortByStart ());
+
+	/* This pass takes the first timespan and every other one that starts
+	   before the pass has ended, or so soon after that rendering the gap
+	   costs less than relocating (and pre-rolling) for another pass.
 	*/
-	current_timespan = config_map.begin()->first;
+	framecnt_t const max_gap = Config->get_export_preroll() * session.nominal_frame_rate ();
 
-	export_status->total_frames_current_timespan = current_timespan->get_length();
-	export_status->timespan_name = current_timespan->name();
+	process_position = timespans.front()->get_start();
+	pass_end = process_position;
+
+	export_status->total_frames_current_timespan = 0;
 	export_status->processed_frames_current_timespan = 0;
+	export_status->timespan_name = timespans.front()->name();
 
-	/* Register file configurations to graph builder */
+	for (std::vector<ExportTimespanPtr>::iterator t = timespans.begin(); t != timespans.end(); ++t) {
 
-	/* Here's the config_map entries that use this timespan */
-	timespan_bounds = config_map.equal_range (current_timespan);
-	graph_builder->reset ();
-	graph_builder->set_current_timespan (current_timespan);
-	handle_duplicate_format_extensions();
-	for (ConfigMap::iterator it = timespan_bounds.first; it != timespan_bounds.second; ++it) {
-		// Filenames can be shared across timespans
-		FileSpec & spec = it->second;
-		spec.filename->set_timespan (it->first);
-		graph_builder->add_config (spec);
+		if (t != timespans.begin() && (*t)->get_start() > pass_end + max_gap) {
+			break;
+		}
+
+		pass_end = std::max (pass_end, (*t)->get_end());
+
+		export_status->timespan++;
+		export_status->total_frames_current_timespan += (*t)->get_length();
+
+		/* Register file configurations to graph builder */
+
+		/* Here's the config_map entries that use this timespan */
+		TimespanBounds timespan_bounds = config_map.equal_range (*t);
+		boost::shared_ptr<ExportGraphBuilder> graph_builder (new ExportGraphBuilder (session));
+		graph_builder->set_current_timespan (*t);
+		handle_duplicate_format_extensions (timespan_bounds);
+		for (ConfigMap::iterator it = timespan_bounds.first; it != timespan_bounds.second; ++it) {
+			// Filenames can be shared across timespans
+			FileSpec & spec = it->second;
+			spec.filename->set_timespan (it->first);
+			graph_builder->add_config (spec);
+		}
+
+		rolling.push_back (TimespanGraph (*t, graph_builder));
 	}
 
 	/* start export */
 
 	normalizing = false;
 	session.ProcessExport.connect_same_thread (process_connection, boost::bind (&ExportHandler::process, this, _1));
-	process_position = current_timespan->get_start();
 	session.start_audio_export (process_position);
 }
 
 void
-ExportHandler::handle_duplicate_format_extensions()
+ExportHandler::handle_duplicate_format_extensions (TimespanBounds const & timespan_bounds)
 {
 	typedef std::map<std::string, int> ExtCountMap;
 
@@ -245,33 +311,64 @@ ExportHandler::process_timespan (framecnt_t frames)
 	export_status->active_job = ExportStatus::Exporting;
 	/* update position */
 
-	framecnt_t frames_to_read = 0;
-	framepos_t const end = current_timespan->get_end();
-
-	bool const last_cycle = (process_position + frames >= end);
+	framepos_t const cycle_end = std::min (process_position + frames, pass_end);
+	bool const last_cycle = (cycle_end >= pass_end);
 
 	if (last_cycle) {
-		frames_to_read = end - process_position;
 		export_status->stop = true;
-	} else {
-		frames_to_read = frames;
 	}
 
-	process_position += frames_to_read;
-	export_status->processed_frames += frames_to_read;
-	export_status->processed_frames_current_timespan += frames_to_read;
+	/* Do actual processing: hand each timespan its part of the cycle */
+	int ret = 0;
+
+	for (TimespanGraphs::iterator i = rolling.begin(); i != rolling.end(); /* ++ in loop */) {
+		framepos_t const start = std::min (std::max (process_position, i->timespan->get_start()), cycle_end);
+		framepos_t const end = std::min (cycle_end, i->timespan->get_end());
+		bool const last = (cycle_end >= i->timespan->get_end());
+
+		if (start == cycle_end && !last) {
+			/* not started yet */
+			++i;
+			continue;
+		}
+
+		framecnt_t const frames_to_read = std::max ((framecnt_t) 0, end - start);
+
+		export_status->processed_frames += frames_to_read;
+		export_status->processed_frames_current_timespan += frames_to_read;
+
+		if (i->graph_builder->process (start - process_position, frames_to_read, last)) {
+			ret = -1;
+		}
+
+		if (!last) {
+			++i;
+			continue;
+		}
+
+		/* Normalize once all of this pass has been rendered */
+		if (i->graph_builder->will_normalize()) {
+			to_normalize.push_back (*i);
+		} else {
+			finish_timespan (*i);
+		}
+		i = rolling.erase (i);
+	}
 
-	/* Do actual processing */
-	int ret = graph_builder->process (frames_to_read, last_cycle);
+	process_position = cycle_end;
 
 	/* Start normalizing if necessary */
 	if (last_cycle) {
-		normalizing = graph_builder->will_normalize();
+		assert (rolling.empty ());
+		normalizing = !to_normalize.empty ();
 		if (normalizing) {
-			export_status->total_normalize_cycles = graph_builder->get_normalize_cycle_count();
+			export_status->total_normalize_cycles = 0;
+			for (TimespanGraphs::iterator i = to_normalize.begin(); i != to_normalize.end(); ++i) {
+				export_status->total_normalize_cycles += i->graph_builder->get_normalize_cycle_count();
+			}
 			export_status->current_normalize_cycle = 0;
 		} else {
-			finish_timespan ();
+			start_timespan ();
 			return 0;
 		}
 	}
@@ -282,8 +379,15 @@ ExportHandler::process_timespan (framecnt_t frames)
 int
 ExportHandler::process_normalize ()
 {
-	if (graph_builder->process_normalize ()) {
-		finish_timespan ();
+	TimespanGraph const & tg = to_normalize.front ();
+
+	if (tg.graph_builder->process_normalize ()) {
+		finish_timespan (tg);
+		to_normalize.pop_front ();
+	}
+
+	if (to_normalize.empty ()) {
+		start_timespan ();
 		export_status->active_job = ExportStatus::Exporting;
 	} else {
 		export_status->active_job = ExportStatus::Normalizing;
@@ -302,33 +406,35 @@ ExportHandler::command_output(std::string output, size_t size)
 }
 
 void
-ExportHandler::finish_timespan ()
+ExportHandler::finish_timespan (TimespanGraph const & tg)
 {
-	graph_builder->get_analysis_results (export_status->result_map);
+	tg.graph_builder->get_analysis_results (export_status->result_map);
 
-	while (config_map.begin() != timespan_bounds.second) {
+	TimespanBounds timespan_bounds = config_map.equal_range (tg.timespan);
 
-		ExportFormatSpecPtr fmt = config_map.begin()->second.format;
-		std::string filename = config_map.begin()->second.filename->get_path(fmt);
+	for (ConfigMap::iterator it = timespan_bounds.first; it != timespan_bounds.second; ++it) {
+
+		ExportFormatSpecPtr fmt = it->second.format;
+		std::string filename = it->second.filename->get_path(fmt);
 		if (fmt->with_cue()) {
-			export_cd_marker_file (current_timespan, fmt, filename, CDMarkerCUE);
+			export_cd_marker_file (tg.timespan, fmt, filename, CDMarkerCUE);
 		}
 
 		if (fmt->with_toc()) {
-			export_cd_marker_file (current_timespan, fmt, filename, CDMarkerTOC);
+			export_cd_marker_file (tg.timespan, fmt, filename, CDMarkerTOC);
 		}
 
 		if (fmt->with_mp4chaps()) {
-			export_cd_marker_file (current_timespan, fmt, filename, MP4Chaps);
+			export_cd_marker_file (tg.timespan, fmt, filename, MP4Chaps);
 		}
 
-		Session::Exported (current_timespan->name(), filename); /* EMIT SIGNAL */
+		Session::Exported (tg.timespan->name(), filename); /* EMIT SIGNAL */
 
 		/* close file first, otherwise TagLib enounters an ERROR_SHARING_VIOLATION
 		 * The process cannot access the file because it is being used.
 		 * ditto for post-export and upload.
 		 */
-		graph_builder->reset ();
+		tg.graph_builder->reset ();
 
 		if (fmt->tag()) {
 			/* TODO: check Umlauts and encoding in filename.
@@ -398,10 +504,9 @@ ExportHandler::finish_timespan ()
 			}
 			delete soundcloud_uploader;
 		}
-		config_map.erase (config_map.begin());
 	}
 
-	start_timespan ();
+	config_map.erase (timespan_bounds.first, timespan_bounds.second);
 }
 
 /*** CD Marker stuff ***/
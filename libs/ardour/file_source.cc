@@ -53,6 +53,14 @@ using namespace Glib;
 
 PBD::Signal2<int,std::string,std::vector<std::string> > FileSource::AmbiguousFileName;
 
+static Glib::Threads::Private<bool> no_questions;
+
+void
+FileSource::dont_ask_in_this_thread ()
+{
+	no_questions.set (new bool (true));
+}
+
 FileSource::FileSource (Session& session, DataType type, const string& path, const string& origin, Source::Flag flag)
 	: Source(session, type, path, flag)
 	, _path (path)
@@ -293,6 +301,12 @@ FileSource::find (Session& s, DataType type, const string& path, bool must_exist
 
 			/* more than one match: ask the user */
 
+			bool* q = no_questions.get ();
+
+			if (q && *q) {
+				goto out;
+			}
+
                         int which = FileSource::AmbiguousFileName (path, de_duped_hits).get_value_or (-1);
 
                         if (which < 0) {
@@ -136,6 +136,9 @@ apply_gain_to_buffer_t  ARDOUR::apply_gain_to_buffer = 0;
 mix_buffers_with_gain_t ARDOUR::mix_buffers_with_gain = 0;
 mix_buffers_no_gain_t   ARDOUR::mix_buffers_no_gain = 0;
 copy_vector_t			ARDOUR::copy_vector = 0;
+apply_gain_ramp_t       ARDOUR::apply_gain_ramp = 0;
+deinterleave_t          ARDOUR::deinterleave = 0;
+interleave_t            ARDOUR::interleave = 0;
 
 PBD::Signal1<void,std::string> ARDOUR::BootMessage;
 PBD::Signal3<void,std::string,std::string,bool> ARDOUR::PluginScanMessage;
@@ -167,6 +170,24 @@ setup_hardware_optimization (bool try_optimization)
 
 #if defined (ARCH_X86) && defined (BUILD_SSE_OPTIMIZATIONS)
 
+		if (fpu->has_avx512f()) {
+
+			info << "Using AVX-512 optimized routines" << endmsg;
+
+			// AVX-512 SET
+			compute_peak          = x86_avx512f_compute_peak;
+			find_peaks            = x86_avx512f_find_peaks;
+			apply_gain_to_buffer  = x86_avx512f_apply_gain_to_buffer;
+			mix_buffers_with_gain = x86_avx512f_mix_buffers_with_gain;
+			mix_buffers_no_gain   = x86_avx512f_mix_buffers_no_gain;
+			copy_vector           = x86_avx512f_copy_vector;
+			apply_gain_ramp       = x86_avx512f_apply_gain_ramp;
+			deinterleave          = x86_avx512f_deinterleave;
+			interleave            = x86_avx512f_interleave;
+
+			generic_mix_functions = false;
+
+		} else
 #ifdef PLATFORM_WINDOWS
 		/* We have AVX-optimized code for Windows */
 
@@ -185,6 +206,9 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_with_gain = x86_sse_avx_mix_buffers_with_gain;
 			mix_buffers_no_gain   = x86_sse_avx_mix_buffers_no_gain;
 			copy_vector           = x86_sse_avx_copy_vector;
+			apply_gain_ramp       = default_apply_gain_ramp;
+			deinterleave          = default_deinterleave;
+			interleave            = default_interleave;
 
 			generic_mix_functions = false;
 
@@ -199,11 +223,22 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_with_gain = x86_sse_mix_buffers_with_gain;
 			mix_buffers_no_gain   = x86_sse_mix_buffers_no_gain;
 			copy_vector           = default_copy_vector;
+			apply_gain_ramp       = default_apply_gain_ramp;
+			deinterleave          = default_deinterleave;
+			interleave            = default_interleave;
 
 			generic_mix_functions = false;
 
 		}
 
+		if (!generic_mix_functions && !fpu->has_avx512f() && fpu->has_fma()) {
+
+			info << "Using FMA optimized routines" << endmsg;
+
+			mix_buffers_with_gain = x86_fma_mix_buffers_with_gain;
+			apply_gain_ramp       = x86_fma_apply_gain_ramp;
+		}
+
 #elif defined (__APPLE__) && defined (BUILD_VECLIB_OPTIMIZATIONS)
 		SInt32 sysVersion = 0;
 
@@ -217,6 +252,9 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_with_gain  = veclib_mix_buffers_with_gain;
 			mix_buffers_no_gain    = veclib_mix_buffers_no_gain;
 			copy_vector            = default_copy_vector;
+			apply_gain_ramp        = default_apply_gain_ramp;
+			deinterleave           = default_deinterleave;
+			interleave             = default_interleave;
 
 			generic_mix_functions = false;
 
@@ -237,6 +275,9 @@ setup_hardware_optimization (bool try_optimization)
 		mix_buffers_with_gain = default_mix_buffers_with_gain;
 		mix_buffers_no_gain   = default_mix_buffers_no_gain;
 		copy_vector           = default_copy_vector;
+		apply_gain_ramp       = default_apply_gain_ramp;
+		deinterleave          = default_deinterleave;
+		interleave            = default_interleave;
 
 		info << "No H/W specific optimizations in use" << endmsg;
 	}
@@ -19,6 +19,8 @@
 */
 #include <stdio.h>
 #include <cmath>
+#include <cstring>
+#include <map>
 
 #include "pbd/compose.h"
 #include "pbd/debug_rt_alloc.h"
@@ -26,6 +28,7 @@
 
 #include "ardour/debug.h"
 #include "ardour/graph.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/types.h"
 #include "ardour/session.h"
 #include "ardour/route.h"
@@ -38,6 +41,109 @@ using namespace ARDOUR;
 using namespace PBD;
 using namespace std;
 
+/** A fixed size, lock-free work-stealing deque (Chase & Lev). Only the
+ *  owning thread may push() and pop(), at the bottom; any other thread
+ *  may steal() from the top.
+ *
+ *  top and bottom only ever increase (modulo wrap-around), so all
+ *  comparisons are done on their difference.
+ */
+struct Graph::Worker {
+	Worker (uint32_t i)
+		: index (i)
+		, top (0)
+		, bottom (0)
+		, steals (0)
+		, busy_usecs (0)
+	{
+		memset (buf, 0, sizeof (buf));
+	}
+
+	static const gint size = 1024; /* must be a power of two */
+
+	uint32_t index;
+
+	volatile gint top;
+	char          pad[64]; /* keep thieves' and owner's index on separate cache lines */
+	volatile gint bottom;
+	gpointer      buf[size];
+
+	/* only written by the owning thread */
+	uint64_t steals;
+	uint64_t busy_usecs;
+
+	static gint diff (gint a, gint b) { return (gint) ((guint) a - (guint) b); }
+	static gint next (gint a) { return (gint) ((guint) a + 1); }
+
+	gint count () const {
+		return diff (g_atomic_int_get (&bottom), g_atomic_int_get (&top));
+	}
+
+	bool push (GraphNode* n) {
+		const gint b = g_atomic_int_get (&bottom);
+		const gint t = g_atomic_int_get (&top);
+
+		if (diff (b, t) >= size) {
+			return false;
+		}
+
+		g_atomic_pointer_set (&buf[(guint) b & (size - 1)], n);
+		g_atomic_int_set (&bottom, next (b));
+		return true;
+	}
+
+	GraphNode* pop () {
+		const gint b = diff (g_atomic_int_get (&bottom), 1);
+		g_atomic_int_set (&bottom, b);
+		const gint t = g_atomic_int_get (&top);
+
+		if (diff (b, t) < 0) {
+			/* empty */
+			g_atomic_int_set (&bottom, t);
+			return 0;
+		}
+
+		GraphNode* n = (GraphNode*) g_atomic_pointer_get (&buf[(guint) b & (size - 1)]);
+
+		if (diff (b, t) > 0) {
+			return n;
+		}
+
+		/* last node: race any thieves for it */
+
+		if (!g_atomic_int_compare_and_exchange (&top, t, next (t))) {
+			n = 0;
+		}
+
+		g_atomic_int_set (&bottom, next (t));
+		return n;
+	}
+
+	GraphNode* steal () {
+		const gint t = g_atomic_int_get (&top);
+		const gint b = g_atomic_int_get (&bottom);
+
+		if (diff (b, t) <= 0) {
+			return 0;
+		}
+
+		GraphNode* n = (GraphNode*) g_atomic_pointer_get (&buf[(guint) t & (size - 1)]);
+
+		if (!g_atomic_int_compare_and_exchange (&top, t, next (t))) {
+			/* someone else got it first */
+			return 0;
+		}
+
+		return n;
+	}
+};
+
+static void do_not_delete_the_worker (void*) {}
+Glib::Threads::Private<Graph::Worker> Graph::_current_worker (do_not_delete_the_worker);
+
+/** number of times an idle thread tries to steal before going to sleep */
+static const int steal_attempts = 64;
+
 #ifdef DEBUG_RT_ALLOC
 static Graph* graph = 0;
 
@@ -55,6 +161,13 @@ Graph::Graph (Session & session)
         : SessionHandleRef (session)
         , _threads_active (false)
 	, _execution_sem ("graph_execution", 0)
+	, _n_workers (0)
+	, _work_stealing (false)
+	, _overflow_count (0)
+	, _reset_stats (0)
+	, _cycle_start (0)
+	, _stats_busy_usecs (0)
+	, _stats_steals (0)
 	, _callback_start_sem ("graph_start", 0)
 	, _callback_done_sem ("graph_done", 0)
 	, _cleanup_sem ("graph_cleanup", 0)
@@ -119,6 +232,13 @@ Graph::reset_thread_list ()
 
         _threads_active = true;
 
+	/* every process thread gets a queue, even if work stealing is not
+	 * enabled yet, so that it can be turned on at any time.
+	 */
+	for (uint32_t i = 0; i < num_threads; ++i) {
+		_workers.push_back (new Worker (i));
+	}
+
 	if (AudioEngine::instance()->create_process_thread (boost::bind (&Graph::main_thread, this)) != 0) {
 		throw failed_constructor ();
 	}
@@ -140,6 +260,8 @@ Graph::session_going_away()
         _nodes_rt[1].clear();
         _init_trigger_list[0].clear();
         _init_trigger_list[1].clear();
+        _sinks_first[0].clear();
+        _sinks_first[1].clear();
         _trigger_queue.clear();
 }
 
@@ -164,6 +286,20 @@ Graph::drop_threads ()
 	AudioEngine::instance()->join_process_threads ();
 
 	_execution_tokens = 0;
+
+	DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("work stealing: %1 cycles, %2 steals, %3 usecs idle (max %4 in one cycle)\n",
+	                                                    _stats.cycles, _stats.steals, _stats.idle_usecs, _stats.max_idle_usecs));
+
+	for (vector<Worker*>::iterator i = _workers.begin(); i != _workers.end(); ++i) {
+		delete *i;
+	}
+
+	_workers.clear ();
+	_n_workers = 0;
+	_work_stealing = false;
+	_overflow_count = 0;
+	_stats_busy_usecs = 0;
+	_stats_steals = 0;
 }
 
 void
@@ -180,6 +316,7 @@ Graph::clear_other_chain ()
 
                         _nodes_rt[_setup_chain].clear ();
                         _init_trigger_list[_setup_chain].clear ();
+                        _sinks_first[_setup_chain].clear ();
                         break;
                 }
                 /* setup chain == pending chain - we have
@@ -216,20 +353,120 @@ Graph::prep()
         }
         _finished_refcount = _init_finished_refcount[chain];
 
+	update_priorities (chain);
+
+	/* the queues are all empty at this point, so this is the only safe
+	 * place to switch between scheduling modes.
+	 */
+	_work_stealing = Config->get_graph_work_stealing () && _current_worker.get ();
+
+	if (_work_stealing) {
+		_cycle_start = g_get_monotonic_time ();
+		for (i=_init_trigger_list[chain].begin(); i!=_init_trigger_list[chain].end(); i++) {
+			trigger (i->get ());
+		}
+		return;
+	}
+
 	/* Trigger the initial nodes for processing, which are the ones at the `input' end */
 	pthread_mutex_lock (&_trigger_mutex);
         for (i=_init_trigger_list[chain].begin(); i!=_init_trigger_list[chain].end(); i++) {
 		/* don't use ::trigger here, as we have already locked the mutex */
-                _trigger_queue.push_back (i->get ());
+                queue_ready (i->get ());
         }
 	pthread_mutex_unlock (&_trigger_mutex);
 }
 
+bool
+Graph::lower_priority (node_ptr_t const & a, node_ptr_t const & b)
+{
+	return a->_priority < b->_priority;
+}
+
+/** Work out the priority of each node from the DSP cost measured in recent
+ *  cycles: a node's priority is the cost of the most expensive path from it
+ *  to the end of the graph. Starting the nodes with the highest priority
+ *  first keeps a single expensive chain from being started late and then
+ *  overrunning the cycle while other threads sit idle.
+ */
+void
+Graph::update_priorities (int chain)
+{
+	for (vector<GraphNode*>::const_iterator i = _sinks_first[chain].begin(); i != _sinks_first[chain].end(); ++i) {
+		float longest = 0;
+		for (node_set_t::const_iterator a = (*i)->_activation_set[chain].begin(); a != (*i)->_activation_set[chain].end(); ++a) {
+			longest = max (longest, (*a)->_priority);
+		}
+		(*i)->_priority = (*i)->_dsp_cost + longest;
+	}
+
+	/* std::list::sort does not allocate */
+	_init_trigger_list[chain].sort (lower_priority);
+}
+
+/** Add a node to _trigger_queue, keeping it sorted so that run_one() takes
+ *  the node with the highest priority. Must be called with _trigger_mutex
+ *  held.
+ */
+void
+Graph::queue_ready (GraphNode* n)
+{
+	vector<GraphNode*>::iterator i = _trigger_queue.end ();
+
+	while (i != _trigger_queue.begin () && (*(i - 1))->_priority > n->_priority) {
+		--i;
+	}
+
+	_trigger_queue.insert (i, n);
+}
+
 void
 Graph::trigger (GraphNode* n)
 {
+	if (_work_stealing) {
+
+		Worker* w = _current_worker.get ();
+
+		if (w && w->push (n)) {
+			/* this thread will run the node itself next, while its
+			 * inputs are still in cache, unless there is more work
+			 * than that for it.
+			 */
+			if (w->count () > 1) {
+				wake_one ();
+			}
+			return;
+		}
+
+		pthread_mutex_lock (&_trigger_mutex);
+		queue_ready (n);
+		g_atomic_int_inc (&_overflow_count);
+		pthread_mutex_unlock (&_trigger_mutex);
+
+		wake_one ();
+		return;
+	}
+
+	pthread_mutex_lock (&_trigger_mutex);
+        queue_ready (n);
+	pthread_mutex_unlock (&_trigger_mutex);
+}
+
+/** Wake up one sleeping process thread, if there are any. Only used in
+ *  work-stealing mode.
+ */
+void
+Graph::wake_one ()
+{
+	if (g_atomic_int_get (&_execution_tokens) <= 0) {
+		return;
+	}
+
 	pthread_mutex_lock (&_trigger_mutex);
-        _trigger_queue.push_back (n);
+	if (_execution_tokens > 0) {
+		g_atomic_int_add (&_execution_tokens, -1);
+		_execution_sem.signal ();
+	}
 	pthread_mutex_unlock (&_trigger_mutex);
 }
 
@@ -252,6 +489,10 @@ Graph::dec_ref()
 void
 Graph::restart_cycle()
 {
+	if (_work_stealing) {
+		update_stats ();
+	}
+
         // we are through. wakeup our caller.
 
   again:
@@ -344,6 +585,34 @@ Graph::rechain (boost::shared_ptr<RouteList> routelist, GraphEdges const & edges
 		}
         }
 
+	/* Order the nodes so that each one comes after everything that it
+	   feeds, for update_priorities(). This is a topological sort of the
+	   reversed graph, using the number of nodes each node feeds.
+	*/
+	_sinks_first[chain].clear ();
+
+	map<GraphNode*, uint32_t> unsorted_outputs;
+	map<GraphNode*, vector<GraphNode*> > feeders;
+
+	for (node_list_t::iterator ni = _nodes_rt[chain].begin(); ni != _nodes_rt[chain].end(); ni++) {
+		unsorted_outputs[ni->get()] = (*ni)->_activation_set[chain].size ();
+		for (node_set_t::iterator ai = (*ni)->_activation_set[chain].begin(); ai != (*ni)->_activation_set[chain].end(); ai++) {
+			feeders[ai->get()].push_back (ni->get());
+		}
+		if ((*ni)->_activation_set[chain].empty ()) {
+			_sinks_first[chain].push_back (ni->get ());
+		}
+	}
+
+	for (size_t n = 0; n < _sinks_first[chain].size(); ++n) {
+		vector<GraphNode*> const & f (feeders[_sinks_first[chain][n]]);
+		for (vector<GraphNode*>::const_iterator i = f.begin(); i != f.end(); ++i) {
+			if (--unsorted_outputs[*i] == 0) {
+				_sinks_first[chain].push_back (*i);
+			}
+		}
+	}
+
         _pending_chain = chain;
         dump(chain);
 }
@@ -356,6 +625,10 @@ Graph::run_one()
 {
         GraphNode* to_run;
 
+	if (_work_stealing) {
+		return run_one_stealing (_current_worker.get ());
+	}
+
         pthread_mutex_lock (&_trigger_mutex);
         if (_trigger_queue.size()) {
                 to_run = _trigger_queue.back();
@@ -388,6 +661,10 @@ Graph::run_one()
                 if (!_threads_active) {
                         return true;
                 }
+                if (_work_stealing) {
+                        /* the mode changed while we were asleep */
+                        return false;
+                }
                 DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 is awake\n", pthread_name()));
                 pthread_mutex_lock (&_trigger_mutex);
                 if (_trigger_queue.size()) {
@@ -397,7 +674,9 @@ Graph::run_one()
         }
         pthread_mutex_unlock (&_trigger_mutex);
 
+        const gint64 before = g_get_monotonic_time ();
         to_run->process();
+        to_run->update_dsp_cost (g_get_monotonic_time () - before);
         to_run->finish (_current_chain);
 
         DEBUG_TRACE(DEBUG::ProcessThreads, string_compose ("%1 has finished run_one()\n", pthread_name()));
@@ -405,6 +684,157 @@ Graph::run_one()
         return !_threads_active;
 }
 
+/** Work-stealing version of run_one().
+ *  @return true to quit, false to carry on.
+ */
+bool
+Graph::run_one_stealing (Worker* w)
+{
+	GraphNode* to_run = w->pop ();
+
+	if (!to_run) {
+		to_run = steal (w);
+	}
+
+	while (!to_run) {
+
+		/* nothing ready; keep trying for a little while, since going
+		 * to sleep and being woken up again costs more than most
+		 * nodes take to run.
+		 */
+
+		for (int n = 0; n < steal_attempts && !to_run; ++n) {
+			if (!_threads_active) {
+				return true;
+			}
+			to_run = steal (w);
+		}
+
+		if (to_run) {
+			break;
+		}
+
+		/* announce that we are going to sleep before looking for work
+		 * one last time, so that a thread readying a node either sees
+		 * us asleep (and wakes us), or we see its node.
+		 */
+
+		pthread_mutex_lock (&_trigger_mutex);
+		g_atomic_int_inc (&_execution_tokens);
+
+		if ((to_run = steal (w)) != 0) {
+			g_atomic_int_add (&_execution_tokens, -1);
+			pthread_mutex_unlock (&_trigger_mutex);
+			break;
+		}
+
+		pthread_mutex_unlock (&_trigger_mutex);
+
+		DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 goes to sleep\n", pthread_name()));
+		_execution_sem.wait ();
+
+		if (!_threads_active) {
+			return true;
+		}
+
+		if (!_work_stealing) {
+			return false;
+		}
+
+		if ((to_run = w->pop ()) == 0) {
+			to_run = steal (w);
+		}
+	}
+
+	const gint64 before = g_get_monotonic_time ();
+	to_run->process ();
+	const gint64 elapsed = g_get_monotonic_time () - before;
+	to_run->update_dsp_cost (elapsed);
+	w->busy_usecs += elapsed;
+
+	to_run->finish (_current_chain);
+
+	return !_threads_active;
+}
+
+/** Take a node from another thread's queue, or failing that from the
+ *  overflow queue.
+ */
+GraphNode*
+Graph::steal (Worker* w)
+{
+	const uint32_t n_workers = _workers.size ();
+
+	for (uint32_t n = 1; n < n_workers; ++n) {
+		Worker* victim = _workers[(w->index + n) % n_workers];
+		GraphNode* node = victim->steal ();
+		if (node) {
+			++w->steals;
+			return node;
+		}
+	}
+
+	GraphNode* node = 0;
+
+	if (g_atomic_int_get (&_overflow_count) > 0) {
+		pthread_mutex_lock (&_trigger_mutex);
+		if (!_trigger_queue.empty ()) {
+			node = _trigger_queue.back ();
+			_trigger_queue.pop_back ();
+			g_atomic_int_add (&_overflow_count, -1);
+		}
+		pthread_mutex_unlock (&_trigger_mutex);
+	}
+
+	return node;
+}
+
+/** Called at the end of each work-stealing cycle, by the thread that ran
+ *  the last node.
+ */
+void
+Graph::update_stats ()
+{
+	const gint64 now = g_get_monotonic_time ();
+	const uint32_t n_workers = _workers.size ();
+
+	uint64_t busy = 0;
+	uint64_t steals = 0;
+
+	for (uint32_t n = 0; n < n_workers; ++n) {
+		busy += _workers[n]->busy_usecs;
+		steals += _workers[n]->steals;
+	}
+
+	if (g_atomic_int_compare_and_exchange (&_reset_stats, 1, 0)) {
+		_stats = Stats ();
+	}
+
+	const uint64_t cycle_busy = busy - _stats_busy_usecs;
+	const uint64_t cycle_steals = steals - _stats_steals;
+	const uint64_t available = (now - _cycle_start) * n_workers;
+	const uint64_t idle = available > cycle_busy ? available - cycle_busy : 0;
+
+	_stats_busy_usecs = busy;
+	_stats_steals = steals;
+
+	_stats.cycles += 1;
+	_stats.steals += cycle_steals;
+	_stats.last_steals = cycle_steals;
+	_stats.idle_usecs += idle;
+	_stats.last_idle_usecs = idle;
+	_stats.max_idle_usecs = max (_stats.max_idle_usecs, (uint32_t) idle);
+}
+
+/** Give the calling process thread its work-stealing queue */
+void
+Graph::setup_worker ()
+{
+	const gint n = g_atomic_int_add (&_n_workers, 1);
+	assert (n < (gint) _workers.size());
+	_current_worker.set (_workers[n]);
+}
+
 void
 Graph::helper_thread()
 {
@@ -413,6 +843,7 @@ Graph::helper_thread()
 	resume_rt_malloc_checks ();
 
         pt->get_buffers();
+	setup_worker ();
 
         while(1) {
                 if (run_one()) {
@@ -432,6 +863,7 @@ Graph::main_thread()
 	resume_rt_malloc_checks ();
 
         pt->get_buffers();
+	setup_worker ();
 
   again:
         _callback_start_sem.wait ();
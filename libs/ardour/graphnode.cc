@@ -26,6 +26,8 @@ using namespace ARDOUR;
 
 GraphNode::GraphNode (boost::shared_ptr<Graph> graph)
         : _graph(graph)
+        , _dsp_cost (0)
+        , _priority (0)
 {
 }
 
@@ -40,30 +42,47 @@ GraphNode::prep (int chain)
         _refcount = _init_refcount[chain];
 }
 
-/** Called by another node to tell us that one of the nodes that feed us
- *  has been processed.
- */
-void
-GraphNode::dec_ref()
-{
-        if (g_atomic_int_dec_and_test (&_refcount)) {
-		/* All the nodes that feed us are done, so we can queue this node
-		   for processing.
-		*/
-                _graph->trigger (this);
-	}
-}
-
 void
 GraphNode::finish (int chain)
 {
         node_set_t::iterator i;
         bool feeds_somebody = false;
 
+	/* the nodes that become ready once we are done; they are queued in
+	   order of priority, rather than in the (arbitrary) order of our
+	   activation set.
+	*/
+	static const uint32_t max_ready = 32;
+	GraphNode* ready[max_ready];
+	uint32_t n_ready = 0;
+
 	/* Tell the nodes that we feed that we've finished */
         for (i=_activation_set[chain].begin(); i!=_activation_set[chain].end(); i++) {
-                (*i)->dec_ref();
                 feeds_somebody = true;
+
+                if (!g_atomic_int_dec_and_test (&(*i)->_refcount)) {
+                        continue;
+                }
+
+                if (n_ready == max_ready) {
+                        _graph->trigger (i->get ());
+                        continue;
+                }
+
+                /* insertion sort, lowest priority first */
+                uint32_t n = n_ready++;
+                while (n > 0 && ready[n-1]->_priority > (*i)->_priority) {
+                        ready[n] = ready[n-1];
+                        --n;
+                }
+                ready[n] = i->get ();
+        }
+
+	/* the highest priority node is queued last, so that this thread
+	   runs it next.
+	*/
+        for (uint32_t n = 0; n < n_ready; ++n) {
+                _graph->trigger (ready[n]);
         }
 
         if (!feeds_somebody) {
@@ -78,3 +97,17 @@ GraphNode::process()
 {
         _graph->process_one_route (dynamic_cast<Route *>(this));
 }
+
+void
+GraphNode::update_dsp_cost (gint64 usecs)
+{
+	/* follow increases quickly, so that a route that has just become
+	   expensive (e.g. a plugin was enabled) is prioritized from the next
+	   cycle on, but decay slowly.
+	*/
+	if (usecs > _dsp_cost) {
+		_dsp_cost += (usecs - _dsp_cost) * 0.5f;
+	} else {
+		_dsp_cost += (usecs - _dsp_cost) * 0.05f;
+	}
+}
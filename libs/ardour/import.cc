@@ -291,7 +291,6 @@ write_audio_data_to_new_files (ImportableSource* source, ImportStatus& status,
 	while (!status.cancel) {
 
 		framecnt_t nread, nfread;
-		uint32_t x;
 		uint32_t chn;
 
 		if ((nread = source->read (data.get(), nframes)) == 0) {
@@ -316,11 +315,7 @@ write_audio_data_to_new_files (ImportableSource* source, ImportStatus& status,
 		/* de-interleave */
 
 		for (chn = 0; chn < channels; ++chn) {
-
-			framecnt_t n;
-			for (x = chn, n = 0; n < nfread; x += channels, ++n) {
-				channel_data[chn][n] = (Sample) data[x];
-			}
+			deinterleave (channel_data[chn].get(), data.get(), nfread, chn, channels);
 		}
 
 		/* flush to disk */
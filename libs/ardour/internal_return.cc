@@ -41,11 +41,15 @@ InternalReturn::run (BufferSet& bufs, framepos_t /*start_frame*/, framepos_t /*e
 	Glib::Threads::Mutex::Lock lm (_sends_mutex, Glib::Threads::TRY_LOCK);
 
 	if (lm.locked ()) {
+		_merge_sources.clear ();
 		for (list<InternalSend*>::iterator i = _sends.begin(); i != _sends.end(); ++i) {
 			if ((*i)->active () && (!(*i)->source_route() || (*i)->source_route()->active())) {
-				bufs.merge_from ((*i)->get_buffers(), nframes);
+				_merge_sources.push_back (&(*i)->get_buffers());
 			}
 		}
+		if (!_merge_sources.empty ()) {
+			bufs.merge_from (&_merge_sources[0], _merge_sources.size (), nframes);
+		}
 	}
 
 	_active = _pending_active;
@@ -56,6 +60,7 @@ InternalReturn::add_send (InternalSend* send)
 {
 	Glib::Threads::Mutex::Lock lm (_sends_mutex);
 	_sends.push_back (send);
+	_merge_sources.reserve (_sends.size ());
 }
 
 void
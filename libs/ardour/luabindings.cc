@@ -528,15 +528,15 @@ LuaBindings::common (lua_State* L)
 		//.addFunction ("region_list", &Playlist::region_list) // RegionListProperty&
 		.addFunction ("add_region", &Playlist::add_region)
 		.addFunction ("remove_region", &Playlist::remove_region)
-		.addFunction ("regions_at", &Playlist::regions_at)
+		.addFunction ("regions_at", (boost::shared_ptr<RegionList> (Playlist::*)(framepos_t))&Playlist::regions_at)
 		.addFunction ("top_region_at", &Playlist::top_region_at)
 		.addFunction ("top_unmuted_region_at", &Playlist::top_unmuted_region_at)
 		.addFunction ("find_next_region", &Playlist::find_next_region)
 		.addFunction ("find_next_region_boundary", &Playlist::find_next_region_boundary)
 		.addFunction ("count_regions_at", &Playlist::count_regions_at)
-		.addFunction ("regions_touched", &Playlist::regions_touched)
-		.addFunction ("regions_with_start_within", &Playlist::regions_with_start_within)
-		.addFunction ("regions_with_end_within", &Playlist::regions_with_end_within)
+		.addFunction ("regions_touched", (boost::shared_ptr<RegionList> (Playlist::*)(framepos_t, framepos_t))&Playlist::regions_touched)
+		.addFunction ("regions_with_start_within", (boost::shared_ptr<RegionList> (Playlist::*)(Evoral::Range<framepos_t>))&Playlist::regions_with_start_within)
+		.addFunction ("regions_with_end_within", (boost::shared_ptr<RegionList> (Playlist::*)(Evoral::Range<framepos_t>))&Playlist::regions_with_end_within)
 		.addFunction ("raise_region", &Playlist::raise_region)
 		.addFunction ("lower_region", &Playlist::lower_region)
 		.addFunction ("raise_region_to_top", &Playlist::raise_region_to_top)
@@ -1067,6 +1067,10 @@ LuaBindings::dsp (lua_State* L)
 		.addFunction ("mix_buffers_no_gain", ARDOUR::mix_buffers_no_gain)
 		.addFunction ("mix_buffers_with_gain", ARDOUR::mix_buffers_with_gain)
 		.addFunction ("copy_vector", ARDOUR::copy_vector)
+		.addFunction ("apply_gain_ramp", ARDOUR::apply_gain_ramp)
+		.addFunction ("deinterleave", ARDOUR::deinterleave)
+		.addFunction ("interleave", ARDOUR::interleave)
+		.addFunction ("mix_with_gain_ramp", &DSP::mix_with_gain_ramp)
 		.addFunction ("dB_to_coefficient", &dB_to_coefficient)
 		.addFunction ("fast_coefficient_to_dB", &fast_coefficient_to_dB)
 		.addFunction ("accurate_coefficient_to_dB", &accurate_coefficient_to_dB)
@@ -1087,8 +1091,46 @@ LuaBindings::dsp (lua_State* L)
 		.addConstructor <void (*) (double)> ()
 		.addFunction ("run", &DSP::BiQuad::run)
 		.addFunction ("compute", &DSP::BiQuad::compute)
+		.addFunction ("configure", &DSP::BiQuad::configure)
 		.addFunction ("reset", &DSP::BiQuad::reset)
 		.endClass ()
+		.beginClass <DSP::BiQuadBank> ("BiquadBank")
+		.addConstructor <void (*) (double, uint32_t, uint32_t)> ()
+		.addFunction ("run", &DSP::BiQuadBank::run)
+		.addFunction ("compute", &DSP::BiQuadBank::compute)
+		.addFunction ("reset", &DSP::BiQuadBank::reset)
+		.endClass ()
+		.beginClass <DSP::FIRFilter> ("FIRFilter")
+		.addConstructor <void (*) (uint32_t, uint32_t)> ()
+		.addFunction ("taps", &DSP::FIRFilter::taps)
+		.addFunction ("set_tap", &DSP::FIRFilter::set_tap)
+		.addFunction ("run", &DSP::FIRFilter::run)
+		.addFunction ("reset", &DSP::FIRFilter::reset)
+		.endClass ()
+		.beginClass <DSP::EnvelopeFollower> ("EnvelopeFollower")
+		.addConstructor <void (*) (double, float, float)> ()
+		.addFunction ("set_attack", &DSP::EnvelopeFollower::set_attack)
+		.addFunction ("set_release", &DSP::EnvelopeFollower::set_release)
+		.addFunction ("proc", &DSP::EnvelopeFollower::proc)
+		.addFunction ("run", &DSP::EnvelopeFollower::run)
+		.addFunction ("level", &DSP::EnvelopeFollower::level)
+		.addFunction ("reset", &DSP::EnvelopeFollower::reset)
+		.endClass ()
+		.beginClass <DSP::DelayLine> ("DelayLine")
+		.addConstructor <void (*) (uint32_t)> ()
+		.addFunction ("set_delay", &DSP::DelayLine::set_delay)
+		.addFunction ("run", &DSP::DelayLine::run)
+		.addFunction ("reset", &DSP::DelayLine::reset)
+		.endClass ()
+		.beginClass <DSP::FFTSpectrum> ("FFTSpectrum")
+		.addConstructor <void (*) (uint32_t, double)> ()
+		.addFunction ("set_data_hann", &DSP::FFTSpectrum::set_data_hann)
+		.addFunction ("execute", &DSP::FFTSpectrum::execute)
+		.addFunction ("bins", &DSP::FFTSpectrum::bins)
+		.addFunction ("freq_at_bin", &DSP::FFTSpectrum::freq_at_bin)
+		.addFunction ("magnitude_at_bin", &DSP::FFTSpectrum::magnitude_at_bin)
+		.addFunction ("power_at_bin", &DSP::FFTSpectrum::power_at_bin)
+		.endClass ()
 
 		/* DSP enums */
 		.beginNamespace ("BiQuadType")
@@ -48,6 +48,8 @@ LuaProc::LuaProc (AudioEngine& engine,
 	, _script (script)
 	, _lua_does_channelmapping (false)
 	, _lua_has_inline_display (false)
+	, _lua_automation_vectors (false)
+	, _lua_ctrl_vectors (0)
 	, _control_data (0)
 	, _shadow_data (0)
 	, _has_midi_input (false)
@@ -71,6 +73,8 @@ LuaProc::LuaProc (const LuaProc &other)
 	, _script (other.script ())
 	, _lua_does_channelmapping (false)
 	, _lua_has_inline_display (false)
+	, _lua_automation_vectors (false)
+	, _lua_ctrl_vectors (0)
 	, _control_data (0)
 	, _shadow_data (0)
 	, _has_midi_input (false)
@@ -102,6 +106,7 @@ LuaProc::~LuaProc () {
 	}
 #endif
 	lua.do_command ("collectgarbage();");
+	delete (_lua_ctrl_vectors);
 	delete (_lua_dsp);
 	delete [] _control_data;
 	delete [] _shadow_data;
@@ -219,6 +224,15 @@ LuaProc::load_script ()
 	}
 	lpi->_is_instrument = _has_midi_input;
 
+	luabridge::LuaRef lua_dsp_auto_vec = luabridge::getGlobal (L, "dsp_automation_vectors");
+	if (lua_dsp_auto_vec.type () == LUA_TFUNCTION) {
+		try {
+			_lua_automation_vectors = lua_dsp_auto_vec ();
+		} catch (luabridge::LuaException const& e) {
+			;
+		}
+	}
+
 	_ctrl_params.clear ();
 
 	luabridge::LuaRef lua_render = luabridge::getGlobal (L, "render_inline");
@@ -573,6 +587,15 @@ LuaProc::configure_io (ChanCount in, ChanCount out)
 		}
 	}
 
+	if (_lua_automation_vectors && !_lua_ctrl_vectors) {
+		/* created once, and only refilled by connect_and_run() */
+		_lua_ctrl_vectors = new luabridge::LuaRef (luabridge::newTable (L));
+		luabridge::push (L, *_lua_ctrl_vectors);
+		lua_setglobal (L, "CtrlVectors");
+		_ctrl_vectors.assign (parameter_count (), (float const*) 0);
+		_ctrl_vectors_next.assign (parameter_count (), (float const*) 0);
+	}
+
 	_info->n_inputs = _configured_in;
 	_info->n_outputs = _configured_out;
 	return true;
@@ -605,6 +628,33 @@ LuaProc::connect_and_run (BufferSet& bufs,
 		}
 	}
 
+	if (_lua_ctrl_vectors) {
+		/* CtrlVectors[n] is the value of automated parameter n for
+		 * every sample of this cycle, or nil (use CtrlPorts).
+		 * The vectors rarely move, so only entries that differ from
+		 * the last cycle are set.
+		 */
+		std::fill (_ctrl_vectors_next.begin (), _ctrl_vectors_next.end (), (float const*) 0);
+		if (_automation_vectors) {
+			for (AutomationVectors::const_iterator v = _automation_vectors->begin (); v != _automation_vectors->end (); ++v) {
+				if (v->port < _ctrl_vectors_next.size ()) {
+					_ctrl_vectors_next[v->port] = v->values;
+				}
+			}
+		}
+		for (uint32_t p = 0; p < _ctrl_vectors.size (); ++p) {
+			if (_ctrl_vectors_next[p] == _ctrl_vectors[p]) {
+				continue;
+			}
+			if (_ctrl_vectors_next[p]) {
+				(*_lua_ctrl_vectors)[p + 1] = const_cast<float*> (_ctrl_vectors_next[p]);
+			} else {
+				(*_lua_ctrl_vectors)[p + 1] = luabridge::Nil ();
+			}
+			_ctrl_vectors[p] = _ctrl_vectors_next[p];
+		}
+	}
+
 #ifdef WITH_LUAPROC_STATS
 	int64_t t0 = g_get_monotonic_time ();
 #endif
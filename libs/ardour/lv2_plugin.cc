@@ -43,6 +43,7 @@
 #include "ardour/audioengine.h"
 #include "ardour/debug.h"
 #include "ardour/lv2_plugin.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/session.h"
 #include "ardour/tempo.h"
 #include "ardour/types.h"
@@ -171,6 +172,7 @@ public:
 #ifdef LV2_EXTENDED
 	LilvNode* lv2_noSampleAccurateCtrl;
 	LilvNode* auto_can_write_automatation; // lv2:optionalFeature
+	LilvNode* auto_can_read_automation; // lv2:optionalFeature
 	LilvNode* auto_automation_control; // atom:supports
 	LilvNode* auto_automation_controlled; // lv2:portProperty
 #endif
@@ -365,6 +367,10 @@ LV2Plugin::init(const void* c_plugin, framecnt_t rate)
 	_was_activated          = false;
 	_has_state_interface    = false;
 	_can_write_automation   = false;
+	_can_read_automation    = false;
+	_auto_ctrl_port_in_index = (uint32_t)-1;
+	_auto_ctrl_atom_buf_index = 0;
+	_auto_event_grid        = 1;
 	_max_latency            = 0;
 	_current_latency        = 0;
 	_impl->block_length     = _session.get_block_size();
@@ -542,6 +548,9 @@ LV2Plugin::init(const void* c_plugin, framecnt_t rate)
 	if (lilv_nodes_contains (optional_features, _world.auto_can_write_automatation)) {
 		_can_write_automation = true;
 	}
+	if (lilv_nodes_contains (optional_features, _world.auto_can_read_automation)) {
+		_can_read_automation = true;
+	}
 	lilv_nodes_free(optional_features);
 #endif
 
@@ -630,12 +639,27 @@ LV2Plugin::init(const void* c_plugin, framecnt_t rate)
 				flags |= PORT_CTRLED;
 			}
 		}
+		if ((flags & PORT_AUTOCTRL) && (flags & PORT_INPUT) && !(flags & (PORT_MIDI|PORT_POSITION))) {
+			_auto_ctrl_port_in_index = i;
+		}
 #endif
 
 		_port_flags.push_back(flags);
 		_port_minimumSize.push_back(minimumSize);
 	}
 
+#ifdef LV2_EXTENDED
+	/* connect_and_run() hands out _atom_ev_buffers to the position inputs
+	 * and the automation control input, in port order.
+	 */
+	for (uint32_t i = 0; i < num_ports && i < _auto_ctrl_port_in_index; ++i) {
+		const PortFlags flags = _port_flags[i];
+		if ((flags & (PORT_EVENT|PORT_SEQUENCE)) && !(flags & PORT_MIDI) && (flags & PORT_POSITION) && (flags & PORT_INPUT)) {
+			++_auto_ctrl_atom_buf_index;
+		}
+	}
+#endif
+
 	_control_data = new float[num_ports];
 	_shadow_data  = new float[num_ports];
 	_defaults     = new float[num_ports];
@@ -789,6 +813,20 @@ LV2Plugin::requires_fixed_sized_buffers () const
 	return _no_sample_accurate_ctrl;
 }
 
+bool
+LV2Plugin::sample_accurate_automation () const
+{
+	/* Plugins that ask for it (auto:canReadAutomation) get the automation
+	 * of their automationControlled ports as auto:event messages on their
+	 * auto:automationControl input, so the process cycle need not be split.
+	 */
+#ifdef LV2_EXTENDED
+	return _can_read_automation && _auto_ctrl_port_in_index != (uint32_t)-1;
+#else
+	return false;
+#endif
+}
+
 LV2Plugin::~LV2Plugin ()
 {
 	DEBUG_TRACE(DEBUG::LV2, string_compose("%1 destroy\n", name()));
@@ -2214,6 +2252,112 @@ write_position(LV2_Atom_Forge*     forge,
 	                       (const uint8_t*)(atom + 1));
 }
 
+#ifdef LV2_EXTENDED
+/** Forge a control port value change as an auto:event message in ev_buf.
+ * @return the message.
+ */
+static const LV2_Atom*
+forge_automation_event(LV2_Atom_Forge* forge,
+                       uint8_t*        ev_buf,
+                       size_t          size,
+                       uint32_t        port,
+                       float           value)
+{
+	const URIMap::URIDs& urids = URIMap::instance().urids;
+
+	lv2_atom_forge_set_buffer(forge, ev_buf, size);
+	LV2_Atom_Forge_Frame frame;
+#ifdef HAVE_LV2_1_10_0
+	lv2_atom_forge_object(forge, &frame, 1, urids.auto_event);
+	lv2_atom_forge_key(forge, urids.auto_parameter);
+	lv2_atom_forge_int(forge, port);
+	lv2_atom_forge_key(forge, urids.auto_value);
+	lv2_atom_forge_float(forge, value);
+#else
+	lv2_atom_forge_blank(forge, &frame, 1, urids.auto_event);
+	lv2_atom_forge_property_head(forge, urids.auto_parameter, 0);
+	lv2_atom_forge_int(forge, port);
+	lv2_atom_forge_property_head(forge, urids.auto_value, 0);
+	lv2_atom_forge_float(forge, value);
+#endif
+
+	return (const LV2_Atom*)ev_buf;
+}
+
+/** Write the changes of automationControlled ports in @param av as
+ * auto:event messages to @param buf, in time order, one per port and
+ * grid point at most. With no buffer, only count them.
+ * @return the number of messages.
+ */
+uint32_t
+LV2Plugin::write_automation_events (AutomationVectors const& av, pframes_t nframes, LV2_Evbuf* buf)
+{
+	const uint32_t num_ports = this->num_ports();
+	const pframes_t grid = _auto_event_grid;
+	uint32_t cnt = 0;
+
+	/* the control ports hold the values at frame 0, and each event
+	 * carries the value up to the next grid point.
+	 */
+	for (pframes_t n = grid; n < nframes; n += grid) {
+		for (AutomationVectors::const_iterator v = av.begin(); v != av.end(); ++v) {
+			if (v->port >= num_ports || !(_port_flags[v->port] & PORT_CTRLED)) {
+				continue;
+			}
+			if (v->values[n] == v->values[n - grid]) {
+				continue;
+			}
+			++cnt;
+			if (!buf) {
+				continue;
+			}
+			uint8_t ev_buf[64];
+			const LV2_Atom* atom = forge_automation_event(&_impl->forge, ev_buf, sizeof(ev_buf), v->port, v->values[n]);
+			LV2_Evbuf_Iterator end = lv2_evbuf_end(buf);
+			if (!lv2_evbuf_write(&end, n, 0, atom->type, atom->size, (const uint8_t*)(atom + 1))) {
+				/* prepare_automation_vectors() made sure this fits */
+				return cnt;
+			}
+		}
+	}
+	return cnt;
+}
+#endif
+
+bool
+LV2Plugin::prepare_automation_vectors (AutomationVectors const& av, pframes_t nframes)
+{
+#ifdef LV2_EXTENDED
+	if (_auto_ctrl_port_in_index == (uint32_t)-1 || !_atom_ev_buffers) {
+		return false;
+	}
+
+	/* the buffer that connect_and_run() will fill */
+	LV2_Evbuf* const auto_buf = _atom_ev_buffers[_auto_ctrl_atom_buf_index];
+
+	if (!auto_buf) {
+		return false;
+	}
+
+	/* changes between grid points take effect at the next one, as they
+	 * would if the cycle were split.
+	 */
+	_auto_event_grid = max ((framecnt_t) 1, (framecnt_t) Config->get_plugin_automation_grid ());
+
+	/* all events are the same size; rather than drop any, let the cycle
+	 * be split if they do not fit.
+	 */
+	uint8_t ev_buf[64];
+	const LV2_Atom* atom = forge_automation_event (&_impl->forge, ev_buf, sizeof (ev_buf), 0, 0.f);
+	const uint32_t ev_size = lv2_atom_pad_size (sizeof (LV2_Atom_Event) + atom->size);
+	const uint32_t space = lv2_evbuf_get_capacity (auto_buf) - sizeof (LV2_Atom_Sequence);
+
+	return write_automation_events (av, nframes, 0) <= space / ev_size;
+#else
+	return false;
+#endif
+}
+
 int
 LV2Plugin::connect_and_run(BufferSet& bufs,
 	ChanMapping in_map, ChanMapping out_map,
@@ -2301,6 +2445,19 @@ LV2Plugin::connect_and_run(BufferSet& bufs,
 				_ev_buffers[port_index] = _atom_ev_buffers[atom_port_index++];
 				valid                   = true;
 			}
+#ifdef LV2_EXTENDED
+			else if (port_index == _auto_ctrl_port_in_index) {
+				assert (atom_port_index == _auto_ctrl_atom_buf_index);
+				lv2_evbuf_reset(_atom_ev_buffers[atom_port_index], true);
+				_ev_buffers[port_index] = _atom_ev_buffers[atom_port_index++];
+				if (_automation_vectors) {
+					write_automation_events (*_automation_vectors, nframes, _ev_buffers[port_index]);
+				}
+				lilv_instance_connect_port(_impl->instance, port_index,
+				                           lv2_evbuf_get_buffer(_ev_buffers[port_index]));
+				continue;
+			}
+#endif
 
 			if (valid && (flags & PORT_INPUT)) {
 				Timecode::BBT_Time bbt;
@@ -2777,6 +2934,7 @@ LV2World::LV2World()
 #ifdef LV2_EXTENDED
 	lv2_noSampleAccurateCtrl    = lilv_new_uri(world, LV2_CORE_PREFIX "noSampleAccurateControls");
 	auto_can_write_automatation = lilv_new_uri(world, LV2_AUTOMATE_URI__can_write);
+	auto_can_read_automation    = lilv_new_uri(world, LV2_AUTOMATE_URI__can_read);
 	auto_automation_control     = lilv_new_uri(world, LV2_AUTOMATE_URI__control);
 	auto_automation_controlled  = lilv_new_uri(world, LV2_AUTOMATE_URI__controlled);
 #endif
@@ -2801,6 +2959,7 @@ LV2World::~LV2World()
 #ifdef LV2_EXTENDED
 	lilv_node_free(lv2_noSampleAccurateCtrl);
 	lilv_node_free(auto_can_write_automatation);
+	lilv_node_free(auto_can_read_automation);
 	lilv_node_free(auto_automation_control);
 	lilv_node_free(auto_automation_controlled);
 #endif
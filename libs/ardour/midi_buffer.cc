@@ -409,6 +409,109 @@ MidiBuffer::second_simultaneous_midi_byte_is_first (uint8_t a, uint8_t b)
 	return b_first;
 }
 
+/** Merge the \a n_others buffers in \a others into this buffer in a single
+ * pass, rather than one at a time.  Realtime safe.
+ *
+ * Our own events are moved to the end of the buffer, then the next event of
+ * all sources is written to the front until they are all used up. The output
+ * cannot overtake our own remaining events as long as everything fits, so no
+ * event is moved more than twice however many sources there are.
+ *
+ * Simultaneous events are ordered by second_simultaneous_midi_byte_is_first(),
+ * as in merge_in_place(); otherwise earlier sources come first.
+ */
+bool
+MidiBuffer::merge_in_place (const MidiBuffer* const* others, uint32_t n_others)
+{
+	static const uint32_t max_sources = 32;
+
+	if (n_others >= max_sources) {
+		return merge_in_place (others, max_sources - 1)
+			&& merge_in_place (others + max_sources - 1, n_others - max_sources + 1);
+	}
+
+	const uint8_t* src[max_sources];
+	size_t         len[max_sources];
+	size_t         pos[max_sources];
+	uint32_t       n_src = 0;
+	size_t         total = _size;
+
+	for (uint32_t i = 0; i < n_others; ++i) {
+		assert (others[i] != this);
+		total += others[i]->size();
+	}
+
+	if (total == _size) {
+		return true;
+	}
+
+	if (total > _capacity) {
+		return false;
+	}
+
+	DEBUG_TRACE (DEBUG::MidiIO, string_compose ("merge %1 buffers in place, sizes %2/%3\n", n_others, size(), total - size()));
+
+	if (_size) {
+		memmove (_data + _capacity - _size, _data, _size);
+		src[n_src] = _data + _capacity - _size;
+		len[n_src] = _size;
+		pos[n_src] = 0;
+		++n_src;
+	}
+
+	for (uint32_t i = 0; i < n_others; ++i) {
+		if (others[i]->size()) {
+			src[n_src] = others[i]->_data;
+			len[n_src] = others[i]->size();
+			pos[n_src] = 0;
+			++n_src;
+		}
+	}
+
+	size_t out = 0;
+
+	while (true) {
+		int      next = -1;
+		TimeType next_time = 0;
+		uint8_t  next_status = 0;
+
+		for (uint32_t s = 0; s < n_src; ++s) {
+			if (pos[s] == len[s]) {
+				continue;
+			}
+			const uint8_t* ev = src[s] + pos[s];
+			const TimeType t = *(reinterpret_cast<const TimeType*>((uintptr_t)ev));
+			const uint8_t status = ev[sizeof (TimeType)];
+
+			if (next < 0 || t < next_time || (t == next_time && second_simultaneous_midi_byte_is_first (next_status, status))) {
+				next = s;
+				next_time = t;
+				next_status = status;
+			}
+		}
+
+		if (next < 0) {
+			break;
+		}
+
+		const uint8_t* ev = src[next] + pos[next];
+		const int event_size = Evoral::midi_event_size (ev + sizeof (TimeType));
+		assert (event_size >= 0);
+		const size_t bytes = sizeof (TimeType) + event_size;
+
+		/* may overlap with our own events, which are always ahead */
+		memmove (_data + out, ev, bytes);
+
+		out += bytes;
+		pos[next] += bytes;
+	}
+
+	_size = out;
+	_silent = false;
+
+	return true;
+}
+
 /** Merge \a other into this buffer.  Realtime safe. */
 bool
 MidiBuffer::merge_in_place (const MidiBuffer &other)
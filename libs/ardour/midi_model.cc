@@ -20,6 +20,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <map>
 #include <set>
 #include <stdexcept>
 #include <stdint.h>
@@ -236,6 +237,63 @@ MidiModel::NoteDiffCommand::operator+= (const NoteDiffCommand& other)
 	return *this;
 }
 
+/* approximate size of a note we hold a reference to, with its shared_ptr
+   control block and the buffers of its on and off events
+*/
+static const size_t note_size = sizeof (Evoral::Note<MidiModel::TimeType>) + 4 * sizeof (void*) + 2 * 3;
+
+size_t
+MidiModel::NoteDiffCommand::memory_size () const
+{
+	/* list nodes hold two links besides their value, set nodes three and a colour */
+	const size_t list_node = 2 * sizeof (void*);
+	const size_t set_node = 4 * sizeof (void*);
+
+	size_t sz = DiffCommand::memory_size () + sizeof (*this) - sizeof (DiffCommand);
+
+	sz += _changes.size () * (list_node + sizeof (NoteChange));
+	sz += (_added_notes.size () + _removed_notes.size ()) * (list_node + sizeof (NotePtr) + note_size);
+	sz += side_effect_removals.size () * (set_node + sizeof (NotePtr) + note_size);
+
+	return sz;
+}
+
+/** Merge changes to the same property of the same note into one, from the
+ *  first old value to the last new value, and drop those which end where
+ *  they started. Changes to different notes or properties are independent,
+ *  so this only makes the command smaller; neither operator() nor undo()
+ *  does anything different.
+ */
+void
+MidiModel::NoteDiffCommand::compact ()
+{
+	typedef std::map<std::pair<NotePtr, Property>, ChangeList::iterator> FirstChanges;
+	FirstChanges first;
+
+	for (ChangeList::iterator i = _changes.begin(); i != _changes.end(); ) {
+		if (!i->note) {
+			/* not yet found after loading history; leave it be */
+			++i;
+			continue;
+		}
+
+		std::pair<FirstChanges::iterator, bool> f = first.insert (make_pair (make_pair (i->note, i->property), i));
+
+		if (f.second) {
+			++i;
+		} else {
+			f.first->second->new_value = i->new_value;
+			i = _changes.erase (i);
+		}
+	}
+
+	for (FirstChanges::iterator f = first.begin(); f != first.end(); ++f) {
+		if (f->second->old_value == f->second->new_value) {
+			_changes.erase (f->second);
+		}
+	}
+}
+
 void
 MidiModel::NoteDiffCommand::operator() ()
 {
@@ -365,7 +423,12 @@ MidiModel::NoteDiffCommand::undo ()
 			}
 		}
 
-		for (ChangeList::iterator i = _changes.begin(); i != _changes.end(); ++i) {
+		/* undo the changes in the reverse order to that in which they were
+		 * made, so that when one property of a note was changed more than
+		 * once, it ends up with the old value of its first change.
+		 */
+
+		for (ChangeList::reverse_iterator i = _changes.rbegin(); i != _changes.rend(); ++i) {
 			Property prop = i->property;
 
 			switch (prop) {
@@ -777,6 +840,23 @@ MidiModel::SysExDiffCommand::change (boost::shared_ptr<Evoral::Event<TimeType> >
 	_changes.push_back (change);
 }
 
+size_t
+MidiModel::SysExDiffCommand::memory_size () const
+{
+	const size_t list_node = 2 * sizeof (void*);
+
+	size_t sz = DiffCommand::memory_size () + sizeof (*this) - sizeof (DiffCommand);
+
+	sz += _changes.size () * (list_node + sizeof (Change));
+
+	/* removed sys-exes are kept alive by us alone */
+	for (list<SysExPtr>::const_iterator i = _removed.begin(); i != _removed.end(); ++i) {
+		sz += list_node + sizeof (SysExPtr) + sizeof (Evoral::Event<TimeType>) + (*i)->size ();
+	}
+
+	return sz;
+}
+
 void
 MidiModel::SysExDiffCommand::operator() ()
 {
@@ -826,7 +906,9 @@ MidiModel::SysExDiffCommand::undo ()
 			}
 		}
 
-		for (ChangeList::iterator i = _changes.begin(); i != _changes.end(); ++i) {
+		/* last change first, as for notes */
+
+		for (ChangeList::reverse_iterator i = _changes.rbegin(); i != _changes.rend(); ++i) {
 			switch (i->property) {
 			case Time:
 				i->sysex->set_time (i->old_time);
@@ -1032,6 +1114,20 @@ MidiModel::PatchChangeDiffCommand::change_bank (PatchChangePtr patch, int bank)
 	_changes.push_back (c);
 }
 
+size_t
+MidiModel::PatchChangeDiffCommand::memory_size () const
+{
+	const size_t list_node = 2 * sizeof (void*);
+	const size_t patch_change = list_node + sizeof (PatchChangePtr) + sizeof (Evoral::PatchChange<TimeType>);
+
+	size_t sz = DiffCommand::memory_size () + sizeof (*this) - sizeof (DiffCommand);
+
+	sz += _changes.size () * (list_node + sizeof (Change));
+	sz += (_added.size () + _removed.size ()) * patch_change;
+
+	return sz;
+}
+
 void
 MidiModel::PatchChangeDiffCommand::operator() ()
 {
@@ -1114,7 +1210,9 @@ MidiModel::PatchChangeDiffCommand::undo ()
 
 		set<PatchChangePtr> temporary_removals;
 
-		for (ChangeList::iterator i = _changes.begin(); i != _changes.end(); ++i) {
+		/* last change first, as for notes */
+
+		for (ChangeList::reverse_iterator i = _changes.rbegin(); i != _changes.rend(); ++i) {
 			switch (i->property) {
 			case Time:
 				if (temporary_removals.find (i->patch) == temporary_removals.end()) {
@@ -23,11 +23,11 @@
 #include <iostream>
 #include <utility>
 
-#include "evoral/EventList.hpp"
 #include "evoral/Control.hpp"
 
 #include "ardour/beats_frames_converter.h"
 #include "ardour/debug.h"
+#include "ardour/midi_buffer.h"
 #include "ardour/midi_model.h"
 #include "ardour/midi_playlist.h"
 #include "ardour/midi_region.h"
@@ -73,6 +73,10 @@ MidiPlaylist::MidiPlaylist (boost::shared_ptr<const MidiPlaylist> other, string
 	, _note_mode(other->_note_mode)
 	, _read_end(0)
 {
+	/* regions were added by the Playlist constructor, before region_added() was ours */
+	for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
+		add_tracker (i->get());
+	}
 }
 
 MidiPlaylist::MidiPlaylist (boost::shared_ptr<const MidiPlaylist> other,
@@ -84,27 +88,88 @@ MidiPlaylist::MidiPlaylist (boost::shared_ptr<const MidiPlaylist> other,
 	, _note_mode(other->_note_mode)
 	, _read_end(0)
 {
+	for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
+		add_tracker (i->get());
+	}
 }
 
 MidiPlaylist::~MidiPlaylist ()
 {
 }
 
-template<typename Time>
-struct EventsSortByTimeAndType {
-    bool operator() (Evoral::Event<Time>* a, Evoral::Event<Time>* b) {
-	    if (a->time() == b->time()) {
-		    if (parameter_is_midi ((AutomationType)a->event_type()) &&
-		        parameter_is_midi ((AutomationType)b->event_type())) {
-			    /* negate return value since we must return whether
-			     * or not a should sort before b, not b before a
-			     */
-			    return !MidiBuffer::second_simultaneous_midi_byte_is_first (a->buffer()[0], b->buffer()[0]);
-		    }
-	    }
-	    return a->time() < b->time();
-    }
-};
+/** @return true if the event at `a' must be played before the one at `b'.
+ *
+ * Simultaneous MIDI events are ordered by type (see
+ * MidiBuffer::second_simultaneous_midi_byte_is_first()), anything else that
+ * ties keeps the order it was read in.
+ */
+bool
+MidiPlaylist::ReadStream::before (ReadStream const & sa, Entry const & a, ReadStream const & sb, Entry const & b)
+{
+	if (a.time != b.time) {
+		return a.time < b.time;
+	}
+	if (parameter_is_midi ((AutomationType) a.type) &&
+	    parameter_is_midi ((AutomationType) b.type)) {
+		return MidiBuffer::second_simultaneous_midi_byte_is_first (sb.data[b.offset], sa.data[a.offset]);
+	}
+	return false;
+}
+
+uint32_t
+MidiPlaylist::ReadStream::write (framepos_t time, Evoral::EventType type, uint32_t size, const uint8_t* buf)
+{
+	if (size == 0) {
+		return 0;
+	}
+
+	Entry e;
+	e.time   = time;
+	e.type   = type;
+	e.offset = data.size ();
+	e.size   = size;
+
+	data.insert (data.end (), buf, buf + size);
+
+	if (sorted && !events.empty () && before (*this, e, *this, events.back ())) {
+		sorted = false;
+	}
+
+	events.push_back (e);
+	return size;
+}
+
+void
+MidiPlaylist::ReadStream::clear ()
+{
+	events.clear ();
+	data.clear ();
+	next   = 0;
+	sorted = true;
+}
+
+void
+MidiPlaylist::ReadStream::sort ()
+{
+	if (sorted) {
+		return;
+	}
+
+	/* Regions produce their events in order, apart from the odd stray from
+	   note resolution, so a (stable, non-allocating) insertion sort is all
+	   that is needed here. */
+	for (size_t i = 1; i < events.size (); ++i) {
+		const Entry e = events[i];
+		size_t      j = i;
+		while (j > 0 && before (*this, e, *this, events[j - 1])) {
+			events[j] = events[j - 1];
+			--j;
+		}
+		events[j] = e;
+	}
+
+	sorted = true;
+}
 
 framecnt_t
 MidiPlaylist::read (Evoral::EventSink<framepos_t>& dst,
@@ -113,9 +178,8 @@ MidiPlaylist::read (Evoral::EventSink<framepos_t>& dst,
                     unsigned                       chan_n,
                     MidiChannelFilter*             filter)
 {
-	typedef pair<MidiStateTracker*,framepos_t> TrackerInfo;
-
 	Playlist::RegionReadLock rl (this);
+	Glib::Threads::Mutex::Lock lm (_read_mutex);
 
 	DEBUG_TRACE (DEBUG::MidiPlaylistIO,
 	             string_compose ("---- MidiPlaylist::read %1 .. %2 (%3 trackers) ----\n",
@@ -123,109 +187,113 @@ MidiPlaylist::read (Evoral::EventSink<framepos_t>& dst,
 
 	/* First, emit any queued edit fixup events at start. */
 	for (NoteTrackers::iterator t = _note_trackers.begin(); t != _note_trackers.end(); ++t) {
-		t->second->fixer.emit(dst, _read_end, t->second->tracker);
+		if (t->second->active) {
+			t->second->fixer.emit(dst, _read_end, t->second->tracker);
+		}
 	}
 
 	/* Find relevant regions that overlap [start..end] */
-	const framepos_t                         end = start + dur - 1;
-	std::vector< boost::shared_ptr<Region> > regs;
-	std::vector< boost::shared_ptr<Region> > ended;
-	for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
-		switch ((*i)->coverage (start, end)) {
-		case Evoral::OverlapStart:
-		case Evoral::OverlapInternal:
-			regs.push_back (*i);
-			break;
-
-		case Evoral::OverlapExternal:
-			/* this region is entirely contained in the read range */
-			regs.push_back (*i);
-			ended.push_back (*i);
-			break;
-
-		case Evoral::OverlapEnd:
-			/* this region ends within the read range */
-			regs.push_back (*i);
-			ended.push_back (*i);
-			break;
-
-		default:
-			/* we don't care */
-			break;
-		}
-	}
+	const framepos_t end = start + dur - 1;
 
-	/* If we are reading from a single region, we can read directly into dst.  Otherwise,
-	   we read into a temporarily list, sort it, then write that to dst. */
-	const bool direct_read = regs.size() == 1 &&
-		(ended.empty() || (ended.size() == 1 && ended.front() == regs.front()));
+	_read_regions.clear ();
+	regions_touched_locked (start, end, _read_regions);
 
-	Evoral::EventList<framepos_t>  evlist;
-	Evoral::EventSink<framepos_t>& tgt = direct_read ? dst : evlist;
+	if (_read_streams.size() < _read_regions.size()) {
+		/* only happens when more regions overlap than ever did before */
+		_read_streams.resize (_read_regions.size());
+	}
+
+	/* If we are reading from a single region, we can read directly into
+	   dst.  Otherwise each region is read into its own stream, and the
+	   streams are merged into dst. */
+	const bool direct_read = _read_regions.size() == 1;
 
 	DEBUG_TRACE (DEBUG::MidiPlaylistIO,
-	             string_compose ("\t%1 regions to read, direct: %2\n", regs.size(), direct_read));
+	             string_compose ("\t%1 regions to read, direct: %2\n", _read_regions.size(), direct_read));
+
+	size_t n_streams = 0;
 
-	for (vector<boost::shared_ptr<Region> >::iterator i = regs.begin(); i != regs.end(); ++i) {
+	for (vector<boost::shared_ptr<Region> >::iterator i = _read_regions.begin(); i != _read_regions.end(); ++i) {
 		boost::shared_ptr<MidiRegion> mr = boost::dynamic_pointer_cast<MidiRegion>(*i);
 		if (!mr) {
 			continue;
 		}
 
-		/* Get the existing note tracker for this region, or create a new one. */
-		NoteTrackers::iterator           t           = _note_trackers.find (mr.get());
-		bool                             new_tracker = false;
-		boost::shared_ptr<RegionTracker> tracker;
+		NoteTrackers::iterator t = _note_trackers.find (mr.get());
 		if (t == _note_trackers.end()) {
-			tracker     = boost::shared_ptr<RegionTracker>(new RegionTracker);
-			new_tracker = true;
+			/* region_added() should have seen to this */
+			add_tracker (mr.get());
+			t = _note_trackers.find (mr.get());
+		}
+
+		RegionTracker& tracker (*t->second);
+
+		if (!tracker.active) {
+			tracker.reset ();
+			tracker.active = true;
 			DEBUG_TRACE (DEBUG::MidiPlaylistIO,
 			             string_compose ("\tPre-read %1 (%2 .. %3): new tracker\n",
 			                             mr->name(), mr->position(), mr->last_frame()));
 		} else {
-			tracker = t->second;
 			DEBUG_TRACE (DEBUG::MidiPlaylistIO,
 			             string_compose ("\tPre-read %1 (%2 .. %3): %4 active notes\n",
-			                             mr->name(), mr->position(), mr->last_frame(), tracker->tracker.on()));
+			                             mr->name(), mr->position(), mr->last_frame(), tracker.tracker.on()));
+		}
+
+		ReadStream* stream = 0;
+
+		if (!direct_read) {
+			stream = &_read_streams[n_streams++];
+			stream->clear ();
 		}
 
+		Evoral::EventSink<framepos_t>& tgt = direct_read ? dst : *stream;
+
 		/* Read from region into target. */
-		mr->read_at (tgt, start, dur, chan_n, _note_mode, &tracker->tracker, filter);
+		mr->read_at (tgt, start, dur, chan_n, _note_mode, &tracker.tracker, filter);
 		DEBUG_TRACE (DEBUG::MidiPlaylistIO,
-		             string_compose ("\tPost-read: %1 active notes\n", tracker->tracker.on()));
+		             string_compose ("\tPost-read: %1 active notes\n", tracker.tracker.on()));
 
-		if (find (ended.begin(), ended.end(), *i) != ended.end()) {
+		if (mr->last_frame() <= end) {
 			/* Region ended within the read range, so resolve any active notes
 			   (either stuck notes in the data, or notes that end after the end
 			   of the region). */
 			DEBUG_TRACE (DEBUG::MidiPlaylistIO,
-			             string_compose ("\t%1 ended, resolve notes and delete (%2) tracker\n",
-			                             mr->name(), ((new_tracker) ? "new" : "old")));
-
-			tracker->tracker.resolve_notes (tgt, (*i)->last_frame());
-			if (!new_tracker) {
-				_note_trackers.erase (t);
-			}
+			             string_compose ("\t%1 ended, resolve notes and reset tracker\n", mr->name()));
 
-		} else {
+			tracker.tracker.resolve_notes (tgt, mr->last_frame());
+			tracker.reset ();
+		}
 
-			if (new_tracker) {
-				_note_trackers.insert (make_pair (mr.get(), tracker));
-				DEBUG_TRACE (DEBUG::MidiPlaylistIO, "\tadded tracker to trackers\n");
-			}
+		if (stream) {
+			stream->sort ();
 		}
 	}
 
-	if (!direct_read && !evlist.empty()) {
-		/* We've read from multiple regions, sort the event list by time. */
-		EventsSortByTimeAndType<framepos_t> cmp;
-		evlist.sort (cmp);
+	if (n_streams > 0) {
+		/* Each stream is in time order, so merge them into dst by
+		   repeatedly taking the earliest head.  There are rarely more than
+		   a handful of overlapping regions, so a linear scan of the heads
+		   beats maintaining a heap. */
+		while (true) {
+			ReadStream* best = 0;
+
+			for (size_t s = 0; s < n_streams; ++s) {
+				ReadStream& rs (_read_streams[s]);
+				if (rs.done()) {
+					continue;
+				}
+				if (!best || ReadStream::before (rs, rs.events[rs.next], *best, best->events[best->next])) {
+					best = &rs;
+				}
+			}
 
-		/* Copy ordered events from event list to dst. */
-		for (Evoral::EventList<framepos_t>::iterator e = evlist.begin(); e != evlist.end(); ++e) {
-			Evoral::Event<framepos_t>* ev (*e);
-			dst.write (ev->time(), ev->event_type(), ev->size(), ev->buffer());
-			delete ev;
+			if (!best) {
+				break;
+			}
+
+			ReadStream::Entry const & e (best->events[best->next++]);
+			dst.write (e.time, e.type, e.size, &best->data[e.offset]);
 		}
 	}
 
@@ -249,7 +317,7 @@ MidiPlaylist::region_edited(boost::shared_ptr<Region>         region,
 	Playlist::RegionWriteLock lock(this);
 
 	NoteTrackers::iterator t = _note_trackers.find(mr.get());
-	if (t == _note_trackers.end()) {
+	if (t == _note_trackers.end() || !t->second->active) {
 		return; /* Region is not currently active, nothing to do. */
 	}
 
@@ -265,7 +333,9 @@ MidiPlaylist::reset_note_trackers ()
 	Playlist::RegionWriteLock rl (this, false);
 
 	DEBUG_TRACE (DEBUG::MidiTrackers, string_compose ("%1 reset all note trackers\n", name()));
-	_note_trackers.clear ();
+	for (NoteTrackers::iterator n = _note_trackers.begin(); n != _note_trackers.end(); ++n) {
+		n->second->reset ();
+	}
 }
 
 void
@@ -274,10 +344,31 @@ MidiPlaylist::resolve_note_trackers (Evoral::EventSink<framepos_t>& dst, framepo
 	Playlist::RegionWriteLock rl (this, false);
 
 	for (NoteTrackers::iterator n = _note_trackers.begin(); n != _note_trackers.end(); ++n) {
-		n->second->tracker.resolve_notes(dst, time);
+		if (n->second->active) {
+			n->second->tracker.resolve_notes(dst, time);
+		}
+		n->second->reset ();
 	}
 	DEBUG_TRACE (DEBUG::MidiTrackers, string_compose ("%1 resolve all note trackers\n", name()));
-	_note_trackers.clear ();
+}
+
+void
+MidiPlaylist::add_tracker (Region* region)
+{
+	NoteTrackers::iterator t = _note_trackers.find (region);
+
+	if (t != _note_trackers.end()) {
+		t->second->reset ();
+		return;
+	}
+
+	_note_trackers.insert (make_pair (region, boost::shared_ptr<RegionTracker> (new RegionTracker)));
+}
+
+void
+MidiPlaylist::region_added (boost::shared_ptr<Region> region)
+{
+	add_tracker (region.get());
 }
 
 void
@@ -347,6 +438,8 @@ MidiPlaylist::destroy_region (boost::shared_ptr<Region> region)
 
 			if ((*i) == region) {
 				regions.erase (i);
+				region_index.remove (region);
+				_note_trackers.erase (region.get());
 				changed = true;
 			}
 
@@ -142,6 +142,41 @@ default_copy_vector (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pframes_t
 	memcpy(dst, src, nframes*sizeof(ARDOUR::Sample));
 }
 
+float
+default_apply_gain_ramp (ARDOUR::Sample * buf, pframes_t nframes, float initial, float target, float coeff)
+{
+	double lpf = initial;
+
+	for (pframes_t i = 0; i < nframes; ++i) {
+		buf[i] *= lpf;
+		lpf += coeff * (target - lpf);
+	}
+
+	return lpf;
+}
+
+void
+default_deinterleave (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pframes_t nframes, uint32_t channel, uint32_t n_channels)
+{
+	src += channel;
+
+	for (pframes_t i = 0; i < nframes; ++i) {
+		dst[i] = *src;
+		src += n_channels;
+	}
+}
+
+void
+default_interleave (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pframes_t nframes, uint32_t channel, uint32_t n_channels)
+{
+	dst += channel;
+
+	for (pframes_t i = 0; i < nframes; ++i) {
+		*dst = src[i];
+		dst += n_channels;
+	}
+}
+
 #if defined (__APPLE__) && defined (BUILD_VECLIB_OPTIMIZATIONS)
 #include <Accelerate/Accelerate.h>
 
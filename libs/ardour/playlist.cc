@@ -301,6 +301,8 @@ Playlist::init (bool hide)
 
 	g_atomic_int_set (&block_notifications, 0);
 	g_atomic_int_set (&ignore_state_changes, 0);
+	g_atomic_int_set (&_contents_generation, 0);
+	g_atomic_pointer_set (&_region_lock_writer, 0);
 	pending_contents_change = false;
 	pending_layering = false;
 	first_set_state = true;
@@ -444,6 +446,8 @@ Playlist::release_notifications (bool from_undo)
 void
 Playlist::notify_contents_changed ()
 {
+	bump_contents_generation ();
+
 	if (holding_state ()) {
 		pending_contents_change = true;
 	} else {
@@ -455,6 +459,8 @@ Playlist::notify_contents_changed ()
 void
 Playlist::notify_layering_changed ()
 {
+	bump_contents_generation ();
+
 	if (holding_state ()) {
 		pending_layering = true;
 	} else {
@@ -466,6 +472,8 @@ Playlist::notify_layering_changed ()
 void
 Playlist::notify_region_removed (boost::shared_ptr<Region> r)
 {
+	bump_contents_generation ();
+
 	if (holding_state ()) {
 		pending_removes.insert (r);
 		pending_contents_change = true;
@@ -484,6 +492,8 @@ Playlist::notify_region_moved (boost::shared_ptr<Region> r)
 {
 	Evoral::RangeMove<framepos_t> const move (r->last_position (), r->length (), r->position ());
 
+	bump_contents_generation ();
+
 	if (holding_state ()) {
 
 		pending_range_moves.push_back (move);
@@ -500,6 +510,8 @@ Playlist::notify_region_moved (boost::shared_ptr<Region> r)
 void
 Playlist::notify_region_start_trimmed (boost::shared_ptr<Region> r)
 {
+	bump_contents_generation ();
+
 	if (r->position() >= r->last_position()) {
 		/* trimmed shorter */
 		return;
@@ -523,6 +535,8 @@ Playlist::notify_region_start_trimmed (boost::shared_ptr<Region> r)
 void
 Playlist::notify_region_end_trimmed (boost::shared_ptr<Region> r)
 {
+	bump_contents_generation ();
+
 	if (r->length() < r->last_length()) {
 		/* trimmed shorter */
 	}
@@ -549,6 +563,8 @@ Playlist::notify_region_added (boost::shared_ptr<Region> r)
 	   as though it could be.
 	*/
 
+	bump_contents_generation ();
+
 	if (holding_state()) {
 		pending_adds.insert (r);
 		pending_contents_change = true;
@@ -750,8 +766,11 @@ Playlist::flush_notifications (bool from_undo)
 	 region->set_position (position);
 
 	 regions.insert (upper_bound (regions.begin(), regions.end(), region, cmp), region);
+	 region_index.add (region);
 	 all_regions.insert (region);
 
+	 region_added (region);
+
 	 possibly_splice_unlocked (position, region->length(), region);
 
 	 if (!holding_state ()) {
@@ -811,6 +830,7 @@ Playlist::flush_notifications (bool from_undo)
 			 framecnt_t distance = (*i)->length();
 
 			 regions.erase (i);
+			 region_index.remove (region);
 
 			 possibly_splice_unlocked (pos, -distance);
 
@@ -1599,6 +1619,19 @@ Playlist::core_ripple (framepos_t at, framecnt_t distance, RegionList *exclude)
 void
 Playlist::region_bounds_changed (const PropertyChange& what_changed, boost::shared_ptr<Region> region)
 {
+	 if (what_changed.contains (Properties::position) || what_changed.contains (Properties::length)) {
+		 /* always keep the index in step with the region's bounds,
+		    even while splicing etc. leave the list itself alone.
+		    This is a no-op for regions not in this playlist.
+		 */
+		 if (region_lock_held_for_writing ()) {
+			 region_index.update (region);
+		 } else {
+			 RegionWriteLock rlock (this, false);
+			 region_index.update (region);
+		 }
+	 }
+
 	 if (in_set_state || _splicing || _rippling || _nudging || _shuffling) {
 		 return;
 	 }
@@ -1663,6 +1696,10 @@ Playlist::region_bounds_changed (const PropertyChange& what_changed, boost::shar
 		 return;
 	 }
 
+	 /* whatever changed, it may change what we read back */
+
+	 bump_contents_generation ();
+
 	 /* this makes a virtual call to the right kind of playlist ... */
 
 	 region_changed (what_changed, region);
@@ -1722,6 +1759,7 @@ Playlist::region_bounds_changed (const PropertyChange& what_changed, boost::shar
  {
 	 RegionWriteLock rl (this);
 	 regions.clear ();
+	 region_index.clear ();
 	 all_regions.clear ();
  }
 
@@ -1750,6 +1788,7 @@ Playlist::region_bounds_changed (const PropertyChange& what_changed, boost::shar
 		 }
 
 		 regions.clear ();
+		 region_index.clear ();
 
 		 for (set<boost::shared_ptr<Region> >::iterator s = pending_removes.begin(); s != pending_removes.end(); ++s) {
 			 remove_dependents (*s);
@@ -1780,36 +1819,51 @@ Playlist::regions_at (framepos_t frame)
 	return find_regions_at (frame);
 }
 
+void
+Playlist::regions_at (framepos_t frame, vector<boost::shared_ptr<Region> >& result)
+{
+	RegionReadLock rlock (this);
+	region_index.regions_at (frame, result);
+}
+
  uint32_t
  Playlist::count_regions_at (framepos_t frame) const
  {
 	 RegionReadLock rlock (const_cast<Playlist*>(this));
-	 uint32_t cnt = 0;
+	 return region_index.count_regions_at (frame);
+ }
 
-	 for (RegionList::const_iterator i = regions.begin(); i != regions.end(); ++i) {
-		 if ((*i)->covers (frame)) {
-			 cnt++;
-		 }
-	 }
+namespace {
 
-	 return cnt;
- }
+/** Pick the region on the highest layer; for equal layers the one that
+ *  comes last in position order wins, as with a stable sort by layer.
+ */
+struct TopRegionFinder {
+	TopRegionFinder (bool m) : include_muted (m) {}
+
+	void operator() (boost::shared_ptr<Region> const & r) {
+		if (!include_muted && r->muted()) {
+			return;
+		}
+		if (!top || r->layer() >= top->layer()) {
+			top = r;
+		}
+	}
+
+	bool include_muted;
+	boost::shared_ptr<Region> top;
+};
+
+}
 
  boost::shared_ptr<Region>
  Playlist::top_region_at (framepos_t frame)
 
  {
 	 RegionReadLock rlock (this);
-	 boost::shared_ptr<RegionList> rlist = find_regions_at (frame);
-	 boost::shared_ptr<Region> region;
-
-	 if (rlist->size()) {
-		 RegionSortByLayer cmp;
-		 rlist->sort (cmp);
-		 region = rlist->back();
-	 }
-
-	 return region;
+	 TopRegionFinder f (true);
+	 region_index.foreach_touched (frame, frame, f);
+	 return f.top;
  }
 
  boost::shared_ptr<Region>
@@ -1817,29 +1871,9 @@ Playlist::regions_at (framepos_t frame)
 
  {
 	 RegionReadLock rlock (this);
-	 boost::shared_ptr<RegionList> rlist = find_regions_at (frame);
-
-	 for (RegionList::iterator i = rlist->begin(); i != rlist->end(); ) {
-
-		 RegionList::iterator tmp = i;
-		 ++tmp;
-
-		 if ((*i)->muted()) {
-			 rlist->erase (i);
-		 }
-
-		 i = tmp;
-	 }
-
-	 boost::shared_ptr<Region> region;
-
-	 if (rlist->size()) {
-		 RegionSortByLayer cmp;
-		 rlist->sort (cmp);
-		 region = rlist->back();
-	 }
-
-	 return region;
+	 TopRegionFinder f (false);
+	 region_index.foreach_touched (frame, frame, f);
+	 return f.top;
  }
 
 boost::shared_ptr<RegionList>
@@ -1848,12 +1882,10 @@ Playlist::find_regions_at (framepos_t frame)
 	/* Caller must hold lock */
 
 	boost::shared_ptr<RegionList> rlist (new RegionList);
+	vector<boost::shared_ptr<Region> > found;
 
-	for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
-		if ((*i)->covers (frame)) {
-			rlist->push_back (*i);
-		}
-	}
+	region_index.regions_at (frame, found);
+	rlist->assign (found.begin(), found.end());
 
 	return rlist;
 }
@@ -1861,58 +1893,70 @@ Playlist::find_regions_at (framepos_t frame)
 boost::shared_ptr<RegionList>
 Playlist::regions_with_start_within (Evoral::Range<framepos_t> range)
 {
-	RegionReadLock rlock (this);
 	boost::shared_ptr<RegionList> rlist (new RegionList);
+	vector<boost::shared_ptr<Region> > found;
 
-	for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
-		if ((*i)->first_frame() >= range.from && (*i)->first_frame() <= range.to) {
-			rlist->push_back (*i);
-		}
-	}
+	regions_with_start_within (range, found);
+	rlist->assign (found.begin(), found.end());
 
 	return rlist;
 }
 
+void
+Playlist::regions_with_start_within (Evoral::Range<framepos_t> range, vector<boost::shared_ptr<Region> >& result)
+{
+	RegionReadLock rlock (this);
+	region_index.regions_with_start_within (range.from, range.to, result);
+}
+
 boost::shared_ptr<RegionList>
 Playlist::regions_with_end_within (Evoral::Range<framepos_t> range)
 {
-	RegionReadLock rlock (this);
 	boost::shared_ptr<RegionList> rlist (new RegionList);
+	vector<boost::shared_ptr<Region> > found;
 
-	for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
-		if ((*i)->last_frame() >= range.from && (*i)->last_frame() <= range.to) {
-			rlist->push_back (*i);
-		}
-	}
+	regions_with_end_within (range, found);
+	rlist->assign (found.begin(), found.end());
 
 	return rlist;
 }
 
+void
+Playlist::regions_with_end_within (Evoral::Range<framepos_t> range, vector<boost::shared_ptr<Region> >& result)
+{
+	RegionReadLock rlock (this);
+	region_index.regions_with_end_within (range.from, range.to, result);
+}
+
 /** @param start Range start.
  *  @param end Range end.
  *  @return regions which have some part within this range.
  */
 boost::shared_ptr<RegionList>
 Playlist::regions_touched (framepos_t start, framepos_t end)
-{
-	RegionReadLock rlock (this);
-	return regions_touched_locked (start, end);
-}
-
-boost::shared_ptr<RegionList>
-Playlist::regions_touched_locked (framepos_t start, framepos_t end)
 {
 	boost::shared_ptr<RegionList> rlist (new RegionList);
+	vector<boost::shared_ptr<Region> > found;
 
-	for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
-		if ((*i)->coverage (start, end) != Evoral::OverlapNone) {
-			rlist->push_back (*i);
-		}
-	}
+	regions_touched (start, end, found);
+	rlist->assign (found.begin(), found.end());
 
 	return rlist;
 }
 
+void
+Playlist::regions_touched (framepos_t start, framepos_t end, vector<boost::shared_ptr<Region> >& result)
+{
+	RegionReadLock rlock (this);
+	regions_touched_locked (start, end, result);
+}
+
+void
+Playlist::regions_touched_locked (framepos_t start, framepos_t end, vector<boost::shared_ptr<Region> >& result) const
+{
+	region_index.regions_touched (start, end, result);
+}
+
 framepos_t
 Playlist::find_next_transient (framepos_t from, int dir)
 {
@@ -1977,6 +2021,19 @@ boost::shared_ptr<Region>
 Playlist::find_next_region (framepos_t frame, RegionPoint point, int dir)
 {
 	RegionReadLock rlock (this);
+
+	/* starts and ends are indexed; sync points are not */
+
+	if (point == Start) {
+		if (dir == 1) {
+			return region_index.first_starting_after (frame);
+		} else {
+			return region_index.last_starting_before (frame);
+		}
+	} else if (point == End && dir == 1) {
+		return region_index.first_ending_after (frame);
+	}
+
 	boost::shared_ptr<Region> ret;
 	framepos_t closest = max_framepos;
 
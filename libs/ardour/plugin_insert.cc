@@ -36,6 +36,7 @@
 #include "ardour/luaproc.h"
 #include "ardour/plugin.h"
 #include "ardour/plugin_insert.h"
+#include "ardour/rc_configuration.h"
 
 #ifdef LV2_SUPPORT
 #include "ardour/lv2_plugin.h"
@@ -73,7 +74,13 @@ PluginInsert::PluginInsert (Session& s, boost::shared_ptr<Plugin> plug)
 	, _strict_io (false)
 	, _custom_cfg (false)
 	, _maps_from_state (false)
+	, _automation_data_nframes (0)
+	, _automation_stat_cycles (0)
+	, _automation_stat_runs (0)
+	, _automation_stat_max_runs (0)
 {
+	g_atomic_int_set (&_automation_stat_reset, 0);
+
 	/* the first is the master */
 
 	if (plug) {
@@ -382,6 +389,24 @@ PluginInsert::create_automatable_parameters ()
 			}
 		}
 	}
+
+	allocate_automation_vectors (_session.get_block_size ());
+}
+
+void
+PluginInsert::allocate_automation_vectors (pframes_t nframes)
+{
+	uint32_t n = 0;
+	for (Controls::const_iterator li = controls().begin(); li != controls().end(); ++li) {
+		if (li->first.type() == PluginAutomation) {
+			++n;
+		}
+	}
+
+	_automation_data.assign ((size_t) n * nframes, 0.f);
+	_automation_data_nframes = nframes;
+	_automation_vectors.clear ();
+	_automation_vectors.reserve (n);
 }
 /** Called when something outside of this host has modified a plugin
  * parameter. Responsible for propagating the change to two places:
@@ -441,6 +466,7 @@ PluginInsert::set_block_size (pframes_t nframes)
 			ret = -1;
 		}
 	}
+	allocate_automation_vectors (nframes);
 	return ret;
 }
 
@@ -832,19 +858,61 @@ PluginInsert::automation_run (BufferSet& bufs, framepos_t start, pframes_t nfram
 		return;
 	}
 
-	if (!find_next_event (now, end, next_event) || _plugins.front()->requires_fixed_sized_buffers()) {
+	if (!find_next_event (now, end, next_event)) {
 
 		/* no events have a time within the relevant range */
 
 		connect_and_run (bufs, nframes, offset, true, now);
+		update_automation_stats (1);
+		return;
+	}
+
+	if (_plugins.front()->sample_accurate_automation () && fill_automation_vectors (now, nframes)) {
+
+		/* the plugin applies the events within the cycle itself */
+
+		for (Plugins::iterator i = _plugins.begin(); i != _plugins.end(); ++i) {
+			(*i)->_automation_vectors = &_automation_vectors;
+		}
+
+		connect_and_run (bufs, nframes, offset, true, now);
+
+		for (Plugins::iterator i = _plugins.begin(); i != _plugins.end(); ++i) {
+			(*i)->_automation_vectors = 0;
+		}
+
+		update_automation_stats (1);
 		return;
 	}
 
+	if (_plugins.front()->requires_fixed_sized_buffers()) {
+		connect_and_run (bufs, nframes, offset, true, now);
+		update_automation_stats (1);
+		return;
+	}
+
+	/* Split the cycle at automation events, but only at multiples of
+	 * the grid (relative to the start of the cycle). Events that fall
+	 * between grid points take effect at the next one, so that dense
+	 * automation does not reduce the plugin to running a few samples
+	 * at a time.
+	 */
+	const framecnt_t grid = max ((framecnt_t) 1, (framecnt_t) Config->get_plugin_automation_grid ());
+	uint32_t runs = 0;
+
 	while (nframes) {
 
-		framecnt_t cnt = min (((framecnt_t) ceil (next_event.when) - now), (framecnt_t) nframes);
+		framecnt_t cnt = (framecnt_t) ceil (next_event.when) - start;
+		cnt = ((cnt + grid - 1) / grid) * grid - offset;
+
+		if (cnt <= 0) {
+			cnt = grid;
+		}
+
+		cnt = min (cnt, (framecnt_t) nframes);
 
 		connect_and_run (bufs, cnt, offset, true, now);
+		++runs;
 
 		nframes -= cnt;
 		offset += cnt;
@@ -859,7 +927,143 @@ PluginInsert::automation_run (BufferSet& bufs, framepos_t start, pframes_t nfram
 
 	if (nframes) {
 		connect_and_run (bufs, nframes, offset, true, now);
+		++runs;
+	}
+
+	update_automation_stats (runs);
+}
+
+/** Fill vec with the value of list at every frame from start.
+ *
+ * Plugin automation is either linear or stepped (curved lists are treated
+ * as linear here), so this is a single pass over the control points
+ * rather than a lookup per frame.
+ */
+static bool
+fill_automation_vector (Evoral::ControlList const & list, framepos_t start, float* vec, pframes_t nframes)
+{
+	Glib::Threads::RWLock::ReaderLock lm (list.lock(), Glib::Threads::TRY_LOCK);
+
+	if (!lm.locked ()) {
+		return false;
+	}
+
+	Evoral::ControlList::Index const & index (list.index ());
+	const size_t npoints = index.size ();
+
+	if (npoints == 0) {
+		for (pframes_t n = 0; n < nframes; ++n) {
+			vec[n] = list.default_value ();
+		}
+		return true;
+	}
+
+	const bool discrete = list.interpolation () == Evoral::ControlList::Discrete;
+
+	/* i is the first point after the current frame */
+	size_t i = index.lower_bound (start);
+
+	for (pframes_t n = 0; n < nframes; ++n) {
+		const double x = start + n;
+
+		while (i < npoints && index.when[i] <= x) {
+			++i;
+		}
+
+		if (i == 0) {
+			vec[n] = index.value[0];
+		} else if (i == npoints) {
+			vec[n] = index.value[npoints - 1];
+		} else if (discrete || index.when[i - 1] == x) {
+			vec[n] = index.value[i - 1];
+		} else {
+			const double lpos = index.when[i - 1];
+			const double lval = index.value[i - 1];
+			vec[n] = lval + (x - lpos) / (index.when[i] - lpos) * (index.value[i] - lval);
+		}
 	}
+
+	return true;
+}
+
+bool
+PluginInsert::fill_automation_vectors (framepos_t start, pframes_t nframes)
+{
+	if (nframes > _automation_data_nframes) {
+		return false;
+	}
+
+	_automation_vectors.clear ();
+
+	float* data = _automation_data.empty () ? 0 : &_automation_data[0];
+
+	for (Controls::iterator li = controls().begin(); li != controls().end(); ++li) {
+
+		if (li->first.type() != PluginAutomation) {
+			continue;
+		}
+
+		boost::shared_ptr<AutomationControl> c
+			= boost::dynamic_pointer_cast<AutomationControl>(li->second);
+
+		if (!c || !c->list() || !c->automation_playback()) {
+			continue;
+		}
+
+		if (_automation_vectors.size () == _automation_vectors.capacity ()) {
+			/* controls were added since the last allocation */
+			return false;
+		}
+
+		if (!fill_automation_vector (*c->list(), start, data, nframes)) {
+			return false;
+		}
+
+		Plugin::AutomationVector v = { li->first.id(), data };
+		_automation_vectors.push_back (v);
+		data += _automation_data_nframes;
+	}
+
+	for (Plugins::iterator i = _plugins.begin(); i != _plugins.end(); ++i) {
+		if (!(*i)->prepare_automation_vectors (_automation_vectors, nframes)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void
+PluginInsert::update_automation_stats (uint32_t runs)
+{
+	if (g_atomic_int_compare_and_exchange (&_automation_stat_reset, 1, 0)) {
+		_automation_stat_cycles = 0;
+		_automation_stat_runs = 0;
+		_automation_stat_max_runs = 0;
+	}
+
+	++_automation_stat_cycles;
+	_automation_stat_runs += runs;
+	_automation_stat_max_runs = max (_automation_stat_max_runs, runs);
+}
+
+bool
+PluginInsert::get_automation_stats (uint64_t& cycles, uint64_t& runs, uint32_t& max_runs) const
+{
+	if (g_atomic_int_get (const_cast<gint*>(&_automation_stat_reset)) || _automation_stat_cycles == 0) {
+		return false;
+	}
+
+	cycles = _automation_stat_cycles;
+	runs = _automation_stat_runs;
+	max_runs = _automation_stat_max_runs;
+	return true;
+}
+
+void
+PluginInsert::clear_automation_stats ()
+{
+	g_atomic_int_set (&_automation_stat_reset, 1);
 }
 
 float
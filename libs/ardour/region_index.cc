@@ -0,0 +1,430 @@
+/*
+    Copyright (C) 2016 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#include <algorithm>
+
+#include "ardour/region.h"
+#include "ardour/region_index.h"
+
+using namespace std;
+using namespace ARDOUR;
+
+namespace {
+
+struct Collector {
+	Collector (vector<boost::shared_ptr<Region> >& r) : result (r) {}
+	void operator() (boost::shared_ptr<Region> const & r) { result.push_back (r); }
+	vector<boost::shared_ptr<Region> >& result;
+};
+
+struct EndWithinCollector {
+	EndWithinCollector (framepos_t e, vector<boost::shared_ptr<Region> >& r) : end (e), result (r) {}
+	void operator() (boost::shared_ptr<Region> const & r) {
+		if (r->last_frame() <= end) {
+			result.push_back (r);
+		}
+	}
+	framepos_t end;
+	vector<boost::shared_ptr<Region> >& result;
+};
+
+struct Counter {
+	Counter () : count (0) {}
+	void operator() (boost::shared_ptr<Region> const &) { ++count; }
+	uint32_t count;
+};
+
+}
+
+RegionIndex::Node::Node (boost::shared_ptr<Region> const & r, uint64_t s)
+	: region (r)
+	, seq (s)
+	, height (1)
+	, left (0)
+	, right (0)
+{
+	set_bounds ();
+}
+
+void
+RegionIndex::Node::set_bounds ()
+{
+	start = region->first_frame ();
+	end = region->last_frame ();
+	max_end = end;
+}
+
+RegionIndex::RegionIndex ()
+	: _root (0)
+	, _next_seq (0)
+{
+}
+
+RegionIndex::~RegionIndex ()
+{
+	clear ();
+}
+
+void
+RegionIndex::add (boost::shared_ptr<Region> r)
+{
+	if (_nodes.find (r.get()) != _nodes.end()) {
+		update (r);
+		return;
+	}
+
+	Node* n = new Node (r, _next_seq++);
+	_nodes.insert (make_pair (r.get(), n));
+	n->end_pos = _ends.insert (make_pair (n->end, n));
+	_root = insert (_root, n);
+}
+
+void
+RegionIndex::remove (boost::shared_ptr<Region> r)
+{
+	NodeMap::iterator i = _nodes.find (r.get());
+
+	if (i == _nodes.end()) {
+		return;
+	}
+
+	Node* n = i->second;
+	_nodes.erase (i);
+	_ends.erase (n->end_pos);
+	_root = remove (_root, n);
+	delete n;
+}
+
+void
+RegionIndex::update (boost::shared_ptr<Region> r)
+{
+	NodeMap::iterator i = _nodes.find (r.get());
+
+	if (i == _nodes.end()) {
+		return;
+	}
+
+	Node* n = i->second;
+
+	/* take it out using its old bounds, then put it back with the new
+	 * ones, after any other regions at the same position.
+	 */
+	_root = remove (_root, n);
+	_ends.erase (n->end_pos);
+	n->left = n->right = 0;
+	n->height = 1;
+	n->seq = _next_seq++;
+	n->set_bounds ();
+	n->end_pos = _ends.insert (make_pair (n->end, n));
+	_root = insert (_root, n);
+}
+
+void
+RegionIndex::clear ()
+{
+	destroy (_root);
+	_root = 0;
+	_nodes.clear ();
+	_ends.clear ();
+}
+
+void
+RegionIndex::regions_touched (framepos_t start, framepos_t end, vector<boost::shared_ptr<Region> >& result) const
+{
+	Collector c (result);
+	foreach_touched (start, end, c);
+}
+
+void
+RegionIndex::regions_at (framepos_t frame, vector<boost::shared_ptr<Region> >& result) const
+{
+	Collector c (result);
+	foreach_touched (frame, frame, c);
+}
+
+uint32_t
+RegionIndex::count_regions_at (framepos_t frame) const
+{
+	Counter c;
+	foreach_touched (frame, frame, c);
+	return c.count;
+}
+
+void
+RegionIndex::regions_with_start_within (framepos_t start, framepos_t end, vector<boost::shared_ptr<Region> >& result) const
+{
+	if (start <= end) {
+		start_within (_root, start, end, result);
+	}
+}
+
+void
+RegionIndex::regions_with_end_within (framepos_t start, framepos_t end, vector<boost::shared_ptr<Region> >& result) const
+{
+	/* any region ending inside [start, end] must touch it */
+	EndWithinCollector c (end, result);
+	foreach_touched (start, end, c);
+}
+
+boost::shared_ptr<Region>
+RegionIndex::first_starting_after (framepos_t frame) const
+{
+	Node const * n = _root;
+	Node const * found = 0;
+
+	while (n) {
+		if (n->start > frame) {
+			found = n;
+			n = n->left;
+		} else {
+			n = n->right;
+		}
+	}
+
+	return found ? found->region : boost::shared_ptr<Region> ();
+}
+
+boost::shared_ptr<Region>
+RegionIndex::last_starting_before (framepos_t frame) const
+{
+	Node const * n = _root;
+	Node const * found = 0;
+
+	/* find the closest start before frame ... */
+
+	while (n) {
+		if (n->start < frame) {
+			found = n;
+			n = n->right;
+		} else {
+			n = n->left;
+		}
+	}
+
+	if (!found) {
+		return boost::shared_ptr<Region> ();
+	}
+
+	/* ... and then the first region with that start */
+
+	const framepos_t start = found->start;
+	n = _root;
+
+	while (n) {
+		if (n->start >= start) {
+			if (n->start == start) {
+				found = n;
+			}
+			n = n->left;
+		} else {
+			n = n->right;
+		}
+	}
+
+	return found->region;
+}
+
+boost::shared_ptr<Region>
+RegionIndex::first_ending_after (framepos_t frame) const
+{
+	EndMap::const_iterator i = _ends.upper_bound (frame);
+
+	if (i == _ends.end()) {
+		return boost::shared_ptr<Region> ();
+	}
+
+	/* of the regions ending there, take the first in position order */
+
+	Node const * found = i->second;
+
+	for (++i; i != _ends.end() && i->first == found->end; ++i) {
+		if (before (i->second, found)) {
+			found = i->second;
+		}
+	}
+
+	return found->region;
+}
+
+void
+RegionIndex::start_within (Node const * n, framepos_t start, framepos_t end, vector<boost::shared_ptr<Region> >& result)
+{
+	if (!n) {
+		return;
+	}
+
+	if (n->start >= start) {
+		start_within (n->left, start, end, result);
+	}
+
+	if (n->start >= start && n->start <= end) {
+		result.push_back (n->region);
+	}
+
+	if (n->start <= end) {
+		start_within (n->right, start, end, result);
+	}
+}
+
+/* AVL tree maintenance, with each node also tracking the largest end
+ * position found in its subtree.
+ */
+
+bool
+RegionIndex::before (Node const * a, Node const * b)
+{
+	return a->start < b->start || (a->start == b->start && a->seq < b->seq);
+}
+
+void
+RegionIndex::recompute (Node* n)
+{
+	int hl = n->left ? n->left->height : 0;
+	int hr = n->right ? n->right->height : 0;
+
+	n->height = 1 + max (hl, hr);
+	n->max_end = n->end;
+
+	if (n->left) {
+		n->max_end = max (n->max_end, n->left->max_end);
+	}
+	if (n->right) {
+		n->max_end = max (n->max_end, n->right->max_end);
+	}
+}
+
+RegionIndex::Node*
+RegionIndex::rotate_left (Node* n)
+{
+	Node* r = n->right;
+	n->right = r->left;
+	r->left = n;
+	recompute (n);
+	recompute (r);
+	return r;
+}
+
+RegionIndex::Node*
+RegionIndex::rotate_right (Node* n)
+{
+	Node* l = n->left;
+	n->left = l->right;
+	l->right = n;
+	recompute (n);
+	recompute (l);
+	return l;
+}
+
+RegionIndex::Node*
+RegionIndex::balance (Node* n)
+{
+	recompute (n);
+
+	int hl = n->left ? n->left->height : 0;
+	int hr = n->right ? n->right->height : 0;
+
+	if (hl - hr > 1) {
+		Node* l = n->left;
+		if ((l->left ? l->left->height : 0) < (l->right ? l->right->height : 0)) {
+			n->left = rotate_left (l);
+		}
+		return rotate_right (n);
+	}
+
+	if (hr - hl > 1) {
+		Node* r = n->right;
+		if ((r->right ? r->right->height : 0) < (r->left ? r->left->height : 0)) {
+			n->right = rotate_right (r);
+		}
+		return rotate_left (n);
+	}
+
+	return n;
+}
+
+RegionIndex::Node*
+RegionIndex::insert (Node* root, Node* n)
+{
+	if (!root) {
+		return n;
+	}
+
+	if (before (n, root)) {
+		root->left = insert (root->left, n);
+	} else {
+		root->right = insert (root->right, n);
+	}
+
+	return balance (root);
+}
+
+RegionIndex::Node*
+RegionIndex::remove_min (Node* n, Node*& min)
+{
+	if (!n->left) {
+		min = n;
+		return n->right;
+	}
+
+	n->left = remove_min (n->left, min);
+	return balance (n);
+}
+
+RegionIndex::Node*
+RegionIndex::remove (Node* root, Node* n)
+{
+	if (!root) {
+		return 0;
+	}
+
+	if (root == n) {
+		Node* l = root->left;
+		Node* r = root->right;
+
+		if (!r) {
+			return l;
+		}
+
+		Node* min;
+		r = remove_min (r, min);
+		min->left = l;
+		min->right = r;
+		return balance (min);
+	}
+
+	if (before (n, root)) {
+		root->left = remove (root->left, n);
+	} else {
+		root->right = remove (root->right, n);
+	}
+
+	return balance (root);
+}
+
+void
+RegionIndex::destroy (Node* n)
+{
+	if (!n) {
+		return;
+	}
+
+	destroy (n->left);
+	destroy (n->right);
+	delete n;
+}
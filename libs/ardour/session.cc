@@ -223,6 +223,9 @@ Session::Session (AudioEngine &eng,
 	, _state_of_the_state (StateOfTheState(CannotSave|InitialConnecting|Loading))
 	, _suspend_save (0)
 	, _save_queued (false)
+	, _save_thread (0)
+	, _save_in_flight (false)
+	, _save_thread_quit (false)
 	, _last_roll_location (0)
 	, _last_roll_or_reversal_location (0)
 	, _last_record_location (0)
@@ -579,6 +582,7 @@ Session::destroy ()
 	*/
 
 	remove_pending_capture_state ();
+	stop_save_thread ();
 
 	Analyser::flush ();
 
@@ -157,6 +157,12 @@ Session::start_audio_export (framepos_t position)
 
 	_engine.Freewheel.connect_same_thread (export_freewheel_connection, boost::bind (&Session::process_export_fw, this, _1));
 	_export_rolling = true;
+
+	if (_engine.processing_offline ()) {
+		/* the caller runs the cycles, see ExportHandler::do_offline_export() */
+		return 0;
+	}
+
 	return _engine.freewheel (true);
 }
 
@@ -248,7 +254,9 @@ Session::finalize_audio_export ()
 
 	/* Clean up */
 
-	_engine.freewheel (false);
+	if (!_engine.processing_offline ()) {
+		_engine.freewheel (false);
+	}
 
 	export_freewheel_connection.disconnect();
 
@@ -28,6 +28,7 @@
 #include <glibmm/threads.h>
 
 #include "ardour/audioengine.h"
+#include "ardour/automation_watch.h"
 #include "ardour/auditioner.h"
 #include "ardour/butler.h"
 #include "ardour/cycle_timer.h"
@@ -73,6 +74,9 @@ Session::process (pframes_t nframes)
 
 	_engine.main_thread()->get_buffers ();
 
+	/* note values of controls being written with the position they apply at */
+	AutomationWatch::process (*this);
+
 	(this->*process_function) (nframes);
 
 	/* realtime-safe meter-position and processor-order changes
@@ -30,6 +30,7 @@
 #include <cstdio> /* snprintf(3) ... grrr */
 #include <cmath>
 #include <unistd.h>
+#include <fcntl.h>
 #include <climits>
 #include <signal.h>
 #include <sys/time.h>
@@ -47,6 +48,10 @@
 #include <sys/statvfs.h>
 #endif
 
+#ifdef PLATFORM_WINDOWS
+#include <io.h> // _commit
+#endif
+
 #include <glib.h>
 #include "pbd/gstdio_compat.h"
 
@@ -68,6 +73,7 @@
 #include "pbd/enumwriter.h"
 #include "pbd/error.h"
 #include "pbd/file_utils.h"
+#include "pbd/cpus.h"
 #include "pbd/pathexpand.h"
 #include "pbd/pthread_utils.h"
 #include "pbd/stacktrace.h"
@@ -86,6 +92,7 @@
 #include "ardour/butler.h"
 #include "ardour/control_protocol_manager.h"
 #include "ardour/directory_names.h"
+#include "ardour/file_source.h"
 #include "ardour/filename_extensions.h"
 #include "ardour/graph.h"
 #include "ardour/location.h"
@@ -181,6 +188,7 @@ Session::pre_engine_init (string fullpath)
 	last_rr_session_dir = session_dirs.begin();
 
 	set_history_depth (Config->get_history_depth());
+	set_history_memory_limit (Config->get_history_memory_limit());
 
         /* default: assume simple stereo speaker configuration */
 
@@ -679,17 +687,66 @@ Session::create (const string& session_template, BusProfile* bus_profile)
 	return 0;
 }
 
+/** State captured by Session::save_state_internal(), to be written to disk
+ *  by Session::write_state(), possibly on the save thread.
+ */
+struct Session::SaveJob {
+	SaveJob ()
+		: state (0)
+		, history (0)
+		, pending (false)
+		, mark_as_clean (false)
+		, background (false)
+		, start_time (0)
+		, capture_usecs (0)
+	{}
+
+	~SaveJob () {
+		delete state;
+		delete history;
+	}
+
+	XMLNode*    state;
+	XMLNode*    history;  ///< undo history to save, or 0
+	std::string snapshot_name;
+	std::string xml_path;
+	std::string tmp_path;
+	bool        pending;
+	bool        mark_as_clean;
+	bool        background;
+	int64_t     start_time;
+	int64_t     capture_usecs;
+};
+
 void
 Session::maybe_write_autosave()
 {
         if (dirty() && record_status() != Recording) {
-                save_state("", true);
+                save_state_in_background ("", true);
         }
 }
 
 void
 Session::remove_pending_capture_state ()
 {
+	/* don't let a queued or running autosave bring the file back */
+	{
+		Glib::Threads::Mutex::Lock lm (_save_queue_lock);
+
+		for (std::list<SaveJob*>::iterator i = _save_queue.begin(); i != _save_queue.end(); ) {
+			if ((*i)->pending) {
+				delete *i;
+				i = _save_queue.erase (i);
+			} else {
+				++i;
+			}
+		}
+
+		while (_save_in_flight) {
+			_save_queue_cond.wait (_save_queue_lock);
+		}
+	}
+
 	std::string pending_state_file_path(_session_dir->root_path());
 
 	pending_state_file_path = Glib::build_filename (pending_state_file_path, legalize_for_path (_current_snapshot_name) + pending_suffix);
@@ -754,11 +811,46 @@ Session::remove_state (string snapshot_name)
 	}
 }
 
+/** Flush the file at @a path to disk. @return true on success */
+static bool
+sync_file (std::string const & path)
+{
+#ifdef PLATFORM_WINDOWS
+	int fd = g_open (path.c_str(), O_RDWR, 0);
+#else
+	int fd = g_open (path.c_str(), O_RDONLY, 0);
+#endif
+	if (fd < 0) {
+		return false;
+	}
+#ifdef PLATFORM_WINDOWS
+	bool ok = _commit (fd) == 0;
+#else
+	bool ok = fsync (fd) == 0;
+#endif
+	::close (fd);
+	return ok;
+}
+
 /** @param snapshot_name Name to save under, without .ardour / .pending prefix */
 int
 Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot, bool template_only)
 {
-	XMLTree tree;
+	return save_state_internal (snapshot_name, pending, switch_to_snapshot, template_only, false);
+}
+
+int
+Session::save_state_in_background (string snapshot_name, bool pending, bool switch_to_snapshot)
+{
+	return save_state_internal (snapshot_name, pending, switch_to_snapshot, false, Config->get_background_session_save ());
+}
+
+/** Capture the session state in the calling thread, then write it either
+ *  right away or, if @a background is true, on the save thread.
+ */
+int
+Session::save_state_internal (string snapshot_name, bool pending, bool switch_to_snapshot, bool template_only, bool background)
+{
 	std::string xml_path(_session_dir->root_path());
 
 	/* prevent concurrent saves from different threads */
@@ -782,9 +874,15 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 		return 1;
 	}
 
-#ifndef NDEBUG
-	const int64_t save_start_time = g_get_monotonic_time();
-#endif
+	if (!background) {
+		/* files must be written in the order in which they were saved */
+		wait_for_background_save ();
+	}
+
+	SaveJob* job = new SaveJob;
+	job->start_time = g_get_monotonic_time();
+	job->pending = pending;
+	job->background = background;
 
 	/* tell sources we're saving first, in case they write out to a new file
 	 * which should be saved with the state rather than the old one */
@@ -798,17 +896,17 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 
 	SessionSaveUnderway (); /* EMIT SIGNAL */
 
-	bool mark_as_clean = true;
+	job->mark_as_clean = true;
 
 	if (!snapshot_name.empty() && !switch_to_snapshot) {
-		mark_as_clean = false;
+		job->mark_as_clean = false;
 	}
 
 	if (template_only) {
-		mark_as_clean = false;
-		tree.set_root (&get_template());
+		job->mark_as_clean = false;
+		job->state = &get_template();
 	} else {
-		tree.set_root (&get_state());
+		job->state = &get_state();
 	}
 
 	if (snapshot_name.empty()) {
@@ -819,17 +917,17 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 
 	assert (!snapshot_name.empty());
 
+	job->snapshot_name = snapshot_name;
+
 	if (!pending) {
 
 		/* proper save: use statefile_suffix (.ardour in English) */
 
 		xml_path = Glib::build_filename (xml_path, legalize_for_path (snapshot_name) + statefile_suffix);
 
-		/* make a backup copy of the old file */
-
-		if (Glib::file_test (xml_path, Glib::FILE_TEST_EXISTS) && !create_backup_file (xml_path)) {
-			// create_backup_file will log the error
-			return -1;
+		if (_writable && Config->get_save_history() && Config->get_saved_history_depth() >= 0 &&
+		    (_history.undo_depth() != 0 || _history.redo_depth() != 0)) {
+			job->history = &_history.get_state (Config->get_saved_history_depth());
 		}
 
 	} else {
@@ -838,39 +936,125 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 		xml_path = Glib::build_filename (xml_path, legalize_for_path (snapshot_name) + pending_suffix);
 	}
 
-	std::string tmp_path(_session_dir->root_path());
-	tmp_path = Glib::build_filename (tmp_path, legalize_for_path (snapshot_name) + temp_suffix);
+	job->xml_path = xml_path;
+	job->tmp_path = Glib::build_filename (_session_dir->root_path(), legalize_for_path (snapshot_name) + temp_suffix);
+	job->capture_usecs = g_get_monotonic_time() - job->start_time;
 
-	cerr << "actually writing state to " << tmp_path << endl;
+	if (!background) {
+		const int ret = write_state (*job);
+		finish_save (*job, ret);
+		delete job;
+		return ret;
+	}
 
-	if (!tree.write (tmp_path)) {
-		error << string_compose (_("state could not be saved to %1"), tmp_path) << endmsg;
-		if (g_remove (tmp_path.c_str()) != 0) {
+	if (!pending && job->mark_as_clean) {
+		/* this is the state that will be saved; anything changed from
+		 * here on makes the session dirty again.
+		 */
+		bool was_dirty = dirty();
+
+		_state_of_the_state = StateOfTheState (_state_of_the_state & ~Dirty);
+
+		if (was_dirty) {
+			DirtyChanged (); /* EMIT SIGNAL */
+		}
+	}
+
+	Glib::Threads::Mutex::Lock ql (_save_queue_lock);
+
+	if (!_save_thread) {
+		_save_thread_quit = false;
+		_save_thread = Glib::Threads::Thread::create (sigc::mem_fun (*this, &Session::save_thread));
+	}
+
+	/* a save of the same file that has not been started yet is now out of date */
+	for (std::list<SaveJob*>::iterator i = _save_queue.begin(); i != _save_queue.end(); ) {
+		if ((*i)->xml_path == job->xml_path) {
+			delete *i;
+			i = _save_queue.erase (i);
+		} else {
+			++i;
+		}
+	}
+
+	_save_queue.push_back (job);
+	_save_queue_cond.broadcast ();
+
+	return 0;
+}
+
+/** Write the state captured in @a job to disk, along with the undo history.
+ *  Does not touch any session state, so it may run on the save thread.
+ *  @return zero on success.
+ */
+int
+Session::write_state (SaveJob& job)
+{
+	if (!job.pending) {
+
+		/* make a backup copy of the old file */
+
+		if (Glib::file_test (job.xml_path, Glib::FILE_TEST_EXISTS) && !create_backup_file (job.xml_path)) {
+			// create_backup_file will log the error
+			return -1;
+		}
+	}
+
+	cerr << "actually writing state to " << job.tmp_path << endl;
+
+	XMLTree tree;
+	tree.set_root (job.state);
+	job.state = 0; /* owned by the tree now */
+
+	if (!tree.write (job.tmp_path) || !sync_file (job.tmp_path)) {
+		error << string_compose (_("state could not be saved to %1"), job.tmp_path) << endmsg;
+		if (g_remove (job.tmp_path.c_str()) != 0) {
 			error << string_compose(_("Could not remove temporary session file at path \"%1\" (%2)"),
-					tmp_path, g_strerror (errno)) << endmsg;
+					job.tmp_path, g_strerror (errno)) << endmsg;
 		}
 		return -1;
 
 	} else {
 
-		cerr << "renaming state to " << xml_path << endl;
+		cerr << "renaming state to " << job.xml_path << endl;
 
-		if (::g_rename (tmp_path.c_str(), xml_path.c_str()) != 0) {
+		if (::g_rename (job.tmp_path.c_str(), job.xml_path.c_str()) != 0) {
 			error << string_compose (_("could not rename temporary session file %1 to %2 (%3)"),
-					tmp_path, xml_path, g_strerror(errno)) << endmsg;
-			if (g_remove (tmp_path.c_str()) != 0) {
+					job.tmp_path, job.xml_path, g_strerror(errno)) << endmsg;
+			if (g_remove (job.tmp_path.c_str()) != 0) {
 				error << string_compose(_("Could not remove temporary session file at path \"%1\" (%2)"),
-						tmp_path, g_strerror (errno)) << endmsg;
+						job.tmp_path, g_strerror (errno)) << endmsg;
 			}
 			return -1;
 		}
 	}
 
-	if (!pending) {
+	if (job.history) {
+		XMLNode* history = job.history;
+		job.history = 0;
+		write_history (job.snapshot_name, history);
+	}
+
+	return 0;
+}
 
-		save_history (snapshot_name);
+/** Called once the state in @a job has been written, with the result of
+ *  write_state(). This is on the save thread for background saves.
+ */
+void
+Session::finish_save (SaveJob& job, int result)
+{
+	if (result != 0) {
+		if (job.background && !job.pending && job.mark_as_clean) {
+			/* marked clean when the state was captured */
+			set_dirty ();
+		}
+		return;
+	}
+
+	if (!job.pending) {
 
-		if (mark_as_clean) {
+		if (job.mark_as_clean && !job.background) {
 			bool was_dirty = dirty();
 
 			_state_of_the_state = StateOfTheState (_state_of_the_state & ~Dirty);
@@ -880,14 +1064,79 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 			}
 		}
 
-		StateSaved (snapshot_name); /* EMIT SIGNAL */
+		StateSaved (job.snapshot_name); /* EMIT SIGNAL */
 	}
 
+	const int64_t elapsed_time_us = g_get_monotonic_time() - job.start_time;
+
+	StateSaveTimed (job.snapshot_name, job.capture_usecs, elapsed_time_us); /* EMIT SIGNAL */
+
 #ifndef NDEBUG
-	const int64_t elapsed_time_us = g_get_monotonic_time() - save_start_time;
-	cerr << "saved state in " << fixed << setprecision (1) << elapsed_time_us / 1000. << " ms\n";
+	cerr << "saved state in " << fixed << setprecision (1) << elapsed_time_us / 1000. << " ms"
+	     << " (" << job.capture_usecs / 1000. << " ms capturing)\n";
 #endif
-	return 0;
+}
+
+void
+Session::save_thread ()
+{
+	pthread_set_name ("SessionSave");
+
+	Glib::Threads::Mutex::Lock lm (_save_queue_lock);
+
+	while (true) {
+		while (_save_queue.empty() && !_save_thread_quit) {
+			_save_queue_cond.wait (_save_queue_lock);
+		}
+
+		if (_save_queue.empty()) {
+			/* asked to quit, and nothing left to write */
+			break;
+		}
+
+		SaveJob* job = _save_queue.front();
+		_save_queue.pop_front ();
+		_save_in_flight = true;
+
+		lm.release ();
+
+		finish_save (*job, write_state (*job));
+		delete job;
+
+		lm.acquire ();
+
+		_save_in_flight = false;
+		_save_queue_cond.broadcast ();
+	}
+}
+
+void
+Session::wait_for_background_save ()
+{
+	Glib::Threads::Mutex::Lock lm (_save_queue_lock);
+
+	while (!_save_queue.empty() || _save_in_flight) {
+		_save_queue_cond.wait (_save_queue_lock);
+	}
+}
+
+/** Write any outstanding background saves, then stop the save thread */
+void
+Session::stop_save_thread ()
+{
+	{
+		Glib::Threads::Mutex::Lock lm (_save_queue_lock);
+
+		if (!_save_thread) {
+			return;
+		}
+
+		_save_thread_quit = true;
+		_save_queue_cond.broadcast ();
+	}
+
+	_save_thread->join ();
+	_save_thread = 0;
 }
 
 int
@@ -2043,6 +2292,76 @@ Session::reset_write_sources (bool mark_write_complete, bool force)
 	}
 }
 
+/** Constructs audio file sources from their XML descriptions across a pool
+ *  of threads, since opening each file is dominated by file-system latency.
+ *  The sources are not announced; Session::load_sources() does that in
+ *  session file order. Anything that fails here (missing or ambiguous files,
+ *  unusual source types) is left for load_sources() to create the usual
+ *  way, where the user can be asked about it.
+ */
+struct SourceLoader {
+	SourceLoader (Session& s, XMLNodeList const & nlist)
+		: session (s)
+		, next (0)
+	{
+		for (XMLNodeConstIterator i = nlist.begin(); i != nlist.end(); ++i) {
+			nodes.push_back (*i);
+		}
+		sources.resize (nodes.size ());
+	}
+
+	static bool loadable (XMLNode const & node) {
+		if (node.name() != "Source" || node.property ("playlist")) {
+			return false;
+		}
+		const XMLProperty* prop = node.property ("type");
+		return !prop || DataType (prop->value()) == DataType::AUDIO;
+	}
+
+	static void* _thread_work (void* arg) {
+		static_cast<SourceLoader*> (arg)->thread_work ();
+		return 0;
+	}
+
+	void thread_work () {
+		FileSource::dont_ask_in_this_thread ();
+
+		int n;
+		while ((n = g_atomic_int_add (&next, 1)) < (int) nodes.size()) {
+			if (!loadable (*nodes[n])) {
+				continue;
+			}
+			try {
+				/* peaks are built by the peak threads, as usual */
+				sources[n] = SourceFactory::create (session, *nodes[n], true, false);
+			} catch (...) {
+				/* leave it to load_sources() */
+			}
+		}
+	}
+
+	void run (uint32_t n_threads) {
+		std::vector<pthread_t> threads;
+
+		for (uint32_t n = 0; n < n_threads; ++n) {
+			pthread_t t;
+			if (pthread_create_and_store ("session load", &t, _thread_work, this)) {
+				break;
+			}
+			threads.push_back (t);
+		}
+
+		for (std::vector<pthread_t>::iterator t = threads.begin(); t != threads.end(); ++t) {
+			pthread_join (*t, 0);
+		}
+	}
+
+	Session&                                 session;
+	std::vector<XMLNode*>                    nodes;
+	std::vector<boost::shared_ptr<Source> >  sources;
+	gint                                     next;
+};
+
 int
 Session::load_sources (const XMLNode& node)
 {
@@ -2057,7 +2376,29 @@ Session::load_sources (const XMLNode& node)
 
 	set_dirty();
 
-	for (niter = nlist.begin(); niter != nlist.end(); ++niter) {
+	uint32_t n_threads = Config->get_session_load_threads ();
+
+	if (n_threads == 0) {
+		n_threads = hardware_concurrency ();
+	}
+
+	SourceLoader loader (*this, nlist);
+
+	if (n_threads > 1 && nlist.size() > 1) {
+		loader.run (std::min (n_threads, (uint32_t) nlist.size()));
+	}
+
+	size_t n = 0;
+
+	for (niter = nlist.begin(); niter != nlist.end(); ++niter, ++n) {
+
+		if (loader.sources[n]) {
+			/* already created by the loader; announce it in file order */
+			SourceFactory::SourceCreated (loader.sources[n]);
+			loader.sources[n].reset ();
+			continue;
+		}
+
           retry:
 		try {
 			if ((source = XMLSourceFactory (**niter)) == 0) {
@@ -2950,7 +3291,7 @@ Session::cleanup_peakfiles ()
 	_state_of_the_state = StateOfTheState (_state_of_the_state | PeakCleanup);
 
 	int timeout = 5000; // 5 seconds
-	while (!SourceFactory::files_with_peaks.empty()) {
+	while (SourceFactory::peak_work_queue_length () > 0) {
 		Glib::usleep (1000);
 		if (--timeout < 0) {
 			warning << _("Timeout waiting for peak-file creation to terminate before cleanup, please try again later.") << endmsg;
@@ -3514,8 +3855,6 @@ Session::instant_xml (const string& node_name)
 int
 Session::save_history (string snapshot_name)
 {
-	XMLTree tree;
-
 	if (!_writable) {
 	        return 0;
 	}
@@ -3529,6 +3868,20 @@ Session::save_history (string snapshot_name)
 		snapshot_name = _current_snapshot_name;
 	}
 
+	wait_for_background_save ();
+
+	return write_history (snapshot_name, &_history.get_state (Config->get_saved_history_depth()));
+}
+
+/** Write @a history, which is taken over, as the history of @a snapshot_name.
+ *  Does not touch the session's history, so it may run on the save thread.
+ */
+int
+Session::write_history (std::string const & snapshot_name, XMLNode* history)
+{
+	XMLTree tree;
+	tree.set_root (history);
+
 	const string history_filename = legalize_for_path (snapshot_name) + history_suffix;
 	const string backup_filename = history_filename + backup_suffix;
 	const std::string xml_path(Glib::build_filename (_session_dir->root_path(), history_filename));
@@ -3541,8 +3894,6 @@ Session::save_history (string snapshot_name)
 		}
 	}
 
-	tree.set_root (&_history.get_state (Config->get_saved_history_depth()));
-
 	if (!tree.write (xml_path))
 	{
 		error << string_compose (_("history could not be saved to %1"), xml_path) << endmsg;
@@ -3832,6 +4183,8 @@ Session::config_changed (std::string p, bool ours)
 		setup_fpu ();
 	} else if (p == "history-depth") {
 		set_history_depth (Config->get_history_depth());
+	} else if (p == "history-memory-limit") {
+		set_history_memory_limit (Config->get_history_memory_limit());
 	} else if (p == "remote-model") {
 		/* XXX DO SOMETHING HERE TO TELL THE GUI THAT WE NEED
 		   TO SET REMOTE ID'S
@@ -3877,6 +4230,12 @@ Session::set_history_depth (uint32_t d)
 	_history.set_depth (d);
 }
 
+void
+Session::set_history_memory_limit (uint32_t megabytes)
+{
+	_history.set_memory_limit ((size_t) megabytes * 1048576);
+}
+
 int
 Session::load_diskstreams_2X (XMLNode const & node, int)
 {
@@ -37,6 +37,7 @@
 
 #include "ardour/audioengine.h"
 #include "ardour/auditioner.h"
+#include "ardour/automation_watch.h"
 #include "ardour/butler.h"
 #include "ardour/click.h"
 #include "ardour/debug.h"
@@ -718,6 +719,11 @@ Session::non_realtime_stop (bool abort, int on_entry, bool& finished)
 		}
 	}
 
+	/* automation recorded by the process thread must reach the lists
+	 * before their write passes finish
+	 */
+	AutomationWatch::instance().flush ();
+
 	if (_engine.running()) {
 		PostTransportWork ptw = post_transport_work ();
 		for (RouteList::iterator i = r->begin(); i != r->end(); ++i) {
@@ -243,17 +243,7 @@ SMFSource::read_unlocked (const Lock&                    lock,
 
 	if (_smf_last_read_end == 0 || start != _smf_last_read_end) {
 		DEBUG_TRACE (DEBUG::MidiSourceIO, string_compose ("SMF read_unlocked: seek to %1\n", start));
-		Evoral::SMF::seek_to_start();
-		while (time < start_ticks) {
-			gint ignored;
-
-			ret = read_event(&ev_delta_t, &ev_size, &ev_buffer, &ignored);
-			if (ret == -1) { // EOF
-				_smf_last_read_end = start + duration;
-				return duration;
-			}
-			time += ev_delta_t; // accumulate delta time
-		}
+		time = Evoral::SMF::seek_to_time (start_ticks);
 	} else {
 		DEBUG_TRACE (DEBUG::MidiSourceIO, string_compose ("SMF read_unlocked: set time to %1\n", _smf_last_read_time));
 		time = _smf_last_read_time;
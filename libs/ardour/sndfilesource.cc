@@ -25,6 +25,8 @@
 #include <cerrno>
 #include <climits>
 #include <cstdarg>
+#include <list>
+#include <map>
 #include <fcntl.h>
 
 #include <sys/stat.h>
@@ -35,7 +37,11 @@
 #include <glibmm/convert.h>
 #include <glibmm/fileutils.h>
 #include <glibmm/miscutils.h>
+#include <glibmm/threads.h>
 
+#include <boost/weak_ptr.hpp>
+
+#include "ardour/runtime_functions.h"
 #include "ardour/sndfilesource.h"
 #include "ardour/sndfile_helpers.h"
 #include "ardour/utils.h"
@@ -57,6 +63,305 @@ const Source::Flag SndFileSource::default_writable_flags = Source::Flag (
 		Source::RemovableIfEmpty |
 		Source::CanRename );
 
+/** Reads an interleaved multichannel file one block at a time, and keeps
+ *  the de-interleaved blocks around so that the other channels of the same
+ *  file (typically read by the butler straight afterwards, for the same
+ *  range) do not have to seek and decode the same data again.
+ *
+ *  All SndFileSources that read a given path share one SharedReader, and
+ *  reads from different threads are serialized by its lock.  The decoded
+ *  blocks of all SharedReaders share one cache of at most cache_bytes,
+ *  from which the least recently used block is dropped first.
+ */
+class SndFileSource::SharedReader
+{
+  public:
+	static boost::shared_ptr<SharedReader> get (std::string const & path, SF_INFO const &);
+
+	~SharedReader ();
+
+	/** Read cnt frames of channel, starting at start (which must be within
+	 *  the file).
+	 *  @return number of frames read.
+	 */
+	framecnt_t read (Sample* dst, framepos_t start, framecnt_t cnt, uint32_t channel);
+
+  private:
+	SharedReader (std::string const & path, SF_INFO const &);
+
+	struct Block;
+	typedef std::list<Block*> LRU; ///< most recently used first
+
+	struct Block {
+		Block (SharedReader* o, framecnt_t sz) : owner (o), start (0), frames (0), size (sz), data (new Sample[sz]) {}
+		~Block () { delete [] data; }
+
+		SharedReader*  owner;
+		framepos_t     start;
+		framecnt_t     frames;
+		framecnt_t     size;    ///< samples allocated for data
+		Sample*        data;    ///< channel-major, block_frames per channel
+		LRU::iterator  lru_pos; ///< this block's entry in _lru
+	};
+
+	typedef std::map<framepos_t, Block*> Blocks;
+
+	Block*     find_block (framepos_t block_start);
+	Block*     new_block ();
+	framecnt_t decode (framepos_t block_start);
+	int        open ();
+
+	std::string          _path;
+	SF_INFO              _info;
+	SNDFILE*             _sndfile;
+	Glib::Threads::Mutex _lock;
+	Blocks               _blocks; ///< protected by _cache_lock
+	Sample*              _interleave_buf;
+
+	static const framecnt_t block_frames = 16384;
+
+	/* roughly 64MB of decoded audio, whatever the number of open files */
+	static const size_t cache_bytes = 64 * 1048576;
+
+	/* all blocks, their owners' _blocks maps and their data are protected
+	 * by _cache_lock, which is never held while taking a reader's _lock.
+	 */
+	static Glib::Threads::Mutex _cache_lock;
+	static LRU                  _lru;
+	static size_t               _cache_size; ///< bytes held by all blocks
+
+	typedef std::map<std::string, boost::weak_ptr<SharedReader> > Readers;
+	static Readers              _readers;
+	static Glib::Threads::Mutex _readers_lock;
+};
+
+SndFileSource::SharedReader::Readers SndFileSource::SharedReader::_readers;
+Glib::Threads::Mutex SndFileSource::SharedReader::_readers_lock;
+Glib::Threads::Mutex SndFileSource::SharedReader::_cache_lock;
+SndFileSource::SharedReader::LRU SndFileSource::SharedReader::_lru;
+size_t SndFileSource::SharedReader::_cache_size = 0;
+
+boost::shared_ptr<SndFileSource::SharedReader>
+SndFileSource::SharedReader::get (string const & path, SF_INFO const & info)
+{
+	Glib::Threads::Mutex::Lock lm (_readers_lock);
+
+	Readers::iterator i = _readers.find (path);
+
+	if (i != _readers.end()) {
+		boost::shared_ptr<SharedReader> r = i->second.lock ();
+		if (r) {
+			return r;
+		}
+		_readers.erase (i);
+	}
+
+	boost::shared_ptr<SharedReader> r (new SharedReader (path, info));
+	_readers.insert (make_pair (path, boost::weak_ptr<SharedReader> (r)));
+
+	return r;
+}
+
+SndFileSource::SharedReader::SharedReader (string const & path, SF_INFO const & info)
+	: _path (path)
+	, _info (info)
+	, _sndfile (0)
+	, _interleave_buf (new Sample[block_frames * info.channels])
+{
+}
+
+SndFileSource::SharedReader::~SharedReader ()
+{
+	{
+		Glib::Threads::Mutex::Lock cl (_cache_lock);
+
+		for (Blocks::iterator i = _blocks.begin(); i != _blocks.end(); ++i) {
+			_lru.erase (i->second->lru_pos);
+			_cache_size -= i->second->size * sizeof (Sample);
+			delete i->second;
+		}
+	}
+
+	if (_sndfile) {
+		sf_close (_sndfile);
+	}
+
+	delete [] _interleave_buf;
+
+	Glib::Threads::Mutex::Lock lm (_readers_lock);
+
+	/* only remove our own entry; the path may have been reused since our
+	 * last reference went away.
+	 */
+	Readers::iterator i = _readers.find (_path);
+	if (i != _readers.end() && i->second.expired()) {
+		_readers.erase (i);
+	}
+}
+
+int
+SndFileSource::SharedReader::open ()
+{
+	if (_sndfile) {
+		return 0;
+	}
+
+#ifdef PLATFORM_WINDOWS
+	int fd = g_open (_path.c_str(), O_RDONLY, 0444);
+#else
+	int fd = ::open (_path.c_str(), O_RDONLY, 0444);
+#endif
+
+	if (fd == -1) {
+		return -1;
+	}
+
+	SF_INFO info;
+	memset (&info, 0, sizeof (info));
+
+	if ((_sndfile = sf_open_fd (fd, SFM_READ, &info, true)) == 0) {
+		return -1;
+	}
+
+	if (info.channels != _info.channels) {
+		sf_close (_sndfile);
+		_sndfile = 0;
+		return -1;
+	}
+
+	return 0;
+}
+
+/** @return our cached block starting at block_start, or 0.
+ *  Must be called with _cache_lock held.
+ */
+SndFileSource::SharedReader::Block*
+SndFileSource::SharedReader::find_block (framepos_t block_start)
+{
+	Blocks::iterator i = _blocks.find (block_start);
+
+	if (i == _blocks.end()) {
+		return 0;
+	}
+
+	_lru.splice (_lru.begin(), _lru, i->second->lru_pos);
+
+	return i->second;
+}
+
+/** @return a block for this reader, not yet in the cache, making room for
+ *  it by dropping the least recently used blocks of any reader.
+ *  Must be called with _cache_lock held.
+ */
+SndFileSource::SharedReader::Block*
+SndFileSource::SharedReader::new_block ()
+{
+	const framecnt_t size = block_frames * _info.channels;
+
+	while (!_lru.empty() && _cache_size + size * sizeof (Sample) > cache_bytes) {
+
+		Block* old = _lru.back ();
+		_lru.pop_back ();
+		old->owner->_blocks.erase (old->start);
+
+		if (old->size == size) {
+			/* recycle it; the cache size does not change */
+			old->owner = this;
+			return old;
+		}
+
+		_cache_size -= old->size * sizeof (Sample);
+		delete old;
+	}
+
+	_cache_size += size * sizeof (Sample);
+
+	return new Block (this, size);
+}
+
+/** Read the block starting at block_start into _interleave_buf.
+ *  Must be called with _lock held.
+ *  @return number of frames read.
+ */
+framecnt_t
+SndFileSource::SharedReader::decode (framepos_t block_start)
+{
+	if (open ()) {
+		return 0;
+	}
+
+	if (sf_seek (_sndfile, (sf_count_t) block_start, SEEK_SET|SFM_READ) != (sf_count_t) block_start) {
+		return 0;
+	}
+
+	return max ((sf_count_t) 0, sf_readf_float (_sndfile, _interleave_buf, block_frames));
+}
+
+framecnt_t
+SndFileSource::SharedReader::read (Sample* dst, framepos_t start, framecnt_t cnt, uint32_t channel)
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+
+	framecnt_t done = 0;
+
+	while (done < cnt) {
+
+		const framepos_t pos = start + done;
+		const framepos_t block_start = pos - (pos % block_frames);
+
+		Glib::Threads::Mutex::Lock cl (_cache_lock);
+
+		/* only this reader adds blocks to _blocks, and we hold _lock,
+		 * so a block that is not here now will not appear while we
+		 * decode it.
+		 */
+		Block* b = find_block (block_start);
+
+		if (!b) {
+			cl.release ();
+
+			const framecnt_t nread = decode (block_start);
+
+			if (nread <= 0) {
+				break;
+			}
+
+			cl.acquire ();
+
+			b = new_block ();
+
+			/* de-interleave once, for every channel */
+
+			const uint32_t nchans = _info.channels;
+
+			for (uint32_t chn = 0; chn < nchans; ++chn) {
+				deinterleave (b->data + (chn * block_frames), _interleave_buf, nread, chn, nchans);
+			}
+
+			b->start = block_start;
+			b->frames = nread;
+
+			_blocks.insert (make_pair (block_start, b));
+			_lru.push_front (b);
+			b->lru_pos = _lru.begin();
+		}
+
+		const framecnt_t offset = pos - block_start;
+
+		if (offset >= b->frames) {
+			/* short block at the end of the file */
+			break;
+		}
+
+		const framecnt_t n = min (cnt - done, b->frames - offset);
+
+		memcpy (dst + done, b->data + (channel * block_frames) + offset, sizeof (Sample) * n);
+		done += n;
+	}
+
+	return done;
+}
+
 SndFileSource::SndFileSource (Session& s, const XMLNode& node)
 	: Source(s, node)
 	, AudioFileSource (s, node)
@@ -257,6 +562,8 @@ SndFileSource::close ()
 		_sndfile = 0;
 		file_closed ();
 	}
+
+	_shared_reader.reset ();
 }
 
 int
@@ -314,6 +621,10 @@ SndFileSource::open ()
 
 	_length = _info.frames;
 
+	if (_info.channels > 1 && !writable()) {
+		_shared_reader = SharedReader::get (_path, _info);
+	}
+
 #ifdef HAVE_RF64_RIFF
 	if (_file_is_new && _length == 0 && writable()) {
 		if (_flags & RF64_RIFF) {
@@ -404,7 +715,6 @@ SndFileSource::read_unlocked (Sample *dst, framepos_t start, framecnt_t cnt) con
 	assert (cnt >= 0);
 
 	framecnt_t nread;
-	float *ptr;
 	framecnt_t real_cnt;
 	framepos_t file_cnt;
 
@@ -445,6 +755,23 @@ SndFileSource::read_unlocked (Sample *dst, framepos_t start, framecnt_t cnt) con
 		memset (dst+file_cnt, 0, sizeof (Sample) * delta);
 	}
 
+	if (_shared_reader) {
+
+		if (file_cnt == 0) {
+			return 0;
+		}
+
+		framecnt_t ret = _shared_reader->read (dst, start, file_cnt, _channel);
+
+		if (ret == file_cnt) {
+			return ret;
+		}
+
+		/* fall back to reading the file ourselves, which will also
+		 * report the error if there is one.
+		 */
+	}
+
 	if (file_cnt) {
 
 		if (sf_seek (_sndfile, (sf_count_t) start, SEEK_SET|SFM_READ) != (sf_count_t) start) {
@@ -470,15 +797,9 @@ SndFileSource::read_unlocked (Sample *dst, framepos_t start, framecnt_t cnt) con
 	Sample* interleave_buf = get_interleave_buffer (real_cnt);
 
 	nread = sf_read_float (_sndfile, interleave_buf, real_cnt);
-	ptr = interleave_buf + _channel;
 	nread /= _info.channels;
 
-	/* stride through the interleaved data */
-
-	for (framecnt_t n = 0; n < nread; ++n) {
-		dst[n] = *ptr;
-		ptr += _info.channels;
-	}
+	deinterleave (dst, interleave_buf, nread, _channel, _info.channels);
 
 	return nread;
 }
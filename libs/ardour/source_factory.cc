@@ -22,7 +22,12 @@
 #include "libardour-config.h"
 #endif
 
+#include <list>
+#include <map>
+#include <set>
+
 #include "pbd/boost_debug.h"
+#include "pbd/cpus.h"
 #include "pbd/error.h"
 #include "pbd/convert.h"
 #include "pbd/pthread_utils.h"
@@ -51,11 +56,29 @@ using namespace std;
 using namespace PBD;
 
 PBD::Signal1<void,boost::shared_ptr<Source> > SourceFactory::SourceCreated;
-Glib::Threads::Cond SourceFactory::PeaksToBuild;
-Glib::Threads::Mutex SourceFactory::peak_building_lock;
-std::list<boost::weak_ptr<AudioSource> > SourceFactory::files_with_peaks;
 
-static int active_threads = 0;
+/* Sources waiting for their peaks to be built, in the order in which they
+ * will be built. Each source appears at most once; `peaks_queued' maps a
+ * source to its place in the queue so that duplicate requests can be
+ * dropped and prioritized sources moved to the front in constant time.
+ * `peaks_building' holds the sources that the worker threads are busy with,
+ * so that they are not queued again in the meantime.
+ */
+
+struct PeakRequest {
+	PeakRequest (boost::shared_ptr<AudioSource> s) : source (s), key (s.get ()) {}
+
+	boost::weak_ptr<AudioSource> source;
+	AudioSource const *          key;
+};
+
+typedef std::list<PeakRequest> PeakQueue;
+
+static Glib::Threads::Mutex peak_building_lock;
+static Glib::Threads::Cond peaks_to_build;
+static PeakQueue peak_queue;
+static std::map<AudioSource const *, PeakQueue::iterator> peaks_queued;
+static std::set<AudioSource const *> peaks_building;
 
 static void
 peak_thread_work ()
@@ -64,49 +87,94 @@ peak_thread_work ()
 
 	while (true) {
 
-		SourceFactory::peak_building_lock.lock ();
+		boost::shared_ptr<AudioSource> as;
 
-	  wait:
-		if (SourceFactory::files_with_peaks.empty()) {
-			SourceFactory::PeaksToBuild.wait (SourceFactory::peak_building_lock);
-		}
+		{
+			Glib::Threads::Mutex::Lock lm (peak_building_lock);
 
-		if (SourceFactory::files_with_peaks.empty()) {
-			goto wait;
-		}
+			while (peak_queue.empty ()) {
+				peaks_to_build.wait (peak_building_lock);
+			}
+
+			PeakRequest const & r (peak_queue.front ());
+
+			as = r.source.lock ();
+			peaks_queued.erase (r.key);
 
-		boost::shared_ptr<AudioSource> as (SourceFactory::files_with_peaks.front().lock());
-		SourceFactory::files_with_peaks.pop_front ();
-		++active_threads;
-		SourceFactory::peak_building_lock.unlock ();
+			if (as) {
+				peaks_building.insert (r.key);
+			}
+
+			peak_queue.pop_front ();
+		}
 
 		if (!as) {
 			continue;
 		}
 
+		/* PeaksReady is emitted by the source once this is done */
+
 		as->setup_peakfile ();
-		SourceFactory::peak_building_lock.lock ();
-		--active_threads;
-		SourceFactory::peak_building_lock.unlock ();
+
+		Glib::Threads::Mutex::Lock lm (peak_building_lock);
+		peaks_building.erase (as.get ());
 	}
 }
 
 int
 SourceFactory::peak_work_queue_length ()
 {
-	// ideally we'd loop over the queue and check for duplicates
-	// and existing valid peak-files..
-	return SourceFactory::files_with_peaks.size () + active_threads;
+	Glib::Threads::Mutex::Lock lm (peak_building_lock);
+	return peak_queue.size () + peaks_building.size ();
 }
 
 void
 SourceFactory::init ()
 {
-	for (int n = 0; n < 2; ++n) {
+	/* building peaks is mostly waiting for the disk, so a couple of
+	 * threads are useful even on a single core; any more than a handful
+	 * just seek against each other.
+	 */
+	uint32_t const n_threads = std::max (2U, std::min (4U, hardware_concurrency () / 2));
+
+	for (uint32_t n = 0; n < n_threads; ++n) {
 		Glib::Threads::Thread::create (sigc::ptr_fun (::peak_thread_work));
 	}
 }
 
+void
+SourceFactory::prioritize_peakfiles (SourceList const & sources)
+{
+	Glib::Threads::Mutex::Lock lm (peak_building_lock);
+
+	/* each source goes in front of the queue, but after the ones
+	 * before it in `sources'.
+	 */
+	PeakQueue::iterator pos = peak_queue.begin ();
+	std::set<AudioSource const *> moved;
+
+	for (SourceList::const_iterator s = sources.begin (); s != sources.end (); ++s) {
+
+		AudioSource const * as = dynamic_cast<AudioSource const *> (s->get ());
+
+		if (!as || !moved.insert (as).second) {
+			continue;
+		}
+
+		std::map<AudioSource const *, PeakQueue::iterator>::iterator i = peaks_queued.find (as);
+
+		if (i == peaks_queued.end ()) {
+			continue;
+		}
+
+		if (i->second == pos) {
+			++pos;
+		} else {
+			peak_queue.splice (pos, peak_queue, i->second);
+		}
+	}
+}
+
 int
 SourceFactory::setup_peakfile (boost::shared_ptr<Source> s, bool async)
 {
@@ -118,8 +186,27 @@ SourceFactory::setup_peakfile (boost::shared_ptr<Source> s, bool async)
 		if (async && !as->empty() && !(as->flags() & Source::NoPeakFile)) {
 
 			Glib::Threads::Mutex::Lock lm (peak_building_lock);
-			files_with_peaks.push_back (boost::weak_ptr<AudioSource> (as));
-			PeaksToBuild.broadcast ();
+
+			std::map<AudioSource const *, PeakQueue::iterator>::iterator i = peaks_queued.find (as.get ());
+
+			if (i != peaks_queued.end () && !i->second->source.expired ()) {
+				/* already waiting */
+				return 0;
+			}
+
+			if (peaks_building.find (as.get ()) != peaks_building.end ()) {
+				/* already being built */
+				return 0;
+			}
+
+			if (i != peaks_queued.end ()) {
+				/* a dead source that happened to live at the same address */
+				peak_queue.erase (i->second);
+				peaks_queued.erase (i);
+			}
+
+			peaks_queued.insert (std::make_pair (as.get (), peak_queue.insert (peak_queue.end (), PeakRequest (as))));
+			peaks_to_build.signal ();
 
 		} else {
 
@@ -147,7 +234,7 @@ SourceFactory::createSilent (Session& s, const XMLNode& node, framecnt_t nframes
 }
 
 boost::shared_ptr<Source>
-SourceFactory::create (Session& s, const XMLNode& node, bool defer_peaks)
+SourceFactory::create (Session& s, const XMLNode& node, bool defer_peaks, bool announce)
 {
 	DataType type = DataType::AUDIO;
 	const XMLProperty* prop = node.property("type");
@@ -171,7 +258,9 @@ SourceFactory::create (Session& s, const XMLNode& node, bool defer_peaks)
 
 				ap->check_for_analysis_data_on_disk ();
 
-				SourceCreated (ap);
+				if (announce) {
+					SourceCreated (ap);
+				}
 				return ap;
 
 			} catch (failed_constructor&) {
@@ -191,7 +280,9 @@ SourceFactory::create (Session& s, const XMLNode& node, bool defer_peaks)
 					return boost::shared_ptr<Source>();
 				}
 				ret->check_for_analysis_data_on_disk ();
-				SourceCreated (ret);
+				if (announce) {
+					SourceCreated (ret);
+				}
 				return ret;
 			}
 
@@ -212,7 +303,9 @@ SourceFactory::create (Session& s, const XMLNode& node, bool defer_peaks)
 				}
 
 				ret->check_for_analysis_data_on_disk ();
-				SourceCreated (ret);
+				if (announce) {
+					SourceCreated (ret);
+				}
 				return ret;
 #else
 				throw; // rethrow
@@ -227,7 +320,9 @@ SourceFactory::create (Session& s, const XMLNode& node, bool defer_peaks)
 		// boost_debug_shared_ptr_mark_interesting (src, "Source");
 #endif
 		src->check_for_analysis_data_on_disk ();
-		SourceCreated (src);
+		if (announce) {
+			SourceCreated (src);
+		}
 		return src;
 	}
 
@@ -0,0 +1,276 @@
+/*
+    Copyright (C) 2016 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/* AVX-512F versions of the runtime functions (see runtime_functions.h).
+ *
+ * None of these care about alignment: unaligned loads are as fast as aligned
+ * ones when the data happens to be aligned, and the last (nframes % 16)
+ * samples are handled with masked loads and stores rather than a scalar loop.
+ *
+ * This file must be compiled with -mavx512f -mfma (or equivalent).
+ */
+
+#include <immintrin.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "ardour/mix.h"
+
+static inline __mmask16
+tail_mask (uint32_t nframes)
+{
+	return (__mmask16) ((1U << nframes) - 1);
+}
+
+float
+x86_avx512f_compute_peak (const float * buf, uint32_t nsamples, float current)
+{
+	__m512 m0 = _mm512_set1_ps (current);
+	__m512 m1 = m0;
+
+	while (nsamples >= 32) {
+		m0 = _mm512_max_ps (m0, _mm512_abs_ps (_mm512_loadu_ps (buf)));
+		m1 = _mm512_max_ps (m1, _mm512_abs_ps (_mm512_loadu_ps (buf + 16)));
+		buf += 32;
+		nsamples -= 32;
+	}
+
+	if (nsamples >= 16) {
+		m0 = _mm512_max_ps (m0, _mm512_abs_ps (_mm512_loadu_ps (buf)));
+		buf += 16;
+		nsamples -= 16;
+	}
+
+	if (nsamples > 0) {
+		/* masked-out lanes load as zero, which cannot raise the peak */
+		m1 = _mm512_max_ps (m1, _mm512_abs_ps (_mm512_maskz_loadu_ps (tail_mask (nsamples), buf)));
+	}
+
+	return _mm512_reduce_max_ps (_mm512_max_ps (m0, m1));
+}
+
+void
+x86_avx512f_find_peaks (const float * buf, uint32_t nframes, float *min, float *max)
+{
+	__m512 cmin = _mm512_set1_ps (*min);
+	__m512 cmax = _mm512_set1_ps (*max);
+
+	while (nframes >= 16) {
+		const __m512 w = _mm512_loadu_ps (buf);
+		cmin = _mm512_min_ps (cmin, w);
+		cmax = _mm512_max_ps (cmax, w);
+		buf += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		cmin = _mm512_mask_min_ps (cmin, m, cmin, _mm512_maskz_loadu_ps (m, buf));
+		cmax = _mm512_mask_max_ps (cmax, m, cmax, _mm512_maskz_loadu_ps (m, buf));
+	}
+
+	*min = _mm512_reduce_min_ps (cmin);
+	*max = _mm512_reduce_max_ps (cmax);
+}
+
+void
+x86_avx512f_apply_gain_to_buffer (float * buf, uint32_t nframes, float gain)
+{
+	const __m512 g = _mm512_set1_ps (gain);
+
+	while (nframes >= 16) {
+		_mm512_storeu_ps (buf, _mm512_mul_ps (_mm512_loadu_ps (buf), g));
+		buf += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (buf, m, _mm512_mul_ps (_mm512_maskz_loadu_ps (m, buf), g));
+	}
+}
+
+void
+x86_avx512f_mix_buffers_with_gain (float * dst, const float * src, uint32_t nframes, float gain)
+{
+	const __m512 g = _mm512_set1_ps (gain);
+
+	while (nframes >= 32) {
+		const __m512 d0 = _mm512_fmadd_ps (_mm512_loadu_ps (src), g, _mm512_loadu_ps (dst));
+		const __m512 d1 = _mm512_fmadd_ps (_mm512_loadu_ps (src + 16), g, _mm512_loadu_ps (dst + 16));
+		_mm512_storeu_ps (dst, d0);
+		_mm512_storeu_ps (dst + 16, d1);
+		dst += 32;
+		src += 32;
+		nframes -= 32;
+	}
+
+	if (nframes >= 16) {
+		_mm512_storeu_ps (dst, _mm512_fmadd_ps (_mm512_loadu_ps (src), g, _mm512_loadu_ps (dst)));
+		dst += 16;
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (dst, m, _mm512_fmadd_ps (_mm512_maskz_loadu_ps (m, src), g, _mm512_maskz_loadu_ps (m, dst)));
+	}
+}
+
+void
+x86_avx512f_mix_buffers_no_gain (float * dst, const float * src, uint32_t nframes)
+{
+	while (nframes >= 32) {
+		const __m512 d0 = _mm512_add_ps (_mm512_loadu_ps (src), _mm512_loadu_ps (dst));
+		const __m512 d1 = _mm512_add_ps (_mm512_loadu_ps (src + 16), _mm512_loadu_ps (dst + 16));
+		_mm512_storeu_ps (dst, d0);
+		_mm512_storeu_ps (dst + 16, d1);
+		dst += 32;
+		src += 32;
+		nframes -= 32;
+	}
+
+	if (nframes >= 16) {
+		_mm512_storeu_ps (dst, _mm512_add_ps (_mm512_loadu_ps (src), _mm512_loadu_ps (dst)));
+		dst += 16;
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (dst, m, _mm512_add_ps (_mm512_maskz_loadu_ps (m, src), _mm512_maskz_loadu_ps (m, dst)));
+	}
+}
+
+void
+x86_avx512f_copy_vector (float * dst, const float * src, uint32_t nframes)
+{
+	/* memcpy() is already as wide as the hardware allows for large copies;
+	 * only do it ourselves for the short buffers that dominate in practice.
+	 */
+	if (nframes > 256) {
+		memcpy (dst, src, nframes * sizeof (float));
+		return;
+	}
+
+	while (nframes >= 16) {
+		_mm512_storeu_ps (dst, _mm512_loadu_ps (src));
+		dst += 16;
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (dst, m, _mm512_maskz_loadu_ps (m, src));
+	}
+}
+
+float
+x86_avx512f_apply_gain_ramp (float * buf, uint32_t nframes, float initial, float target, float coeff)
+{
+	/* see x86_fma_apply_gain_ramp() for the maths */
+	const double r = 1.0 - coeff;
+	const double r16 = pow (r, 16);
+	double dist = initial - target;
+
+	float rp[16];
+	double p = 1.0;
+	for (int k = 0; k < 16; ++k) {
+		rp[k] = p;
+		p *= r;
+	}
+
+	const __m512 rpow = _mm512_loadu_ps (rp);
+	const __m512 tgt = _mm512_set1_ps (target);
+
+	while (nframes >= 16) {
+		const __m512 g = _mm512_fmadd_ps (_mm512_set1_ps (dist), rpow, tgt);
+		_mm512_storeu_ps (buf, _mm512_mul_ps (_mm512_loadu_ps (buf), g));
+		dist *= r16;
+		buf += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		const __m512 g = _mm512_fmadd_ps (_mm512_set1_ps (dist), rpow, tgt);
+		_mm512_mask_storeu_ps (buf, m, _mm512_mul_ps (_mm512_maskz_loadu_ps (m, buf), g));
+		dist *= pow (r, nframes);
+	}
+
+	return target + dist;
+}
+
+void
+x86_avx512f_deinterleave (float * dst, const float * src, uint32_t nframes, uint32_t channel, uint32_t n_channels)
+{
+	src += channel;
+
+	if (n_channels == 1) {
+		x86_avx512f_copy_vector (dst, src, nframes);
+		return;
+	}
+
+	const __m512i idx = _mm512_mullo_epi32 (_mm512_set_epi32 (15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0),
+	                                        _mm512_set1_epi32 (n_channels));
+	const size_t stride = 16 * (size_t) n_channels;
+
+	while (nframes >= 16) {
+		_mm512_storeu_ps (dst, _mm512_i32gather_ps (idx, src, 4));
+		dst += 16;
+		src += stride;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (dst, m, _mm512_mask_i32gather_ps (_mm512_setzero_ps (), m, idx, src, 4));
+	}
+}
+
+void
+x86_avx512f_interleave (float * dst, const float * src, uint32_t nframes, uint32_t channel, uint32_t n_channels)
+{
+	dst += channel;
+
+	if (n_channels == 1) {
+		x86_avx512f_copy_vector (dst, src, nframes);
+		return;
+	}
+
+	const __m512i idx = _mm512_mullo_epi32 (_mm512_set_epi32 (15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0),
+	                                        _mm512_set1_epi32 (n_channels));
+	const size_t stride = 16 * (size_t) n_channels;
+
+	while (nframes >= 16) {
+		_mm512_i32scatter_ps (dst, idx, _mm512_loadu_ps (src), 4);
+		dst += stride;
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_i32scatter_ps (dst, m, idx, _mm512_maskz_loadu_ps (m, src), 4);
+	}
+}
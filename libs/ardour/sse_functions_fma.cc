@@ -0,0 +1,104 @@
+/*
+    Copyright (C) 2016 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/* 256 bit AVX + FMA3 versions of the functions that gain most from a fused
+ * multiply-add. Everything else is left to the SSE/AVX set.
+ *
+ * This file must be compiled with -mavx -mfma (or equivalent).
+ */
+
+#include <immintrin.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "ardour/mix.h"
+
+void
+x86_fma_mix_buffers_with_gain (float * dst, const float * src, uint32_t nframes, float gain)
+{
+	const __m256 g = _mm256_set1_ps (gain);
+
+	while (nframes >= 16) {
+		__m256 d0 = _mm256_loadu_ps (dst);
+		__m256 d1 = _mm256_loadu_ps (dst + 8);
+		d0 = _mm256_fmadd_ps (_mm256_loadu_ps (src), g, d0);
+		d1 = _mm256_fmadd_ps (_mm256_loadu_ps (src + 8), g, d1);
+		_mm256_storeu_ps (dst, d0);
+		_mm256_storeu_ps (dst + 8, d1);
+		dst += 16;
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes >= 8) {
+		_mm256_storeu_ps (dst, _mm256_fmadd_ps (_mm256_loadu_ps (src), g, _mm256_loadu_ps (dst)));
+		dst += 8;
+		src += 8;
+		nframes -= 8;
+	}
+
+	while (nframes > 0) {
+		*dst++ += *src++ * gain;
+		--nframes;
+	}
+
+	_mm256_zeroupper ();
+}
+
+float
+x86_fma_apply_gain_ramp (float * buf, uint32_t nframes, float initial, float target, float coeff)
+{
+	/* the per-sample low-pass g[n+1] = g[n] + coeff * (target - g[n]) has
+	 * the closed form g[n] = target + (initial - target) * (1 - coeff)^n,
+	 * which lets us compute 8 gains at once. The distance to the target
+	 * is carried in double precision between blocks so that it does not
+	 * drift over long ramps.
+	 */
+	const double r = 1.0 - coeff;
+	const double r8 = pow (r, 8);
+	double dist = initial - target;
+
+	float rp[8];
+	double p = 1.0;
+	for (int k = 0; k < 8; ++k) {
+		rp[k] = p;
+		p *= r;
+	}
+
+	const __m256 rpow = _mm256_loadu_ps (rp);
+	const __m256 tgt = _mm256_set1_ps (target);
+
+	while (nframes >= 8) {
+		const __m256 g = _mm256_fmadd_ps (_mm256_set1_ps (dist), rpow, tgt);
+		_mm256_storeu_ps (buf, _mm256_mul_ps (_mm256_loadu_ps (buf), g));
+		dist *= r8;
+		buf += 8;
+		nframes -= 8;
+	}
+
+	_mm256_zeroupper ();
+
+	while (nframes > 0) {
+		*buf++ *= target + dist;
+		dist *= r;
+		--nframes;
+	}
+
+	return target + dist;
+}
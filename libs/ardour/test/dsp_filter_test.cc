@@ -0,0 +1,145 @@
+#include <vector>
+
+#include "ardour/dsp_filter.h"
+
+#include "dsp_filter_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (DSPFilterTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+/** deterministic noise in [-1, 1) */
+static void
+fill_noise (vector<float>& buf)
+{
+	uint32_t seed = 12345;
+	for (vector<float>::iterator i = buf.begin (); i != buf.end (); ++i) {
+		seed = seed * 1103515245 + 12345;
+		*i = (float) ((seed >> 8) & 0xffff) / 32768.f - 1.f;
+	}
+}
+
+/** run @param buf through @param f, in blocks of the sizes in
+ * @param blocks, repeated.
+ */
+template<typename F> static void
+run_in_blocks (F& f, vector<float>& buf, vector<uint32_t> const& blocks)
+{
+	uint32_t done = 0;
+	for (uint32_t b = 0; done < buf.size (); ++b) {
+		const uint32_t n = min (blocks[b % blocks.size ()], (uint32_t) buf.size () - done);
+		f.run (&buf[done], n);
+		done += n;
+	}
+}
+
+void
+DSPFilterTest::delayLineTest ()
+{
+	const uint32_t max_delay = 5000;
+
+	uint32_t const delays[] = { 0, 1, 63, 64, 1000, 3000, 5000 };
+
+	/* block sizes both shorter and longer than the delays, and than
+	 * what the ring-buffer can process in one go.
+	 */
+	vector<uint32_t> blocks;
+	blocks.push_back (64);
+	blocks.push_back (1);
+	blocks.push_back (1000);
+	blocks.push_back (17);
+	blocks.push_back (8192);
+	blocks.push_back (255);
+
+	/* several times the size of the ring-buffer, so that it wraps around */
+	vector<float> in (48000);
+	fill_noise (in);
+
+	for (size_t d = 0; d < sizeof (delays) / sizeof (delays[0]); ++d) {
+		const uint32_t delay = delays[d];
+
+		DSP::DelayLine dl (max_delay);
+		dl.set_delay (delay);
+
+		vector<float> out (in);
+		run_in_blocks (dl, out, blocks);
+
+		for (uint32_t i = 0; i < out.size (); ++i) {
+			const float expected = i < delay ? 0.f : in[i - delay];
+			CPPUNIT_ASSERT_EQUAL (expected, out[i]);
+		}
+	}
+
+	/* delays beyond max_delay are clamped */
+	DSP::DelayLine dl (64);
+	dl.set_delay (1000);
+
+	vector<float> out (in.begin (), in.begin () + 4096);
+	run_in_blocks (dl, out, blocks);
+
+	for (uint32_t i = 0; i < out.size (); ++i) {
+		const float expected = i < 64 ? 0.f : in[i - 64];
+		CPPUNIT_ASSERT_EQUAL (expected, out[i]);
+	}
+}
+
+void
+DSPFilterTest::firFilterTest ()
+{
+	const uint32_t n_taps = 33;
+
+	vector<float> in (10000);
+	fill_noise (in);
+
+	vector<uint32_t> blocks;
+	blocks.push_back (1);
+	blocks.push_back (7);
+	blocks.push_back (64);
+	blocks.push_back (65);
+	blocks.push_back (300);
+
+	/* the initial impulse response is a unit impulse */
+	{
+		DSP::FIRFilter fir (n_taps);
+		vector<float> out (in);
+		run_in_blocks (fir, out, blocks);
+		for (uint32_t i = 0; i < out.size (); ++i) {
+			CPPUNIT_ASSERT_EQUAL (in[i], out[i]);
+		}
+	}
+
+	/* a small max_block splits the longer blocks */
+	DSP::FIRFilter fir (n_taps, 64);
+
+	vector<float> taps (n_taps);
+	for (uint32_t k = 0; k < n_taps; ++k) {
+		taps[k] = 1.f / (1.f + k) * (k & 1 ? -1.f : 1.f);
+		fir.set_tap (k, taps[k]);
+	}
+
+	vector<float> out (in);
+	run_in_blocks (fir, out, blocks);
+
+	/* direct convolution; the filter state carries over between calls */
+	for (uint32_t i = 0; i < out.size (); ++i) {
+		double expected = 0;
+		for (uint32_t k = 0; k < n_taps && k <= i; ++k) {
+			expected += taps[k] * in[i - k];
+		}
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (expected, out[i], 1e-5);
+	}
+
+	/* after a reset, the history is silent again */
+	fir.reset ();
+	out.assign (in.begin (), in.begin () + 100);
+	run_in_blocks (fir, out, blocks);
+
+	for (uint32_t i = 0; i < out.size (); ++i) {
+		double expected = 0;
+		for (uint32_t k = 0; k < n_taps && k <= i; ++k) {
+			expected += taps[k] * in[i - k];
+		}
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (expected, out[i], 1e-5);
+	}
+}
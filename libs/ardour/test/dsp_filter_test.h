@@ -0,0 +1,14 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class DSPFilterTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (DSPFilterTest);
+	CPPUNIT_TEST (delayLineTest);
+	CPPUNIT_TEST (firFilterTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void delayLineTest ();
+	void firFilterTest ();
+};
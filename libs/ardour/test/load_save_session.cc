@@ -10,6 +10,7 @@
 
 #include "ardour/ardour.h"
 #include "ardour/audioengine.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/session.h"
 
 #include "test_ui.h"
@@ -33,10 +34,40 @@ pause_for_effect()
 	g_usleep(sleep_seconds*1000000);
 }
 
+static
+Session*
+timed_load_session (const char* dir, const char* name, uint64_t& usecs)
+{
+	PBD::Timing load_session_timing;
+
+	Session* s = 0;
+
+	try {
+		s = load_session (dir, name);
+	} catch (failed_constructor& e) {
+		cerr << "failed_constructor: " << e.what() << "\n";
+		exit (EXIT_FAILURE);
+	} catch (AudioEngine::PortRegistrationFailure& e) {
+		cerr << "PortRegistrationFailure: " << e.what() << "\n";
+		exit (EXIT_FAILURE);
+	} catch (exception& e) {
+		cerr << "exception: " << e.what() << "\n";
+		exit (EXIT_FAILURE);
+	} catch (...) {
+		cerr << "unknown exception.\n";
+		exit (EXIT_FAILURE);
+	}
+
+	load_session_timing.update();
+	usecs = load_session_timing.elapsed();
+
+	return s;
+}
+
 int main (int argc, char* argv[])
 {
-	if (argc != 3) {
-		cerr << "Syntax: " << argv[0] << " <dir> <snapshot-name>\n";
+	if (argc != 3 && argc != 4) {
+		cerr << "Syntax: " << argv[0] << " <dir> <snapshot-name> [<source-loading-threads>]\n";
 		exit (EXIT_FAILURE);
 	}
 
@@ -56,33 +87,49 @@ int main (int argc, char* argv[])
 
 	create_and_start_dummy_backend ();
 
-	std::cerr << "Loading session: " << argv[2] << std::endl;
+	Session* s = 0;
+	uint64_t load_usecs;
 
-	PBD::Timing load_session_timing;
+	if (argc == 4) {
 
-	Session* s = 0;
+		/* compare loading with the given number of source-loading
+		 * threads against loading with one. The threaded load goes
+		 * first, so that a warm file-system cache favours the
+		 * single-threaded one.
+		 */
 
-	try {
-		s = load_session (argv[1], argv[2]);
-	} catch (failed_constructor& e) {
-		cerr << "failed_constructor: " << e.what() << "\n";
-		exit (EXIT_FAILURE);
-	} catch (AudioEngine::PortRegistrationFailure& e) {
-		cerr << "PortRegistrationFailure: " << e.what() << "\n";
-		exit (EXIT_FAILURE);
-	} catch (exception& e) {
-		cerr << "exception: " << e.what() << "\n";
-		exit (EXIT_FAILURE);
-	} catch (...) {
-		cerr << "unknown exception.\n";
-		exit (EXIT_FAILURE);
+		const uint32_t n_threads = atoi (argv[3]);
+
+		Config->set_session_load_threads (n_threads);
+
+		std::cerr << "Loading session: " << argv[2] << " (" << n_threads << " threads)" << std::endl;
+
+		s = timed_load_session (argv[1], argv[2], load_usecs);
+
+		std::cerr << "Loading session time : " << load_usecs
+		          << " usecs" << std::endl;
+
+		AudioEngine::instance()->remove_session ();
+		delete s;
+
+		Config->set_session_load_threads (1);
 	}
 
-	load_session_timing.update();
+	std::cerr << "Loading session: " << argv[2] << std::endl;
+
+	uint64_t usecs;
 
-	std::cerr << "Loading session time : " << load_session_timing.elapsed()
+	s = timed_load_session (argv[1], argv[2], usecs);
+
+	std::cerr << "Loading session time : " << usecs
 	          << " usecs" << std::endl;
 
+	if (argc == 4) {
+		std::cerr << "Loading session speedup : x"
+		          << (load_usecs > 0 ? usecs / (double) load_usecs : 0.0)
+		          << std::endl;
+	}
+
 	PBD::Timing save_session_timing;
 
 	pause_for_effect ();
@@ -0,0 +1,117 @@
+/*
+    Copyright (C) 2016 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include "ardour/playlist.h"
+#include "ardour/region.h"
+#include "ardour/audioplaylist.h"
+#include "ardour/audioregion.h"
+#include "playlist_read_plan_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (PlaylistReadPlanTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+void
+PlaylistReadPlanTest::setUp ()
+{
+	AudioRegionTest::setUp ();
+
+	_N = 1024;
+	_buf = new Sample[_N];
+	_mbuf = new Sample[_N];
+	_gbuf = new float[_N];
+
+	for (int i = 0; i < _N; ++i) {
+		_buf[i] = 0;
+	}
+}
+
+void
+PlaylistReadPlanTest::tearDown ()
+{
+	delete[] _buf;
+	delete[] _mbuf;
+	delete[] _gbuf;
+
+	AudioRegionTest::tearDown ();
+}
+
+/* Check that reads follow changes to the playlist and its regions between
+   them, rather than reusing the read plan worked out for a previous read.
+   All reads are well clear of the regions' fades.
+*/
+void
+PlaylistReadPlanTest::changedReadTest ()
+{
+	_audio_playlist->add_region (_ar[0], 0);
+	_ar[0]->set_default_fade_in ();
+	_ar[0]->set_default_fade_out ();
+	_ar[0]->set_length (1024);
+
+	_audio_playlist->read (_buf, _mbuf, _gbuf, 256, 128, 0);
+	check_staircase (_buf, 256, 128);
+
+	/* Move the region */
+	_ar[0]->set_position (128);
+
+	_audio_playlist->read (_buf, _mbuf, _gbuf, 256, 128, 0);
+	check_staircase (_buf, 128, 128);
+
+	_audio_playlist->read (_buf, _mbuf, _gbuf, 0, 128, 0);
+	check_silence (_buf, 128);
+
+	/* Mute it */
+	_ar[0]->set_muted (true);
+
+	_audio_playlist->read (_buf, _mbuf, _gbuf, 256, 128, 0);
+	check_silence (_buf, 128);
+
+	/* Unmute it, and put a second region on top of it */
+	_ar[0]->set_muted (false);
+	_audio_playlist->add_region (_ar[1], 0);
+	_ar[1]->set_default_fade_in ();
+	_ar[1]->set_default_fade_out ();
+	_ar[1]->set_length (1024);
+
+	_audio_playlist->read (_buf, _mbuf, _gbuf, 256, 128, 0);
+	check_staircase (_buf, 256, 128);
+
+	/* And remove it again */
+	_audio_playlist->remove_region (_ar[1]);
+
+	_audio_playlist->read (_buf, _mbuf, _gbuf, 256, 128, 0);
+	check_staircase (_buf, 128, 128);
+}
+
+void
+PlaylistReadPlanTest::check_staircase (Sample* b, int offset, int N)
+{
+	for (int i = 0; i < N; ++i) {
+		int const j = i + offset;
+		CPPUNIT_ASSERT_EQUAL (j, int (b[i]));
+	}
+}
+
+void
+PlaylistReadPlanTest::check_silence (Sample* b, int N)
+{
+	for (int i = 0; i < N; ++i) {
+		CPPUNIT_ASSERT_EQUAL (float (0), b[i]);
+	}
+}
@@ -0,0 +1,167 @@
+/*
+    Copyright (C) 2016 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include "ardour/playlist.h"
+#include "ardour/region.h"
+#include "playlist_region_index_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (PlaylistRegionIndexTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+/* Regions are all 100 frames long */
+
+void
+PlaylistRegionIndexTest::touchedTest ()
+{
+	_playlist->clear ();
+
+	_playlist->add_region (_r[0], 0);
+	_playlist->add_region (_r[1], 50);
+	_playlist->add_region (_r[2], 1000);
+
+	vector<boost::shared_ptr<Region> > r;
+
+	_playlist->regions_touched (0, 49, r);
+	CPPUNIT_ASSERT_EQUAL (size_t (1), r.size ());
+	CPPUNIT_ASSERT_EQUAL (_r[0], r[0]);
+
+	r.clear ();
+	_playlist->regions_touched (60, 99, r);
+	CPPUNIT_ASSERT_EQUAL (size_t (2), r.size ());
+	CPPUNIT_ASSERT_EQUAL (_r[0], r[0]);
+	CPPUNIT_ASSERT_EQUAL (_r[1], r[1]);
+
+	r.clear ();
+	_playlist->regions_touched (150, 1000, r);
+	CPPUNIT_ASSERT_EQUAL (size_t (1), r.size ());
+	CPPUNIT_ASSERT_EQUAL (_r[2], r[0]);
+
+	r.clear ();
+	_playlist->regions_touched (150, 999, r);
+	CPPUNIT_ASSERT (r.empty ());
+
+	CPPUNIT_ASSERT_EQUAL (uint32_t (2), _playlist->count_regions_at (75));
+	CPPUNIT_ASSERT_EQUAL (_r[1], _playlist->top_region_at (75));
+
+	r.clear ();
+	_playlist->regions_with_start_within (Evoral::Range<framepos_t> (1, 1000), r);
+	CPPUNIT_ASSERT_EQUAL (size_t (2), r.size ());
+	CPPUNIT_ASSERT_EQUAL (_r[1], r[0]);
+	CPPUNIT_ASSERT_EQUAL (_r[2], r[1]);
+
+	r.clear ();
+	_playlist->regions_with_end_within (Evoral::Range<framepos_t> (0, 149), r);
+	CPPUNIT_ASSERT_EQUAL (size_t (2), r.size ());
+
+	_playlist->remove_region (_r[0]);
+	CPPUNIT_ASSERT_EQUAL (uint32_t (1), _playlist->count_regions_at (75));
+}
+
+void
+PlaylistRegionIndexTest::boundsChangedTest ()
+{
+	_playlist->clear ();
+
+	_playlist->add_region (_r[0], 0);
+	_playlist->add_region (_r[1], 500);
+
+	/* Move and trim regions and check that the index follows them */
+	_r[0]->set_position (2000);
+	_r[1]->trim_end (549);
+
+	vector<boost::shared_ptr<Region> > r;
+
+	_playlist->regions_touched (0, 499, r);
+	CPPUNIT_ASSERT (r.empty ());
+
+	_playlist->regions_touched (550, 1999, r);
+	CPPUNIT_ASSERT (r.empty ());
+
+	_playlist->regions_touched (0, 2000, r);
+	CPPUNIT_ASSERT_EQUAL (size_t (2), r.size ());
+	CPPUNIT_ASSERT_EQUAL (_r[1], r[0]);
+	CPPUNIT_ASSERT_EQUAL (_r[0], r[1]);
+
+	/* A region that is no longer in the playlist must not be found */
+	_playlist->remove_region (_r[1]);
+	_r[1]->set_position (2000);
+
+	CPPUNIT_ASSERT_EQUAL (uint32_t (1), _playlist->count_regions_at (2000));
+}
+
+void
+PlaylistRegionIndexTest::findNextRegionTest ()
+{
+	_playlist->clear ();
+
+	_playlist->add_region (_r[0], 100);
+	_playlist->add_region (_r[1], 300);
+	_playlist->add_region (_r[2], 500);
+
+	CPPUNIT_ASSERT_EQUAL (_r[1], _playlist->find_next_region (100, Start, 1));
+	CPPUNIT_ASSERT_EQUAL (_r[0], _playlist->find_next_region (300, Start, -1));
+	CPPUNIT_ASSERT_EQUAL (_r[1], _playlist->find_next_region (199, End, 1));
+	CPPUNIT_ASSERT (!_playlist->find_next_region (500, Start, 1));
+	CPPUNIT_ASSERT (!_playlist->find_next_region (100, Start, -1));
+}
+
+void
+PlaylistRegionIndexTest::nestedRegionsTest ()
+{
+	_playlist->clear ();
+
+	/* _r[0] covers 0..999, with _r[1] (100..199) and _r[2] (300..399) inside it */
+	_r[0]->trim_end (999);
+	_playlist->add_region (_r[0], 0);
+	_playlist->add_region (_r[1], 100);
+	_playlist->add_region (_r[2], 300);
+
+	vector<boost::shared_ptr<Region> > r;
+
+	_playlist->regions_touched (200, 299, r);
+	CPPUNIT_ASSERT_EQUAL (size_t (1), r.size ());
+	CPPUNIT_ASSERT_EQUAL (_r[0], r[0]);
+
+	r.clear ();
+	_playlist->regions_touched (150, 350, r);
+	CPPUNIT_ASSERT_EQUAL (size_t (3), r.size ());
+	CPPUNIT_ASSERT_EQUAL (_r[0], r[0]);
+	CPPUNIT_ASSERT_EQUAL (_r[1], r[1]);
+	CPPUNIT_ASSERT_EQUAL (_r[2], r[2]);
+
+	CPPUNIT_ASSERT_EQUAL (uint32_t (2), _playlist->count_regions_at (150));
+	CPPUNIT_ASSERT_EQUAL (_r[1], _playlist->top_region_at (150));
+
+	r.clear ();
+	_playlist->regions_with_end_within (Evoral::Range<framepos_t> (0, 500), r);
+	CPPUNIT_ASSERT_EQUAL (size_t (2), r.size ());
+	CPPUNIT_ASSERT_EQUAL (_r[1], r[0]);
+	CPPUNIT_ASSERT_EQUAL (_r[2], r[1]);
+
+	/* the nearest end, not the end of the region that starts first */
+	CPPUNIT_ASSERT_EQUAL (_r[1], _playlist->find_next_region (150, End, 1));
+	CPPUNIT_ASSERT_EQUAL (_r[2], _playlist->find_next_region (199, End, 1));
+	CPPUNIT_ASSERT_EQUAL (_r[0], _playlist->find_next_region (399, End, 1));
+	CPPUNIT_ASSERT (!_playlist->find_next_region (999, End, 1));
+
+	/* moving the outer region inside the others updates its end */
+	_r[0]->trim_end (149);
+	CPPUNIT_ASSERT_EQUAL (_r[0], _playlist->find_next_region (100, End, 1));
+}
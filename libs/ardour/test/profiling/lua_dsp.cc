@@ -0,0 +1,138 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+
+#include <glib.h>
+
+#include "test_util.h"
+#include "pbd/failed_constructor.h"
+#include "ardour/ardour.h"
+#include "ardour/audioengine.h"
+#include "ardour/buffer_set.h"
+#include "ardour/chan_mapping.h"
+#include "ardour/luaproc.h"
+#include "ardour/session.h"
+
+using namespace std;
+using namespace ARDOUR;
+
+/* Time Lua DSP scripts processing stereo audio at a few block sizes, to
+ * compare scripts written with per-sample Lua loops against ones using the
+ * ARDOUR.DSP functions and classes.
+ *
+ * usage: lua_dsp <session-dir> <snapshot-name> <script.lua> [<script.lua> ...]
+ */
+
+static const char* localedir = LOCALEDIR;
+static const pframes_t block_sizes[] = { 64, 256, 1024 };
+static const double seconds = 10.0;
+
+static bool
+read_script (const char* path, string& script)
+{
+	ifstream f (path);
+	if (!f) {
+		return false;
+	}
+	stringstream ss;
+	ss << f.rdbuf ();
+	script = ss.str ();
+	return true;
+}
+
+static void
+bench (Session* s, const char* path, string const & script)
+{
+	boost::shared_ptr<LuaProc> p;
+	try {
+		p.reset (new LuaProc (*AudioEngine::instance (), *s, script));
+	} catch (failed_constructor& e) {
+		cerr << path << ": not a valid Lua DSP script\n";
+		return;
+	}
+
+	const ChanCount in (DataType::AUDIO, 2);
+	ChanCount out (DataType::AUDIO, 2);
+	if (!p->can_support_io_configuration (in, out, 0) || !p->configure_io (in, out)) {
+		cerr << path << ": cannot be configured for stereo\n";
+		return;
+	}
+
+	ChanCount bufcnt (ChanCount::max (in, out));
+	bufcnt.set (DataType::MIDI, 1);
+
+	const pframes_t capacity = AudioEngine::instance ()->samples_per_cycle ();
+	BufferSet bufs;
+	bufs.ensure_buffers (bufcnt, capacity);
+	bufs.set_count (bufcnt);
+
+	for (size_t b = 0; b < sizeof (block_sizes) / sizeof (block_sizes[0]); ++b) {
+		const pframes_t nframes = min (block_sizes[b], capacity);
+		const int cycles = max (1, (int) (seconds * s->nominal_frame_rate () / nframes));
+
+		bufs.silence (capacity, 0);
+		for (uint32_t c = 0; c < bufs.count ().n_audio (); ++c) {
+			Sample* d = bufs.get_audio (c).data ();
+			for (pframes_t i = 0; i < capacity; ++i) {
+				d[i] = (rand () / (float) RAND_MAX) * 2.0f - 1.0f;
+			}
+		}
+
+		const gint64 start = g_get_monotonic_time ();
+		for (int i = 0; i < cycles; ++i) {
+			p->connect_and_run (bufs, ChanMapping (in), ChanMapping (out), nframes, 0);
+		}
+		const gint64 usecs = g_get_monotonic_time () - start;
+
+		cout << path << "\t" << nframes << " frames\t"
+		     << (usecs * 1000.0 / ((double) cycles * nframes)) << " ns/frame\t"
+		     << "x" << (usecs > 0 ? seconds * 1e6 / usecs : 0.0) << " realtime"
+		     << endl;
+	}
+}
+
+int main (int argc, char* argv[])
+{
+	if (argc < 4) {
+		cerr << "Syntax: " << argv[0] << " <dir> <snapshot-name> <script.lua> [<script.lua> ...]\n";
+		exit (EXIT_FAILURE);
+	}
+
+	ARDOUR::init (false, true, localedir);
+
+	Session* s = 0;
+
+	try {
+		s = load_session (argv[1], argv[2]);
+	} catch (failed_constructor& e) {
+		cerr << "failed_constructor: " << e.what() << "\n";
+		exit (EXIT_FAILURE);
+	} catch (AudioEngine::PortRegistrationFailure& e) {
+		cerr << "PortRegistrationFailure: " << e.what() << "\n";
+		exit (EXIT_FAILURE);
+	} catch (exception& e) {
+		cerr << "exception: " << e.what() << "\n";
+		exit (EXIT_FAILURE);
+	} catch (...) {
+		cerr << "unknown exception.\n";
+		exit (EXIT_FAILURE);
+	}
+
+	for (int i = 3; i < argc; ++i) {
+		string script;
+		if (!read_script (argv[i], script)) {
+			cerr << argv[i] << ": cannot read\n";
+			continue;
+		}
+		bench (s, argv[i], script);
+	}
+
+	AudioEngine::instance()->remove_session ();
+	delete s;
+	AudioEngine::instance()->stop ();
+
+	AudioEngine::destroy ();
+
+	return 0;
+}
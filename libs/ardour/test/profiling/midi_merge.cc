@@ -0,0 +1,155 @@
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+
+#include <glib.h>
+
+#include "ardour/midi_buffer.h"
+
+using namespace std;
+using namespace ARDOUR;
+
+/* Time merging N MIDI buffers into one, one source at a time with
+ * MidiBuffer::merge_in_place (const MidiBuffer&) and all at once with
+ * MidiBuffer::merge_in_place (const MidiBuffer* const*, uint32_t),
+ * for a range of source counts and event densities.
+ *
+ * usage: midi_merge [nframes [iterations]]
+ */
+
+static pframes_t nframes = 1024;
+static int iterations = 2000;
+
+static const uint32_t source_counts[] = { 2, 4, 8, 16, 32, 64 };
+static const uint32_t densities[] = { 4, 32, 128, 512 };
+
+static void
+fill (MidiBuffer& buf, uint32_t n_events)
+{
+	vector<MidiBuffer::TimeType> times;
+
+	for (uint32_t n = 0; n < n_events; ++n) {
+		times.push_back (rand() % nframes);
+	}
+	sort (times.begin(), times.end());
+
+	buf.clear ();
+
+	for (uint32_t n = 0; n < n_events; ++n) {
+		uint8_t ev[3];
+		switch (rand() % 3) {
+		case 0:
+			ev[0] = 0x90 | (rand() % 16);
+			break;
+		case 1:
+			ev[0] = 0xb0 | (rand() % 16);
+			break;
+		default:
+			ev[0] = 0xe0 | (rand() % 16);
+			break;
+		}
+		ev[1] = rand() % 128;
+		ev[2] = 1 + rand() % 127;
+		buf.push_back (times[n], 3, ev);
+	}
+}
+
+/** @return true if @a buf holds @a n_events events in time order */
+static bool
+check (MidiBuffer const & buf, size_t n_events)
+{
+	size_t n = 0;
+	MidiBuffer::TimeType last = 0;
+
+	for (MidiBuffer::const_iterator i = buf.begin(); i != buf.end(); ++i, ++n) {
+		if ((*i).time() < last) {
+			return false;
+		}
+		last = (*i).time();
+	}
+
+	return n == n_events;
+}
+
+int
+main (int argc, char* argv[])
+{
+	if (argc > 1) {
+		nframes = atoi (argv[1]);
+	}
+	if (argc > 2) {
+		iterations = atoi (argv[2]);
+	}
+
+	const uint32_t max_sources = source_counts[sizeof (source_counts) / sizeof (source_counts[0]) - 1];
+	const uint32_t max_density = densities[sizeof (densities) / sizeof (densities[0]) - 1];
+	const size_t capacity = (max_sources + 1) * max_density * (sizeof (MidiBuffer::TimeType) + 3);
+
+	vector<MidiBuffer*> sources;
+	for (uint32_t s = 0; s < max_sources; ++s) {
+		sources.push_back (new MidiBuffer (capacity));
+	}
+	MidiBuffer own (capacity);
+	MidiBuffer dst (capacity);
+
+	cout << "nframes: " << nframes << ", iterations: " << iterations << endl;
+	cout << "sources\tevents/source\tone-at-a-time\tall-at-once\tspeedup" << endl;
+
+	int failures = 0;
+
+	for (size_t d = 0; d < sizeof (densities) / sizeof (densities[0]); ++d) {
+		for (size_t c = 0; c < sizeof (source_counts) / sizeof (source_counts[0]); ++c) {
+
+			const uint32_t n_sources = source_counts[c];
+			const size_t n_events = (n_sources + 1) * densities[d];
+
+			fill (own, densities[d]);
+			for (uint32_t s = 0; s < n_sources; ++s) {
+				fill (*sources[s], densities[d]);
+			}
+
+			bool ok = true;
+
+			gint64 before = g_get_monotonic_time ();
+			for (int i = 0; i < iterations; ++i) {
+				dst.copy (own);
+				for (uint32_t s = 0; s < n_sources; ++s) {
+					ok = dst.merge_in_place (*sources[s]) && ok;
+				}
+			}
+			const gint64 pairwise = g_get_monotonic_time () - before;
+			ok = check (dst, n_events) && ok;
+
+			before = g_get_monotonic_time ();
+			for (int i = 0; i < iterations; ++i) {
+				dst.copy (own);
+				ok = dst.merge_in_place (&sources[0], n_sources) && ok;
+			}
+			const gint64 kway = g_get_monotonic_time () - before;
+			ok = check (dst, n_events) && ok;
+
+			if (!ok) {
+				++failures;
+			}
+
+			cout << n_sources << "\t" << densities[d] << "\t"
+			     << (pairwise * 1000.0 / iterations) << " ns\t"
+			     << (kway * 1000.0 / iterations) << " ns\t"
+			     << "x" << (kway > 0 ? pairwise / (double) kway : 0.0)
+			     << (ok ? "" : "\tFAILED")
+			     << endl;
+		}
+	}
+
+	for (uint32_t s = 0; s < max_sources; ++s) {
+		delete sources[s];
+	}
+
+	if (failures) {
+		cerr << failures << " merge(s) lost events or were out of order\n";
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,344 @@
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include <glib.h>
+
+#include "pbd/fpu.h"
+#include "pbd/malign.h"
+#include "ardour/mix.h"
+#include "ardour/runtime_functions.h"
+
+using namespace std;
+using namespace PBD;
+using namespace ARDOUR;
+
+/* Time every available implementation of the runtime functions against the
+ * default_* versions, checking that they all produce the same results.
+ *
+ * usage: mix_functions [nframes [iterations]]
+ */
+
+struct FunctionSet {
+	const char*             name;
+	bool                    available;
+	compute_peak_t          compute_peak;
+	find_peaks_t            find_peaks;
+	apply_gain_to_buffer_t  apply_gain_to_buffer;
+	mix_buffers_with_gain_t mix_buffers_with_gain;
+	mix_buffers_no_gain_t   mix_buffers_no_gain;
+	copy_vector_t           copy_vector;
+	apply_gain_ramp_t       apply_gain_ramp;
+	deinterleave_t          deinterleave;
+	interleave_t            interleave;
+};
+
+static const uint32_t n_channels = 4;
+
+static pframes_t nframes = 1024;
+static int iterations = 100000;
+
+static Sample* src;
+static Sample* dst;
+static Sample* expected;
+static Sample* interleaved;
+
+static Sample*
+alloc_buffer (size_t n)
+{
+	void* p;
+	cache_aligned_malloc (&p, n * sizeof (Sample));
+	return (Sample*) p;
+}
+
+static void
+fill (Sample* buf, size_t n)
+{
+	for (size_t i = 0; i < n; ++i) {
+		buf[i] = (rand() / (float) RAND_MAX) * 2.0f - 1.0f;
+	}
+}
+
+static bool
+same (Sample const * a, Sample const * b, size_t n)
+{
+	for (size_t i = 0; i < n; ++i) {
+		if (fabsf (a[i] - b[i]) > 1e-5 * max (1.f, fabsf (a[i]))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void
+report (const char* op, const char* set, gint64 usecs, gint64 default_usecs, bool ok)
+{
+	cout << op << "\t" << set << "\t"
+	     << (usecs * 1000.0 / iterations) << " ns/call\t"
+	     << "x" << (usecs > 0 ? default_usecs / (double) usecs : 0.0)
+	     << (ok ? "" : "\tMISMATCH")
+	     << endl;
+}
+
+/* Each bench_* function runs one operation from one set: once to check the
+ * result against the reference computed by the default set, then
+ * `iterations' times for timing. It returns the time taken, or -1 if the
+ * set does not provide the operation.
+ */
+
+static gint64
+bench_compute_peak (FunctionSet const & fs, float& result)
+{
+	if (!fs.compute_peak) {
+		return -1;
+	}
+	result = fs.compute_peak (src, nframes, 0.0f);
+	float p = 0.0f;
+	const gint64 start = g_get_monotonic_time ();
+	for (int i = 0; i < iterations; ++i) {
+		p = fs.compute_peak (src, nframes, p);
+	}
+	return g_get_monotonic_time () - start;
+}
+
+static gint64
+bench_find_peaks (FunctionSet const & fs, float& mn, float& mx)
+{
+	if (!fs.find_peaks) {
+		return -1;
+	}
+	mn = 1.0f;
+	mx = -1.0f;
+	fs.find_peaks (src, nframes, &mn, &mx);
+	float a = 1.0f;
+	float b = -1.0f;
+	const gint64 start = g_get_monotonic_time ();
+	for (int i = 0; i < iterations; ++i) {
+		fs.find_peaks (src, nframes, &a, &b);
+	}
+	return g_get_monotonic_time () - start;
+}
+
+static gint64
+bench_apply_gain_to_buffer (FunctionSet const & fs)
+{
+	if (!fs.apply_gain_to_buffer) {
+		return -1;
+	}
+	memcpy (dst, src, nframes * sizeof (Sample));
+	fs.apply_gain_to_buffer (dst, nframes, 0.5f);
+	const gint64 start = g_get_monotonic_time ();
+	for (int i = 0; i < iterations; ++i) {
+		fs.apply_gain_to_buffer (expected + nframes, nframes, 1.0f);
+	}
+	return g_get_monotonic_time () - start;
+}
+
+static gint64
+bench_mix_buffers_with_gain (FunctionSet const & fs)
+{
+	if (!fs.mix_buffers_with_gain) {
+		return -1;
+	}
+	memcpy (dst, src, nframes * sizeof (Sample));
+	fs.mix_buffers_with_gain (dst, src + nframes, nframes, 0.5f);
+	const gint64 start = g_get_monotonic_time ();
+	for (int i = 0; i < iterations; ++i) {
+		fs.mix_buffers_with_gain (expected + nframes, src, nframes, 0.0f);
+	}
+	return g_get_monotonic_time () - start;
+}
+
+static gint64
+bench_mix_buffers_no_gain (FunctionSet const & fs)
+{
+	if (!fs.mix_buffers_no_gain) {
+		return -1;
+	}
+	memcpy (dst, src, nframes * sizeof (Sample));
+	fs.mix_buffers_no_gain (dst, src + nframes, nframes);
+	const gint64 start = g_get_monotonic_time ();
+	for (int i = 0; i < iterations; ++i) {
+		fs.mix_buffers_no_gain (expected + nframes, src, nframes);
+	}
+	return g_get_monotonic_time () - start;
+}
+
+static gint64
+bench_copy_vector (FunctionSet const & fs)
+{
+	if (!fs.copy_vector) {
+		return -1;
+	}
+	fs.copy_vector (dst, src, nframes);
+	const gint64 start = g_get_monotonic_time ();
+	for (int i = 0; i < iterations; ++i) {
+		fs.copy_vector (expected + nframes, src, nframes);
+	}
+	return g_get_monotonic_time () - start;
+}
+
+static gint64
+bench_apply_gain_ramp (FunctionSet const & fs, float& result)
+{
+	if (!fs.apply_gain_ramp) {
+		return -1;
+	}
+	const float a = 156.825 / 48000.0;
+	memcpy (dst, src, nframes * sizeof (Sample));
+	result = fs.apply_gain_ramp (dst, nframes, 0.25f, 1.0f, a);
+	const gint64 start = g_get_monotonic_time ();
+	for (int i = 0; i < iterations; ++i) {
+		fs.apply_gain_ramp (expected + nframes, nframes, 1.0f, 1.0f, a);
+	}
+	return g_get_monotonic_time () - start;
+}
+
+static gint64
+bench_deinterleave (FunctionSet const & fs)
+{
+	if (!fs.deinterleave) {
+		return -1;
+	}
+	fs.deinterleave (dst, interleaved, nframes, 1, n_channels);
+	const gint64 start = g_get_monotonic_time ();
+	for (int i = 0; i < iterations; ++i) {
+		fs.deinterleave (expected + nframes, interleaved, nframes, i % n_channels, n_channels);
+	}
+	return g_get_monotonic_time () - start;
+}
+
+static gint64
+bench_interleave (FunctionSet const & fs)
+{
+	if (!fs.interleave) {
+		return -1;
+	}
+	Sample* out = alloc_buffer (nframes * n_channels);
+	memcpy (out, interleaved, nframes * n_channels * sizeof (Sample));
+	fs.interleave (out, src, nframes, 2, n_channels);
+	memcpy (dst, out, nframes * sizeof (Sample));
+	const gint64 start = g_get_monotonic_time ();
+	for (int i = 0; i < iterations; ++i) {
+		fs.interleave (out, src, nframes, i % n_channels, n_channels);
+	}
+	const gint64 elapsed = g_get_monotonic_time () - start;
+	cache_aligned_free (out);
+	return elapsed;
+}
+
+int
+main (int argc, char* argv[])
+{
+	if (argc > 1) {
+		nframes = atoi (argv[1]);
+	}
+	if (argc > 2) {
+		iterations = atoi (argv[2]);
+	}
+
+	FPU* fpu = FPU::instance ();
+
+	FunctionSet sets[] = {
+		{ "default", true,
+		  default_compute_peak, default_find_peaks, default_apply_gain_to_buffer,
+		  default_mix_buffers_with_gain, default_mix_buffers_no_gain, default_copy_vector,
+		  default_apply_gain_ramp, default_deinterleave, default_interleave },
+#if defined (ARCH_X86) && defined (BUILD_SSE_OPTIMIZATIONS)
+		{ "sse", fpu->has_sse (),
+		  x86_sse_compute_peak, x86_sse_find_peaks, x86_sse_apply_gain_to_buffer,
+		  x86_sse_mix_buffers_with_gain, x86_sse_mix_buffers_no_gain, 0,
+		  0, 0, 0 },
+		{ "avx", fpu->has_avx (),
+		  x86_sse_avx_compute_peak, x86_sse_avx_find_peaks, x86_sse_avx_apply_gain_to_buffer,
+		  x86_sse_avx_mix_buffers_with_gain, x86_sse_avx_mix_buffers_no_gain, x86_sse_avx_copy_vector,
+		  0, 0, 0 },
+		{ "fma", fpu->has_fma (),
+		  0, 0, 0,
+		  x86_fma_mix_buffers_with_gain, 0, 0,
+		  x86_fma_apply_gain_ramp, 0, 0 },
+		{ "avx512f", fpu->has_avx512f (),
+		  x86_avx512f_compute_peak, x86_avx512f_find_peaks, x86_avx512f_apply_gain_to_buffer,
+		  x86_avx512f_mix_buffers_with_gain, x86_avx512f_mix_buffers_no_gain, x86_avx512f_copy_vector,
+		  x86_avx512f_apply_gain_ramp, x86_avx512f_deinterleave, x86_avx512f_interleave },
+#endif
+#if defined (__APPLE__) && defined (BUILD_VECLIB_OPTIMIZATIONS)
+		{ "veclib", true,
+		  veclib_compute_peak, veclib_find_peaks, veclib_apply_gain_to_buffer,
+		  veclib_mix_buffers_with_gain, veclib_mix_buffers_no_gain, 0,
+		  0, 0, 0 },
+#endif
+	};
+
+	const size_t n_sets = sizeof (sets) / sizeof (sets[0]);
+
+	src = alloc_buffer (nframes * 2);
+	dst = alloc_buffer (nframes);
+	expected = alloc_buffer (nframes * 2);
+	interleaved = alloc_buffer (nframes * n_channels);
+
+	fill (src, nframes * 2);
+	fill (expected, nframes * 2);
+	fill (interleaved, nframes * n_channels);
+
+	cout << "nframes: " << nframes << ", iterations: " << iterations << endl;
+
+	int failures = 0;
+
+#define BENCH(op, call, check)                                          \
+	{                                                                   \
+		gint64 default_usecs = 0;                                       \
+		for (size_t s = 0; s < n_sets; ++s) {                           \
+			FunctionSet const & fs (sets[s]);                           \
+			if (!fs.available) {                                        \
+				continue;                                               \
+			}                                                           \
+			const gint64 usecs = call;                                  \
+			if (usecs < 0) {                                            \
+				continue;                                               \
+			}                                                           \
+			bool ok = true;                                             \
+			if (s == 0) {                                               \
+				default_usecs = usecs;                                  \
+				memcpy (expected, dst, nframes * sizeof (Sample));           \
+				expected_value = value;                                      \
+				expected_value2 = value2;                                    \
+			} else {                                                    \
+				ok = check;                                             \
+			}                                                           \
+			if (!ok) {                                                  \
+				++failures;                                             \
+			}                                                           \
+			report (op, fs.name, usecs, default_usecs, ok);             \
+		}                                                               \
+	}
+
+	float value = 0;
+	float value2 = 0;
+	float expected_value = 0;
+	float expected_value2 = 0;
+
+	BENCH ("compute_peak", bench_compute_peak (fs, value), value == expected_value);
+	BENCH ("find_peaks", bench_find_peaks (fs, value, value2), value == expected_value && value2 == expected_value2);
+	BENCH ("apply_gain_to_buffer", bench_apply_gain_to_buffer (fs), same (expected, dst, nframes));
+	BENCH ("mix_buffers_with_gain", bench_mix_buffers_with_gain (fs), same (expected, dst, nframes));
+	BENCH ("mix_buffers_no_gain", bench_mix_buffers_no_gain (fs), same (expected, dst, nframes));
+	BENCH ("copy_vector", bench_copy_vector (fs), same (expected, dst, nframes));
+	BENCH ("apply_gain_ramp", bench_apply_gain_ramp (fs, value),
+	       same (expected, dst, nframes) && fabsf (value - expected_value) < 1e-5);
+	BENCH ("deinterleave", bench_deinterleave (fs), same (expected, dst, nframes));
+	BENCH ("interleave", bench_interleave (fs), same (expected, dst, nframes));
+
+	cache_aligned_free (src);
+	cache_aligned_free (dst);
+	cache_aligned_free (expected);
+	cache_aligned_free (interleaved);
+
+	if (failures) {
+		cerr << failures << " implementation(s) did not match the default\n";
+		return 1;
+	}
+
+	return 0;
+}
@@ -4,10 +4,13 @@
 
 #include <stdexcept>
 
+#include <boost/bind.hpp>
+
 #include "pbd/textreceiver.h"
 #include "pbd/file_utils.h"
 #include "ardour/session.h"
 #include "ardour/audioengine.h"
+#include "ardour/filename_extensions.h"
 #include "ardour/smf_source.h"
 #include "ardour/midi_model.h"
 
@@ -85,3 +88,45 @@ SessionTest::new_session_from_template ()
 	delete template_session;
 	stop_and_destroy_backend ();
 }
+
+static void
+count_save (int* saves, std::string, int64_t capture_usecs, int64_t total_usecs)
+{
+	CPPUNIT_ASSERT (capture_usecs <= total_usecs);
+	g_atomic_int_inc (saves);
+}
+
+void
+SessionTest::background_save ()
+{
+	const string session_name("background_save");
+	std::string new_session_dir = Glib::build_filename (new_test_output_dir(), session_name);
+
+	create_and_start_dummy_backend ();
+
+	Session* session = load_session (new_session_dir, session_name);
+
+	CPPUNIT_ASSERT (session);
+
+	int saves = 0;
+	ScopedConnection c;
+	session->StateSaveTimed.connect_same_thread (c, boost::bind (&count_save, &saves, _1, _2, _3));
+
+	/* back to back saves of the same file may be coalesced, but at least
+	 * one must be written, and the session is clean as soon as it is captured.
+	 */
+	for (int i = 0; i < 10; ++i) {
+		session->set_dirty ();
+		CPPUNIT_ASSERT (session->save_state_in_background ("") == 0);
+		CPPUNIT_ASSERT (!session->dirty ());
+	}
+
+	session->wait_for_background_save ();
+
+	CPPUNIT_ASSERT (g_atomic_int_get (&saves) >= 1);
+	CPPUNIT_ASSERT (g_atomic_int_get (&saves) <= 10);
+	CPPUNIT_ASSERT (Glib::file_test (Glib::build_filename (new_session_dir, session_name + statefile_suffix), Glib::FILE_TEST_EXISTS));
+
+	delete session;
+	stop_and_destroy_backend ();
+}
@@ -7,10 +7,12 @@ class SessionTest : public CppUnit::TestFixture
 	CPPUNIT_TEST_SUITE (SessionTest);
 	CPPUNIT_TEST (new_session);
 	CPPUNIT_TEST (new_session_from_template);
+	CPPUNIT_TEST (background_save);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
 
 	void new_session ();
 	void new_session_from_template ();
+	void background_save ();
 };
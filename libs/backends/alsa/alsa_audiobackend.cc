@@ -1647,6 +1647,12 @@ AlsaAudioBackend::midi_event_get (
 	return 0;
 }
 
+struct MidiEventSorter {
+	bool operator() (const boost::shared_ptr<AlsaMidiEvent>& a, const boost::shared_ptr<AlsaMidiEvent>& b) {
+		return *a < *b;
+	}
+};
+
 int
 AlsaAudioBackend::midi_event_put (
 		void* port_buffer,
@@ -1655,14 +1661,17 @@ AlsaAudioBackend::midi_event_put (
 {
 	assert (buffer && port_buffer);
 	AlsaMidiBuffer& dst = * static_cast<AlsaMidiBuffer*>(port_buffer);
+	boost::shared_ptr<AlsaMidiEvent> ev (new AlsaMidiEvent (timestamp, buffer, size));
 	if (dst.size () && (pframes_t)dst.back ()->timestamp () > timestamp) {
 #ifndef NDEBUG
-		// nevermind, ::get_buffer() sorts events
+		// nevermind, keep the buffer sorted for ::get_buffer()
 		fprintf (stderr, "AlsaMidiBuffer: it's too late for this event. %d > %d\n",
 				(pframes_t)dst.back ()->timestamp (), timestamp);
 #endif
+		dst.insert (std::upper_bound (dst.begin (), dst.end (), ev, MidiEventSorter()), ev);
+	} else {
+		dst.push_back (ev);
 	}
-	dst.push_back (boost::shared_ptr<AlsaMidiEvent>(new AlsaMidiEvent (timestamp, buffer, size)));
 	return 0;
 }
 
@@ -2272,25 +2281,38 @@ AlsaMidiPort::AlsaMidiPort (AlsaAudioBackend &b, const std::string& name, PortFl
 
 AlsaMidiPort::~AlsaMidiPort () { }
 
-struct MidiEventSorter {
-	bool operator() (const boost::shared_ptr<AlsaMidiEvent>& a, const boost::shared_ptr<AlsaMidiEvent>& b) {
-		return *a < *b;
-	}
-};
-
 void* AlsaMidiPort::get_buffer (pframes_t /* nframes */)
 {
 	if (is_input ()) {
 		(_buffer[_bufperiod]).clear ();
+		_merge_srcs.clear ();
 		for (std::vector<AlsaPort*>::const_iterator i = get_connections ().begin ();
 				i != get_connections ().end ();
 				++i) {
 			const AlsaMidiBuffer * src = static_cast<const AlsaMidiPort*>(*i)->const_buffer ();
-			for (AlsaMidiBuffer::const_iterator it = src->begin (); it != src->end (); ++it) {
-				(_buffer[_bufperiod]).push_back (boost::shared_ptr<AlsaMidiEvent>(new AlsaMidiEvent (**it)));
+			if (!src->empty ()) {
+				_merge_srcs.push_back (std::make_pair (src->begin (), src->end ()));
+			}
+		}
+		/* each source is already in time order: merge them all in one
+		 * pass, earlier connections first for simultaneous events.
+		 */
+		while (true) {
+			size_t next = _merge_srcs.size ();
+			for (size_t s = 0; s < _merge_srcs.size (); ++s) {
+				if (_merge_srcs[s].first == _merge_srcs[s].second) {
+					continue;
+				}
+				if (next == _merge_srcs.size () || **_merge_srcs[s].first < **_merge_srcs[next].first) {
+					next = s;
+				}
+			}
+			if (next == _merge_srcs.size ()) {
+				break;
 			}
+			(_buffer[_bufperiod]).push_back (boost::shared_ptr<AlsaMidiEvent>(new AlsaMidiEvent (**_merge_srcs[next].first)));
+			++_merge_srcs[next].first;
 		}
-		std::sort ((_buffer[_bufperiod]).begin (), (_buffer[_bufperiod]).end (), MidiEventSorter());
 	}
 	return &(_buffer[_bufperiod]);
 }
@@ -155,6 +155,7 @@ class AlsaMidiPort : public AlsaPort {
 
 	private:
 		AlsaMidiBuffer _buffer[3];
+		std::vector<std::pair<AlsaMidiBuffer::const_iterator, AlsaMidiBuffer::const_iterator> > _merge_srcs;
 		int _n_periods;
 		int _bufperiod;
 }; // class AlsaMidiPort
@@ -1063,6 +1063,12 @@ ASIOBackend::midi_event_get (
 	return 0;
 }
 
+struct MidiEventSorter {
+	bool operator() (const boost::shared_ptr<WindowsMidiEvent>& a, const boost::shared_ptr<WindowsMidiEvent>& b) {
+		return *a < *b;
+	}
+};
+
 int
 ASIOBackend::midi_event_put (
 		void* port_buffer,
@@ -1071,14 +1077,17 @@ ASIOBackend::midi_event_put (
 {
 	if (!buffer || !port_buffer) return -1;
 	WindowsMidiBuffer& dst = * static_cast<WindowsMidiBuffer*>(port_buffer);
+	boost::shared_ptr<WindowsMidiEvent> ev (new WindowsMidiEvent (timestamp, buffer, size));
 	if (dst.size () && (pframes_t)dst.back ()->timestamp () > timestamp) {
 #ifndef NDEBUG
-		// nevermind, ::get_buffer() sorts events
+		// nevermind, keep the buffer sorted for ::get_buffer()
 		fprintf (stderr, "WindowsMidiBuffer: unordered event: %d > %d\n",
 				(pframes_t)dst.back ()->timestamp (), timestamp);
 #endif
+		dst.insert (std::upper_bound (dst.begin (), dst.end (), ev, MidiEventSorter()), ev);
+	} else {
+		dst.push_back (ev);
 	}
-	dst.push_back (boost::shared_ptr<WindowsMidiEvent>(new WindowsMidiEvent (timestamp, buffer, size)));
 	return 0;
 }
 
@@ -1789,25 +1798,38 @@ WindowsMidiPort::WindowsMidiPort (ASIOBackend &b, const std::string& name, PortF
 
 WindowsMidiPort::~WindowsMidiPort () { }
 
-struct MidiEventSorter {
-	bool operator() (const boost::shared_ptr<WindowsMidiEvent>& a, const boost::shared_ptr<WindowsMidiEvent>& b) {
-		return *a < *b;
-	}
-};
-
 void* WindowsMidiPort::get_buffer (pframes_t /* nframes */)
 {
 	if (is_input ()) {
 		(_buffer[_bufperiod]).clear ();
+		_merge_srcs.clear ();
 		for (std::vector<ASIOBackendPort*>::const_iterator i = get_connections ().begin ();
 				i != get_connections ().end ();
 				++i) {
 			const WindowsMidiBuffer * src = static_cast<const WindowsMidiPort*>(*i)->const_buffer ();
-			for (WindowsMidiBuffer::const_iterator it = src->begin (); it != src->end (); ++it) {
-				(_buffer[_bufperiod]).push_back (boost::shared_ptr<WindowsMidiEvent>(new WindowsMidiEvent (**it)));
+			if (!src->empty ()) {
+				_merge_srcs.push_back (std::make_pair (src->begin (), src->end ()));
+			}
+		}
+		/* each source is already in time order: merge them all in one
+		 * pass, earlier connections first for simultaneous events.
+		 */
+		while (true) {
+			size_t next = _merge_srcs.size ();
+			for (size_t s = 0; s < _merge_srcs.size (); ++s) {
+				if (_merge_srcs[s].first == _merge_srcs[s].second) {
+					continue;
+				}
+				if (next == _merge_srcs.size () || **_merge_srcs[s].first < **_merge_srcs[next].first) {
+					next = s;
+				}
+			}
+			if (next == _merge_srcs.size ()) {
+				break;
 			}
+			(_buffer[_bufperiod]).push_back (boost::shared_ptr<WindowsMidiEvent>(new WindowsMidiEvent (**_merge_srcs[next].first)));
+			++_merge_srcs[next].first;
 		}
-		std::sort ((_buffer[_bufperiod]).begin (), (_buffer[_bufperiod]).end (), MidiEventSorter());
 	}
 	return &(_buffer[_bufperiod]);
 }
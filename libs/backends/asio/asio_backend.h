@@ -147,6 +147,7 @@ class WindowsMidiPort : public ASIOBackendPort {
 
 	private:
 		WindowsMidiBuffer _buffer[2];
+		std::vector<std::pair<WindowsMidiBuffer::const_iterator, WindowsMidiBuffer::const_iterator> > _merge_srcs;
 		int _n_periods;
 		int _bufperiod;
 }; // class WindowsMidiPort
@@ -155,6 +155,7 @@ class CoreMidiPort : public CoreBackendPort {
 
   private:
 	CoreMidiBuffer _buffer[2];
+	std::vector<std::pair<CoreMidiBuffer::const_iterator, CoreMidiBuffer::const_iterator> > _merge_srcs;
 	int _n_periods;
 	int _bufperiod;
 
@@ -69,6 +69,7 @@ DummyAudioBackend::DummyAudioBackend (AudioEngine& e, AudioBackendInfo& info)
 	, _systemic_input_latency (0)
 	, _systemic_output_latency (0)
 	, _processed_samples (0)
+	, _cycle_count (0)
 	, _port_change_flag (false)
 {
 	_instance_name = s_instance_name;
@@ -437,6 +438,8 @@ DummyAudioBackend::_start (bool /*for_latency_measurement*/)
 		_system_midi_in.clear();
 		_system_midi_out.clear();
 		_ports.clear();
+		_portmap.clear();
+		_portset.clear();
 	}
 
 	if (register_system_ports()) {
@@ -646,7 +649,17 @@ DummyAudioBackend::set_port_name (PortEngine::PortHandle port, const std::string
 		PBD::error << _("DummyBackend::set_port_name: Invalid Port(s)") << endmsg;
 		return -1;
 	}
-	return static_cast<DummyPort*>(port)->set_name (_instance_name + ":" + name);
+	DummyPort* p = static_cast<DummyPort*>(port);
+	const std::string newname (_instance_name + ":" + name);
+	DummyPort* other = find_port (newname);
+	if (other && other != p) {
+		PBD::error << _("DummyBackend::set_port_name: Port with given name already exists") << endmsg;
+		return -1;
+	}
+	_portmap.erase (p->name ());
+	int rv = p->set_name (newname);
+	_portmap.insert (std::make_pair (p->name (), p));
+	return rv;
 }
 
 std::string
@@ -744,6 +757,8 @@ DummyAudioBackend::add_port (
 	}
 
 	_ports.push_back (port);
+	_portmap.insert (std::make_pair (name, port));
+	_portset.insert (port);
 
 	return port;
 }
@@ -764,6 +779,8 @@ DummyAudioBackend::unregister_port (PortEngine::PortHandle port_handle)
 	}
 	disconnect_all(port_handle);
 	_ports.erase (i);
+	_portmap.erase (port->name ());
+	_portset.erase (port);
 	delete port;
 }
 
@@ -870,6 +887,8 @@ DummyAudioBackend::unregister_ports (bool system_only)
 		DummyPort* port = *i;
 		if (! system_only || (port->is_physical () && port->is_terminal ())) {
 			port->disconnect_all ();
+			_portmap.erase (port->name ());
+			_portset.erase (port);
 			delete port;
 			i = _ports.erase (i);
 		} else {
@@ -1018,6 +1037,12 @@ DummyAudioBackend::midi_event_get (
 	return 0;
 }
 
+struct MidiEventSorter {
+	bool operator() (const boost::shared_ptr<DummyMidiEvent>& a, const boost::shared_ptr<DummyMidiEvent>& b) {
+		return *a < *b;
+	}
+};
+
 int
 DummyAudioBackend::midi_event_put (
 		void* port_buffer,
@@ -1026,11 +1051,14 @@ DummyAudioBackend::midi_event_put (
 {
 	assert (buffer && port_buffer);
 	DummyMidiBuffer& dst = * static_cast<DummyMidiBuffer*>(port_buffer);
+	boost::shared_ptr<DummyMidiEvent> ev (new DummyMidiEvent (timestamp, buffer, size));
 	if (dst.size () && (pframes_t)dst.back ()->timestamp () > timestamp) {
-		// nevermind, ::get_buffer() sorts events, but always print warning
+		// nevermind, keep the buffer sorted for ::get_buffer(), but always print warning
 		fprintf (stderr, "DummyMidiBuffer: it's too late for this event %d > %d.\n", (pframes_t)dst.back ()->timestamp (), timestamp);
+		dst.insert (std::upper_bound (dst.begin (), dst.end (), ev, MidiEventSorter()), ev);
+	} else {
+		dst.push_back (ev);
 	}
-	dst.push_back (boost::shared_ptr<DummyMidiEvent>(new DummyMidiEvent (timestamp, buffer, size)));
 #if 0 // DEBUG MIDI EVENTS
 	printf("DummyAudioBackend::midi_event_put %d, %zu: ", timestamp, size);
 	for (size_t xx = 0; xx < size; ++xx) {
@@ -1239,6 +1267,8 @@ DummyAudioBackend::main_process_thread ()
 			(*it)->next_period();
 		}
 
+		++_cycle_count;
+
 		if (engine.process_callback (_samples_per_period)) {
 			return 0;
 		}
@@ -1397,6 +1427,11 @@ DummyPort::DummyPort (DummyAudioBackend &b, const std::string& name, PortFlags f
 	: _dummy_backend (b)
 	, _name  (name)
 	, _flags (flags)
+	, _mix_valid (false)
+	, _mix_cycle (0)
+	, _mix_nframes (0)
+	, _mix_gen (0)
+	, _buffer_gen (0)
 	, _rseed (0)
 	, _gen_cycle (false)
 {
@@ -1457,6 +1492,7 @@ int DummyPort::connect (DummyPort *port)
 void DummyPort::_connect (DummyPort *port, bool callback)
 {
 	_connections.push_back (port);
+	_mix_valid = false;
 	if (callback) {
 		port->_connect (this, false);
 		_dummy_backend.port_connect_callback (name(),  port->name(), true);
@@ -1487,6 +1523,7 @@ void DummyPort::_disconnect (DummyPort *port, bool callback)
 	assert (it != _connections.end ());
 
 	_connections.erase (it);
+	_mix_valid = false;
 
 	if (callback) {
 		port->_disconnect (this, false);
@@ -1497,6 +1534,7 @@ void DummyPort::_disconnect (DummyPort *port, bool callback)
 
 void DummyPort::disconnect_all ()
 {
+	_mix_valid = false;
 	while (!_connections.empty ()) {
 		_connections.back ()->_disconnect (this, false);
 		_dummy_backend.port_connect_callback (name(),  _connections.back ()->name(), false);
@@ -1504,6 +1542,36 @@ void DummyPort::disconnect_all ()
 	}
 }
 
+bool DummyPort::mixdown_valid (pframes_t n_samples)
+{
+	uint64_t gen = 0;
+
+	for (std::vector<DummyPort*>::const_iterator it = _connections.begin (); it != _connections.end (); ++it) {
+		DummyPort * source = *it;
+		if (source->is_physical() && source->is_terminal()) {
+			source->get_buffer(n_samples); // generate signal.
+		}
+		gen += source->_buffer_gen;
+	}
+
+	/* generation counters only ever increase, so an unchanged sum means
+	 * that no source has been written since we last summed them.
+	 */
+	if (_mix_valid
+			&& _mix_cycle == _dummy_backend._cycle_count
+			&& _mix_nframes == n_samples
+			&& _mix_gen == gen) {
+		return true;
+	}
+
+	_mix_valid = true;
+	_mix_cycle = _dummy_backend._cycle_count;
+	_mix_nframes = n_samples;
+	_mix_gen = gen;
+
+	return false;
+}
+
 bool
 DummyPort::is_connected (const DummyPort *port) const
 {
@@ -1824,11 +1892,15 @@ void DummyAudioPort::generate (const pframes_t n_samples)
 			break;
 	}
 	_gen_cycle = true;
+	++_buffer_gen;
 }
 
 void* DummyAudioPort::get_buffer (pframes_t n_samples)
 {
 	if (is_input ()) {
+		if (mixdown_valid (n_samples)) {
+			return _buffer;
+		}
 		std::vector<DummyPort*>::const_iterator it = get_connections ().begin ();
 		if (it == get_connections ().end ()) {
 			memset (_buffer, 0, n_samples * sizeof (Sample));
@@ -1856,6 +1928,9 @@ void* DummyAudioPort::get_buffer (pframes_t n_samples)
 		if (!_gen_cycle) {
 			generate(n_samples);
 		}
+	} else if (is_output ()) {
+		/* the caller is about to write to it */
+		++_buffer_gen;
 	}
 	return _buffer;
 }
@@ -1876,12 +1951,6 @@ DummyMidiPort::~DummyMidiPort () {
 	_loopback.clear ();
 }
 
-struct MidiEventSorter {
-	bool operator() (const boost::shared_ptr<DummyMidiEvent>& a, const boost::shared_ptr<DummyMidiEvent>& b) {
-		return *a < *b;
-	}
-};
-
 void DummyMidiPort::set_loopback (DummyMidiBuffer const * const src)
 {
 	_loopback.clear ();
@@ -1908,6 +1977,7 @@ void DummyMidiPort::midi_generate (const pframes_t n_samples)
 
 	_buffer.clear ();
 	_gen_cycle = true;
+	++_buffer_gen;
 
 	if (_midi_seq_spb == 0 || !_midi_seq_dat) {
 		for (DummyMidiBuffer::const_iterator it = _loopback.begin (); it != _loopback.end (); ++it) {
@@ -1943,7 +2013,11 @@ void DummyMidiPort::midi_generate (const pframes_t n_samples)
 void* DummyMidiPort::get_buffer (pframes_t n_samples)
 {
 	if (is_input ()) {
+		if (mixdown_valid (n_samples)) {
+			return &_buffer;
+		}
 		_buffer.clear ();
+		_merge_srcs.clear ();
 		for (std::vector<DummyPort*>::const_iterator i = get_connections ().begin ();
 				i != get_connections ().end ();
 				++i) {
@@ -1952,15 +2026,36 @@ void* DummyMidiPort::get_buffer (pframes_t n_samples)
 				source->get_buffer(n_samples); // generate signal.
 			}
 			const DummyMidiBuffer *src = source->const_buffer ();
-			for (DummyMidiBuffer::const_iterator it = src->begin (); it != src->end (); ++it) {
-				_buffer.push_back (boost::shared_ptr<DummyMidiEvent>(new DummyMidiEvent (**it)));
+			if (!src->empty ()) {
+				_merge_srcs.push_back (std::make_pair (src->begin (), src->end ()));
+			}
+		}
+		/* each source is already in time order: merge them all in one
+		 * pass, earlier connections first for simultaneous events.
+		 */
+		while (true) {
+			size_t next = _merge_srcs.size ();
+			for (size_t s = 0; s < _merge_srcs.size (); ++s) {
+				if (_merge_srcs[s].first == _merge_srcs[s].second) {
+					continue;
+				}
+				if (next == _merge_srcs.size () || **_merge_srcs[s].first < **_merge_srcs[next].first) {
+					next = s;
+				}
+			}
+			if (next == _merge_srcs.size ()) {
+				break;
 			}
+			_buffer.push_back (boost::shared_ptr<DummyMidiEvent>(new DummyMidiEvent (**_merge_srcs[next].first)));
+			++_merge_srcs[next].first;
 		}
-		std::sort (_buffer.begin (), _buffer.end (), MidiEventSorter());
 	} else if (is_output () && is_physical () && is_terminal()) {
 		if (!_gen_cycle) {
 			midi_generate(n_samples);
 		}
+	} else if (is_output ()) {
+		/* the caller is about to write to it */
+		++_buffer_gen;
 	}
 	return &_buffer;
 }
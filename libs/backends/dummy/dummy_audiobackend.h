@@ -29,6 +29,7 @@
 #include <pthread.h>
 
 #include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
 
 #include "ardour/types.h"
 #include "ardour/audio_backend.h"
@@ -123,7 +124,24 @@ class DummyPort {
 		void _connect (DummyPort* , bool);
 		void _disconnect (DummyPort* , bool);
 
+		// cached mix-down of our connections (input ports)
+		bool      _mix_valid;
+		uint64_t  _mix_cycle;
+		pframes_t _mix_nframes;
+		uint64_t  _mix_gen;
+
 	protected:
+		/* input ports: true if the buffer still holds the mix of all
+		 * connected ports for this cycle, in which case it need not be
+		 * summed again.
+		 */
+		bool mixdown_valid (pframes_t nframes);
+
+		/* output ports: bumped whenever the buffer may have been
+		 * (re)written, to invalidate the mix-down of connected inputs.
+		 */
+		uint64_t _buffer_gen;
+
 		// random number generator
 		void setup_random_number_generator ();
 		inline float    randf ();
@@ -206,6 +224,7 @@ class DummyMidiPort : public DummyPort {
 	private:
 		DummyMidiBuffer _buffer;
 		DummyMidiBuffer _loopback;
+		std::vector<std::pair<DummyMidiBuffer::const_iterator, DummyMidiBuffer::const_iterator> > _merge_srcs;
 
 		// midi event generator ('fake' physical inputs)
 		void midi_generate (const pframes_t n_samples);
@@ -416,6 +435,7 @@ class DummyAudioBackend : public AudioBackend {
 		uint32_t _systemic_output_latency;
 
 		framecnt_t _processed_samples;
+		uint64_t   _cycle_count;
 
 		pthread_t _main_thread;
 
@@ -443,6 +463,10 @@ class DummyAudioBackend : public AudioBackend {
 		std::vector<DummyMidiPort *> _system_midi_out;
 		std::vector<DummyPort *> _ports;
 
+		typedef boost::unordered_map<std::string, DummyPort*> PortMap;
+		PortMap                  _portmap;
+		std::set<DummyPort*>     _portset;
+
 		struct PortConnectData {
 			std::string a;
 			std::string b;
@@ -469,16 +493,15 @@ class DummyAudioBackend : public AudioBackend {
 		}
 
 		bool valid_port (PortHandle port) const {
-			return std::find (_ports.begin (), _ports.end (), (DummyPort*)port) != _ports.end ();
+			return _portset.find ((DummyPort*)port) != _portset.end ();
 		}
 
 		DummyPort * find_port (const std::string& port_name) const {
-			for (std::vector<DummyPort*>::const_iterator it = _ports.begin (); it != _ports.end (); ++it) {
-				if ((*it)->name () == port_name) {
-					return *it;
-				}
+			PortMap::const_iterator it = _portmap.find (port_name);
+			if (it == _portmap.end ()) {
+				return NULL;
 			}
-			return NULL;
+			return it->second;
 		}
 
 }; // class DummyAudioBackend
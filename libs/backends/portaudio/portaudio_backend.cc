@@ -1608,6 +1608,12 @@ PortAudioBackend::midi_event_get (
 	return 0;
 }
 
+struct MidiEventSorter {
+	bool operator() (const boost::shared_ptr<PortMidiEvent>& a, const boost::shared_ptr<PortMidiEvent>& b) {
+		return *a < *b;
+	}
+};
+
 int
 PortAudioBackend::midi_event_put (
 		void* port_buffer,
@@ -1616,13 +1622,16 @@ PortAudioBackend::midi_event_put (
 {
 	if (!buffer || !port_buffer) return -1;
 	PortMidiBuffer& dst = * static_cast<PortMidiBuffer*>(port_buffer);
+	boost::shared_ptr<PortMidiEvent> ev (new PortMidiEvent (timestamp, buffer, size));
 	if (dst.size () && (pframes_t)dst.back ()->timestamp () > timestamp) {
-		// nevermind, ::get_buffer() sorts events
+		// nevermind, keep the buffer sorted for ::get_buffer()
 		DEBUG_MIDI (string_compose ("PortMidiBuffer: unordered event: %1 > %2\n",
 		                            (pframes_t)dst.back ()->timestamp (),
 		                            timestamp));
+		dst.insert (std::upper_bound (dst.begin (), dst.end (), ev, MidiEventSorter()), ev);
+	} else {
+		dst.push_back (ev);
 	}
-	dst.push_back (boost::shared_ptr<PortMidiEvent>(new PortMidiEvent (timestamp, buffer, size)));
 	return 0;
 }
 
@@ -2338,25 +2347,38 @@ PortMidiPort::PortMidiPort (PortAudioBackend &b, const std::string& name, PortFl
 
 PortMidiPort::~PortMidiPort () { }
 
-struct MidiEventSorter {
-	bool operator() (const boost::shared_ptr<PortMidiEvent>& a, const boost::shared_ptr<PortMidiEvent>& b) {
-		return *a < *b;
-	}
-};
-
 void* PortMidiPort::get_buffer (pframes_t /* nframes */)
 {
 	if (is_input ()) {
 		(_buffer[_bufperiod]).clear ();
+		_merge_srcs.clear ();
 		for (std::vector<PamPort*>::const_iterator i = get_connections ().begin ();
 				i != get_connections ().end ();
 				++i) {
 			const PortMidiBuffer * src = static_cast<const PortMidiPort*>(*i)->const_buffer ();
-			for (PortMidiBuffer::const_iterator it = src->begin (); it != src->end (); ++it) {
-				(_buffer[_bufperiod]).push_back (boost::shared_ptr<PortMidiEvent>(new PortMidiEvent (**it)));
+			if (!src->empty ()) {
+				_merge_srcs.push_back (std::make_pair (src->begin (), src->end ()));
+			}
+		}
+		/* each source is already in time order: merge them all in one
+		 * pass, earlier connections first for simultaneous events.
+		 */
+		while (true) {
+			size_t next = _merge_srcs.size ();
+			for (size_t s = 0; s < _merge_srcs.size (); ++s) {
+				if (_merge_srcs[s].first == _merge_srcs[s].second) {
+					continue;
+				}
+				if (next == _merge_srcs.size () || **_merge_srcs[s].first < **_merge_srcs[next].first) {
+					next = s;
+				}
+			}
+			if (next == _merge_srcs.size ()) {
+				break;
 			}
+			(_buffer[_bufperiod]).push_back (boost::shared_ptr<PortMidiEvent>(new PortMidiEvent (**_merge_srcs[next].first)));
+			++_merge_srcs[next].first;
 		}
-		std::sort ((_buffer[_bufperiod]).begin (), (_buffer[_bufperiod]).end (), MidiEventSorter());
 	}
 	return &(_buffer[_bufperiod]);
 }
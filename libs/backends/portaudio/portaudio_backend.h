@@ -151,6 +151,7 @@ class PortMidiPort : public PamPort {
 
 	private:
 		PortMidiBuffer _buffer[2];
+		std::vector<std::pair<PortMidiBuffer::const_iterator, PortMidiBuffer::const_iterator> > _merge_srcs;
 		int _n_periods;
 		int _bufperiod;
 }; // class PortMidiPort
@@ -0,0 +1,249 @@
+#include <iostream>
+#include <list>
+#include <vector>
+#include <cstdlib>
+
+#include <boost/bind.hpp>
+
+#include <glib.h>
+#include <gtkmm/main.h>
+#include <cairomm/cairomm.h>
+
+#include "pbd/compose.h"
+#include "pbd/cpus.h"
+
+#include "gtkmm2ext/gtk_ui.h"
+#include "gtkmm2ext/utils.h"
+
+#include "ardour/ardour.h"
+#include "ardour/audioengine.h"
+#include "ardour/audioregion.h"
+#include "ardour/playlist.h"
+#include "ardour/session.h"
+#include "ardour/session_playlists.h"
+
+#include "canvas/canvas.h"
+#include "canvas/wave_view.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace ArdourCanvas;
+
+/* Time how long the WaveView drawing threads take to generate the waveform
+ * images for every audio region of a session, laid out one playlist channel
+ * per row as in the editor, with one drawing thread and with several.
+ *
+ * Only the top rows fit in the (unmapped) canvas window. The rows below it
+ * are rendered first, as if the user had just scrolled back up, so the time
+ * until the visible rows are ready shows the effect of visible requests
+ * being served first.
+ *
+ * Peak files should already exist (open the session in Ardour once), and a
+ * display is needed for the GUI event loop that WaveViews report to.
+ *
+ * usage: render_waveviews <session-dir> <snapshot-name> [<threads>]
+ */
+
+static const int width = 1920;
+static const int height = 1080;
+static const Coord row_height = 64;
+
+static gint ready = 0;
+static gint visible_ready = 0;
+
+static void
+image_ready (bool visible)
+{
+	g_atomic_int_inc (&ready);
+	if (visible) {
+		g_atomic_int_inc (&visible_ready);
+	}
+}
+
+static void
+add_region (list<boost::shared_ptr<Region> >* regions, boost::shared_ptr<Region> r)
+{
+	regions->push_back (r);
+}
+
+struct Run {
+	double visible_secs;
+	double all_secs;
+	int    views;
+	int    visible_views;
+};
+
+/* Lay out the waveviews of all of @param session's audio regions on
+ * @param canvas, render the whole lot and wait for the drawing threads.
+ * @param spp is varied from run to run so that no run finds images from
+ * the previous one in the cache.
+ */
+static Run
+run (Session* session, GtkCanvas& canvas, double spp)
+{
+	vector<boost::shared_ptr<Playlist> > playlists;
+	session->playlists->get (playlists);
+
+	vector<WaveView*> views;
+	PBD::ScopedConnectionList connections;
+	Coord y = 0;
+	Run r = { 0, 0, 0, 0 };
+
+	for (vector<boost::shared_ptr<Playlist> >::iterator p = playlists.begin(); p != playlists.end(); ++p) {
+
+		if ((*p)->data_type() != DataType::AUDIO) {
+			continue;
+		}
+
+		list<boost::shared_ptr<Region> > regions;
+		(*p)->foreach_region (boost::bind (&add_region, &regions, _1));
+
+		uint32_t channels = 0;
+
+		for (list<boost::shared_ptr<Region> >::iterator i = regions.begin(); i != regions.end(); ++i) {
+			boost::shared_ptr<AudioRegion> ar = boost::dynamic_pointer_cast<AudioRegion> (*i);
+			if (!ar) {
+				continue;
+			}
+			for (uint32_t c = 0; c < ar->n_channels(); ++c) {
+				WaveView* wv = new WaveView (canvas.root(), ar);
+				wv->set_channel (c);
+				wv->set_samples_per_pixel (spp);
+				wv->set_height (row_height);
+				wv->set_position (Duple (ar->position() / spp, y + c * row_height));
+
+				const bool visible = y + c * row_height < height;
+				wv->ImageReady.connect_same_thread (connections, boost::bind (&image_ready, visible));
+
+				views.push_back (wv);
+				++r.views;
+				if (visible) {
+					++r.visible_views;
+				}
+			}
+			channels = max (channels, ar->n_channels());
+		}
+
+		y += channels * row_height;
+	}
+
+	g_atomic_int_set (&ready, 0);
+	g_atomic_int_set (&visible_ready, 0);
+
+	Cairo::RefPtr<Cairo::ImageSurface> surface = Cairo::ImageSurface::create (Cairo::FORMAT_ARGB32, width, height);
+	Cairo::RefPtr<Cairo::Context> context = Cairo::Context::create (surface);
+
+	const gint64 start = g_get_monotonic_time ();
+
+	/* render the canvas a window-height strip at a time, bottom up, so
+	 * that the visible rows are asked for last.
+	 */
+	for (Coord strip = max (0.0, y - height); ; strip = max (0.0, strip - height)) {
+		context->save ();
+		context->translate (0, -strip);
+		canvas.render (Rect (0, strip, width, strip + height), context);
+		context->restore ();
+		if (strip == 0) {
+			break;
+		}
+	}
+
+	while (g_atomic_int_get (&ready) < r.views) {
+		if (r.visible_secs == 0 && g_atomic_int_get (&visible_ready) == r.visible_views) {
+			r.visible_secs = (g_get_monotonic_time () - start) / 1e6;
+		}
+		g_usleep (1000);
+	}
+
+	r.all_secs = (g_get_monotonic_time () - start) / 1e6;
+
+	if (r.visible_secs == 0) {
+		r.visible_secs = r.all_secs;
+	}
+
+	connections.drop_connections ();
+
+	for (vector<WaveView*>::iterator v = views.begin(); v != views.end(); ++v) {
+		delete *v;
+	}
+
+	/* let the GUI thread handle the ImageReady requests */
+	while (Glib::MainContext::get_default()->iteration (false)) {}
+
+	return r;
+}
+
+static void
+report (const char* what, uint32_t threads, Run const & r, Run const & ref)
+{
+	cout << what << "\t" << threads << " threads\t"
+	     << r.visible_secs << " s visible (" << r.visible_views << " views)\t"
+	     << r.all_secs << " s all (" << r.views << " views)";
+	if (&r != &ref) {
+		cout << "\tx" << (r.all_secs > 0 ? ref.all_secs / r.all_secs : 0.0);
+	}
+	cout << endl;
+}
+
+int main (int argc, char* argv[])
+{
+	if (argc < 3) {
+		cerr << "Syntax: render_waveviews <session-dir> <snapshot-name> [<threads>]\n";
+		exit (EXIT_FAILURE);
+	}
+
+	const uint32_t n_threads = argc > 3 ? atoi (argv[3]) : hardware_concurrency ();
+
+	Gtkmm2ext::init (0);
+	Gtkmm2ext::UI ui ("render_waveviews", "gui", &argc, &argv);
+
+	ARDOUR::init (false, true, 0);
+
+	AudioEngine* engine = AudioEngine::create ();
+
+	if (!engine->set_backend ("None (Dummy)", "render_waveviews", "")) {
+		cerr << "cannot set up the dummy backend\n";
+		exit (EXIT_FAILURE);
+	}
+
+	init_post_engine ();
+
+	if (engine->start ()) {
+		cerr << "cannot start the dummy backend\n";
+		exit (EXIT_FAILURE);
+	}
+
+	Session* session = new Session (*engine, argv[1], argv[2]);
+	engine->set_session (session);
+
+	GtkCanvas canvas;
+	canvas.size_allocate (Gtk::Allocation (0, 0, width, height));
+
+	const double spp = max ((framecnt_t) 1, session->current_end_frame() / width);
+
+	/* warm up the file-system cache; not reported */
+	WaveView::start_drawing_threads (n_threads);
+	run (session, canvas, spp * 1.001);
+	WaveView::stop_drawing_threads ();
+
+	WaveView::start_drawing_threads (1);
+	const Run one = run (session, canvas, spp * 1.002);
+	WaveView::stop_drawing_threads ();
+
+	WaveView::start_drawing_threads (n_threads);
+	const Run many = run (session, canvas, spp * 1.003);
+	WaveView::stop_drawing_threads ();
+
+	report ("render", 1, one, one);
+	report ("render", n_threads, many, one);
+
+	engine->remove_session ();
+	delete session;
+
+	engine->stop ();
+	AudioEngine::destroy ();
+
+	ARDOUR::cleanup ();
+
+	return 0;
+}
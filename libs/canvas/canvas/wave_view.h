@@ -18,6 +18,9 @@
 
 */
 
+#include <list>
+#include <vector>
+
 #include <boost/shared_ptr.hpp>
 #include <boost/shared_array.hpp>
 #include <boost/scoped_array.hpp>
@@ -62,6 +65,8 @@ struct LIBCANVAS_API WaveViewThreadRequest
 	RequestType type;
 	framepos_t start;
 	framepos_t end;
+	framepos_t image_start; /* the range that the image will span, fixed */
+	framepos_t image_end;   /* when the request is made */
 	double     width;
 	double     height;
 	double     samples_per_pixel;
@@ -273,8 +278,12 @@ public:
 	static void set_clip_level (double dB);
 	static PBD::Signal0<void> ClipLevelChanged;
 
-	static void start_drawing_thread ();
-	static void stop_drawing_thread ();
+	/** Start the pool of threads that generate waveform images, if it is
+	 *  not already running, with @param n_threads threads (0: one per CPU
+	 *  core).
+	 */
+	static void start_drawing_threads (uint32_t n_threads = 0);
+	static void stop_drawing_threads ();
 
 	static void set_image_cache_size (uint64_t);
 
@@ -386,6 +395,8 @@ public:
         void cancel_my_render_request () const;
 
         void queue_get_image (boost::shared_ptr<const ARDOUR::Region> region, framepos_t start, framepos_t end) const;
+        void image_range (framepos_t start, framepos_t end, framecnt_t width, framepos_t& image_start, framepos_t& image_end) const;
+        bool in_visible_area () const;
         void generate_image (boost::shared_ptr<WaveViewThreadRequest>, bool in_render_thread) const;
         boost::shared_ptr<WaveViewCache::Entry> cache_request_result (boost::shared_ptr<WaveViewThreadRequest> req) const;
 
@@ -403,9 +414,20 @@ public:
         static Glib::Threads::Mutex request_queue_lock;
         static Glib::Threads::Mutex current_image_lock;
         static Glib::Threads::Cond request_cond;
-        static Glib::Threads::Thread* _drawing_thread;
-        typedef std::set<WaveView const *> DrawingRequestQueue;
+        static Glib::Threads::Cond render_done_cond;
+        static std::vector<Glib::Threads::Thread*> _drawing_threads;
+
+        /* WaveViews with a request waiting for a drawing thread. Views
+         * that are on screen are queued at the front, so the visible
+         * area fills in first; others go to the back.
+         */
+        typedef std::list<WaveView const *> DrawingRequestQueue;
         static DrawingRequestQueue request_queue;
+
+        /* all protected by request_queue_lock */
+        mutable bool _queued;
+        mutable DrawingRequestQueue::iterator _queue_position; /* valid iff _queued */
+        mutable uint32_t _renders_in_progress;
 };
 
 }
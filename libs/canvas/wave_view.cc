@@ -29,6 +29,7 @@
 #include "pbd/base_ui.h"
 #include "pbd/compose.h"
 #include "pbd/convert.h"
+#include "pbd/cpus.h"
 #include "pbd/signals.h"
 #include "pbd/stacktrace.h"
 
@@ -67,7 +68,8 @@ gint WaveView::drawing_thread_should_quit = 0;
 Glib::Threads::Mutex WaveView::request_queue_lock;
 Glib::Threads::Mutex WaveView::current_image_lock;
 Glib::Threads::Cond WaveView::request_cond;
-Glib::Threads::Thread* WaveView::_drawing_thread = 0;
+Glib::Threads::Cond WaveView::render_done_cond;
+std::vector<Glib::Threads::Thread*> WaveView::_drawing_threads;
 WaveView::DrawingRequestQueue WaveView::request_queue;
 
 PBD::Signal0<void> WaveView::VisualPropertiesChanged;
@@ -103,6 +105,8 @@ WaveView::WaveView (Canvas* c, boost::shared_ptr<ARDOUR::AudioRegion> region)
 	, get_image_in_thread (false)
 	, always_get_image_in_thread (false)
 	, rendered (false)
+	, _queued (false)
+	, _renders_in_progress (0)
 {
 	if (!images) {
 		images = new WaveViewCache;
@@ -136,6 +140,8 @@ WaveView::WaveView (Item* parent, boost::shared_ptr<ARDOUR::AudioRegion> region)
 	, get_image_in_thread (false)
 	, always_get_image_in_thread (false)
 	, rendered (false)
+	, _queued (false)
+	, _renders_in_progress (0)
 {
 	if (!images) {
 		images = new WaveViewCache;
@@ -150,6 +156,17 @@ WaveView::WaveView (Item* parent, boost::shared_ptr<ARDOUR::AudioRegion> region)
 WaveView::~WaveView ()
 {
 	invalidate_image_cache ();
+
+	{
+		/* a drawing thread may still be using this WaveView for a
+		 * (now cancelled) request: wait for it to finish.
+		 */
+		Glib::Threads::Mutex::Lock lm (request_queue_lock);
+		while (_renders_in_progress) {
+			render_done_cond.wait (request_queue_lock);
+		}
+	}
+
 	if (images ) {
 		images->clear_cache ();
 	}
@@ -864,6 +881,7 @@ WaveView::get_image (framepos_t start, framepos_t end, bool& full_image) const
 			req->fill_color = _fill_color;
 			req->amplitude = _region_amplitude * _amplitude_above_axis;
 			req->width = desired_image_width ();
+			image_range (start, end, req->width, req->image_start, req->image_end);
 
 			/* draw image in this (the GUI thread) */
 
@@ -924,9 +942,62 @@ WaveView::desired_image_width () const
 	return one_tenth_of_second;
 }
 
+void
+WaveView::image_range (framepos_t start, framepos_t end, framecnt_t width, framepos_t& image_start, framepos_t& image_end) const
+{
+	/* sample position is canonical here, and we want to generate
+	 * an image that spans about 3x the canvas width. We get to that
+	 * width by using an image sample count of the screen width added
+	 * on each side of the desired image center.
+	 */
+
+	const framepos_t center = start + ((end - start) / 2);
+
+	/* we can request data from anywhere in the Source, between 0 and its length
+	 */
+
+	image_start = max (_region_start, (center - width));
+	image_end = min (center + width, region_end());
+}
+
+bool
+WaveView::in_visible_area () const
+{
+	Rect self = item_to_window (Rect (0.0, 0.0, region_length() / _samples_per_pixel, _height));
+	return static_cast<bool> (self.intersection (_canvas->visible_area ()));
+}
+
 void
 WaveView::queue_get_image (boost::shared_ptr<const ARDOUR::Region> region, framepos_t start, framepos_t end) const
 {
+	const bool visible = in_visible_area ();
+
+	{
+		Glib::Threads::Mutex::Lock lm (request_queue_lock);
+
+		/* render() asks for an image every time it is called, for as
+		 * long as we do not have one. If the request that is already
+		 * queued or being rendered will do, keep it rather than cancel
+		 * work in progress, but make sure it is near the front of the
+		 * queue if we are on screen.
+		 */
+
+		if (current_request && !current_request->should_stop() && !current_request->image &&
+		    current_request->samples_per_pixel == _samples_per_pixel &&
+		    current_request->channel == _channel &&
+		    current_request->height == _height &&
+		    current_request->fill_color == _fill_color &&
+		    current_request->amplitude == _region_amplitude * _amplitude_above_axis &&
+		    current_request->image_start <= start && current_request->image_end >= end) {
+
+			if (_queued && visible && _queue_position != request_queue.begin()) {
+				request_queue.splice (request_queue.begin(), request_queue, _queue_position);
+			}
+
+			return;
+		}
+	}
+
 	boost::shared_ptr<WaveViewThreadRequest> req (new WaveViewThreadRequest);
 
 	req->type = WaveViewThreadRequest::Draw;
@@ -939,6 +1010,7 @@ WaveView::queue_get_image (boost::shared_ptr<const ARDOUR::Region> region, frame
 	req->fill_color = _fill_color;
 	req->amplitude = _region_amplitude * _amplitude_above_axis;
 	req->width = desired_image_width ();
+	image_range (start, end, req->width, req->image_start, req->image_end);
 
 	if (current_request) {
 		/* this will stop rendering in progress (which might otherwise
@@ -950,7 +1022,7 @@ WaveView::queue_get_image (boost::shared_ptr<const ARDOUR::Region> region, frame
 		}
 	}
 
-	start_drawing_thread ();
+	start_drawing_threads ();
 
 	/* swap requests (protected by lock) */
 
@@ -960,11 +1032,15 @@ WaveView::queue_get_image (boost::shared_ptr<const ARDOUR::Region> region, frame
 
 		DEBUG_TRACE (DEBUG::WaveView, string_compose ("%1 now has current request %2\n", this, req));
 
-		if (request_queue.insert (this).second) {
+		if (!_queued) {
 			/* this waveview was not already in the request queue, make sure we wake
-				 the rendering thread in case it is asleep.
-				 */
+			   a rendering thread in case they are all asleep.
+			*/
+			_queue_position = request_queue.insert (visible ? request_queue.begin() : request_queue.end(), this);
+			_queued = true;
 			request_cond.signal ();
+		} else if (visible && _queue_position != request_queue.begin()) {
+			request_queue.splice (request_queue.begin(), request_queue, _queue_position);
 		}
 	}
 }
@@ -974,20 +1050,10 @@ WaveView::generate_image (boost::shared_ptr<WaveViewThreadRequest> req, bool in_
 {
 	if (!req->should_stop()) {
 
-		/* sample position is canonical here, and we want to generate
-		 * an image that spans about 3x the canvas width. We get to that
-		 * width by using an image sample count of the screen width added
-		 * on each side of the desired image center.
-		 */
+		/* see image_range() */
 
-		const framepos_t center = req->start + ((req->end - req->start) / 2);
-		const framecnt_t image_samples = req->width;
-
-		/* we can request data from anywhere in the Source, between 0 and its length
-		 */
-
-		framepos_t sample_start = max (_region_start, (center - image_samples));
-		framepos_t sample_end = min (center + image_samples, region_end());
+		const framepos_t sample_start = req->image_start;
+		const framepos_t sample_end = req->image_end;
 		const int n_peaks = std::max (1LL, llrint (ceil ((sample_end - sample_start) / (req->samples_per_pixel))));
 
 		assert (n_peaks > 0 && n_peaks < 32767);
@@ -1508,7 +1574,10 @@ WaveView::cancel_my_render_request () const
 	   have no outstanding request (that we know about)
 	*/
 
-	request_queue.erase (this);
+	if (_queued) {
+		request_queue.erase (_queue_position);
+		_queued = false;
+	}
 	current_request.reset ();
 	DEBUG_TRACE (DEBUG::WaveView, string_compose ("%1 now has no request %2\n", this));
 
@@ -1527,21 +1596,41 @@ WaveView::set_image_cache_size (uint64_t sz)
 /*-------------------------------------------------*/
 
 void
-WaveView::start_drawing_thread ()
+WaveView::start_drawing_threads (uint32_t n_threads)
 {
-	if (!_drawing_thread) {
-		_drawing_thread = Glib::Threads::Thread::create (sigc::ptr_fun (WaveView::drawing_thread));
+	if (!_drawing_threads.empty()) {
+		return;
+	}
+
+	if (n_threads == 0) {
+		n_threads = hardware_concurrency ();
+	}
+
+	g_atomic_int_set (&drawing_thread_should_quit, 0);
+
+	for (uint32_t n = 0; n < std::max (1U, n_threads); ++n) {
+		_drawing_threads.push_back (Glib::Threads::Thread::create (sigc::ptr_fun (WaveView::drawing_thread)));
 	}
 }
 
 void
-WaveView::stop_drawing_thread ()
+WaveView::stop_drawing_threads ()
 {
-	while (_drawing_thread) {
+	if (_drawing_threads.empty()) {
+		return;
+	}
+
+	{
 		Glib::Threads::Mutex::Lock lm (request_queue_lock);
 		g_atomic_int_set (&drawing_thread_should_quit, 1);
-		request_cond.signal ();
+		request_cond.broadcast ();
 	}
+
+	for (std::vector<Glib::Threads::Thread*>::iterator t = _drawing_threads.begin(); t != _drawing_threads.end(); ++t) {
+		(*t)->join ();
+	}
+
+	_drawing_threads.clear ();
 }
 
 void
@@ -1573,22 +1662,27 @@ WaveView::drawing_thread ()
 		 * is just a pointer to a WaveView object)
 		 */
 
-		requestor = *(request_queue.begin());
-		request_queue.erase (request_queue.begin());
+		requestor = request_queue.front();
+		request_queue.pop_front();
+		requestor->_queued = false;
 
 		DEBUG_TRACE (DEBUG::WaveView, string_compose ("start request for %1 at %2\n", requestor, g_get_monotonic_time()));
 
 		boost::shared_ptr<WaveViewThreadRequest> req = requestor->current_request;
 
-		if (!req) {
+		if (!req || req->should_stop()) {
+			/* cancelled while it was waiting in the queue */
 			continue;
 		}
 
 		/* Generate an image. Unlock the request queue lock
 		 * while we do this, so that other things can happen
-		 * as we do rendering.
+		 * as we do rendering. The requestor's destructor waits
+		 * for us to finish with it.
 		 */
 
+		++requestor->_renders_in_progress;
+
 		lm.release (); /* some RAII would be good here */
 
 		try {
@@ -1599,11 +1693,12 @@ WaveView::drawing_thread ()
 
 		lm.acquire ();
 
+		if (--requestor->_renders_in_progress == 0) {
+			render_done_cond.broadcast ();
+		}
+
 		req.reset (); /* drop/delete request as appropriate */
 	}
-
-	/* thread is vanishing */
-	_drawing_thread = 0;
 }
 
 /*-------------------------------------------------*/
@@ -21,6 +21,7 @@
 
 #include <cassert>
 #include <list>
+#include <vector>
 #include <stdint.h>
 
 #include <boost/pool/pool.hpp>
@@ -207,7 +208,7 @@ public:
 	std::pair<ControlList::iterator,ControlList::iterator> control_points_adjacent (double when);
 
 	template<class T> void apply_to_points (T& obj, void (T::*method)(const ControlList&)) {
-		Glib::Threads::RWLock::WriterLock lm (_lock);
+		WriteLock lm (*this);
 		(obj.*method)(*this);
 	}
 
@@ -240,26 +241,36 @@ public:
 		return a->when < b->when;
 	}
 
-	/** Lookup cache for eval functions, range contains equivalent values */
-	struct LookupCache {
-		LookupCache() : left(-1) {}
-		double left;  /* leftmost x coordinate used when finding "range" */
-		std::pair<ControlList::const_iterator,ControlList::const_iterator> range;
+	/** The events, sorted by time, with their times and values held in
+	 *  contiguous arrays so that the evaluation functions can binary-search
+	 *  them rather than walk the (linked) EventList. Only ever modified with
+	 *  the write lock held, so readers may use it with just the read lock.
+	 */
+	struct Index {
+		std::vector<double>        when;
+		std::vector<double>        value;
+		std::vector<ControlEvent*> events;
+
+		size_t size () const { return when.size(); }
+		bool   empty () const { return when.empty(); }
+
+		/** @return index of the first event at or after x, or size() */
+		size_t lower_bound (double x) const;
 	};
 
-	/** Lookup cache for point finding, range contains points after left */
+	/** Lookup cache for point finding, first is the index of the first point after left */
 	struct SearchCache {
-		SearchCache () : left(-1) {}
+		SearchCache () : left(-1), first(0) {}
 		double left;  /* leftmost x coordinate used when finding "first" */
-		ControlList::const_iterator first;
+		size_t first;
 	};
 
 	const EventList& events() const { return _events; }
+	const Index& index() const { return _index; }
 	double default_value() const { return _default_value; }
 
 	// FIXME: const violations for Curve
 	Glib::Threads::RWLock& lock()       const { return _lock; }
-	LookupCache& lookup_cache() const { return _lookup_cache; }
 	SearchCache& search_cache() const { return _search_cache; }
 
 	/** Called by locked entry point and various private
@@ -318,6 +329,36 @@ public:
 
 protected:
 
+	/** The write lock on our events. Anything that modifies the events
+	 *  must hold one of these, so that _index is brought up to date with
+	 *  the changes before the lock is released. Changes made with the
+	 *  unlocked_index_*() calls are applied to the index as they happen;
+	 *  otherwise it is rebuilt when the lock is released, or on thaw() if
+	 *  we are frozen.
+	 */
+	class WriteLock {
+	public:
+		WriteLock (ControlList& l) : _list (l), _lm (l._lock) { _list.unlocked_start_index_update (); }
+		~WriteLock () { _list.unlocked_finish_index_update (); }
+	private:
+		ControlList&                      _list;
+		Glib::Threads::RWLock::WriterLock _lm;
+	};
+
+	void unlocked_rebuild_index ();
+	void unlocked_start_index_update ();
+	void unlocked_finish_index_update ();
+
+	/* keep _index in step with a single event being added, removed or
+	 * changed; call unlocked_index_updated() once all changes made under
+	 * the current WriteLock have been passed on like this.
+	 */
+	void unlocked_index_insert (iterator);
+	void unlocked_index_erase (ControlEvent*);
+	void unlocked_index_set_value (ControlEvent*);
+	void unlocked_index_updated ();
+	size_t unlocked_index_find (ControlEvent const *) const;
+
 	/** Called by unlocked_eval() to handle cases of 3 or more control points. */
 	double multipoint_eval (double x) const;
 
@@ -334,7 +375,6 @@ protected:
 
 	void _x_scale (double factor);
 
-	mutable LookupCache   _lookup_cache;
 	mutable SearchCache   _search_cache;
 
 	mutable Glib::Threads::RWLock _lock;
@@ -343,6 +383,9 @@ protected:
 	ParameterDescriptor   _desc;
 	InterpolationStyle    _interpolation;
 	EventList             _events;
+	Index                 _index;
+	bool                  _index_dirty;       ///< _index does not match _events
+	bool                  _index_incremental; ///< _index is being kept in step by this write
 	int8_t                _frozen;
 	bool                  _changed_when_thawed;
 	double                _min_yval;
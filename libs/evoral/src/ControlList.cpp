@@ -58,15 +58,12 @@ ControlList::ControlList (const Parameter& id, const ParameterDescriptor& desc)
 {
 	_interpolation = desc.toggled ? Discrete : Linear;
 	_frozen = 0;
+	_index_dirty = false;
+	_index_incremental = false;
 	_changed_when_thawed = false;
 	_min_yval = desc.lower;
 	_max_yval = desc.upper;
 	_default_value = desc.normal;
-	_lookup_cache.left = -1;
-	_lookup_cache.range.first = _events.end();
-	_lookup_cache.range.second = _events.end();
-	_search_cache.left = -1;
-	_search_cache.first = _events.end();
 	_sort_pending = false;
 	new_write_pass = true;
 	_in_write_pass = false;
@@ -82,13 +79,12 @@ ControlList::ControlList (const ControlList& other)
 	, _curve(0)
 {
 	_frozen = 0;
+	_index_dirty = false;
+	_index_incremental = false;
 	_changed_when_thawed = false;
 	_min_yval = other._min_yval;
 	_max_yval = other._max_yval;
 	_default_value = other._default_value;
-	_lookup_cache.range.first = _events.end();
-	_lookup_cache.range.second = _events.end();
-	_search_cache.first = _events.end();
 	_sort_pending = false;
 	new_write_pass = true;
 	_in_write_pass = false;
@@ -108,13 +104,12 @@ ControlList::ControlList (const ControlList& other, double start, double end)
 	, _curve(0)
 {
 	_frozen = 0;
+	_index_dirty = false;
+	_index_incremental = false;
 	_changed_when_thawed = false;
 	_min_yval = other._min_yval;
 	_max_yval = other._max_yval;
 	_default_value = other._default_value;
-	_lookup_cache.range.first = _events.end();
-	_lookup_cache.range.second = _events.end();
-	_search_cache.first = _events.end();
 	_sort_pending = false;
 
 	/* now grab the relevant points, and shift them back if necessary */
@@ -177,7 +172,7 @@ void
 ControlList::copy_events (const ControlList& other)
 {
 	{
-		Glib::Threads::RWLock::WriterLock lm (_lock);
+		WriteLock lm (*this);
 		_events.clear ();
 		for (const_iterator i = other.begin(); i != other.end(); ++i) {
 			_events.push_back (new ControlEvent ((*i)->when, (*i)->value));
@@ -215,7 +210,7 @@ void
 ControlList::clear ()
 {
 	{
-		Glib::Threads::RWLock::WriterLock lm (_lock);
+		WriteLock lm (*this);
 		_events.clear ();
 		unlocked_invalidate_insert_iterator ();
 		mark_dirty ();
@@ -227,14 +222,14 @@ ControlList::clear ()
 void
 ControlList::x_scale (double factor)
 {
-	Glib::Threads::RWLock::WriterLock lm (_lock);
+	WriteLock lm (*this);
 	_x_scale (factor);
 }
 
 bool
 ControlList::extend_to (double when)
 {
-	Glib::Threads::RWLock::WriterLock lm (_lock);
+	WriteLock lm (*this);
 	if (_events.empty() || _events.back()->when == when) {
 		return false;
 	}
@@ -269,7 +264,7 @@ ControlList::thin (double thinning_factor)
 	bool changed = false;
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (_lock);
+		WriteLock lm (*this);
 
 		ControlEvent* prevprev = 0;
 		ControlEvent* cur = 0;
@@ -329,9 +324,16 @@ ControlList::thin (double thinning_factor)
 void
 ControlList::fast_simple_add (double when, double value)
 {
-	Glib::Threads::RWLock::WriterLock lm (_lock);
+	WriteLock lm (*this);
 	/* to be used only for loading pre-sorted data from saved state */
-	_events.insert (_events.end(), new ControlEvent (when, value));
+	ControlEvent* ev = new ControlEvent (when, value);
+	EventList::iterator i = _events.insert (_events.end(), ev);
+
+	/* this is called for every point when loading, so avoid rebuilding
+	   the whole index each time.
+	*/
+	unlocked_index_insert (i);
+	unlocked_index_updated ();
 
 	mark_dirty ();
 }
@@ -389,7 +391,9 @@ ControlList::set_in_write_pass (bool yn, bool add_point, double when)
 	_in_write_pass = yn;
 
 	if (yn && add_point) {
+		WriteLock lm (*this);
 		add_guard_point (when);
+		unlocked_index_updated ();
 	}
 }
 
@@ -405,6 +409,7 @@ ControlList::add_guard_point (double when)
 
 		DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 insert iterator at end, adding eval-value there %2\n", this, eval_value));
 		_events.push_back (new ControlEvent (when, eval_value));
+		unlocked_index_insert (--_events.end());
 		/* leave insert iterator at the end */
 
 	} else if ((*most_recent_insert_iterator)->when == when) {
@@ -432,6 +437,7 @@ ControlList::add_guard_point (double when)
 								 this, eval_value, (*most_recent_insert_iterator)->when));
 
 		most_recent_insert_iterator = _events.insert (most_recent_insert_iterator, new ControlEvent (when, eval_value));
+		unlocked_index_insert (most_recent_insert_iterator);
 
 		/* advance most_recent_insert_iterator so that the "real"
 		 * insert occurs in the right place, since it
@@ -458,42 +464,51 @@ ControlList::editor_add (double when, double value, bool with_guard)
 	/* this is for making changes from a graphical line editor
 	*/
 
-	ControlEvent cp (when, 0.0f);
-	iterator i = lower_bound (_events.begin(), _events.end(), &cp, time_comparator);
+	{
+		WriteLock lm (*this);
 
-	if (i != _events.end () && (*i)->when == when) {
-		return false;
-	}
+		ControlEvent cp (when, 0.0f);
+		iterator i = lower_bound (_events.begin(), _events.end(), &cp, time_comparator);
 
-	if (_events.empty()) {
+		if (i != _events.end () && (*i)->when == when) {
+			return false;
+		}
 
-		/* as long as the point we're adding is not at zero,
-		 * add an "anchor" point there.
-		 */
+		if (_events.empty()) {
+
+			/* as long as the point we're adding is not at zero,
+			 * add an "anchor" point there.
+			 */
 
-		if (when >= 1) {
-			_events.insert (_events.end(), new ControlEvent (0, value));
-			DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 added value %2 at zero\n", this, value));
+			if (when >= 1) {
+				_events.insert (_events.end(), new ControlEvent (0, value));
+				unlocked_index_insert (--_events.end());
+				DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 added value %2 at zero\n", this, value));
+			}
 		}
-	}
 
-	insert_position = when;
-	if (with_guard) {
-		if (when > 64) {
-			add_guard_point (when - 64);
+		insert_position = when;
+		if (with_guard) {
+			if (when > 64) {
+				add_guard_point (when - 64);
+			}
+			maybe_add_insert_guard (when);
 		}
-		maybe_add_insert_guard (when);
-	}
 
-	iterator result;
-	DEBUG_TRACE (DEBUG::ControlList, string_compose ("editor_add: actually add when= %1 value= %2\n", when, value));
-	result = _events.insert (i, new ControlEvent (when, value));
+		iterator result;
+		DEBUG_TRACE (DEBUG::ControlList, string_compose ("editor_add: actually add when= %1 value= %2\n", when, value));
+		result = _events.insert (i, new ControlEvent (when, value));
 
-	if (i == result) {
-		return false;
+		if (i == result) {
+			return false;
+		}
+
+		unlocked_index_insert (result);
+		unlocked_index_updated ();
+
+		mark_dirty ();
 	}
 
-	mark_dirty ();
 	maybe_signal_changed ();
 
 	return true;
@@ -511,6 +526,7 @@ ControlList::maybe_add_insert_guard (double when)
 			most_recent_insert_iterator = _events.insert (
 				most_recent_insert_iterator,
 				new ControlEvent (when + 64, (*most_recent_insert_iterator)->value));
+			unlocked_index_insert (most_recent_insert_iterator);
 			DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 added insert guard point @ %2 = %3\n",
 			                                                 this, when + 64,
 			                                                 (*most_recent_insert_iterator)->value));
@@ -539,7 +555,9 @@ ControlList::maybe_insert_straight_line (double when, double value)
 		if ((*b)->value == value) {
 			/* At least two points with the exact same value (straight
 			   line), just move the final point to the new time. */
+			unlocked_index_erase (_events.back());
 			_events.back()->when = when;
+			unlocked_index_insert (--_events.end());
 			DEBUG_TRACE (DEBUG::ControlList, string_compose ("final value of %1 moved to %2\n", value, when));
 			return true;
 		}
@@ -553,6 +571,7 @@ ControlList::erase_from_iterator_to (iterator iter, double when)
 	while (iter != _events.end()) {
 		if ((*iter)->when < when) {
 			DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 erase existing @ %2\n", this, (*iter)->when));
+			unlocked_index_erase (*iter);
 			delete *iter;
 			iter = _events.erase (iter);
 			continue;
@@ -576,7 +595,7 @@ ControlList::add (double when, double value, bool with_guards, bool with_initial
 	                             this, value, when, with_guards, _in_write_pass, new_write_pass,
 	                             (most_recent_insert_iterator == _events.end())));
 	{
-		Glib::Threads::RWLock::WriterLock lm (_lock);
+		WriteLock lm (*this);
 		ControlEvent cp (when, 0.0f);
 		iterator insertion_point;
 
@@ -588,10 +607,12 @@ ControlList::add (double when, double value, bool with_guards, bool with_initial
 				if (_desc.toggled) {
 					const double opp_val = ((value < 0.5) ? 1.0 : 0.0);
 					_events.insert (_events.end(), new ControlEvent (0, opp_val));
+					unlocked_index_insert (--_events.end());
 					DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 added toggled value %2 at zero\n", this, opp_val));
 
 				} else {
 					_events.insert (_events.end(), new ControlEvent (0, value));
+					unlocked_index_insert (--_events.end());
 					DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 added default value %2 at zero\n", this, _default_value));
 				}
 			}
@@ -643,6 +664,7 @@ ControlList::add (double when, double value, bool with_guards, bool with_initial
 			const bool done = maybe_insert_straight_line (when, value);
 			if (!done) {
 				_events.push_back (new ControlEvent (when, value));
+				unlocked_index_insert (--_events.end());
 				DEBUG_TRACE (DEBUG::ControlList, string_compose ("\tactually appended, size now %1\n", _events.size()));
 			}
 
@@ -659,6 +681,7 @@ ControlList::add (double when, double value, bool with_guards, bool with_initial
 				 */
 
 				(*most_recent_insert_iterator)->value = value;
+				unlocked_index_set_value (*most_recent_insert_iterator);
 
 				/* if we modified the final value, then its as
 				 * if we inserted a new point as far as the
@@ -689,7 +712,9 @@ ControlList::add (double when, double value, bool with_guards, bool with_initial
 				}
 
 				if (have_point1 && have_point2) {
+					unlocked_index_erase (*most_recent_insert_iterator);
 					(*most_recent_insert_iterator)->when = when;
+					unlocked_index_insert (most_recent_insert_iterator);
 					done = true;
 				} else {
 					++most_recent_insert_iterator;
@@ -708,11 +733,13 @@ ControlList::add (double when, double value, bool with_guards, bool with_initial
 
 			if (!done) {
 				EventList::iterator x = _events.insert (most_recent_insert_iterator, new ControlEvent (when, value));
+				unlocked_index_insert (x);
 				DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 inserted new value before MRI, size now %2\n", this, _events.size()));
 				most_recent_insert_iterator = x;
 			}
 		}
 
+		unlocked_index_updated ();
 		mark_dirty ();
 	}
 
@@ -723,11 +750,13 @@ void
 ControlList::erase (iterator i)
 {
 	{
-		Glib::Threads::RWLock::WriterLock lm (_lock);
+		WriteLock lm (*this);
 		if (most_recent_insert_iterator == i) {
 			unlocked_invalidate_insert_iterator ();
 		}
+		unlocked_index_erase (*i);
 		_events.erase (i);
+		unlocked_index_updated ();
 		mark_dirty ();
 	}
 	maybe_signal_changed ();
@@ -737,7 +766,7 @@ void
 ControlList::erase (iterator start, iterator end)
 {
 	{
-		Glib::Threads::RWLock::WriterLock lm (_lock);
+		WriteLock lm (*this);
 		_events.erase (start, end);
 		unlocked_invalidate_insert_iterator ();
 		mark_dirty ();
@@ -750,7 +779,7 @@ void
 ControlList::erase (double when, double value)
 {
 	{
-		Glib::Threads::RWLock::WriterLock lm (_lock);
+		WriteLock lm (*this);
 
 		iterator i = begin ();
 		while (i != end() && ((*i)->when != when || (*i)->value != value)) {
@@ -758,12 +787,14 @@ ControlList::erase (double when, double value)
 		}
 
 		if (i != end ()) {
-			_events.erase (i);
 			if (most_recent_insert_iterator == i) {
 				unlocked_invalidate_insert_iterator ();
 			}
+			unlocked_index_erase (*i);
+			_events.erase (i);
 		}
 
+		unlocked_index_updated ();
 		mark_dirty ();
 	}
 
@@ -776,7 +807,7 @@ ControlList::erase_range (double start, double endt)
 	bool erased = false;
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (_lock);
+		WriteLock lm (*this);
 		erased = erase_range_internal (start, endt, _events);
 
 		if (erased) {
@@ -815,7 +846,7 @@ void
 ControlList::slide (iterator before, double distance)
 {
 	{
-		Glib::Threads::RWLock::WriterLock lm (_lock);
+		WriteLock lm (*this);
 
 		if (before == _events.end()) {
 			return;
@@ -836,7 +867,7 @@ void
 ControlList::shift (double pos, double frames)
 {
 	{
-		Glib::Threads::RWLock::WriterLock lm (_lock);
+		WriteLock lm (*this);
 
 		for (iterator i = _events.begin(); i != _events.end(); ++i) {
 			if ((*i)->when >= pos) {
@@ -859,7 +890,7 @@ ControlList::modify (iterator iter, double when, double val)
 	*/
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (_lock);
+		WriteLock lm (*this);
 
 		(*iter)->when = when;
 		(*iter)->value = val;
@@ -929,12 +960,15 @@ ControlList::thaw ()
 	}
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (_lock);
+		WriteLock lm (*this);
 
 		if (_sort_pending) {
 			_events.sort (event_time_less_than);
 			unlocked_invalidate_insert_iterator ();
 			_sort_pending = false;
+		} else {
+			/* only rebuilds the index if it was changed while we were frozen */
+			unlocked_index_updated ();
 		}
 	}
 }
@@ -942,11 +976,8 @@ ControlList::thaw ()
 void
 ControlList::mark_dirty () const
 {
-	_lookup_cache.left = -1;
-	_lookup_cache.range.first = _events.end();
-	_lookup_cache.range.second = _events.end();
 	_search_cache.left = -1;
-	_search_cache.first = _events.end();
+	_search_cache.first = 0;
 
 	if (_curve) {
 		_curve->mark_dirty();
@@ -955,11 +986,156 @@ ControlList::mark_dirty () const
 	Dirty (); /* EMIT SIGNAL */
 }
 
+/** Bring _index up to date with _events; must be called with the write lock held */
+void
+ControlList::unlocked_rebuild_index ()
+{
+	_index.events.assign (_events.begin(), _events.end());
+
+	/* the list may be out of order while frozen (_sort_pending), or after
+	   a careless fast_simple_add(); readers always need a sorted index.
+	*/
+	for (size_t n = 1; n < _index.events.size(); ++n) {
+		if (_index.events[n]->when < _index.events[n-1]->when) {
+			stable_sort (_index.events.begin(), _index.events.end(), time_comparator);
+			break;
+		}
+	}
+
+	_index.when.resize (_index.events.size());
+	_index.value.resize (_index.events.size());
+
+	for (size_t n = 0; n < _index.events.size(); ++n) {
+		_index.when[n] = _index.events[n]->when;
+		_index.value[n] = _index.events[n]->value;
+	}
+
+	_index_dirty = false;
+
+	/* the search cache holds a position in the index */
+	_search_cache.left = -1;
+	_search_cache.first = 0;
+}
+
+void
+ControlList::unlocked_start_index_update ()
+{
+	/* while frozen, the index is left alone until thaw() */
+	_index_incremental = !_index_dirty && !_frozen;
+	_index_dirty = true;
+}
+
+void
+ControlList::unlocked_finish_index_update ()
+{
+	if (_index_dirty && !_frozen) {
+		unlocked_rebuild_index ();
+	}
+	_index_incremental = false;
+}
+
+/** @return position of @param ev in the index, or size() if it is not there */
+size_t
+ControlList::unlocked_index_find (ControlEvent const * ev) const
+{
+	for (size_t n = _index.lower_bound (ev->when); n < _index.size() && _index.when[n] == ev->when; ++n) {
+		if (_index.events[n] == ev) {
+			return n;
+		}
+	}
+	return _index.size();
+}
+
+void
+ControlList::unlocked_index_insert (iterator i)
+{
+	if (!_index_incremental) {
+		return;
+	}
+
+	ControlEvent* ev = *i;
+	size_t n = upper_bound (_index.when.begin(), _index.when.end(), ev->when) - _index.when.begin();
+
+	if (n > 0 && _index.when[n-1] == ev->when) {
+		/* points at the same time stay in list order, as they would
+		   after a rebuild: go in front of the next one in the list.
+		*/
+		for (++i; i != _events.end() && (*i)->when <= ev->when; ++i) {
+			if ((*i)->when == ev->when) {
+				n = unlocked_index_find (*i);
+				break;
+			}
+		}
+		if (n == _index.size() && i != _events.end() && (*i)->when == ev->when) {
+			/* out of step; rebuild it when the lock is released */
+			_index_incremental = false;
+			return;
+		}
+	}
+
+	_index.when.insert (_index.when.begin() + n, ev->when);
+	_index.value.insert (_index.value.begin() + n, ev->value);
+	_index.events.insert (_index.events.begin() + n, ev);
+}
+
+void
+ControlList::unlocked_index_erase (ControlEvent* ev)
+{
+	if (!_index_incremental) {
+		return;
+	}
+
+	const size_t n = unlocked_index_find (ev);
+
+	if (n == _index.size()) {
+		/* out of step; rebuild it when the lock is released */
+		_index_incremental = false;
+		return;
+	}
+
+	_index.when.erase (_index.when.begin() + n);
+	_index.value.erase (_index.value.begin() + n);
+	_index.events.erase (_index.events.begin() + n);
+}
+
+void
+ControlList::unlocked_index_set_value (ControlEvent* ev)
+{
+	if (!_index_incremental) {
+		return;
+	}
+
+	const size_t n = unlocked_index_find (ev);
+
+	if (n == _index.size()) {
+		_index_incremental = false;
+		return;
+	}
+
+	_index.value[n] = ev->value;
+}
+
+void
+ControlList::unlocked_index_updated ()
+{
+	if (_index_incremental) {
+		_index_dirty = false;
+		_search_cache.left = -1;
+		_search_cache.first = 0;
+	}
+}
+
+size_t
+ControlList::Index::lower_bound (double x) const
+{
+	return std::lower_bound (when.begin(), when.end(), x) - when.begin();
+}
+
 void
 ControlList::truncate_end (double last_coordinate)
 {
 	{
-		Glib::Threads::RWLock::WriterLock lm (_lock);
+		WriteLock lm (*this);
 		ControlEvent cp (last_coordinate, 0);
 		ControlList::reverse_iterator i;
 		double last_val;
@@ -1062,7 +1238,7 @@ void
 ControlList::truncate_start (double overall_length)
 {
 	{
-		Glib::Threads::RWLock::WriterLock lm (_lock);
+		WriteLock lm (*this);
 		iterator i;
 		double first_legal_value;
 		double first_legal_coordinate;
@@ -1162,37 +1338,28 @@ ControlList::truncate_start (double overall_length)
 double
 ControlList::unlocked_eval (double x) const
 {
-	pair<EventList::iterator,EventList::iterator> range;
-	int32_t npoints;
 	double lpos, upos;
 	double lval, uval;
 	double fraction;
 
-	const_iterator length_check_iter = _events.begin();
-	for (npoints = 0; npoints < 4; ++npoints, ++length_check_iter) {
-		if (length_check_iter == _events.end()) {
-			break;
-		}
-	}
-
-	switch (npoints) {
+	switch (_index.size()) {
 	case 0:
 		return _default_value;
 
 	case 1:
-		return _events.front()->value;
+		return _index.value[0];
 
 	case 2:
-		if (x >= _events.back()->when) {
-			return _events.back()->value;
-		} else if (x <= _events.front()->when) {
-			return _events.front()->value;
+		if (x >= _index.when[1]) {
+			return _index.value[1];
+		} else if (x <= _index.when[0]) {
+			return _index.value[0];
 		}
 
-		lpos = _events.front()->when;
-		lval = _events.front()->value;
-		upos = _events.back()->when;
-		uval = _events.back()->value;
+		lpos = _index.when[0];
+		lval = _index.value[0];
+		upos = _index.when[1];
+		uval = _index.value[1];
 
 		if (_interpolation == Discrete) {
 			return lval;
@@ -1203,10 +1370,10 @@ ControlList::unlocked_eval (double x) const
 		return lval + (fraction * (uval - lval));
 
 	default:
-		if (x >= _events.back()->when) {
-			return _events.back()->value;
-		} else if (x <= _events.front()->when) {
-			return _events.front()->value;
+		if (x >= _index.when.back()) {
+			return _index.value.back();
+		} else if (x <= _index.when.front()) {
+			return _index.value.front();
 		}
 
 		return multipoint_eval (x);
@@ -1219,98 +1386,71 @@ ControlList::unlocked_eval (double x) const
 double
 ControlList::multipoint_eval (double x) const
 {
-	double upos, lpos;
-	double uval, lval;
-	double fraction;
+	/* the first point at or after x */
+	const size_t i = _index.lower_bound (x);
 
 	/* "Stepped" lookup (no interpolation) */
-	/* FIXME: no cache.  significant? */
 	if (_interpolation == Discrete) {
-		const ControlEvent cp (x, 0);
-		EventList::const_iterator i = lower_bound (_events.begin(), _events.end(), &cp, time_comparator);
 
 		// shouldn't have made it to multipoint_eval
-		assert(i != _events.end());
+		assert(i != _index.size());
 
-		if (i == _events.begin() || (*i)->when == x)
-			return (*i)->value;
+		if (i == 0 || _index.when[i] == x)
+			return _index.value[i];
 		else
-			return (*(--i))->value;
+			return _index.value[i-1];
 	}
 
-	/* Only do the range lookup if x is in a different range than last time
-	 * this was called (or if the lookup cache has been marked "dirty" (left<0) */
-	if ((_lookup_cache.left < 0) ||
-	    ((_lookup_cache.left > x) ||
-	     (_lookup_cache.range.first == _events.end()) ||
-	     ((*_lookup_cache.range.second)->when < x))) {
-
-		const ControlEvent cp (x, 0);
-
-		_lookup_cache.range = equal_range (_events.begin(), _events.end(), &cp, time_comparator);
+	if (i != _index.size() && _index.when[i] == x) {
+		/* x is a control point in the data */
+		return _index.value[i];
 	}
 
-	pair<const_iterator,const_iterator> range = _lookup_cache.range;
-
-	if (range.first == range.second) {
+	/* x does not exist within the list as a control point */
 
-		/* x does not exist within the list as a control point */
-
-		_lookup_cache.left = x;
-
-		if (range.first != _events.begin()) {
-			--range.first;
-			lpos = (*range.first)->when;
-			lval = (*range.first)->value;
-		}  else {
-			/* we're before the first point */
-			// return _default_value;
-			return _events.front()->value;
-		}
-
-		if (range.second == _events.end()) {
-			/* we're after the last point */
-			return _events.back()->value;
-		}
-
-		upos = (*range.second)->when;
-		uval = (*range.second)->value;
+	if (i == 0) {
+		/* we're before the first point */
+		// return _default_value;
+		return _index.value.front();
+	}
 
-		/* linear interpolation betweeen the two points
-		   on either side of x
-		*/
+	if (i == _index.size()) {
+		/* we're after the last point */
+		return _index.value.back();
+	}
 
-		fraction = (double) (x - lpos) / (double) (upos - lpos);
-		return lval + (fraction * (uval - lval));
+	const double lpos = _index.when[i-1];
+	const double lval = _index.value[i-1];
+	const double upos = _index.when[i];
+	const double uval = _index.value[i];
 
-	}
+	/* linear interpolation betweeen the two points
+	   on either side of x
+	*/
 
-	/* x is a control point in the data */
-	_lookup_cache.left = -1;
-	return (*range.first)->value;
+	const double fraction = (double) (x - lpos) / (double) (upos - lpos);
+	return lval + (fraction * (uval - lval));
 }
 
 void
 ControlList::build_search_cache_if_necessary (double start) const
 {
-	if (_events.empty()) {
+	if (_index.empty()) {
 		/* Empty, nothing to cache, move to end. */
-		_search_cache.first = _events.end();
+		_search_cache.first = 0;
 		_search_cache.left = 0;
 		return;
 	} else if ((_search_cache.left < 0) || (_search_cache.left > start)) {
 		/* Marked dirty (left < 0), or we're too far forward, re-search. */
 
-		const ControlEvent start_point (start, 0);
-
-		_search_cache.first = lower_bound (_events.begin(), _events.end(), &start_point, time_comparator);
+		_search_cache.first = _index.lower_bound (start);
 		_search_cache.left = start;
 	}
 
 	/* We now have a search cache that is not too far right, but it may be too
 	   far left and need to be advanced. */
 
-	while (_search_cache.first != end() && (*_search_cache.first)->when < start) {
+	while (_search_cache.first < _index.size() && _index.when[_search_cache.first] < start) {
 		++_search_cache.first;
 	}
 	_search_cache.left = start;
@@ -1366,16 +1506,16 @@ ControlList::rt_safe_earliest_event_discrete_unlocked (double start, double& x,
 {
 	build_search_cache_if_necessary (start);
 
-	if (_search_cache.first != _events.end()) {
-		const ControlEvent* const first = *_search_cache.first;
+	if (_search_cache.first < _index.size()) {
+		const double first_when = _index.when[_search_cache.first];
 
-		const bool past_start = (inclusive ? first->when >= start : first->when > start);
+		const bool past_start = (inclusive ? first_when >= start : first_when > start);
 
 		/* Earliest points is in range, return it */
 		if (past_start) {
 
-			x = first->when;
-			y = first->value;
+			x = first_when;
+			y = _index.value[_search_cache.first];
 
 			/* Move left of cache to this point
 			 * (Optimize for immediate call this cycle within range) */
@@ -1407,54 +1547,56 @@ ControlList::rt_safe_earliest_event_linear_unlocked (double start, double& x, do
 {
 	// cout << "earliest_event(start: " << start << ", x: " << x << ", y: " << y << ", inclusive: " << inclusive <<  ")" << endl;
 
-	const_iterator length_check_iter = _events.begin();
-	if (_events.empty()) { // 0 events
+	if (_index.empty()) { // 0 events
 		return false;
-	} else if (_events.end() == ++length_check_iter) { // 1 event
+	} else if (_index.size() == 1) { // 1 event
 		return rt_safe_earliest_event_discrete_unlocked (start, x, y, inclusive);
 	}
 
 	// Hack to avoid infinitely repeating the same event
 	build_search_cache_if_necessary (start);
 
-	if (_search_cache.first != _events.end()) {
+	if (_search_cache.first < _index.size()) {
 
-		const ControlEvent* first = NULL;
-		const ControlEvent* next = NULL;
+		size_t first;
+		size_t next;
 
-		if (_search_cache.first == _events.begin() || (*_search_cache.first)->when <= start) {
+		if (_search_cache.first == 0 || _index.when[_search_cache.first] <= start) {
 			/* Step is after first */
-			first = *_search_cache.first;
+			first = _search_cache.first;
 			++_search_cache.first;
-			if (_search_cache.first == _events.end()) {
+			if (_search_cache.first == _index.size()) {
 				return false;
 			}
-			next = *_search_cache.first;
+			next = _search_cache.first;
 
 		} else {
 			/* Step is before first */
-			const_iterator prev = _search_cache.first;
-			--prev;
-			first = *prev;
-			next = *_search_cache.first;
+			first = _search_cache.first - 1;
+			next = _search_cache.first;
 		}
 
-		if (inclusive && first->when == start) {
-			x = first->when;
-			y = first->value;
+		const double first_when = _index.when[first];
+		const double first_value = _index.value[first];
+		const double next_when = _index.when[next];
+		const double next_value = _index.value[next];
+
+		if (inclusive && first_when == start) {
+			x = first_when;
+			y = first_value;
 			/* Move left of cache to this point
 			 * (Optimize for immediate call this cycle within range) */
 			_search_cache.left = x;
 			return true;
-		} else if (next->when < start || (!inclusive && next->when == start)) {
+		} else if (next_when < start || (!inclusive && next_when == start)) {
 			/* "Next" is before the start, no points left. */
 			return false;
 		}
 
-		if (fabs(first->value - next->value) <= 1) {
-			if (next->when > start) {
-				x = next->when;
-				y = next->value;
+		if (fabs(first_value - next_value) <= 1) {
+			if (next_when > start) {
+				x = next_when;
+				y = next_value;
 				/* Move left of cache to this point
 				 * (Optimize for immediate call this cycle within range) */
 				_search_cache.left = x;
@@ -1464,35 +1606,35 @@ ControlList::rt_safe_earliest_event_linear_unlocked (double start, double& x, do
 			}
 		}
 
-		const double slope = (next->value - first->value) / (double)(next->when - first->when);
+		const double slope = (next_value - first_value) / (double)(next_when - first_when);
 		//cerr << "start y: " << start_y << endl;
 
-		//y = first->value + (slope * fabs(start - first->when));
-		y = first->value;
+		//y = first_value + (slope * fabs(start - first_when));
+		y = first_value;
 
-		if (first->value < next->value) // ramping up
+		if (first_value < next_value) // ramping up
 			y = ceil(y);
 		else // ramping down
 			y = floor(y);
 
-		x = first->when + (y - first->value) / (double)slope;
+		x = first_when + (y - first_value) / (double)slope;
 
-		while ((inclusive && x < start) || (x <= start && y != next->value)) {
+		while ((inclusive && x < start) || (x <= start && y != next_value)) {
 
-			if (first->value < next->value) // ramping up
+			if (first_value < next_value) // ramping up
 				y += 1.0;
 			else // ramping down
 				y -= 1.0;
 
-			x = first->when + (y - first->value) / (double)slope;
+			x = first_when + (y - first_value) / (double)slope;
 		}
 
-		/*cerr << first->value << " @ " << first->when << " ... "
-		  << next->value << " @ " << next->when
+		/*cerr << first_value << " @ " << first_when << " ... "
+		  << next_value << " @ " << next_when
 		  << " = " << y << " @ " << x << endl;*/
 
-		assert(    (y >= first->value && y <= next->value)
-		           || (y <= first->value && y >= next->value) );
+		assert(    (y >= first_value && y <= next_value)
+		           || (y <= first_value && y >= next_value) );
 
 
 		const bool past_start = (inclusive ? x >= start : x > start);
@@ -1504,7 +1646,7 @@ ControlList::rt_safe_earliest_event_linear_unlocked (double start, double& x, do
 			return true;
 		} else {
 			if (inclusive) {
-				x = next->when;
+				x = next_when;
 			} else {
 				x = start;
 			}
@@ -1531,7 +1673,9 @@ ControlList::cut_copy_clear (double start, double end, int op)
 	ControlEvent cp (start, 0.0);
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (_lock);
+		WriteLock lm (*this);
+		/* nobody else can see nal yet, but its index must be built too */
+		WriteLock nlm (*nal);
 
 		/* first, determine s & e, two iterators that define the range of points
 		   affected by this operation
@@ -1647,7 +1791,7 @@ ControlList::paste (const ControlList& alist, double pos, float /*times*/)
 	}
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (_lock);
+		WriteLock lm (*this);
 		iterator where;
 		iterator prev;
 		double end = 0;
@@ -1713,7 +1857,7 @@ ControlList::move_ranges (const list< RangeMove<double> >& movements)
 	typedef list< RangeMove<double> > RangeMoveList;
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (_lock);
+		WriteLock lm (*this);
 
 		/* a copy of the events list before we started moving stuff around */
 		EventList old_events = _events;
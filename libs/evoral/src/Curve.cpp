@@ -50,22 +50,18 @@ Curve::solve ()
 		return;
 	}
 
-	if ((npoints = _list.events().size()) > 2) {
+	ControlList::Index const & index (_list.index());
+
+	if ((npoints = index.size()) > 2) {
 
 		/* Compute coefficients needed to efficiently compute a constrained spline
 		   curve. See "Constrained Cubic Spline Interpolation" by CJC Kruger
 		   (www.korf.co.uk/spline.pdf) for more details.
 		*/
 
-		vector<double> x(npoints);
-		vector<double> y(npoints);
+		vector<double> const & x (index.when);
+		vector<double> const & y (index.value);
 		uint32_t i;
-		ControlList::EventList::const_iterator xx;
-
-		for (i = 0, xx = _list.events().begin(); xx != _list.events().end(); ++xx, ++i) {
-			x[i] = (double) (*xx)->when;
-			y[i] = (double) (*xx)->value;
-		}
 
 		double lp0, lp1, fpone;
 
@@ -80,7 +76,7 @@ Curve::solve ()
 
 		double fplast = 0;
 
-		for (i = 0, xx = _list.events().begin(); xx != _list.events().end(); ++xx, ++i) {
+		for (i = 0; i < npoints; ++i) {
 
 			double xdelta;   /* gcc is wrong about possible uninitialized use */
 			double xdelta2;  /* ditto */
@@ -154,11 +150,12 @@ Curve::solve ()
 
 			/* store */
 
-			(*xx)->create_coeffs();
-			(*xx)->coeff[0] = y[i-1] - (b * x[i-1]) - (c * xim12) - (d * xim13);
-			(*xx)->coeff[1] = b;
-			(*xx)->coeff[2] = c;
-			(*xx)->coeff[3] = d;
+			ControlEvent* ev = index.events[i];
+			ev->create_coeffs();
+			ev->coeff[0] = y[i-1] - (b * x[i-1]) - (c * xim12) - (d * xim13);
+			ev->coeff[1] = b;
+			ev->coeff[2] = c;
+			ev->coeff[3] = d;
 
 			fplast = fpi;
 		}
@@ -196,11 +193,13 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen)
 	int32_t original_veclen;
 	int32_t npoints;
 
+	ControlList::Index const & index (_list.index());
+
 	if (veclen == 0) {
 		return;
 	}
 
-	if ((npoints = _list.events().size()) == 0) {
+	if ((npoints = index.size()) == 0) {
 		/* no events in list, so just fill the entire array with the default value */
 		for (int32_t i = 0; i < veclen; ++i) {
 			vec[i] = _list.default_value();
@@ -210,20 +209,20 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen)
 
 	if (npoints == 1) {
 		for (int32_t i = 0; i < veclen; ++i) {
-			vec[i] = _list.events().front()->value;
+			vec[i] = index.value.front();
 		}
 		return;
 	}
 
 	/* events is now known not to be empty */
 
-	max_x = _list.events().back()->when;
-	min_x = _list.events().front()->when;
+	max_x = index.when.back();
+	min_x = index.when.front();
 
 	if (x0 > max_x) {
 		/* totally past the end - just fill the entire array with the final value */
 		for (int32_t i = 0; i < veclen; ++i) {
-			vec[i] = _list.events().back()->value;
+			vec[i] = index.value.back();
 		}
 		return;
 	}
@@ -233,7 +232,7 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen)
 		 * the initial value.
 		 */
 		for (int32_t i = 0; i < veclen; ++i) {
-			vec[i] = _list.events().front()->value;
+			vec[i] = index.value.front();
 		}
 		return;
 	}
@@ -252,7 +251,7 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen)
 		fill_len = min (fill_len, (int64_t)veclen);
 
 		for (i = 0; i < fill_len; ++i) {
-			vec[i] = _list.events().front()->value;
+			vec[i] = index.value.front();
 		}
 
 		veclen -= fill_len;
@@ -268,7 +267,7 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen)
 		float val;
 
 		fill_len = min (fill_len, (int64_t)veclen);
-		val = _list.events().back()->value;
+		val = index.value.back();
 
 		for (i = veclen - fill_len; i < veclen; ++i) {
 			vec[i] = val;
@@ -290,11 +289,11 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen)
 		*/
 
 		/* gradient of the line */
-		double const m_num = _list.events().back()->value - _list.events().front()->value;
-		double const m_den = _list.events().back()->when - _list.events().front()->when;
+		double const m_num = index.value.back() - index.value.front();
+		double const m_den = index.when.back() - index.when.front();
 
 		/* y intercept of the line */
-		double const c = double (_list.events().back()->value) - (m_num * _list.events().back()->when / m_den);
+		double const c = double (index.value.back()) - (m_num * index.when.back() / m_den);
 
 		/* dx that we are using */
 		double dx_num = 0;
@@ -343,76 +342,46 @@ Curve::unlocked_eval (double x)
 double
 Curve::multipoint_eval (double x)
 {
-	pair<ControlList::EventList::const_iterator,ControlList::EventList::const_iterator> range;
-
-	ControlList::LookupCache& lookup_cache = _list.lookup_cache();
-
-	if ((lookup_cache.left < 0) ||
-	    ((lookup_cache.left > x) ||
-	     (lookup_cache.range.first == _list.events().end()) ||
-	     ((*lookup_cache.range.second)->when < x))) {
+	ControlList::Index const & index (_list.index());
 
-		ControlEvent cp (x, 0.0);
+	/* the first point at or after x */
+	const size_t i = index.lower_bound (x);
 
-		lookup_cache.range = equal_range (_list.events().begin(), _list.events().end(), &cp, ControlList::time_comparator);
+	if (i != index.size() && index.when[i] == x) {
+		/* x is a control point in the data */
+		return index.value[i];
 	}
 
-	range = lookup_cache.range;
-
-	/* EITHER
-
-	   a) x is an existing control point, so first == existing point, second == next point
-
-	   OR
-
-	   b) x is between control points, so range is empty (first == second, points to where
-	       to insert x)
-
-	*/
-
-	if (range.first == range.second) {
+	/* x does not exist within the list as a control point */
 
-		/* x does not exist within the list as a control point */
-
-		lookup_cache.left = x;
-
-		if (range.first == _list.events().begin()) {
-			/* we're before the first point */
-			// return default_value;
-			return _list.events().front()->value;
-		}
+	if (i == 0) {
+		/* we're before the first point */
+		// return default_value;
+		return index.value.front();
+	}
 
-		if (range.second == _list.events().end()) {
-			/* we're after the last point */
-			return _list.events().back()->value;
-		}
+	if (i == index.size()) {
+		/* we're after the last point */
+		return index.value.back();
+	}
 
-		ControlEvent* after = (*range.second);
-		range.second--;
-		ControlEvent* before = (*range.second);
+	double vdelta = index.value[i] - index.value[i-1];
 
-		double vdelta = after->value - before->value;
+	if (vdelta == 0.0) {
+		return index.value[i-1];
+	}
 
-		if (vdelta == 0.0) {
-			return before->value;
-		}
+	double tdelta = x - index.when[i-1];
+	double trange = index.when[i] - index.when[i-1];
 
-		double tdelta = x - before->when;
-		double trange = after->when - before->when;
+	ControlEvent const * after = index.events[i];
 
-		if (_list.interpolation() == ControlList::Curved && after->coeff) {
-				ControlEvent* ev = after;
-				double x2 = x * x;
-				return ev->coeff[0] + (ev->coeff[1] * x) + (ev->coeff[2] * x2) + (ev->coeff[3] * x2 * x);
-		} else {
-			return before->value + (vdelta * (tdelta / trange));
-		}
+	if (_list.interpolation() == ControlList::Curved && after->coeff) {
+		double x2 = x * x;
+		return after->coeff[0] + (after->coeff[1] * x) + (after->coeff[2] * x2) + (after->coeff[3] * x2 * x);
+	} else {
+		return index.value[i-1] + (vdelta * (tdelta / trange));
 	}
-
-	/* x is a control point in the data */
-	/* invalidate the cached range because its not usable */
-	lookup_cache.left = -1;
-	return (*range.first)->value;
 }
 
 } // namespace Evoral
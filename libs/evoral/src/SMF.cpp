@@ -216,6 +216,51 @@ SMF::seek_to_start() const
 	}
 }
 
+/** Seek so that the next read_event() returns the first event at or after
+ * \a ticks.
+ *
+ * The whole track is held in memory by libsmf, with the absolute time of
+ * every event, so this is a binary search rather than a read of every
+ * event before \a ticks.
+ *
+ * \return the time, in SMF ticks, that the delta time of the next event
+ * is relative to (the time of the event before it, or 0).
+ */
+uint64_t
+SMF::seek_to_time(uint64_t ticks) const
+{
+	Glib::Threads::Mutex::Lock lm (_smf_lock);
+
+	if (!_smf_track) {
+		cerr << "WARNING: SMF seek_to_time() with no track" << endl;
+		return 0;
+	}
+
+	/* find the first event number (they start at 1) with time >= ticks */
+	size_t lo = 1;
+	size_t hi = _smf_track->number_of_events + 1;
+
+	while (lo < hi) {
+		const size_t mid = lo + (hi - lo) / 2;
+		if (smf_track_get_event_by_number(_smf_track, mid)->time_pulses < ticks) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	if (lo > _smf_track->number_of_events) {
+		/* past the last event */
+		_smf_track->next_event_number = 0;
+		return (lo > 1) ? smf_track_get_event_by_number(_smf_track, lo - 1)->time_pulses : 0;
+	}
+
+	_smf_track->next_event_number = lo;
+	_smf_track->time_of_next_event = smf_track_get_event_by_number(_smf_track, lo)->time_pulses;
+
+	return (lo > 1) ? smf_track_get_event_by_number(_smf_track, lo - 1)->time_pulses : 0;
+}
+
 /** Read an event from the current position in file.
  *
  * File position MUST be at the beginning of a delta time, or this will die very messily.
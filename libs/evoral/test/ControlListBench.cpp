@@ -0,0 +1,211 @@
+#include <iostream>
+#include <algorithm>
+#include <list>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+
+#include <glib.h>
+
+#include "pbd/pbd.h"
+#include "evoral/ControlList.hpp"
+#include "evoral/Curve.hpp"
+
+using namespace std;
+using namespace Evoral;
+
+/* Time ControlList evaluation against the linked-list lookup it replaced
+ * (equal_range() over a std::list, with a one-range cache), checking that
+ * both produce the same values.
+ *
+ * usage: control-list-bench [points [iterations]]
+ */
+
+static int npoints = 1000;
+static int iterations = 1000;
+
+static const double length = 48000.0 * 600.0;
+static const int block = 1024;
+
+/* The reference: what ControlList::multipoint_eval() used to do */
+class ListEval {
+public:
+	ListEval (ControlList const & cl)
+		: _cache_left (-1)
+	{
+		for (ControlList::const_iterator i = cl.begin(); i != cl.end(); ++i) {
+			_events.push_back (new ControlEvent (**i));
+		}
+		_cache = make_pair (_events.end(), _events.end());
+	}
+
+	~ListEval () {
+		for (Events::iterator i = _events.begin(); i != _events.end(); ++i) {
+			delete *i;
+		}
+	}
+
+	double eval (double x) {
+		if (x >= _events.back()->when) {
+			return _events.back()->value;
+		} else if (x <= _events.front()->when) {
+			return _events.front()->value;
+		}
+
+		if (_cache_left < 0 || _cache_left > x || _cache.first == _events.end() || (*_cache.second)->when < x) {
+			const ControlEvent cp (x, 0);
+			_cache = equal_range (_events.begin(), _events.end(), &cp, cmp);
+		}
+
+		Range range = _cache;
+
+		if (range.first == range.second) {
+			_cache_left = x;
+			--range.first;
+			const double lpos = (*range.first)->when;
+			const double lval = (*range.first)->value;
+			const double upos = (*range.second)->when;
+			const double uval = (*range.second)->value;
+			return lval + ((x - lpos) / (upos - lpos)) * (uval - lval);
+		}
+
+		_cache_left = -1;
+		return (*range.first)->value;
+	}
+
+private:
+	typedef std::list<ControlEvent*> Events;
+	typedef std::pair<Events::iterator, Events::iterator> Range;
+
+	static bool cmp (ControlEvent const * a, ControlEvent const * b) {
+		return a->when < b->when;
+	}
+
+	Events _events;
+	Range  _cache;
+	double _cache_left;
+};
+
+static void
+report (const char* op, const char* impl, gint64 usecs, gint64 ref_usecs, size_t calls, bool ok)
+{
+	cout << op << "\t" << impl << "\t"
+	     << (usecs * 1000.0 / calls) << " ns/call";
+	if (ref_usecs > 0) {
+		cout << "\tx" << (usecs > 0 ? ref_usecs / (double) usecs : 0.0);
+	}
+	cout << (ok ? "" : "\tMISMATCH") << endl;
+}
+
+static bool
+same (vector<double> const & a, vector<double> const & b)
+{
+	for (size_t i = 0; i < a.size(); ++i) {
+		if (fabs (a[i] - b[i]) > 1e-9 * max (1.0, fabs (a[i]))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+int
+main (int argc, char* argv[])
+{
+	if (argc > 1) {
+		npoints = atoi (argv[1]);
+	}
+	if (argc > 2) {
+		iterations = atoi (argv[2]);
+	}
+
+	if (npoints < 3 || iterations < 1) {
+		cerr << "usage: control-list-bench [points [iterations]]\n";
+		return 1;
+	}
+
+	if (!PBD::init ()) {
+		return 1;
+	}
+
+	ControlList cl (Parameter (0), ParameterDescriptor ());
+	cl.set_interpolation (ControlList::Linear);
+	cl.create_curve ();
+
+	srand (1);
+	for (int i = 0; i < npoints; ++i) {
+		cl.fast_simple_add (i * length / npoints, rand () / (double) RAND_MAX);
+	}
+
+	ListEval ref (cl);
+
+	cout << "points: " << npoints << ", iterations: " << iterations << endl;
+
+	/* playback: a block-sized walk over the whole list, one eval per block */
+	const size_t nseq = (size_t) (length / block);
+	vector<double> seq_x (nseq);
+	for (size_t i = 0; i < nseq; ++i) {
+		seq_x[i] = i * (double) block + 0.5;
+	}
+
+	/* editing: evaluation at random positions */
+	vector<double> rnd_x (nseq);
+	for (size_t i = 0; i < nseq; ++i) {
+		rnd_x[i] = (rand () / (double) RAND_MAX) * length;
+	}
+
+	vector<double> expected (nseq);
+	vector<double> result (nseq);
+	int failures = 0;
+
+#define BENCH(op, xs)                                                    \
+	{                                                                    \
+		const int passes = max (1, iterations / 100);                    \
+		gint64 start = g_get_monotonic_time ();                          \
+		for (int p = 0; p < passes; ++p) {                               \
+			for (size_t i = 0; i < nseq; ++i) {                          \
+				expected[i] = ref.eval (xs[i]);                          \
+			}                                                            \
+		}                                                                \
+		const gint64 ref_usecs = g_get_monotonic_time () - start;        \
+		start = g_get_monotonic_time ();                                 \
+		for (int p = 0; p < passes; ++p) {                               \
+			for (size_t i = 0; i < nseq; ++i) {                          \
+				result[i] = cl.unlocked_eval (xs[i]);                    \
+			}                                                            \
+		}                                                                \
+		const gint64 usecs = g_get_monotonic_time () - start;            \
+		const bool ok = same (expected, result);                         \
+		if (!ok) {                                                       \
+			++failures;                                                  \
+		}                                                                \
+		report (op, "list", ref_usecs, ref_usecs, nseq * passes, true);  \
+		report (op, "index", usecs, ref_usecs, nseq * passes, ok);       \
+	}
+
+	BENCH ("eval sequential", seq_x);
+	BENCH ("eval random", rnd_x);
+
+	/* automation playback fills a block at a time from the curve */
+	float vec[block];
+	gint64 start = g_get_monotonic_time ();
+	for (int i = 0; i < iterations; ++i) {
+		const double s = fmod (i * (double) block * 37.0, length - block);
+		cl.curve ().get_vector (s, s + block, vec, block);
+	}
+	report ("curve get_vector", "index", g_get_monotonic_time () - start, 0, iterations, true);
+
+	cl.set_interpolation (ControlList::Curved);
+	start = g_get_monotonic_time ();
+	for (int i = 0; i < iterations; ++i) {
+		cl.curve ().mark_dirty ();
+		cl.curve ().solve ();
+	}
+	report ("curve solve", "index", g_get_monotonic_time () - start, 0, iterations, true);
+
+	if (failures) {
+		cerr << failures << " evaluation(s) did not match the list\n";
+		return 1;
+	}
+
+	return 0;
+}
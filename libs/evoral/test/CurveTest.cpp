@@ -245,6 +245,56 @@ CurveTest::ctrlListEval ()
 	CPPUNIT_ASSERT_EQUAL(9.0, cl->unlocked_eval(999.));
 }
 
+void
+CurveTest::ctrlListEdits ()
+{
+	/* evaluation must follow every kind of edit, not just appends */
+	boost::shared_ptr<Evoral::ControlList> cl = TestCtrlList();
+	cl->set_interpolation (ControlList::Linear);
+
+	cl->fast_simple_add (   0.0 , 0.0);
+	cl->fast_simple_add ( 100.0 , 4.0);
+	cl->fast_simple_add ( 200.0 , 0.0);
+	CPPUNIT_ASSERT_EQUAL(2.0, cl->unlocked_eval(50.));
+	CPPUNIT_ASSERT_EQUAL(2.0, cl->unlocked_eval(150.));
+
+	cl->modify (++cl->begin (), 100.0, 8.0);
+	CPPUNIT_ASSERT_EQUAL(4.0, cl->unlocked_eval(50.));
+	CPPUNIT_ASSERT_EQUAL(4.0, cl->unlocked_eval(150.));
+
+	cl->erase (++cl->begin ());
+	CPPUNIT_ASSERT_EQUAL(0.0, cl->unlocked_eval(50.));
+	CPPUNIT_ASSERT_EQUAL(0.0, cl->unlocked_eval(150.));
+
+	cl->shift (0.0, 100.0);
+	CPPUNIT_ASSERT_EQUAL(0.0, cl->unlocked_eval(50.));
+	CPPUNIT_ASSERT_EQUAL(0.0, cl->unlocked_eval(350.));
+
+	/* out of order: the index must be sorted even if the list is not yet */
+	cl->fast_simple_add (  50.0 , 2.0);
+	CPPUNIT_ASSERT_EQUAL(2.0, cl->unlocked_eval(0.));
+	CPPUNIT_ASSERT_EQUAL(1.0, cl->unlocked_eval(75.));
+
+	cl->clear ();
+	CPPUNIT_ASSERT_EQUAL(cl->default_value(), cl->unlocked_eval(75.));
+
+	/* edits which update the index in place */
+	cl->editor_add (400.0, 4.0, false);
+	CPPUNIT_ASSERT_EQUAL(4.0, cl->unlocked_eval(350.));
+	cl->add (500.0, 0.0, false, false);
+	CPPUNIT_ASSERT_EQUAL(2.0, cl->unlocked_eval(450.));
+	cl->erase (400.0, 4.0);
+	CPPUNIT_ASSERT_EQUAL(2.0, cl->unlocked_eval(250.));
+
+	/* a copied range must be evaluable straight away */
+	cl->editor_add (400.0, 4.0, false);
+	boost::shared_ptr<Evoral::ControlList> cp = cl->copy (300.0, 500.0);
+	CPPUNIT_ASSERT_EQUAL((size_t) 3, cp->size());
+	CPPUNIT_ASSERT_EQUAL((size_t) 3, cp->index().size());
+	CPPUNIT_ASSERT_EQUAL(4.0, cp->unlocked_eval(50.));
+	CPPUNIT_ASSERT_EQUAL(2.0, cp->unlocked_eval(150.));
+}
+
 void
 CurveTest::constrainedCubic ()
 {
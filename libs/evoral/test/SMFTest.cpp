@@ -1,3 +1,5 @@
+#include <vector>
+
 #include "SMFTest.hpp"
 
 #include <glibmm/fileutils.h>
@@ -68,3 +70,49 @@ SMFTest::takeFiveTest ()
 	                Evoral::Beats::ticks_at_rate(time, smf.ppqn()));
 	CPPUNIT_ASSERT(!seq->empty());
 }
+
+void
+SMFTest::seekToTimeTest ()
+{
+	TestSMF smf;
+	string testdata_path;
+	CPPUNIT_ASSERT (find_file (test_search_path (), "TakeFive.mid", testdata_path));
+	smf.open(testdata_path);
+	CPPUNIT_ASSERT(!smf.is_empty());
+
+	/* absolute time of every event, read from the start */
+	vector<uint64_t> times;
+	uint64_t time = 0;
+	uint32_t delta_t = 0;
+	uint32_t size    = 0;
+	uint8_t* buf     = NULL;
+
+	smf.seek_to_start();
+	while (smf.read_event(&delta_t, &size, &buf) >= 0) {
+		time += delta_t;
+		times.push_back (time);
+	}
+	CPPUNIT_ASSERT(times.size() > 2);
+
+	const uint64_t probes[] = { 0, 1, times[1], times[1] + 1, times[times.size() / 2], times.back(), times.back() + 1 };
+
+	for (size_t p = 0; p < sizeof (probes) / sizeof (probes[0]); ++p) {
+		/* the first event at or after the probe, found the slow way */
+		size_t n = 0;
+		while (n < times.size() && times[n] < probes[p]) {
+			++n;
+		}
+
+		time = smf.seek_to_time (probes[p]);
+
+		if (n == times.size()) {
+			CPPUNIT_ASSERT(smf.read_event(&delta_t, &size, &buf) < 0);
+		} else {
+			CPPUNIT_ASSERT_EQUAL (n > 0 ? times[n - 1] : (uint64_t) 0, time);
+			CPPUNIT_ASSERT(smf.read_event(&delta_t, &size, &buf) >= 0);
+			CPPUNIT_ASSERT_EQUAL (times[n], time + delta_t);
+		}
+	}
+
+	free (buf);
+}
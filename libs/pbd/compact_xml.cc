@@ -0,0 +1,456 @@
+/*
+    Copyright (C) 2016 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#include <algorithm>
+#include <map>
+
+#include <gio/gio.h>
+
+#include "pbd/compact_xml.h"
+#include "pbd/xml++.h"
+
+using namespace std;
+using namespace PBD;
+
+/* Encoding of each child node, relative to the reference node's children */
+enum ChildEncoding {
+	Full  = 0, ///< complete node follows
+	Same  = 1, ///< identical to the reference child whose index follows
+	Delta = 2, ///< index of a reference child follows, then a delta against it
+};
+
+namespace {
+
+class Writer {
+  public:
+	Writer (vector<uint8_t>& d) : data (d) {}
+
+	void put_byte (uint8_t b) { data.push_back (b); }
+
+	void put_varint (size_t v) {
+		while (v >= 0x80) {
+			data.push_back ((v & 0x7f) | 0x80);
+			v >>= 7;
+		}
+		data.push_back (v);
+	}
+
+	void put_string (string const & s) {
+		put_varint (s.size ());
+		data.insert (data.end (), s.begin (), s.end ());
+	}
+
+  private:
+	vector<uint8_t>& data;
+};
+
+class Reader {
+  public:
+	Reader (uint8_t const * d, size_t s) : data (d), size (s), pos (0) {}
+
+	uint8_t get_byte () {
+		if (pos >= size) {
+			throw XMLException ("CompactXML: truncated data");
+		}
+		return data[pos++];
+	}
+
+	size_t get_varint () {
+		size_t v = 0;
+		for (int shift = 0; ; shift += 7) {
+			const uint8_t b = get_byte ();
+			v |= (size_t) (b & 0x7f) << shift;
+			if (!(b & 0x80)) {
+				break;
+			}
+		}
+		return v;
+	}
+
+	string get_string () {
+		const size_t len = get_varint ();
+		if (len > size - pos) {
+			throw XMLException ("CompactXML: truncated data");
+		}
+		string s ((char const *) data + pos, len);
+		pos += len;
+		return s;
+	}
+
+  private:
+	uint8_t const * data;
+	size_t          size;
+	size_t          pos;
+};
+
+} // anonymous namespace
+
+static bool
+equal (XMLNode const & a, XMLNode const & b)
+{
+	if (a.name () != b.name () || a.is_content () != b.is_content () || a.content () != b.content ()) {
+		return false;
+	}
+
+	XMLPropertyList const & ap (a.properties ());
+	XMLPropertyList const & bp (b.properties ());
+
+	if (ap.size () != bp.size ()) {
+		return false;
+	}
+
+	for (size_t n = 0; n < ap.size (); ++n) {
+		if (ap[n]->name () != bp[n]->name () || ap[n]->value () != bp[n]->value ()) {
+			return false;
+		}
+	}
+
+	XMLNodeList const & ac (a.children ());
+	XMLNodeList const & bc (b.children ());
+
+	if (ac.size () != bc.size ()) {
+		return false;
+	}
+
+	for (size_t n = 0; n < ac.size (); ++n) {
+		if (!equal (*ac[n], *bc[n])) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void
+encode_full (Writer& w, XMLNode const & node)
+{
+	w.put_string (node.name ());
+	w.put_byte (node.is_content ());
+	w.put_string (node.content ());
+
+	XMLPropertyList const & props (node.properties ());
+	w.put_varint (props.size ());
+	for (XMLPropertyConstIterator p = props.begin (); p != props.end (); ++p) {
+		w.put_string ((*p)->name ());
+		w.put_string ((*p)->value ());
+	}
+
+	XMLNodeList const & children (node.children ());
+	w.put_varint (children.size ());
+	for (XMLNodeConstIterator c = children.begin (); c != children.end (); ++c) {
+		w.put_byte (Full);
+		encode_full (w, **c);
+	}
+}
+
+/** Encode @a node, which has the same name as @a ref, as a delta against it */
+static void
+encode_delta (Writer& w, XMLNode const & node, XMLNode const & ref)
+{
+	w.put_byte (node.is_content ());
+	w.put_string (node.content ());
+
+	/* properties are written in order, either as (1 + index) of an identical
+	 * property of the reference, or as 0 followed by name and value.
+	 */
+
+	XMLPropertyList const & props (node.properties ());
+	XMLPropertyList const & ref_props (ref.properties ());
+
+	w.put_varint (props.size ());
+	for (size_t n = 0; n < props.size (); ++n) {
+		size_t r = 0;
+		if (n < ref_props.size () && ref_props[n]->name () == props[n]->name ()) {
+			r = n;
+		} else {
+			for (r = 0; r < ref_props.size () && ref_props[r]->name () != props[n]->name (); ++r) {}
+		}
+		if (r < ref_props.size () && ref_props[r]->value () == props[n]->value ()) {
+			w.put_varint (r + 1);
+		} else {
+			w.put_varint (0);
+			w.put_string (props[n]->name ());
+			w.put_string (props[n]->value ());
+		}
+	}
+
+	/* children are matched to those of the reference by name and "id"
+	 * property if they have one, by name and position otherwise.
+	 */
+
+	XMLNodeList const & children (node.children ());
+	XMLNodeList const & ref_children (ref.children ());
+
+	map<pair<string, string>, size_t> by_id;
+	for (size_t n = 0; n < ref_children.size (); ++n) {
+		XMLProperty const * id = ref_children[n]->property ("id");
+		if (id) {
+			by_id.insert (make_pair (make_pair (ref_children[n]->name (), id->value ()), n));
+		}
+	}
+
+	w.put_varint (children.size ());
+	for (size_t n = 0; n < children.size (); ++n) {
+		XMLNode const & child (*children[n]);
+		XMLProperty const * id = child.property ("id");
+		size_t r = ref_children.size ();
+
+		if (id) {
+			map<pair<string, string>, size_t>::const_iterator i = by_id.find (make_pair (child.name (), id->value ()));
+			if (i != by_id.end ()) {
+				r = i->second;
+			}
+		} else if (n < ref_children.size () && ref_children[n]->name () == child.name ()) {
+			r = n;
+		}
+
+		if (r == ref_children.size ()) {
+			w.put_byte (Full);
+			encode_full (w, child);
+		} else if (equal (child, *ref_children[r])) {
+			w.put_byte (Same);
+			w.put_varint (r);
+		} else {
+			w.put_byte (Delta);
+			w.put_varint (r);
+			encode_delta (w, child, *ref_children[r]);
+		}
+	}
+}
+
+static XMLNode* decode_delta (Reader& r, XMLNode const & ref);
+
+static XMLNode*
+decode_child (Reader& r, XMLNode const * ref);
+
+static XMLNode*
+decode_full (Reader& r)
+{
+	const string name = r.get_string ();
+	const bool is_content = r.get_byte ();
+	const string content = r.get_string ();
+
+	XMLNode* node = is_content ? new XMLNode (name, content) : new XMLNode (name);
+
+	try {
+		for (size_t n = r.get_varint (); n > 0; --n) {
+			const string pname = r.get_string ();
+			node->add_property (pname.c_str (), r.get_string ());
+		}
+
+		for (size_t n = r.get_varint (); n > 0; --n) {
+			node->add_child_nocopy (*decode_child (r, 0));
+		}
+	} catch (...) {
+		delete node;
+		throw;
+	}
+
+	return node;
+}
+
+static XMLNode*
+decode_child (Reader& r, XMLNode const * ref)
+{
+	const uint8_t how = r.get_byte ();
+
+	if (how == Full) {
+		return decode_full (r);
+	}
+
+	if (!ref) {
+		throw XMLException ("CompactXML: delta without reference");
+	}
+
+	const size_t idx = r.get_varint ();
+	XMLNodeList const & ref_children (ref->children ());
+
+	if (idx >= ref_children.size ()) {
+		throw XMLException ("CompactXML: reference does not match");
+	}
+
+	if (how == Same) {
+		return new XMLNode (*ref_children[idx]);
+	}
+
+	return decode_delta (r, *ref_children[idx]);
+}
+
+static XMLNode*
+decode_delta (Reader& r, XMLNode const & ref)
+{
+	const bool is_content = r.get_byte ();
+	const string content = r.get_string ();
+
+	XMLNode* node = is_content ? new XMLNode (ref.name (), content) : new XMLNode (ref.name ());
+	XMLPropertyList const & ref_props (ref.properties ());
+
+	try {
+		for (size_t n = r.get_varint (); n > 0; --n) {
+			const size_t idx = r.get_varint ();
+			if (idx > ref_props.size ()) {
+				throw XMLException ("CompactXML: reference does not match");
+			}
+			if (idx) {
+				node->add_property (ref_props[idx - 1]->name ().c_str (), ref_props[idx - 1]->value ());
+			} else {
+				const string pname = r.get_string ();
+				node->add_property (pname.c_str (), r.get_string ());
+			}
+		}
+
+		for (size_t n = r.get_varint (); n > 0; --n) {
+			node->add_child_nocopy (*decode_child (r, &ref));
+		}
+	} catch (...) {
+		delete node;
+		throw;
+	}
+
+	return node;
+}
+
+/** Run @a in through @a converter into @a out. @return true on success */
+static bool
+convert (GConverter* converter, uint8_t const * in, size_t in_size, vector<uint8_t>& out)
+{
+	size_t read_total = 0;
+	size_t written_total = 0;
+
+	out.resize (max ((size_t) 64, out.size ()));
+
+	while (true) {
+		gsize bytes_read = 0;
+		gsize bytes_written = 0;
+		GError* error = 0;
+
+		GConverterResult res = g_converter_convert (converter,
+		                                            in + read_total, in_size - read_total,
+		                                            &out[written_total], out.size () - written_total,
+		                                            G_CONVERTER_INPUT_AT_END,
+		                                            &bytes_read, &bytes_written, &error);
+
+		if (res == G_CONVERTER_ERROR) {
+			const bool no_space = g_error_matches (error, G_IO_ERROR, G_IO_ERROR_NO_SPACE);
+			g_error_free (error);
+			if (!no_space) {
+				return false;
+			}
+			out.resize (out.size () * 2);
+			continue;
+		}
+
+		read_total += bytes_read;
+		written_total += bytes_written;
+
+		if (res == G_CONVERTER_FINISHED) {
+			break;
+		}
+
+		if (written_total == out.size ()) {
+			out.resize (out.size () * 2);
+		}
+	}
+
+	out.resize (written_total);
+	return true;
+}
+
+CompactXML::CompactXML (XMLNode const & node, XMLNode const * reference)
+	: _raw_size (0)
+	, _compressed (false)
+{
+	vector<uint8_t> raw;
+	Writer w (raw);
+
+	if (reference && reference->name () == node.name ()) {
+		w.put_byte (Delta);
+		encode_delta (w, node, *reference);
+	} else {
+		w.put_byte (Full);
+		encode_full (w, node);
+	}
+
+	_raw_size = raw.size ();
+
+	GConverter* deflate = G_CONVERTER (g_zlib_compressor_new (G_ZLIB_COMPRESSOR_FORMAT_RAW, -1));
+	vector<uint8_t> compressed (_raw_size / 4);
+
+	if (convert (deflate, &raw[0], raw.size (), compressed) && compressed.size () < raw.size ()) {
+		_data.swap (compressed);
+		_compressed = true;
+	} else {
+		_data.swap (raw);
+	}
+
+	g_object_unref (deflate);
+
+	/* drop any slack left by encoding and compression */
+	vector<uint8_t> (_data).swap (_data);
+}
+
+XMLNode*
+CompactXML::expand (XMLNode const * reference) const
+{
+	vector<uint8_t> raw;
+	uint8_t const * data = &_data[0];
+
+	if (_compressed) {
+		GConverter* inflate = G_CONVERTER (g_zlib_decompressor_new (G_ZLIB_COMPRESSOR_FORMAT_RAW));
+		raw.resize (_raw_size);
+		const bool ok = convert (inflate, &_data[0], _data.size (), raw);
+		g_object_unref (inflate);
+		if (!ok || raw.size () != _raw_size) {
+			throw XMLException ("CompactXML: cannot decompress");
+		}
+		data = &raw[0];
+	}
+
+	Reader r (data, _raw_size);
+
+	if (r.get_byte () == Full) {
+		return decode_full (r);
+	}
+
+	if (!reference) {
+		throw XMLException ("CompactXML: delta without reference");
+	}
+
+	return decode_delta (r, *reference);
+}
+
+size_t
+CompactXML::memory_size (XMLNode const & node)
+{
+	size_t sz = sizeof (XMLNode) + node.name ().capacity () + node.content ().capacity ();
+
+	XMLPropertyList const & props (node.properties ());
+	for (XMLPropertyConstIterator p = props.begin (); p != props.end (); ++p) {
+		/* property list entry, property map node and the property itself */
+		sz += 2 * sizeof (void*) + 4 * sizeof (void*) + sizeof (XMLProperty);
+		sz += 2 * (*p)->name ().capacity () + (*p)->value ().capacity ();
+	}
+
+	XMLNodeList const & children (node.children ());
+	for (XMLNodeConstIterator c = children.begin (); c != children.end (); ++c) {
+		sz += sizeof (void*) + memory_size (**c);
+	}
+
+	return sz;
+}
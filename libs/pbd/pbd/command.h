@@ -49,6 +49,14 @@ public:
 		return false;
 	}
 
+	/** @return approximate number of bytes of memory held by this command */
+	virtual size_t memory_size () const { return sizeof (Command) + _name.capacity (); }
+
+	/** Reduce the memory held by this command, which is not expected
+	 *  to be undone or redone soon. Undo and redo must still work.
+	 */
+	virtual void compact () {}
+
 protected:
 	Command() {}
 	Command(const std::string& name) : _name(name) {}
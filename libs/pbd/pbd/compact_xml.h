@@ -0,0 +1,64 @@
+/*
+    Copyright (C) 2016 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#ifndef __lib_pbd_compact_xml_h__
+#define __lib_pbd_compact_xml_h__
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "pbd/libpbd_visibility.h"
+
+class XMLNode;
+
+namespace PBD {
+
+/** A compressed, binary copy of an XMLNode tree, used to keep old state
+ *  (such as undo history) around without holding on to the full tree.
+ *
+ *  The node may be stored as a delta against a reference node; children
+ *  which are identical to one in the reference (matched by their "id"
+ *  property, or by position) are stored as a reference to it, and those
+ *  which differ only hold the properties that changed. The same reference
+ *  must then be passed to expand().
+ */
+class LIBPBD_API CompactXML
+{
+  public:
+	CompactXML (XMLNode const & node, XMLNode const * reference = 0);
+
+	/** @return a new copy of the original node, owned by the caller */
+	XMLNode* expand (XMLNode const * reference = 0) const;
+
+	/** @return number of bytes held */
+	size_t memory_size () const { return sizeof (CompactXML) + _data.capacity (); }
+
+	/** @return an estimate of the number of bytes used by an XMLNode tree */
+	static size_t memory_size (XMLNode const &);
+
+  private:
+	std::vector<uint8_t> _data;
+	size_t               _raw_size;
+	bool                 _compressed;
+};
+
+} // namespace PBD
+
+#endif /* __lib_pbd_compact_xml_h__ */
@@ -25,6 +25,7 @@
 
 #include "pbd/libpbd_visibility.h"
 #include "pbd/command.h"
+#include "pbd/compact_xml.h"
 #include "pbd/stacktrace.h"
 #include "pbd/xml++.h"
 #include "pbd/demangle.h"
@@ -105,6 +106,7 @@ class LIBPBD_TEMPLATE_API MementoCommand : public Command
 public:
 	MementoCommand (obj_T& a_object, XMLNode* a_before, XMLNode* a_after)
 		: _binder (new SimpleMementoCommandBinder<obj_T> (a_object)), before (a_before), after (a_after)
+		, compact_before (0), compact_after (0)
 	{
 		/* The binder's object died, so we must die */
 		_binder->DropReferences.connect_same_thread (_binder_death_connection, boost::bind (&MementoCommand::binder_dying, this));
@@ -112,6 +114,7 @@ public:
 
 	MementoCommand (MementoCommandBinder<obj_T>* b, XMLNode* a_before, XMLNode* a_after)
 		: _binder (b), before (a_before), after (a_after)
+		, compact_before (0), compact_after (0)
 	{
 		/* The binder's object died, so we must die */
 		_binder->DropReferences.connect_same_thread (_binder_death_connection, boost::bind (&MementoCommand::binder_dying, this));
@@ -121,6 +124,8 @@ public:
 		drop_references ();
 		delete before;
 		delete after;
+		delete compact_before;
+		delete compact_after;
 		delete _binder;
 	}
 
@@ -129,22 +134,31 @@ public:
 	}
 
 	void operator() () {
+		expand ();
 		if (after) {
 			_binder->get()->set_state(*after, Stateful::current_state_version);
 		}
 	}
 
 	void undo() {
+		expand ();
 		if (before) {
 			_binder->get()->set_state(*before, Stateful::current_state_version);
 		}
 	}
 
 	virtual XMLNode &get_state() {
+		/* expand compacted mementos only for as long as we need them */
+		XMLNode* a = compact_after ? compact_after->expand () : 0;
+		XMLNode* b = compact_before ? compact_before->expand (a) : 0;
+
+		XMLNode const * bf = b ? b : before;
+		XMLNode const * af = a ? a : after;
+
 		std::string name;
-		if (before && after) {
+		if (bf && af) {
 			name = "MementoCommand";
-		} else if (before) {
+		} else if (bf) {
 			name = "MementoUndoCommand";
 		} else {
 			name = "MementoRedoCommand";
@@ -155,22 +169,74 @@ public:
 
 		node->add_property ("type_name", _binder->type_name ());
 
-		if (before) {
-			node->add_child_copy(*before);
+		if (b) {
+			node->add_child_nocopy(*b);
+		} else if (bf) {
+			node->add_child_copy(*bf);
 		}
 
-		if (after) {
-			node->add_child_copy(*after);
+		if (a) {
+			node->add_child_nocopy(*a);
+		} else if (af) {
+			node->add_child_copy(*af);
 		}
 
 		return *node;
 	}
 
+	size_t memory_size () const {
+		size_t sz = Command::memory_size () + sizeof (*this) - sizeof (Command);
+		if (before) {
+			sz += PBD::CompactXML::memory_size (*before);
+		}
+		if (after) {
+			sz += PBD::CompactXML::memory_size (*after);
+		}
+		if (compact_before) {
+			sz += compact_before->memory_size ();
+		}
+		if (compact_after) {
+			sz += compact_after->memory_size ();
+		}
+		return sz;
+	}
+
+	/** Replace the before and after mementos with compressed copies, the
+	 *  before memento being stored as a delta against the after one.
+	 */
+	void compact () {
+		if (after) {
+			compact_after = new PBD::CompactXML (*after);
+		}
+		if (before) {
+			compact_before = new PBD::CompactXML (*before, after);
+		}
+		delete before;
+		delete after;
+		before = after = 0;
+	}
+
 protected:
 	MementoCommandBinder<obj_T>* _binder;
 	XMLNode* before;
 	XMLNode* after;
+	PBD::CompactXML* compact_before;
+	PBD::CompactXML* compact_after;
 	PBD::ScopedConnection _binder_death_connection;
+
+	/** Restore the mementos after compact(), when they are needed again */
+	void expand () {
+		if (compact_after) {
+			after = compact_after->expand ();
+			delete compact_after;
+			compact_after = 0;
+		}
+		if (compact_before) {
+			before = compact_before->expand (after);
+			delete compact_before;
+			compact_before = 0;
+		}
+	}
 };
 
 #endif // __lib_pbd_memento_h__
@@ -150,6 +150,8 @@ public:
 		}
 	}
 
+	size_t memory_size () const { return sizeof (*this); }
+
 
 	/* VARIOUS */
 
@@ -430,6 +432,13 @@ public:
 		}
 	}
 
+	/* both states are full copies of a T, but we can only guess at what
+	 * a T holds beyond its own size.
+	 */
+	size_t memory_size () const {
+		return sizeof (*this) + (_old ? sizeof (T) : 0) + (_current ? sizeof (T) : 0);
+	}
+
 	void apply_changes (PropertyBase const * p) {
 		*_current = *(dynamic_cast<SharedStatefulProperty const *> (p))->val ();
 	}
@@ -138,6 +138,11 @@ public:
 	/** Collect StatefulDiffCommands for changes to anything that we own */
 	virtual void rdiff (std::vector<Command*> &) const {}
 
+	/** @return approximate number of bytes of memory held by this property,
+	 *  for a StatefulDiffCommand to report.
+	 */
+	virtual size_t memory_size () const = 0;
+
 	/** Look in an XML node written by get_changes_as_xml and, if XML from this property
 	 *  is found, create a property with the changes from the XML.
 	 */
@@ -126,15 +126,7 @@ public:
 
 		// clean out any dead wood
 
-		typename std::list<boost::shared_ptr<T> >::iterator i;
-
-		for (i = m_dead_wood.begin(); i != m_dead_wood.end(); ) {
-			if ((*i).unique()) {
-				i = m_dead_wood.erase (i);
-			} else {
-				++i;
-			}
-		}
+		drop_unused_dead_wood ();
 
 		/* store the current so that we can do compare and exchange
 		   when someone calls update(). Notice that we hold
@@ -193,7 +185,27 @@ public:
 		m_dead_wood.clear ();
 	}
 
+	/* unlike flush(), only let go of old values that no reader still
+	   holds, so that none of them is destroyed in a reader's thread.
+	*/
+	void collect () {
+		Glib::Threads::Mutex::Lock lm (m_lock);
+		drop_unused_dead_wood ();
+	}
+
 private:
+	void drop_unused_dead_wood () {
+		typename std::list<boost::shared_ptr<T> >::iterator i;
+
+		for (i = m_dead_wood.begin(); i != m_dead_wood.end(); ) {
+			if ((*i).unique()) {
+				i = m_dead_wood.erase (i);
+			} else {
+				++i;
+			}
+		}
+	}
+
 	Glib::Threads::Mutex                      m_lock;
 	boost::shared_ptr<T>*            current_write_old;
 	std::list<boost::shared_ptr<T> > m_dead_wood;
@@ -214,6 +214,12 @@ class /*LIBPBD_API*/ SequenceProperty : public PropertyBase
 		return p;
         }
 
+	/** The items themselves are shared with their owners; count only our references */
+	size_t memory_size () const {
+		const size_t node = sizeof (typename Container::value_type) + 4 * sizeof (void*);
+		return sizeof (*this) + (_val.size () + _changes.added.size () + _changes.removed.size ()) * node;
+	}
+
 	/** Given an \<Add\> or \<Remove\> node as passed into get_content_to_xml, obtain an item */
 	virtual typename Container::value_type get_content_from_xml (XMLNode const & node) const = 0;
 
@@ -27,6 +27,7 @@
 #undef nil
 #endif
 
+#include <glib.h>
 #include <glibmm/threads.h>
 
 #include <boost/noncopyable.hpp>
@@ -56,8 +57,10 @@ class LIBPBD_API SignalBase
 {
 public:
 	SignalBase ()
+	: _emissions (0)
+	, _writing (0)
 #ifdef DEBUG_PBD_SIGNAL_CONNECTIONS
-	: _debug_connection (false)
+	, _debug_connection (false)
 #endif
 	{}
 	virtual ~SignalBase () {}
@@ -67,7 +70,51 @@ public:
 #endif
 
 protected:
+	/** Counts an emission (or other lock-free look at the slots) as being in
+	 *  progress for as long as it exists.  While any emission is in progress
+	 *  the slots are only changed by copying them, and old copies are not
+	 *  freed.
+	 */
+	class EmissionScope {
+	public:
+		EmissionScope (SignalBase& s) : _s (s) {
+			while (true) {
+				g_atomic_int_inc (&_s._emissions);
+				if (!g_atomic_int_get (&_s._writing)) {
+					break;
+				}
+				/* the slots are being changed in place (which only takes
+				   a moment): wait for that to finish, and try again.
+				*/
+				g_atomic_int_dec_and_test (&_s._emissions);
+				Glib::Threads::Mutex::Lock lm (_s._mutex);
+			}
+		}
+		~EmissionScope () { g_atomic_int_dec_and_test (&_s._emissions); }
+	private:
+		SignalBase& _s;
+	};
+
+	bool emitting () const { return g_atomic_int_get (&_emissions) != 0; }
+
+	/** Call with _mutex held.  @return true if no emission is in progress,
+	 *  in which case none will start until end_write() is called and the
+	 *  slots may be changed in place.
+	 */
+	bool begin_write () {
+		g_atomic_int_compare_and_exchange (&_writing, 0, 1);
+		if (!emitting ()) {
+			return true;
+		}
+		g_atomic_int_set (&_writing, 0);
+		return false;
+	}
+
+	void end_write () { g_atomic_int_set (&_writing, 0); }
+
         Glib::Threads::Mutex _mutex;
+	gint _emissions;
+	gint _writing;
 #ifdef DEBUG_PBD_SIGNAL_CONNECTIONS
 	bool _debug_connection;
 #endif
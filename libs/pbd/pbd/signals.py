@@ -101,20 +101,61 @@ def signal(f, n, v):
     print("private:", file=f)
 
     print("""
-	/** The slots that this signal will call on emission */
+	/** The slots that this signal will call on emission.  While an
+	    emission is walking the list it is never changed: connecting or
+	    disconnecting then builds a new one and swaps it in, so that
+	    emission can walk the current list without a lock or a copy.
+	*/
 	typedef std::map<boost::shared_ptr<Connection>, slot_function_type> Slots;
-	Slots _slots;
+	mutable volatile gpointer _slots;    ///< the current Slots*, or 0 if there are none
+	std::list<Slots*>         _old_slots; ///< replaced lists that an emission may still be walking
+
+	Slots const * slots () const { return static_cast<Slots const *> (g_atomic_pointer_get (&_slots)); }
+
+	/* Make @a s the current list of slots; call with _mutex held */
+	void set_slots (Slots* s)
+	{
+		Slots* old = static_cast<Slots*> (_slots);
+		g_atomic_pointer_compare_and_exchange (&_slots, (gpointer) old, (gpointer) s);
+
+		if (old) {
+			_old_slots.push_back (old);
+		}
+
+		/* Any emission that starts from now on will see the new list, so
+		   if none is running at the moment nobody can be using the old ones.
+		*/
+		if (!emitting ()) {
+			drop_old_slots ();
+		}
+	}
+
+	void drop_old_slots ()
+	{
+		while (!_old_slots.empty ()) {
+			delete _old_slots.front ();
+			_old_slots.pop_front ();
+		}
+	}
 """, file=f)
 
     print("public:", file=f)
     print("", file=f)
+    print("\tSignal%d () : _slots (0) {}" % n, file=f)
+    print("", file=f)
     print("\t~Signal%d () {" % n, file=f)
 
     print("\t\tGlib::Threads::Mutex::Lock lm (_mutex);", file=f)
-    print("\t\t/* Tell our connection objects that we are going away, so they don't try to call us */", file=f)
-    print("\t\tfor (%sSlots::const_iterator i = _slots.begin(); i != _slots.end(); ++i) {" % typename, file=f)
-
-    print("\t\t\ti->first->signal_going_away ();", file=f)
+    print("\t\tSlots* s = static_cast<Slots*> (_slots);", file=f)
+    print("\t\tif (s) {", file=f)
+    print("\t\t\t/* Tell our connection objects that we are going away, so they don't try to call us */", file=f)
+    print("\t\t\tfor (%sSlots::const_iterator i = s->begin(); i != s->end(); ++i) {" % typename, file=f)
+    print("\t\t\t\ti->first->signal_going_away ();", file=f)
+    print("\t\t\t}", file=f)
+    print("\t\t\tdelete s;", file=f)
+    print("\t\t}", file=f)
+    print("\t\tfor (%sstd::list<Slots*>::const_iterator i = _old_slots.begin(); i != _old_slots.end(); ++i) {" % typename, file=f)
+    print("\t\t\tdelete *i;", file=f)
     print("\t\t}", file=f)
     print("\t}", file=f)
     print("", file=f)
@@ -230,34 +271,37 @@ def signal(f, n, v):
     else:
         print("\ttypename C::result_type operator() (%s)" % comma_separated(Anan), file=f)
     print("\t{", file=f)
-    print("\t\t/* First, take a copy of our list of slots as it is now */", file=f)
-    print("", file=f)
-    print("\t\tSlots s;", file=f)
-    print("\t\t{", file=f)
-    print("\t\t\tGlib::Threads::Mutex::Lock lm (_mutex);", file=f)
-    print("\t\t\ts = _slots;", file=f)
-    print("\t\t}", file=f)
-    print("", file=f)
+    if v:
+        print("""		if (!slots ()) {
+			/* nothing connected, and nothing to return */
+			return;
+		}
+""", file=f)
+    print("""		/* Walk our list of slots as it is now.  Connecting or disconnecting
+		   replaces the list rather than changing it, and no replaced list is
+		   freed while an emission is in progress, so there is no need for a
+		   lock or a copy.
+		*/
+		EmissionScope es (*this);
+		Slots const * s = slots ();
+""", file=f)
     if not v:
         print("\t\tstd::list<R> r;", file=f)
-    print("\t\tfor (%sSlots::const_iterator i = s.begin(); i != s.end(); ++i) {" % typename, file=f)
+    print("\t\tif (s) {", file=f)
+    print("\t\t\tfor (%sSlots::const_iterator i = s->begin(); i != s->end(); ++i) {" % typename, file=f)
     print("""
-			/* We may have just called a slot, and this may have resulted in
-			   disconnection of other slots from us.  The list copy means that
-			   this won't cause any problems with invalidated iterators, but we
-			   must check to see if the slot we are about to call is still on the list.
-			*/
-			bool still_there = false;
-			{
-				Glib::Threads::Mutex::Lock lm (_mutex);
-				still_there = _slots.find (i->first) != _slots.end ();
-			}
-
-			if (still_there) {""", file=f)
+				/* We may have just called a slot, and this may have resulted in
+				   disconnection of other slots from us.  We must check to see if
+				   the slot we are about to call is still on the list.
+				*/
+				Slots const * now = slots ();
+
+				if (now == s || (now && now->find (i->first) != now->end ())) {""", file=f)
     if v:
-        print("\t\t\t\t(i->second)(%s);" % comma_separated(an), file=f)
+        print("\t\t\t\t\t(i->second)(%s);" % comma_separated(an), file=f)
     else:
-        print("\t\t\t\tr.push_back ((i->second)(%s));" % comma_separated(an), file=f)
+        print("\t\t\t\t\tr.push_back ((i->second)(%s));" % comma_separated(an), file=f)
+    print("\t\t\t\t}", file=f)
     print("\t\t\t}", file=f)
     print("\t\t}", file=f)
     print("", file=f)
@@ -269,8 +313,9 @@ def signal(f, n, v):
 
     print("""
 	bool empty () {
-		Glib::Threads::Mutex::Lock lm (_mutex);
-		return _slots.empty ();
+		EmissionScope es (*this);
+		Slots const * s = slots ();
+		return !s || s->empty ();
 	}
 """, file=f)
 
@@ -293,7 +338,16 @@ def signal(f, n, v):
 #endif
 		boost::shared_ptr<Connection> c (new Connection (this));
 		Glib::Threads::Mutex::Lock lm (_mutex);
-		_slots[c] = f;
+		Slots* s = static_cast<Slots*> (_slots);
+		if (s && begin_write ()) {
+			(*s)[c] = f;
+			drop_old_slots ();
+			end_write ();
+		} else {
+			Slots* n = s ? new Slots (*s) : new Slots;
+			(*n)[c] = f;
+			set_slots (n);
+		}
 		return c;
 	}""", file=f)
 
@@ -301,7 +355,19 @@ def signal(f, n, v):
 	void disconnect (boost::shared_ptr<Connection> c)
 	{
 		Glib::Threads::Mutex::Lock lm (_mutex);
-		_slots.erase (c);
+		Slots* s = static_cast<Slots*> (_slots);
+		if (!s || s->find (c) == s->end ()) {
+			return;
+		}
+		if (begin_write ()) {
+			s->erase (c);
+			drop_old_slots ();
+			end_write ();
+		} else {
+			Slots* n = new Slots (*s);
+			n->erase (c);
+			set_slots (n);
+		}
 	}
 };    
 """, file=f)
@@ -57,6 +57,10 @@ class LIBPBD_API UndoTransaction : public Command
 
 	XMLNode &get_state();
 
+	size_t memory_size () const;
+	void compact ();
+	bool compacted () const { return _compacted; }
+
 	void set_timestamp (struct timeval &t) {
 		_timestamp = t;
 	}
@@ -69,6 +73,7 @@ class LIBPBD_API UndoTransaction : public Command
 	std::list<Command*>    actions;
 	struct timeval        _timestamp;
 	bool                  _clearing;
+	bool                  _compacted;
 
 	friend void command_death (UndoTransaction*, Command *);
 
@@ -108,6 +113,16 @@ class LIBPBD_API UndoHistory : public PBD::ScopedConnectionList
 
 	void set_depth (uint32_t);
 
+	/** Limit the memory used by the undo history to about @a bytes, removing
+	 *  the oldest transactions as needed (but never the most recent one).
+	 *  0 means no limit.
+	 */
+	void set_memory_limit (size_t bytes);
+	size_t memory_limit () const { return _memory_limit; }
+
+	/** @return approximate number of bytes used by the undo and redo lists */
+	size_t memory_size () const;
+
 	PBD::Signal0<void> Changed;
 	PBD::Signal0<void> BeginUndoRedo;
 	PBD::Signal0<void> EndUndoRedo;
@@ -115,10 +130,12 @@ class LIBPBD_API UndoHistory : public PBD::ScopedConnectionList
   private:
 	bool _clearing;
 	uint32_t _depth;
+	size_t _memory_limit;
 	std::list<UndoTransaction*> UndoList;
 	std::list<UndoTransaction*> RedoList;
 
 	void remove (UndoTransaction*);
+	void enforce_memory_limit ();
 };
 
 
@@ -122,3 +122,22 @@ StatefulDiffCommand::empty () const
 {
 	return _changes->empty();
 }
+
+/* _changes holds only the properties that changed, so there is nothing
+   to gain from compact ().
+*/
+size_t
+StatefulDiffCommand::memory_size () const
+{
+	size_t sz = Command::memory_size () + sizeof (*this) - sizeof (Command);
+
+	if (_changes) {
+		sz += sizeof (PropertyList);
+		for (PropertyList::const_iterator i = _changes->begin(); i != _changes->end(); ++i) {
+			/* map node and the property */
+			sz += 4 * sizeof (void*) + sizeof (*i) + i->second->memory_size ();
+		}
+	}
+
+	return sz;
+}
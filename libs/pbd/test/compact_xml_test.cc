@@ -0,0 +1,83 @@
+#include <cstdio>
+
+#include "compact_xml_test.h"
+
+#include "pbd/compact_xml.h"
+#include "pbd/xml++.h"
+
+using namespace std;
+using namespace PBD;
+
+CPPUNIT_TEST_SUITE_REGISTRATION (CompactXMLTest);
+
+namespace {
+
+/** @return a playlist-like node with @a n regions */
+XMLNode*
+make_state (int n)
+{
+	XMLNode* node = new XMLNode ("Playlist");
+	node->add_property ("name", "audio 1");
+	node->add_property ("id", "1");
+
+	for (int i = 0; i < n; ++i) {
+		char buf[32];
+		snprintf (buf, sizeof (buf), "%d", 100 + i);
+		XMLNode* r = node->add_child ("Region");
+		r->add_property ("id", buf);
+		r->add_property ("position", buf);
+		r->add_property ("length", "48000");
+		r->add_child ("Envelope")->add_property ("default", "yes");
+	}
+
+	node->add_child ("Comment")->add_content ("some text");
+
+	return node;
+}
+
+string
+to_string (XMLNode const & node)
+{
+	XMLTree tree;
+	tree.set_root (new XMLNode (node));
+	return tree.write_buffer ();
+}
+
+} // anonymous namespace
+
+void
+CompactXMLTest::testRoundTrip ()
+{
+	XMLNode* node = make_state (100);
+	CompactXML compact (*node);
+
+	XMLNode* copy = compact.expand ();
+	CPPUNIT_ASSERT_EQUAL (to_string (*node), to_string (*copy));
+	CPPUNIT_ASSERT (compact.memory_size () < CompactXML::memory_size (*node));
+
+	delete copy;
+	delete node;
+}
+
+void
+CompactXMLTest::testDelta ()
+{
+	XMLNode* after = make_state (100);
+	XMLNode* before = make_state (100);
+
+	before->add_property ("name", "audio 2");
+	before->children ()[5]->add_property ("position", "7");
+	before->remove_nodes_and_delete ("id", "109");
+	before->add_child ("Region")->add_property ("id", "999");
+
+	CompactXML full (*before);
+	CompactXML delta (*before, after);
+
+	XMLNode* copy = delta.expand (after);
+	CPPUNIT_ASSERT_EQUAL (to_string (*before), to_string (*copy));
+	CPPUNIT_ASSERT (delta.memory_size () < full.memory_size ());
+
+	delete copy;
+	delete before;
+	delete after;
+}
@@ -0,0 +1,14 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class CompactXMLTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (CompactXMLTest);
+	CPPUNIT_TEST (testRoundTrip);
+	CPPUNIT_TEST (testDelta);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void testRoundTrip ();
+	void testDelta ();
+};
@@ -0,0 +1,193 @@
+#include <iostream>
+#include <map>
+#include <cstdlib>
+
+#include <glib.h>
+#include <glibmm/threads.h>
+
+#include "pbd/signals.h"
+
+using namespace std;
+
+/* Time PBD::Signal emission against the locking implementation it replaced
+ * (copy the slot map under the signal's mutex, then take the mutex again
+ * before each call), with and without another thread connecting and
+ * disconnecting slots at the same time.
+ *
+ * usage: signal-bench [slots [emissions]]
+ */
+
+static int nslots = 8;
+static int emissions = 1000000;
+
+/* The reference: what Signal1<void,int>::operator() used to do */
+class LockedSignal : public PBD::SignalBase
+{
+public:
+	typedef boost::function<void(int)> slot_function_type;
+
+	~LockedSignal () {
+		Glib::Threads::Mutex::Lock lm (_mutex);
+		for (Slots::const_iterator i = _slots.begin(); i != _slots.end(); ++i) {
+			i->first->signal_going_away ();
+		}
+	}
+
+	void connect_same_thread (PBD::ScopedConnectionList& clist, const slot_function_type& slot) {
+		boost::shared_ptr<PBD::Connection> c (new PBD::Connection (this));
+		Glib::Threads::Mutex::Lock lm (_mutex);
+		_slots[c] = slot;
+		clist.add_connection (c);
+	}
+
+	void operator() (int a1) {
+		Slots s;
+		{
+			Glib::Threads::Mutex::Lock lm (_mutex);
+			s = _slots;
+		}
+		for (Slots::const_iterator i = s.begin(); i != s.end(); ++i) {
+			bool still_there = false;
+			{
+				Glib::Threads::Mutex::Lock lm (_mutex);
+				still_there = _slots.find (i->first) != _slots.end ();
+			}
+			if (still_there) {
+				(i->second)(a1);
+			}
+		}
+	}
+
+	void disconnect (boost::shared_ptr<PBD::Connection> c) {
+		Glib::Threads::Mutex::Lock lm (_mutex);
+		_slots.erase (c);
+	}
+
+private:
+	typedef std::map<boost::shared_ptr<PBD::Connection>, slot_function_type> Slots;
+	Slots _slots;
+};
+
+static gint calls = 0;
+
+static void
+receiver (int n)
+{
+	g_atomic_int_add (&calls, n);
+}
+
+template<typename S>
+struct Churn {
+	Churn (S& s) : signal (s), quit (0), rounds (0) {}
+
+	static void* run (void* arg) {
+		Churn* c = static_cast<Churn*> (arg);
+		while (!g_atomic_int_get (&c->quit)) {
+			PBD::ScopedConnectionList clist;
+			c->signal.connect_same_thread (clist, boost::bind (&receiver, 0));
+			++c->rounds;
+		}
+		return 0;
+	}
+
+	S&   signal;
+	gint quit;
+	int  rounds;
+};
+
+/* @return the time taken for all emissions, in microseconds */
+template<typename S>
+static gint64
+bench (S& signal, bool churn, int& rounds)
+{
+	Churn<S>  c (signal);
+	pthread_t thread;
+
+	if (churn) {
+		pthread_create (&thread, 0, &Churn<S>::run, &c);
+	}
+
+	const gint64 start = g_get_monotonic_time ();
+	for (int i = 0; i < emissions; ++i) {
+		signal (1);
+	}
+	const gint64 usecs = g_get_monotonic_time () - start;
+
+	if (churn) {
+		g_atomic_int_set (&c.quit, 1);
+		pthread_join (thread, 0);
+	}
+
+	rounds = c.rounds;
+	return usecs;
+}
+
+static void
+report (const char* op, const char* impl, gint64 usecs, gint64 ref_usecs, int rounds, bool ok)
+{
+	cout << op << "\t" << impl << "\t"
+	     << (usecs * 1000.0 / emissions) << " ns/emission";
+	if (ref_usecs > 0) {
+		cout << "\tx" << (usecs > 0 ? ref_usecs / (double) usecs : 0.0);
+	}
+	if (rounds > 0) {
+		cout << "\t" << rounds << " (dis)connections";
+	}
+	cout << (ok ? "" : "\tMISMATCH") << endl;
+}
+
+int
+main (int argc, char* argv[])
+{
+	if (argc > 1) {
+		nslots = atoi (argv[1]);
+	}
+	if (argc > 2) {
+		emissions = atoi (argv[2]);
+	}
+
+	if (nslots < 0 || emissions < 1) {
+		cerr << "usage: signal-bench [slots [emissions]]\n";
+		return 1;
+	}
+
+	LockedSignal ref;
+	PBD::Signal1<void,int> sig;
+	PBD::ScopedConnectionList clist;
+
+	for (int i = 0; i < nslots; ++i) {
+		ref.connect_same_thread (clist, boost::bind (&receiver, _1));
+		sig.connect_same_thread (clist, boost::bind (&receiver, _1));
+	}
+
+	cout << "slots: " << nslots << ", emissions: " << emissions << endl;
+
+	int failures = 0;
+
+#define BENCH(op, churn)                                                      \
+	{                                                                         \
+		int ref_rounds;                                                       \
+		int rounds;                                                           \
+		g_atomic_int_set (&calls, 0);                                         \
+		const gint64 ref_usecs = bench (ref, churn, ref_rounds);              \
+		const bool ref_ok = g_atomic_int_get (&calls) == nslots * emissions;  \
+		g_atomic_int_set (&calls, 0);                                         \
+		const gint64 usecs = bench (sig, churn, rounds);                      \
+		const bool ok = g_atomic_int_get (&calls) == nslots * emissions;      \
+		if (!ok || !ref_ok) {                                                 \
+			++failures;                                                       \
+		}                                                                     \
+		report (op, "locked", ref_usecs, ref_usecs, ref_rounds, ref_ok);      \
+		report (op, "lock-free", usecs, ref_usecs, rounds, ok);               \
+	}
+
+	BENCH ("emit", false);
+	BENCH ("emit while connecting", true);
+
+	if (failures) {
+		cerr << failures << " run(s) did not call every slot once per emission\n";
+		return 1;
+	}
+
+	return 0;
+}
@@ -89,3 +89,89 @@ SignalsTest::testScopedConnectionList ()
 
 	CPPUNIT_ASSERT_EQUAL (1, N);
 }
+
+/* A slot which disconnects all the others the first time it is called */
+class Disconnector
+{
+public:
+	Disconnector (Emitter* e, int n) {
+		e->Fred.connect_same_thread (_first, boost::bind (&Disconnector::first, this));
+		for (int i = 0; i < n; ++i) {
+			e->Fred.connect_same_thread (_others, boost::bind (&receiver));
+		}
+	}
+
+	void first () {
+		++N;
+		_others.drop_connections ();
+	}
+
+private:
+	PBD::ScopedConnection _first;
+	PBD::ScopedConnectionList _others;
+};
+
+void
+SignalsTest::testDisconnectDuringEmission ()
+{
+	Emitter* e = new Emitter;
+
+	/* slots are called in an unspecified order, so all we know is that
+	 * once the disconnecting slot has been called none of the others may be.
+	 */
+	Disconnector* d = new Disconnector (e, 16);
+	N = 0;
+	e->emit ();
+	CPPUNIT_ASSERT (N >= 1 && N <= 17);
+
+	N = 0;
+	e->emit ();
+	CPPUNIT_ASSERT_EQUAL (1, N);
+
+	delete d;
+	N = 0;
+	e->emit ();
+	CPPUNIT_ASSERT_EQUAL (0, N);
+	CPPUNIT_ASSERT (e->Fred.empty ());
+
+	delete e;
+}
+
+static PBD::ScopedConnectionList* connect_list = 0;
+static Emitter* connect_emitter = 0;
+
+void
+connector ()
+{
+	++N;
+	connect_emitter->Fred.connect_same_thread (*connect_list, boost::bind (&receiver));
+}
+
+void
+SignalsTest::testConnectDuringEmission ()
+{
+	connect_emitter = new Emitter;
+	connect_list = new PBD::ScopedConnectionList;
+
+	PBD::ScopedConnection c;
+	connect_emitter->Fred.connect_same_thread (c, boost::bind (&connector));
+
+	/* a slot connected during an emission may or may not be called by it,
+	 * but must be by the next one.
+	 */
+	N = 0;
+	connect_emitter->emit ();
+	CPPUNIT_ASSERT (N == 1 || N == 2);
+
+	N = 0;
+	connect_emitter->emit ();
+	CPPUNIT_ASSERT (N >= 2);
+
+	c.disconnect ();
+	delete connect_list;
+	N = 0;
+	connect_emitter->emit ();
+	CPPUNIT_ASSERT_EQUAL (0, N);
+
+	delete connect_emitter;
+}
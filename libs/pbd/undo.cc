@@ -21,6 +21,7 @@
 #include <string>
 #include <sstream>
 #include <time.h>
+#include <algorithm>
 
 #include "pbd/undo.h"
 #include "pbd/xml++.h"
@@ -32,6 +33,7 @@ using namespace sigc;
 
 UndoTransaction::UndoTransaction ()
 	: _clearing(false)
+	, _compacted(false)
 {
 	gettimeofday (&_timestamp, 0);
 }
@@ -39,6 +41,7 @@ UndoTransaction::UndoTransaction ()
 UndoTransaction::UndoTransaction (const UndoTransaction& rhs)
 	: Command(rhs._name)
 	, _clearing(false)
+	, _compacted(false)
 {
         _timestamp = rhs._timestamp;
 	clear ();
@@ -121,6 +124,7 @@ UndoTransaction::operator() ()
 void
 UndoTransaction::undo ()
 {
+	_compacted = false;
 	for (list<Command*>::reverse_iterator i = actions.rbegin(); i != actions.rend(); ++i) {
 		(*i)->undo();
 	}
@@ -129,9 +133,31 @@ UndoTransaction::undo ()
 void
 UndoTransaction::redo ()
 {
+	_compacted = false;
         (*this)();
 }
 
+size_t
+UndoTransaction::memory_size () const
+{
+	size_t sz = sizeof (UndoTransaction) + _name.capacity ();
+
+	for (list<Command*>::const_iterator i = actions.begin(); i != actions.end(); ++i) {
+		sz += (*i)->memory_size ();
+	}
+
+	return sz;
+}
+
+void
+UndoTransaction::compact ()
+{
+	for (list<Command*>::iterator i = actions.begin(); i != actions.end(); ++i) {
+		(*i)->compact ();
+	}
+	_compacted = true;
+}
+
 XMLNode &UndoTransaction::get_state()
 {
     XMLNode *node = new XMLNode ("UndoTransaction");
@@ -168,6 +194,7 @@ UndoHistory::UndoHistory ()
 {
 	_clearing = false;
 	_depth = 0;
+	_memory_limit = 0;
 }
 
 void
@@ -195,6 +222,59 @@ UndoHistory::set_depth (uint32_t d)
 	}
 }
 
+void
+UndoHistory::set_memory_limit (size_t bytes)
+{
+	_memory_limit = bytes;
+	enforce_memory_limit ();
+}
+
+size_t
+UndoHistory::memory_size () const
+{
+	size_t sz = 0;
+
+	for (list<UndoTransaction*>::const_iterator i = UndoList.begin(); i != UndoList.end(); ++i) {
+		sz += (*i)->memory_size ();
+	}
+
+	for (list<UndoTransaction*>::const_iterator i = RedoList.begin(); i != RedoList.end(); ++i) {
+		sz += (*i)->memory_size ();
+	}
+
+	return sz;
+}
+
+/** Compact all but the most recent transaction, then drop the oldest ones
+ *  until we are within the memory limit (if there is one).
+ */
+void
+UndoHistory::enforce_memory_limit ()
+{
+	if (UndoList.size() > 1) {
+		list<UndoTransaction*>::iterator last = UndoList.end();
+		--last;
+		for (list<UndoTransaction*>::iterator i = UndoList.begin(); i != last; ++i) {
+			if (!(*i)->compacted ()) {
+				(*i)->compact ();
+			}
+		}
+	}
+
+	if (_memory_limit == 0) {
+		return;
+	}
+
+	size_t sz = memory_size ();
+
+	while (sz > _memory_limit && UndoList.size() > 1) {
+		UndoTransaction* ut = UndoList.front ();
+		UndoList.pop_front ();
+		sz -= min (sz, ut->memory_size ());
+		delete ut;
+	}
+}
+
 void
 UndoHistory::add (UndoTransaction* const ut)
 {
@@ -228,6 +308,8 @@ UndoHistory::add (UndoTransaction* const ut)
 	RedoList.clear ();
 	_clearing = false;
 
+	enforce_memory_limit ();
+
 	/* we are now owners of the transaction and must delete it when finished with it */
 
 	Changed (); /* EMIT SIGNAL */
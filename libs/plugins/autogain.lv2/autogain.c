@@ -0,0 +1,217 @@
+/* example plugin for the Ardour auto:canReadAutomation LV2 extension
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/* LV2 */
+#include "lv2/lv2plug.in/ns/lv2core/lv2.h"
+#include "lv2/lv2plug.in/ns/ext/atom/atom.h"
+#include "lv2/lv2plug.in/ns/ext/atom/util.h"
+#include "lv2/lv2plug.in/ns/ext/urid/urid.h"
+
+#define AGN_URI "urn:ardour:autogain"
+
+/* see libs/ardour/ardour/lv2_extensions.h */
+#define AUTO_URI_PREFIX "http://ardour.org/lv2/automate#"
+#define AUTO__event     AUTO_URI_PREFIX "event"
+#define AUTO__parameter AUTO_URI_PREFIX "parameter"
+#define AUTO__value     AUTO_URI_PREFIX "value"
+
+typedef enum {
+  AGN_GAIN = 0,
+  AGN_AUTOMATION,
+  AGN_INPUT,
+  AGN_OUTPUT
+} PortIndex;
+
+typedef struct {
+  const float* gain;
+  const LV2_Atom_Sequence* automation;
+  const float* input;
+  float* output;
+
+  LV2_URID atom_Blank;
+  LV2_URID atom_Object;
+  LV2_URID atom_Int;
+  LV2_URID atom_Float;
+  LV2_URID auto_event;
+  LV2_URID auto_parameter;
+  LV2_URID auto_value;
+} AutoGain;
+
+static LV2_Handle
+instantiate(const LV2_Descriptor*     descriptor,
+            double                    rate,
+            const char*               bundle_path,
+            const LV2_Feature* const* features)
+{
+  (void) descriptor; /* unused variable */
+  (void) rate; /* unused variable */
+  (void) bundle_path; /* unused variable */
+
+  LV2_URID_Map* map = NULL;
+
+  int i;
+  for (i=0; features[i]; ++i) {
+    if (!strcmp(features[i]->URI, LV2_URID__map)) {
+      map = (LV2_URID_Map*)features[i]->data;
+    }
+  }
+
+  if (!map) {
+    fprintf(stderr, "AutoGain.lv2 error: Host does not support urid:map\n");
+    return NULL;
+  }
+
+  AutoGain* self = (AutoGain*)calloc(1, sizeof(AutoGain));
+  if (!self) {
+    return NULL;
+  }
+
+  self->atom_Blank     = map->map(map->handle, LV2_ATOM__Blank);
+  self->atom_Object    = map->map(map->handle, LV2_ATOM__Object);
+  self->atom_Int       = map->map(map->handle, LV2_ATOM__Int);
+  self->atom_Float     = map->map(map->handle, LV2_ATOM__Float);
+  self->auto_event     = map->map(map->handle, AUTO__event);
+  self->auto_parameter = map->map(map->handle, AUTO__parameter);
+  self->auto_value     = map->map(map->handle, AUTO__value);
+
+  return (LV2_Handle)self;
+}
+
+static void
+connect_port(LV2_Handle handle,
+             uint32_t   port,
+             void*      data)
+{
+  AutoGain* self = (AutoGain*)handle;
+
+  switch ((PortIndex)port) {
+    case AGN_GAIN:
+      self->gain = (const float*)data;
+      break;
+    case AGN_AUTOMATION:
+      self->automation = (const LV2_Atom_Sequence*)data;
+      break;
+    case AGN_INPUT:
+      self->input = (const float*)data;
+      break;
+    case AGN_OUTPUT:
+      self->output = (float*)data;
+      break;
+  }
+}
+
+static void
+apply_gain(AutoGain* self, uint32_t start, uint32_t end, float gain)
+{
+  uint32_t i;
+  for (i = start; i < end; ++i) {
+    self->output[i] = self->input[i] * gain;
+  }
+}
+
+static void
+run(LV2_Handle handle, uint32_t n_samples)
+{
+  AutoGain* self = (AutoGain*)handle;
+
+  /* the control port holds the value at the start of the cycle ... */
+  float gain = *self->gain;
+  uint32_t done = 0;
+
+  /* ... and each auto:event the value from its frame onwards */
+  if (self->automation) {
+    LV2_ATOM_SEQUENCE_FOREACH(self->automation, ev) {
+      if (ev->body.type != self->atom_Object && ev->body.type != self->atom_Blank) {
+        continue;
+      }
+      const LV2_Atom_Object* obj = (const LV2_Atom_Object*)&ev->body;
+      if (obj->body.otype != self->auto_event) {
+        continue;
+      }
+
+      const LV2_Atom* parameter = NULL;
+      const LV2_Atom* value = NULL;
+      lv2_atom_object_get(obj, self->auto_parameter, &parameter, self->auto_value, &value, 0);
+
+      if (!parameter || parameter->type != self->atom_Int || ((const LV2_Atom_Int*)parameter)->body != AGN_GAIN) {
+        continue;
+      }
+      if (!value || value->type != self->atom_Float) {
+        continue;
+      }
+
+      uint32_t when = ev->time.frames;
+      if (when > n_samples) {
+        when = n_samples;
+      }
+      if (when > done) {
+        apply_gain(self, done, when, gain);
+        done = when;
+      }
+      gain = ((const LV2_Atom_Float*)value)->body;
+    }
+  }
+
+  apply_gain(self, done, n_samples, gain);
+}
+
+static void
+cleanup(LV2_Handle handle)
+{
+  free(handle);
+}
+
+static const void*
+extension_data(const char* uri)
+{
+  (void) uri; /* unused variable */
+  return NULL;
+}
+
+static const LV2_Descriptor descriptor = {
+  AGN_URI,
+  instantiate,
+  connect_port,
+  NULL,
+  run,
+  NULL,
+  cleanup,
+  extension_data
+};
+
+#if defined(COMPILER_MSVC)
+__declspec(dllexport)
+#else
+__attribute__ ((visibility ("default")))
+#endif
+const LV2_Descriptor*
+lv2_descriptor(uint32_t idx)
+{
+  switch (idx) {
+  case 0:
+    return &descriptor;
+  default:
+    return NULL;
+  }
+}
+
+/* vi:set ts=8 sts=2 sw=2 et: */
@@ -40,6 +40,7 @@
 #include "ardour/midi_track.h"
 #include "ardour/dB.h"
 #include "ardour/filesystem_paths.h"
+#include "ardour/meter.h"
 #include "ardour/panner.h"
 #include "ardour/plugin.h"
 #include "ardour/plugin_insert.h"
@@ -76,6 +77,7 @@ OSC::OSC (Session& s, uint32_t port)
 	, AbstractUI<OSCUIRequest> (name())
 	, local_server (0)
 	, remote_server (0)
+	, feedback_timer (0)
 	, _port(port)
 	, _ok (true)
 	, _shutdown (false)
@@ -84,6 +86,7 @@ OSC::OSC (Session& s, uint32_t port)
 	, _namespace_root ("/ardour")
 	, _send_route_changes (true)
 	, _debugmode (Off)
+	, _feedback_interval (50)
 	, gui (0)
 {
 	_instance = this;
@@ -263,6 +266,8 @@ OSC::thread_init ()
 		g_source_ref (remote_server);
 	}
 
+	start_feedback_timer ();
+
 	PBD::notify_event_loops_about_thread_creation (pthread_self(), event_loop_name(), 2048);
 	SessionEvent::create_per_thread_pool (event_loop_name(), 128);
 }
@@ -284,6 +289,12 @@ OSC::stop ()
 		remote_server = 0;
 	}
 
+	if (feedback_timer) {
+		g_source_destroy (feedback_timer);
+		g_source_unref (feedback_timer);
+		feedback_timer = 0;
+	}
+
 	BaseUI::quit ();
 
 	if (_osc_server) {
@@ -317,6 +328,11 @@ OSC::stop ()
 		}
 	}
 
+	for (FeedbackClients::iterator c = feedback_clients.begin(); c != feedback_clients.end(); ++c) {
+		lo_address_free (c->second.addr);
+	}
+	feedback_clients.clear ();
+
 	return 0;
 }
 
@@ -354,6 +370,8 @@ OSC::register_callbacks()
 		REGISTER_CALLBACK (serv, "/ardour/transport_frame", "", transport_frame);
 		REGISTER_CALLBACK (serv, "/ardour/transport_speed", "", transport_speed);
 		REGISTER_CALLBACK (serv, "/ardour/record_enabled", "", record_enabled);
+		REGISTER_CALLBACK (serv, "/ardour/stream/start", "", stream_start);
+		REGISTER_CALLBACK (serv, "/ardour/stream/stop", "", stream_stop);
 		REGISTER_CALLBACK (serv, "/ardour/set_transport_speed", "f", set_transport_speed);
 		REGISTER_CALLBACK (serv, "/ardour/locate", "ii", locate);
 		REGISTER_CALLBACK (serv, "/ardour/save_state", "", save_state);
@@ -862,6 +880,273 @@ OSC::update_clock ()
 
 }
 
+/* keep bundles below a typical network MTU, so that they are not
+ * fragmented on their way to the client
+ */
+static const size_t max_bundle_size = 1400;
+static const uint32_t max_stream_routes = 64; /* per /ardour/stream message */
+
+/** Collects the messages for one client into bundles of at most
+ *  max_bundle_size bytes, sending each one as it fills up.
+ *
+ *  Older versions of liblo only keep a pointer to the path of a
+ *  bundled message, so paths must stay valid until send().
+ */
+namespace {
+class FeedbackBundle
+{
+  public:
+	FeedbackBundle (lo_address a, lo_timetag tt)
+		: _addr (a)
+		, _tt (tt)
+		, _bundle (0)
+		, _size (0)
+	{}
+
+	~FeedbackBundle () { send (); }
+
+	void add (const char* path, lo_message msg)
+	{
+		/* each bundle element is preceded by its size */
+		size_t const len = lo_message_length (msg, path) + 4;
+
+		if (_bundle && _size + len > max_bundle_size) {
+			send ();
+		}
+
+		if (!_bundle) {
+			_bundle = lo_bundle_new (_tt);
+			_size = 16; /* "#bundle" and the timetag */
+		}
+
+		lo_bundle_add_message (_bundle, path, msg);
+		_size += len;
+	}
+
+	void send ()
+	{
+		if (!_bundle) {
+			return;
+		}
+		lo_send_bundle (_addr, _bundle);
+		lo_bundle_free_messages (_bundle);
+		_bundle = 0;
+	}
+
+  private:
+	lo_address _addr;
+	lo_timetag _tt;
+	lo_bundle  _bundle;
+	size_t     _size;
+};
+} // anonymous namespace
+
+static std::string
+feedback_client_key (lo_address addr)
+{
+	return string (lo_address_get_hostname (addr)) + ':' + lo_address_get_port (addr);
+}
+
+OSC::FeedbackClient&
+OSC::feedback_client (lo_address addr)
+{
+	FeedbackClient& c (feedback_clients[feedback_client_key (addr)]);
+
+	if (!c.addr) {
+		c.addr = lo_address_new (lo_address_get_hostname (addr), lo_address_get_port (addr));
+	}
+
+	return c;
+}
+
+OSC::FeedbackValue&
+OSC::feedback_value (lo_address addr, const std::string& path, int32_t rid)
+{
+	FeedbackValue& v (feedback_client (addr).pending[FeedbackKey (path, rid)]);
+	v.rid = rid;
+	return v;
+}
+
+void
+OSC::queue_feedback (lo_address addr, const std::string& path, int32_t rid, float val)
+{
+	FeedbackValue& v (feedback_value (addr, path, rid));
+	v.is_string = false;
+	v.fval = val;
+}
+
+void
+OSC::queue_feedback (lo_address addr, const std::string& path, int32_t rid, const std::string& val)
+{
+	FeedbackValue& v (feedback_value (addr, path, rid));
+	v.is_string = true;
+	v.sval = val;
+}
+
+void
+OSC::queue_feedback (lo_address addr, const std::string& path, float val)
+{
+	queue_feedback (addr, path, -1, val);
+}
+
+void
+OSC::cancel_feedback (lo_address addr, int32_t rid)
+{
+	FeedbackClients::iterator c = feedback_clients.find (feedback_client_key (addr));
+
+	if (c == feedback_clients.end()) {
+		return;
+	}
+
+	FeedbackValues& pending (c->second.pending);
+
+	for (FeedbackValues::iterator v = pending.begin(); v != pending.end();) {
+		if (v->first.second == rid) {
+			pending.erase (v++);
+		} else {
+			++v;
+		}
+	}
+}
+
+void
+OSC::set_feedback_interval (uint32_t msecs)
+{
+	_feedback_interval = max (msecs, (uint32_t) 1);
+
+	if (get_active ()) {
+		/* the timer belongs to our event loop */
+		call_slot (MISSING_INVALIDATOR, boost::bind (&OSC::start_feedback_timer, this));
+	}
+}
+
+void
+OSC::start_feedback_timer ()
+{
+	if (feedback_timer) {
+		g_source_destroy (feedback_timer);
+		g_source_unref (feedback_timer);
+	}
+
+	Glib::RefPtr<TimeoutSource> src = TimeoutSource::create (_feedback_interval);
+	src->connect (sigc::mem_fun (*this, &OSC::feedback_tick));
+	src->attach (_main_loop->get_context());
+	feedback_timer = src->gobj();
+	g_source_ref (feedback_timer);
+}
+
+bool
+OSC::feedback_tick ()
+{
+	lo_timetag now;
+	lo_timetag_now (&now);
+
+	bool have_stream_state = false;
+
+	for (FeedbackClients::iterator c = feedback_clients.begin(); c != feedback_clients.end(); ++c) {
+
+		FeedbackClient& client (c->second);
+
+		if (client.pending.empty() && !client.stream) {
+			continue;
+		}
+
+		{
+			FeedbackBundle bundle (client.addr, now);
+
+			for (FeedbackValues::const_iterator v = client.pending.begin(); v != client.pending.end(); ++v) {
+
+				lo_message msg = lo_message_new ();
+
+				if (v->second.rid >= 0) {
+					lo_message_add_int32 (msg, v->second.rid);
+				}
+				if (v->second.is_string) {
+					lo_message_add_string (msg, v->second.sval.c_str());
+				} else {
+					lo_message_add_float (msg, v->second.fval);
+				}
+
+				bundle.add (v->first.first.c_str(), msg);
+			}
+
+			if (client.stream) {
+				if (!have_stream_state) {
+					read_stream_state ();
+					have_stream_state = true;
+				}
+				vector<lo_message> msgs;
+				stream_messages (msgs);
+				for (vector<lo_message>::iterator m = msgs.begin(); m != msgs.end(); ++m) {
+					bundle.add ("/ardour/stream", *m);
+				}
+			}
+
+			/* bundle is sent here, while the paths are still valid */
+		}
+
+		client.pending.clear ();
+	}
+
+	return true;
+}
+
+/** Take the transport position and speed and every route's meter level
+ *  for this tick.  The peak meter is only read, never reset, so this can
+ *  not take anything away from the GUI's meters.
+ */
+void
+OSC::read_stream_state ()
+{
+	stream_state.meters.clear ();
+
+	if (!session) {
+		return;
+	}
+
+	stream_state.frame = session->transport_frame ();
+	stream_state.speed = session->transport_speed ();
+
+	boost::shared_ptr<RouteList> routes = session->get_routes ();
+
+	for (RouteList::const_iterator r = routes->begin(); r != routes->end(); ++r) {
+		if ((*r)->is_auditioner() || (*r)->is_monitor()) {
+			continue;
+		}
+		stream_state.meters.push_back (make_pair ((int32_t) (*r)->remote_control_id(), (*r)->peak_meter().meter_level (0, MeterPeak)));
+	}
+}
+
+/** Fill @a msgs with /ardour/stream messages from the state taken by
+ *  read_stream_state(), each holding the transport position and speed
+ *  followed by a (remote id, peak dB) pair for up to max_stream_routes
+ *  routes.
+ */
+void
+OSC::stream_messages (std::vector<lo_message>& msgs) const
+{
+	if (!session) {
+		return;
+	}
+
+	vector<pair<int32_t, float> >::const_iterator m = stream_state.meters.begin();
+
+	do {
+		lo_message msg = lo_message_new ();
+
+		lo_message_add_int64 (msg, stream_state.frame);
+		lo_message_add_double (msg, stream_state.speed);
+
+		for (uint32_t n = 0; m != stream_state.meters.end() && n < max_stream_routes; ++m, ++n) {
+			lo_message_add_int32 (msg, m->first);
+			lo_message_add_float (msg, m->second);
+		}
+
+		msgs.push_back (msg);
+
+	} while (m != stream_state.meters.end());
+}
+
 // "Application Hook" Handlers //
 void
 OSC::session_loaded (Session& s)
@@ -1046,6 +1331,18 @@ OSC::record_enabled (lo_message msg)
 	lo_message_free (reply);
 }
 
+void
+OSC::stream_start (lo_message msg)
+{
+	feedback_client (lo_message_get_source (msg)).stream = true;
+}
+
+void
+OSC::stream_stop (lo_message msg)
+{
+	feedback_client (lo_message_get_source (msg)).stream = false;
+}
+
 
 int
 OSC::route_mute (int rid, int yn)
@@ -1353,6 +1650,7 @@ OSC::get_state ()
 {
 	XMLNode& node (ControlProtocol::get_state());
 	node.add_property("debugmode", (int) _debugmode); // TODO: enum2str
+	node.add_property("feedback-interval", _feedback_interval);
 	return node;
 }
 
@@ -1366,6 +1664,10 @@ OSC::set_state (const XMLNode& node, int version)
 	if (p) {
 		_debugmode = OSCDebugMode (PBD::atoi(p->value ()));
 	}
+	p = node.property (X_("feedback-interval"));
+	if (p) {
+		set_feedback_interval (PBD::atoi (p->value ()));
+	}
 
 	return 0;
 }
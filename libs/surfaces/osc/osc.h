@@ -21,6 +21,8 @@
 #define ardour_osc_h
 
 #include <string>
+#include <map>
+#include <vector>
 
 #include <sys/time.h>
 #include <pthread.h>
@@ -97,12 +99,27 @@ class OSC : public ARDOUR::ControlProtocol, public AbstractUI<OSCUIRequest>
 	void set_debug_mode (OSCDebugMode m) { _debugmode = m; }
 	OSCDebugMode get_debug_mode () { return _debugmode; }
 
+	/* feedback is not sent as it happens but collected per client and
+	 * sent as one or more bundles every feedback_interval() ms. A value
+	 * queued again for the same path and route before then replaces the
+	 * earlier one. These must be called from the OSC event loop.
+	 */
+
+	void queue_feedback (lo_address, const std::string& path, int32_t rid, float val);
+	void queue_feedback (lo_address, const std::string& path, int32_t rid, const std::string& val);
+	void queue_feedback (lo_address, const std::string& path, float val);
+	void cancel_feedback (lo_address, int32_t rid);
+
+	void set_feedback_interval (uint32_t msecs);
+	uint32_t feedback_interval () const { return _feedback_interval; }
+
   protected:
         void thread_init ();
 	void do_request (OSCUIRequest*);
 
 	GSource* local_server;
 	GSource* remote_server;
+	GSource* feedback_timer;
 
 	bool osc_input_handler (Glib::IOCondition, lo_server);
 
@@ -117,6 +134,48 @@ class OSC : public ARDOUR::ControlProtocol, public AbstractUI<OSCUIRequest>
 	std::string _namespace_root;
 	bool _send_route_changes;
 	OSCDebugMode _debugmode;
+	uint32_t _feedback_interval;
+
+	struct FeedbackValue {
+		FeedbackValue () : rid (-1), is_string (false), fval (0) {}
+
+		int32_t rid; /* -1 if the message has no route id */
+		bool is_string;
+		float fval;
+		std::string sval;
+	};
+
+	typedef std::pair<std::string, int32_t> FeedbackKey; /* path, route id */
+	typedef std::map<FeedbackKey, FeedbackValue> FeedbackValues;
+
+	struct FeedbackClient {
+		FeedbackClient () : addr (0), stream (false) {}
+
+		lo_address addr;
+		bool stream; /* send meters and transport every tick */
+		FeedbackValues pending;
+	};
+
+	typedef std::map<std::string, FeedbackClient> FeedbackClients; /* by "host:port" */
+	FeedbackClients feedback_clients;
+
+	FeedbackClient& feedback_client (lo_address);
+	FeedbackValue& feedback_value (lo_address, const std::string& path, int32_t rid);
+	void start_feedback_timer ();
+	bool feedback_tick ();
+
+	/** What /ardour/stream reports; read once per tick and shared by all
+	 *  streaming clients.
+	 */
+	struct StreamState {
+		ARDOUR::framepos_t frame;
+		double speed;
+		std::vector<std::pair<int32_t, float> > meters; /* remote id, peak dB */
+	};
+	StreamState stream_state;
+
+	void read_stream_state ();
+	void stream_messages (std::vector<lo_message>&) const;
 
 	void register_callbacks ();
 
@@ -142,6 +201,8 @@ class OSC : public ARDOUR::ControlProtocol, public AbstractUI<OSCUIRequest>
 	void transport_frame (lo_message msg);
 	void transport_speed (lo_message msg);
 	void record_enabled (lo_message msg);
+	void stream_start (lo_message msg);
+	void stream_stop (lo_message msg);
 
 #define OSC_DEBUG \
 	if (_debugmode == All) { \
@@ -162,6 +223,8 @@ class OSC : public ARDOUR::ControlProtocol, public AbstractUI<OSCUIRequest>
 	PATH_CALLBACK_MSG(transport_frame);
 	PATH_CALLBACK_MSG(transport_speed);
 	PATH_CALLBACK_MSG(record_enabled);
+	PATH_CALLBACK_MSG(stream_start);
+	PATH_CALLBACK_MSG(stream_stop);
 
 #define PATH_CALLBACK(name) \
         static int _ ## name (const char *path, const char *types, lo_arg **argv, int argc, void *data, void *user_data) { \
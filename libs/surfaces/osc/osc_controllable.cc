@@ -62,14 +62,7 @@ OSCControllable::set_state (const XMLNode& /*node*/, int /*version*/)
 void
 OSCControllable::send_change_message ()
 {
-	lo_message msg = lo_message_new ();
-
-	lo_message_add_float (msg, (float) controllable->get_value());
-
-	/* XXX thread issues */
-
-	lo_send_message (addr, path.c_str(), msg);
-	lo_message_free (msg);
+	OSC::instance()->queue_feedback (addr, path, (float) controllable->get_value());
 }
 
 /*------------------------------------------------------------*/
@@ -83,20 +76,13 @@ OSCRouteControllable::OSCRouteControllable (lo_address a, const std::string& p,
 
 OSCRouteControllable::~OSCRouteControllable ()
 {
+	OSC::instance()->cancel_feedback (addr, _route->remote_control_id());
 }
 
 void
 OSCRouteControllable::send_change_message ()
 {
-	lo_message msg = lo_message_new ();
-
-	lo_message_add_int32 (msg, _route->remote_control_id());
-	lo_message_add_float (msg, (float) controllable->get_value());
-
-	/* XXX thread issues */
-
-	//std::cerr << "ORC: send " << path << " = " << controllable->get_value() << std::endl;
+	//std::cerr << "ORC: queue " << path << " = " << controllable->get_value() << std::endl;
 
-	lo_send_message (addr, path.c_str(), msg);
-	lo_message_free (msg);
+	OSC::instance()->queue_feedback (addr, path, _route->remote_control_id(), (float) controllable->get_value());
 }
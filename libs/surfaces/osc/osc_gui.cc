@@ -26,6 +26,8 @@
 #include <gtkmm/table.h>
 #include <gtkmm/label.h>
 #include <gtkmm/comboboxtext.h>
+#include <gtkmm/adjustment.h>
+#include <gtkmm/spinbutton.h>
 
 #include "gtkmm2ext/gtk_ui.h"
 #include "gtkmm2ext/gui_thread.h"
@@ -47,6 +49,10 @@ private:
 	Gtk::ComboBoxText debug_combo;
 	void debug_changed ();
 
+	Gtk::Adjustment feedback_interval_adjustment;
+	Gtk::SpinButton feedback_interval_spinner;
+	void feedback_interval_changed ();
+
 	OSC& cp;
 };
 
@@ -91,7 +97,9 @@ using namespace Gtkmm2ext;
 using namespace ArdourSurface;
 
 OSC_GUI::OSC_GUI (OSC& p)
-	: cp (p)
+	: feedback_interval_adjustment (p.feedback_interval(), 10, 1000, 10, 100)
+	, feedback_interval_spinner (feedback_interval_adjustment)
+	, cp (p)
 {
 	int n = 0; // table row
 	Table* table = manage (new Table);
@@ -114,11 +122,17 @@ OSC_GUI::OSC_GUI (OSC& p)
 
 	set_popdown_strings (debug_combo, debug_options);
 	debug_combo.set_active ((int)cp.get_debug_mode());
+	++n;
+
+	label = manage (new Gtk::Label(_("Feedback interval (ms):")));
+	table->attach (*label, 0, 1, n, n+1, AttachOptions(FILL|EXPAND), AttachOptions(0));
+	table->attach (feedback_interval_spinner, 1, 2, n, n+1, AttachOptions(FILL|EXPAND), AttachOptions(0), 0, 0);
 
 	table->show_all ();
 	pack_start (*table, false, false);
 
 	debug_combo.signal_changed().connect (sigc::mem_fun (*this, &OSC_GUI::debug_changed));
+	feedback_interval_adjustment.signal_value_changed().connect (sigc::mem_fun (*this, &OSC_GUI::feedback_interval_changed));
 }
 
 OSC_GUI::~OSC_GUI ()
@@ -143,3 +157,9 @@ OSC_GUI::debug_changed ()
 		assert (0);
 	}
 }
+
+void
+OSC_GUI::feedback_interval_changed ()
+{
+	cp.set_feedback_interval (feedback_interval_adjustment.get_value());
+}
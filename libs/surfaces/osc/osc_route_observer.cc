@@ -66,6 +66,8 @@ OSCRouteObserver::~OSCRouteObserver ()
 	solo_changed_connection.disconnect();
 	gain_changed_connection.disconnect();
 
+	OSC::instance()->cancel_feedback (addr, _route->remote_control_id());
+
 	lo_address_free (addr);
 }
 
@@ -80,27 +82,13 @@ OSCRouteObserver::name_changed (const PBD::PropertyChange& what_changed)
 		return;
 	}
 
-	lo_message msg = lo_message_new ();
-
-	lo_message_add_int32 (msg, _route->remote_control_id());
-	lo_message_add_string (msg, _route->name().c_str());
-
-	lo_send_message (addr, "/route/name", msg);
-	lo_message_free (msg);
+	OSC::instance()->queue_feedback (addr, X_("/route/name"), _route->remote_control_id(), _route->name());
 }
 
 void
 OSCRouteObserver::send_change_message (string path, boost::shared_ptr<Controllable> controllable)
 {
-	lo_message msg = lo_message_new ();
-
-	lo_message_add_int32 (msg, _route->remote_control_id());
-	lo_message_add_float (msg, (float) controllable->get_value());
-
-	/* XXX thread issues */
-
-	//std::cerr << "ORC: send " << path << " = " << controllable->get_value() << std::endl;
+	//std::cerr << "ORC: queue " << path << " = " << controllable->get_value() << std::endl;
 
-	lo_send_message (addr, path.c_str(), msg);
-	lo_message_free (msg);
+	OSC::instance()->queue_feedback (addr, path, _route->remote_control_id(), (float) controllable->get_value());
 }
@@ -0,0 +1,223 @@
+/*
+    Copyright (C) 2016 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/* Subscribe to feedback from a running OSC surface and report how many
+ * messages and datagrams arrive per second, and how long bundles take
+ * from being sent to being received. Run it on the same host as Ardour,
+ * since latency is measured against the bundle timetags.
+ *
+ * usage: osc_feedback_client [-s] [-t seconds] url [remote-id ...]
+ *
+ *   -s  also start the /ardour/stream meter and transport stream
+ */
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+
+#include <getopt.h>
+#include <stdint.h>
+
+#include <lo/lo.h>
+
+using namespace std;
+
+struct Stats {
+	Stats ()
+		: messages (0)
+		, unbundled (0)
+		, ticks (0)
+		, stream_routes (0)
+		, latency_sum (0)
+		, latency_min (1e9)
+		, latency_max (0)
+	{
+		last_tt.sec = 0;
+		last_tt.frac = 0;
+	}
+
+	uint64_t messages;
+	uint64_t unbundled;
+	uint64_t ticks;         /* distinct bundle timetags */
+	uint64_t stream_routes; /* routes received in /ardour/stream messages */
+	double   latency_sum;
+	double   latency_min;
+	double   latency_max;
+	lo_timetag last_tt;
+	map<string, uint64_t> paths;
+};
+
+static void
+error_callback (int num, const char* m, const char* path)
+{
+	cerr << "liblo server error " << num << " in path " << (path ? path : "") << ": " << m << endl;
+}
+
+static int
+handler (const char* path, const char* types, lo_arg** /*argv*/, int argc, lo_message msg, void* user_data)
+{
+	Stats* stats = static_cast<Stats*> (user_data);
+	lo_timetag tt = lo_message_get_timestamp (msg);
+
+	++stats->messages;
+	++stats->paths[path];
+
+	if (tt.sec == 0 && tt.frac <= 1) {
+		/* not in a bundle, or sent "immediately" */
+		++stats->unbundled;
+	} else {
+		if (tt.sec != stats->last_tt.sec || tt.frac != stats->last_tt.frac) {
+			lo_timetag now;
+			lo_timetag_now (&now);
+
+			const double latency = lo_timetag_diff (now, tt);
+
+			stats->latency_sum += latency;
+			stats->latency_min = min (stats->latency_min, latency);
+			stats->latency_max = max (stats->latency_max, latency);
+			stats->last_tt = tt;
+			++stats->ticks;
+		}
+	}
+
+	if (!strcmp (path, "/ardour/stream") && argc >= 2 && !strncmp (types, "hd", 2)) {
+		stats->stream_routes += (argc - 2) / 2;
+	}
+
+	return 0;
+}
+
+static void
+usage ()
+{
+	cerr << "usage: osc_feedback_client [-s] [-t seconds] url [remote-id ...]\n";
+	exit (1);
+}
+
+int
+main (int argc, char* argv[])
+{
+	bool stream = false;
+	double duration = 10;
+	int c;
+
+	while ((c = getopt (argc, argv, "st:")) != -1) {
+		switch (c) {
+		case 's':
+			stream = true;
+			break;
+		case 't':
+			duration = atof (optarg);
+			break;
+		default:
+			usage ();
+		}
+	}
+
+	if (optind >= argc) {
+		usage ();
+	}
+
+	lo_address ardour = lo_address_new_from_url (argv[optind]);
+
+	if (!ardour) {
+		cerr << "cannot parse OSC url " << argv[optind] << endl;
+		return 1;
+	}
+
+	/* feedback goes back to the address that requests came from */
+	lo_server server = lo_server_new (0, error_callback);
+
+	if (!server) {
+		lo_address_free (ardour);
+		return 1;
+	}
+
+	Stats stats;
+	lo_server_add_method (server, 0, 0, handler, &stats);
+
+	lo_message listen = lo_message_new ();
+	for (int n = optind + 1; n < argc; ++n) {
+		lo_message_add_int32 (listen, atoi (argv[n]));
+	}
+	if (argc > optind + 1) {
+		lo_send_message_from (ardour, server, "/routes/listen", listen);
+	}
+
+	if (stream) {
+		lo_message msg = lo_message_new ();
+		lo_send_message_from (ardour, server, "/ardour/stream/start", msg);
+		lo_message_free (msg);
+	}
+
+	uint64_t datagrams = 0;
+	lo_timetag start;
+	lo_timetag now;
+
+	lo_timetag_now (&start);
+	now = start;
+
+	while (lo_timetag_diff (now, start) < duration) {
+		if (lo_server_recv_noblock (server, 100) > 0) {
+			++datagrams;
+		}
+		lo_timetag_now (&now);
+	}
+
+	const double elapsed = lo_timetag_diff (now, start);
+
+	if (argc > optind + 1) {
+		lo_send_message_from (ardour, server, "/routes/ignore", listen);
+	}
+	lo_message_free (listen);
+
+	if (stream) {
+		lo_message msg = lo_message_new ();
+		lo_send_message_from (ardour, server, "/ardour/stream/stop", msg);
+		lo_message_free (msg);
+	}
+
+	cout << "seconds:     " << elapsed << endl;
+	cout << "messages:    " << stats.messages << " (" << stats.messages / elapsed << "/s, "
+	     << stats.unbundled << " unbundled)" << endl;
+	cout << "datagrams:   " << datagrams << " (" << datagrams / elapsed << "/s)" << endl;
+	cout << "ticks:       " << stats.ticks << " (" << stats.ticks / elapsed << "/s)" << endl;
+
+	if (stats.ticks) {
+		cout << "latency:     min " << stats.latency_min * 1000.0
+		     << " ms, avg " << stats.latency_sum * 1000.0 / stats.ticks
+		     << " ms, max " << stats.latency_max * 1000.0 << " ms" << endl;
+	}
+
+	if (stats.paths["/ardour/stream"]) {
+		cout << "stream:      " << stats.stream_routes / (double) stats.paths["/ardour/stream"]
+		     << " routes/message" << endl;
+	}
+
+	for (map<string, uint64_t>::const_iterator p = stats.paths.begin(); p != stats.paths.end(); ++p) {
+		cout << "  " << p->first << "\t" << p->second << endl;
+	}
+
+	lo_server_free (server);
+	lo_address_free (ardour);
+
+	return 0;
+}
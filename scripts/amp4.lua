@@ -0,0 +1,56 @@
+ardour {
+	["type"]    = "dsp",
+	name        = "Simple Amp IV",
+	license     = "MIT",
+	author      = "Ardour Lua Task Force",
+	description = [[
+	An Example DSP Plugin for processing audio, to
+	be used with Ardour's Lua scripting facility.
+
+	This variant applies gain automation sample-accurately,
+	using the automation vectors that Ardour provides for
+	the whole process cycle.]]
+}
+
+function dsp_ioconfig ()
+	return
+	{
+		{ audio_in = -1, audio_out = -1},
+	}
+end
+
+function dsp_params ()
+	return
+	{
+		{ ["type"] = "input", name = "Gain", min = -20, max = 20, default = 0, unit="dB"},
+	}
+end
+
+-- ask for automation vectors rather than having Ardour
+-- split the process cycle at automation events
+function dsp_automation_vectors ()
+	return true
+end
+
+function dsp_run (ins, outs, n_samples)
+	assert (#ins == #outs) -- ensure that we can run in-place
+	for c = 1,#ins do
+		assert (ins[c]:sameinstance(outs[c])) -- check in-place
+	end
+	local vec = CtrlVectors[1] -- nil unless the gain is automated
+	if not vec then
+		local ctrl = CtrlPorts:array()
+		local gain = ARDOUR.DSP.dB_to_coefficient (ctrl[1])
+		for c = 1,#ins do
+			ARDOUR.DSP.apply_gain_to_buffer (ins[c], n_samples, gain);
+		end
+		return
+	end
+	local g = vec:array()
+	for c = 1,#ins do
+		local a = ins[c]:array()
+		for s = 1,n_samples do
+			a[s] = a[s] * ARDOUR.DSP.dB_to_coefficient (g[s])
+		end
+	end
+end
@@ -0,0 +1,53 @@
+ardour {
+	["type"]    = "dsp",
+	name        = "Simple Delay",
+	license     = "MIT",
+	author      = "Ardour Lua Task Force",
+	description = [[
+	An Example DSP Plugin for processing audio, to
+	be used with Ardour's Lua scripting facility.
+
+	This delays every channel by a given time, using the
+	DelayLine class of ARDOUR.DSP rather than a per-sample
+	loop in Lua.]]
+}
+
+function dsp_ioconfig ()
+	return
+	{
+		{ audio_in = -1, audio_out = -1},
+	}
+end
+
+function dsp_params ()
+	return
+	{
+		{ ["type"] = "input", name = "Delay", min = 0, max = 1000, default = 250, unit="ms"},
+	}
+end
+
+function dsp_init (rate)
+	samplerate = rate
+end
+
+function dsp_configure (ins, outs)
+	-- allocate one delay-line per channel; memory allocation
+	-- is not realtime safe and must not be done in dsp_run()
+	lines = {}
+	for c = 1,ins:n_audio () do
+		lines[c] = ARDOUR.DSP.DelayLine (samplerate)
+	end
+end
+
+function dsp_run (ins, outs, n_samples)
+	assert (#ins == #outs)
+	local ctrl = CtrlPorts:array ()
+	local delay = math.floor (ctrl[1] * samplerate / 1000)
+	for c = 1,#ins do
+		if not ins[c]:sameinstance (outs[c]) then
+			ARDOUR.DSP.copy_vector (outs[c], ins[c], n_samples)
+		end
+		lines[c]:set_delay (delay)
+		lines[c]:run (outs[c], n_samples)
+	end
+end
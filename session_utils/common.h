@@ -25,8 +25,9 @@ namespace SessionUtils {
 
 	/** @param dir Session directory.
 	 *  @param state Session state file, without .ardour suffix.
+	 *  @param buffer_size engine buffer size to use, 0 for the backend's default.
 	 */
-	ARDOUR::Session * load_session (std::string dir, std::string state);
+	ARDOUR::Session * load_session (std::string dir, std::string state, uint32_t buffer_size = 0);
 
 	/** close session and stop engine
 	 * @param s Session to close (may me NULL)
@@ -7,12 +7,14 @@
 
 #include "pbd/basename.h"
 
+#include "ardour/audioengine.h"
 #include "ardour/export_handler.h"
 #include "ardour/export_status.h"
 #include "ardour/export_timespan.h"
 #include "ardour/export_channel_configuration.h"
 #include "ardour/export_format_specification.h"
 #include "ardour/export_filename.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/route.h"
 #include "ardour/session_metadata.h"
 #include "ardour/broadcast_info.h"
@@ -24,7 +26,8 @@ using namespace SessionUtils;
 static int export_session (Session *session,
 		std::string outfile,
 		std::string samplerate,
-		bool normalize)
+		bool normalize,
+		bool offline)
 {
 	ExportTimespanPtr tsp = session->get_export_handler()->add_timespan();
 	boost::shared_ptr<ExportChannelConfiguration> ccp = session->get_export_handler()->add_channel_config();
@@ -114,10 +117,20 @@ static int export_session (Session *session,
 	/* do audio export */
 	fmp->set_soundcloud_upload(false);
 	session->get_export_handler()->add_export_config (tsp, ccp, fmp, fnp, b);
-	session->get_export_handler()->do_export();
 
 	boost::shared_ptr<ARDOUR::ExportStatus> status = session->get_export_status ();
 
+	const gint64 start_time = g_get_monotonic_time ();
+
+	if (offline) {
+		/* runs the whole export in this thread, returns when done */
+		if (session->get_export_handler()->do_offline_export()) {
+			PBD::error << _("Export Util: Offline export failed") << endmsg;
+		}
+	} else {
+		session->get_export_handler()->do_export();
+	}
+
 	// TODO trap SIGINT -> status->abort();
 
 	while (status->running ()) {
@@ -139,9 +152,21 @@ static int export_session (Session *session,
 	}
 	printf("\n");
 
+	const double elapsed = (g_get_monotonic_time () - start_time) / 1e6;
+	const bool failed = status->aborted ();
+
 	status->finish ();
 
-	printf ("* Done.\n");
+	if (failed) {
+		printf ("* Failed.\n");
+		return -1;
+	}
+
+	/* how much faster than realtime the session was rendered */
+	printf ("* Done in %.2f sec (%.1fx realtime, %u frames per cycle).\n",
+			elapsed,
+			elapsed > 0 ? (status->total_frames / (double) session->nominal_frame_rate ()) / elapsed : 0.0,
+			session->engine().samples_per_cycle ());
 	return 0;
 }
 
@@ -150,8 +175,12 @@ static void usage (int status) {
 	printf ("export - export an ardour session from the commandline.\n\n");
 	printf ("Usage: export [ OPTIONS ] <session-dir> <session-name>\n\n");
 	printf ("Options:\n\
+  -b, --buffer-size <size>   frames per process cycle (default: 8192 when\n\
+                             rendering offline, the backend's otherwise)\n\
   -h, --help                 display this help and exit\n\
   -n, --normalize            normalize signal level (to 0dBFS)\n\
+  -O, --offline              render as fast as possible, from this thread and\n\
+                             using all CPU cores, instead of freewheeling\n\
   -o, --output  <file>       set expected [initial] framerate\n\
   -s, --samplerate <rate>    samplerate to use (default: 48000)\n\
   -V, --version              print version information and exit\n\
@@ -159,6 +188,8 @@ static void usage (int status) {
 	printf ("\n\
 The session is exported as 16bit wav.\n\
 If the no output file is given, the session's export dir is used.\n\
+The time taken, and how many times faster than realtime that is, is\n\
+reported at the end.\n\
 \n");
 
 	printf ("Report bugs to <http://tracker.ardour.org/>\n"
@@ -171,12 +202,16 @@ int main (int argc, char* argv[])
 	std::string rate = "48000";
 	std::string outfile;
 	bool normalize = false;
+	bool offline = false;
+	uint32_t buffer_size = 0;
 
-	const char *optstring = "hno:r:V";
+	const char *optstring = "b:hnOo:r:V";
 
 	const struct option longopts[] = {
+		{ "buffer-size", 1, 0, 'b' },
 		{ "help",       0, 0, 'h' },
 		{ "normalize",  0, 0, 'n' },
+		{ "offline",    0, 0, 'O' },
 		{ "output",     1, 0, 'o' },
 		{ "samplerate", 1, 0, 'r' },
 		{ "version",    0, 0, 'V' },
@@ -187,10 +222,25 @@ int main (int argc, char* argv[])
 					optstring, longopts, (int *) 0))) {
 		switch (c) {
 
+			case 'b':
+				{
+					const int bs = atoi (optarg);
+					if (bs >= 16 && bs <= 8192) {
+						buffer_size = bs;
+					} else {
+						fprintf(stderr, "Invalid Buffer Size\n");
+					}
+				}
+				break;
+
 			case 'n':
 				normalize = true;
 				break;
 
+			case 'O':
+				offline = true;
+				break;
+
 			case 'o':
 				outfile = optarg;
 				break;
@@ -231,9 +281,19 @@ int main (int argc, char* argv[])
 	SessionUtils::init();
 	Session* s = 0;
 
-	s = SessionUtils::load_session (argv[optind], argv[optind+1]);
+	if (offline) {
+		/* nothing else is running: use every core for the process graph,
+		 * and the largest cycles the (dummy) backend allows.
+		 */
+		Config->set_processor_usage (0);
+		if (buffer_size == 0) {
+			buffer_size = 8192;
+		}
+	}
+
+	s = SessionUtils::load_session (argv[optind], argv[optind+1], buffer_size);
 
-	export_session (s, outfile, rate, normalize);
+	export_session (s, outfile, rate, normalize, offline);
 
 	SessionUtils::unload_session(s);
 	SessionUtils::cleanup();